@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/WadFileSystem.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        /** The number of times every mip level is converted per run, so that a run takes long enough to measure. */
+        static constexpr size_t PaletteConversionPasses = 50;
+
+        struct IndexedMip {
+            std::vector<unsigned char> indices;
+            PaletteTransparency transparency;
+        };
+
+        static std::vector<IndexedMip> loadIndexedMips(const IO::Path& wadPath) {
+            NullLogger logger;
+            IO::WadFileSystem wadFS(wadPath, logger);
+
+            std::vector<IndexedMip> result;
+            for (const auto& texturePath : wadFS.findItems(IO::Path(""), IO::FileExtensionMatcher("D"))) {
+                auto file = wadFS.openFile(texturePath);
+                auto reader = file->reader().buffer();
+
+                const auto name = reader.readString(16);
+                const auto width = reader.readSize<int32_t>();
+                const auto height = reader.readSize<int32_t>();
+                const auto transparency = (!name.empty() && name.front() == '{')
+                                          ? PaletteTransparency::Index255Transparent
+                                          : PaletteTransparency::Opaque;
+
+                for (size_t level = 0; level < 4; ++level) {
+                    const auto offset = reader.readSize<int32_t>();
+                    const auto pixelCount = (width >> level) * (height >> level);
+                    const auto* begin = reinterpret_cast<const unsigned char*>(reader.begin() + offset);
+                    result.push_back(IndexedMip{std::vector<unsigned char>(begin, begin + pixelCount), transparency});
+                }
+            }
+            return result;
+        }
+
+        static std::vector<unsigned char> makePaletteTable(const std::vector<unsigned char>& rgb, const PaletteTransparency transparency) {
+            std::vector<unsigned char> result;
+            for (size_t i = 0; i < 256; ++i) {
+                result.push_back(rgb[3 * i + 0]);
+                result.push_back(rgb[3 * i + 1]);
+                result.push_back(rgb[3 * i + 2]);
+                result.push_back(i == 255 && transparency == PaletteTransparency::Index255Transparent ? 0x00 : 0xFF);
+            }
+            return result;
+        }
+
+        TEST_CASE("PaletteBenchmark.indexedToRgba", "[PaletteBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(2, 20);
+
+            const auto fixturePath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test");
+
+            IO::DiskFileSystem fs(fixturePath);
+            auto paletteReader = fs.openFile(IO::Path("palette.lmp"))->reader();
+            auto paletteData = std::vector<unsigned char>(paletteReader.size());
+            paletteReader.read(paletteData.data(), paletteData.size());
+
+            const auto opaqueTable = makePaletteTable(paletteData, PaletteTransparency::Opaque);
+            const auto transparentTable = makePaletteTable(paletteData, PaletteTransparency::Index255Transparent);
+
+            auto mips = loadIndexedMips(fixturePath + IO::Path("IO/Wad/cr8_czg.wad"));
+            for (auto& mip : loadIndexedMips(fixturePath + IO::Path("IO/Wad/q1_masked.wad"))) {
+                mips.push_back(std::move(mip));
+            }
+            REQUIRE(!mips.empty());
+
+            std::vector<TextureBuffer> buffers;
+            size_t pixelCount = 0;
+            for (const auto& mip : mips) {
+                buffers.emplace_back(4 * mip.indices.size());
+                pixelCount += mip.indices.size();
+            }
+
+            const auto suffix = " (" + std::to_string(mips.size()) + " mips, " + std::to_string(pixelCount * PaletteConversionPasses) + " pixels)";
+
+            const auto runConversion = [&](const auto& convert) {
+                uint64_t colorSum = 0;
+                for (size_t pass = 0; pass < PaletteConversionPasses; ++pass) {
+                    for (size_t i = 0; i < mips.size(); ++i) {
+                        const auto& table = mips[i].transparency == PaletteTransparency::Opaque ? opaqueTable : transparentTable;
+                        const auto stats = convert(table.data(), mips[i].indices.data(), mips[i].indices.size(), buffers[i].data());
+                        colorSum += stats.colorSum[0] + stats.colorSum[1] + stats.colorSum[2];
+                    }
+                }
+                return colorSum;
+            };
+
+            uint64_t scalarColorSum = 0;
+            runBenchmark("Palette.convertIndexedToRgbaScalar" + suffix, options, [&]() {
+                scalarColorSum = runConversion(convertIndexedToRgbaScalar);
+            });
+
+            uint64_t colorSum = 0;
+            runBenchmark("Palette.convertIndexedToRgba" + suffix, options, [&]() {
+                colorSum = runConversion(convertIndexedToRgba);
+            });
+
+            CHECK(colorSum == scalarColorSum);
+
+            const auto palette = Palette(paletteData);
+            runBenchmark("Palette.indexedToRgba" + suffix, options, [&]() {
+                for (size_t pass = 0; pass < PaletteConversionPasses; ++pass) {
+                    for (size_t i = 0; i < mips.size(); ++i) {
+                        const auto& indices = mips[i].indices;
+                        auto reader = IO::Reader::from(reinterpret_cast<const char*>(indices.data()), reinterpret_cast<const char*>(indices.data() + indices.size())).buffer();
+                        Color averageColor;
+                        palette.indexedToRgba(reader, indices.size(), buffers[i], mips[i].transparency, averageColor);
+                    }
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkMaps.h"
+
+#include "IO/NodeWriter.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/string_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace TrenchBroom {
+    namespace BenchmarkMaps {
+        static constexpr size_t TextureCount = 64;
+        static constexpr size_t DetailInterval = 10;
+        static constexpr size_t GroupSize = 100;
+        static constexpr size_t LinkInterval = 50;
+
+        vm::bbox3 worldBounds() {
+            return vm::bbox3(8192.0);
+        }
+
+        static size_t gridSize(const size_t brushCount) {
+            return static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(brushCount))));
+        }
+
+        vm::bbox3 cellBounds(const size_t index, const size_t brushCount) {
+            const size_t n = gridSize(brushCount);
+            const auto cell = vm::vec3(
+                static_cast<FloatType>(index % n),
+                static_cast<FloatType>((index / n) % n),
+                static_cast<FloatType>(index / (n * n)));
+
+            // center the grid around the origin
+            const auto offset = vm::vec3::fill(static_cast<FloatType>(n) * CubeSize / 2.0);
+            const auto min = cell * CubeSize - offset;
+            return vm::bbox3(min, min + vm::vec3::fill(CubeSize));
+        }
+
+        std::unique_ptr<Model::WorldNode> makeWorld(const size_t brushCount, const Model::MapFormat mapFormat) {
+            auto world = std::make_unique<Model::WorldNode>(Model::Entity(), mapFormat);
+            Model::LayerNode* layer = world->defaultLayer();
+
+            const Model::BrushBuilder builder(mapFormat, worldBounds());
+
+            Model::GroupNode* currentGroup = nullptr;
+            size_t worldBrushCount = 0;
+
+            for (size_t i = 0; i < brushCount; ++i) {
+                const vm::bbox3 bounds = cellBounds(i, brushCount);
+                const std::string textureName = "texture_" + std::to_string(i % TextureCount);
+                auto* brushNode = new Model::BrushNode(builder.createCuboid(bounds, textureName).value());
+
+                if (i % DetailInterval == 0) {
+                    auto* entityNode = new Model::EntityNode({
+                        {Model::PropertyKeys::Classname, "func_detail"}
+                    });
+                    entityNode->addChild(brushNode);
+                    layer->addChild(entityNode);
+                } else {
+                    if (worldBrushCount % GroupSize == 0) {
+                        currentGroup = new Model::GroupNode(Model::Group("group " + std::to_string(worldBrushCount / GroupSize)));
+                        layer->addChild(currentGroup);
+                    }
+                    currentGroup->addChild(brushNode);
+                    ++worldBrushCount;
+                }
+
+                if (i % LinkInterval == 0) {
+                    const std::string targetName = "target_" + std::to_string(i / LinkInterval);
+                    const auto origin = kdl::str_to_string(bounds.center());
+
+                    layer->addChild(new Model::EntityNode({
+                        {Model::PropertyKeys::Classname, "trigger_relay"},
+                        {Model::PropertyKeys::Origin, origin},
+                        {Model::PropertyKeys::Target, targetName}
+                    }));
+                    layer->addChild(new Model::EntityNode({
+                        {Model::PropertyKeys::Classname, "info_notnull"},
+                        {Model::PropertyKeys::Origin, origin},
+                        {Model::PropertyKeys::Targetname, targetName}
+                    }));
+                }
+            }
+
+            return world;
+        }
+
+        std::unique_ptr<Model::WorldNode> makeBrushWorld(const size_t brushCount, const Model::MapFormat mapFormat) {
+            auto world = std::make_unique<Model::WorldNode>(Model::Entity(), mapFormat);
+            const Model::BrushBuilder builder(mapFormat, worldBounds());
+
+            for (size_t i = 0; i < brushCount; ++i) {
+                world->defaultLayer()->addChild(new Model::BrushNode(builder.createCuboid(cellBounds(i, brushCount), "texture").value()));
+            }
+
+            return world;
+        }
+
+        std::string writeMap(const Model::WorldNode& world) {
+            std::stringstream str;
+            IO::NodeWriter writer(world, str);
+            writer.writeMap();
+            return str.str();
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <memory>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        enum class MapFormat;
+        class WorldNode;
+    }
+
+    namespace BenchmarkMaps {
+        /** The brush counts of the generated fixture maps. */
+        constexpr size_t SmallMap = 1'000;
+        constexpr size_t MediumMap = 20'000;
+        constexpr size_t LargeMap = 200'000;
+
+        /** The edge length of the generated cube brushes. */
+        constexpr FloatType CubeSize = 32.0;
+
+        /** The bounds used for all generated maps. */
+        vm::bbox3 worldBounds();
+
+        /**
+         * Generates a map with the given number of brushes which resembles the structure of a real map. The brushes are
+         * cubes that are laid out in a dense grid so that neighbouring brushes touch. Every tenth brush belongs to a
+         * func_detail entity, the world brushes are grouped in groups of 100, the brushes cycle through 64 texture names,
+         * and there is a linked pair of point entities for every 50 brushes.
+         *
+         * The result is deterministic, so maps of the same size are identical across runs.
+         */
+        std::unique_ptr<Model::WorldNode> makeWorld(size_t brushCount, Model::MapFormat mapFormat);
+
+        /**
+         * Generates a map that contains the given number of cube brushes laid out in the same grid as in makeWorld, but
+         * all brushes are added directly to the default layer and there are no entities or groups. The brushes share a
+         * single texture name.
+         */
+        std::unique_ptr<Model::WorldNode> makeBrushWorld(size_t brushCount, Model::MapFormat mapFormat);
+
+        /**
+         * Serializes the given world to a string in its map format.
+         */
+        std::string writeMap(const Model::WorldNode& world);
+
+        /**
+         * Returns the bounds of the grid cell at the given index.
+         */
+        vm::bbox3 cellBounds(size_t index, size_t brushCount);
+    }
+}
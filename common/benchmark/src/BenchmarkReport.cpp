@@ -0,0 +1,228 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkReport.h"
+
+#include "EL/EvaluationContext.h"
+#include "EL/Expression.h"
+#include "EL/Value.h"
+#include "IO/ELParser.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    static std::optional<std::string> getEnvironmentVariable(const char* name) {
+        const char* value = std::getenv(name);
+        if (value == nullptr || *value == '\0') {
+            return std::nullopt;
+        }
+        return std::string(value);
+    }
+
+    BenchmarkOptions BenchmarkOptions::fromEnvironment(const size_t warmupRuns, const size_t measuredRuns) {
+        if (const auto repetitions = getEnvironmentVariable("TB_BENCHMARK_REPETITIONS")) {
+            const auto value = std::atol(repetitions->c_str());
+            if (value > 0) {
+                return BenchmarkOptions{warmupRuns, static_cast<size_t>(value)};
+            }
+        }
+        return BenchmarkOptions{warmupRuns, measuredRuns};
+    }
+
+    /**
+     * Returns the sample at the given percentile using the nearest rank method. The samples must be sorted.
+     */
+    static double percentile(const std::vector<double>& sortedSamples, const double p) {
+        assert(!sortedSamples.empty());
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sortedSamples.size())));
+        return sortedSamples[std::clamp(rank, size_t(1), sortedSamples.size()) - 1u];
+    }
+
+    BenchmarkStatistics computeStatistics(std::string name, std::vector<double> samples) {
+        if (samples.empty()) {
+            return BenchmarkStatistics{std::move(name), 0u, 0.0, 0.0, 0.0, 0.0, 0.0};
+        }
+
+        std::sort(std::begin(samples), std::end(samples));
+
+        const size_t count = samples.size();
+        const double median = count % 2u == 1u
+            ? samples[count / 2u]
+            : (samples[count / 2u - 1u] + samples[count / 2u]) / 2.0;
+        const double mean = std::accumulate(std::begin(samples), std::end(samples), 0.0) / static_cast<double>(count);
+
+        return BenchmarkStatistics{
+            std::move(name),
+            count,
+            samples.front(),
+            median,
+            percentile(samples, 0.95),
+            samples.back(),
+            mean
+        };
+    }
+
+    double BenchmarkComparison::ratio() const {
+        return baselineMedian > 0.0 ? currentMedian / baselineMedian : 1.0;
+    }
+
+    BenchmarkReport& BenchmarkReport::instance() {
+        static BenchmarkReport instance;
+        return instance;
+    }
+
+    void BenchmarkReport::add(BenchmarkStatistics statistics) {
+        m_statistics.push_back(std::move(statistics));
+    }
+
+    const std::vector<BenchmarkStatistics>& BenchmarkReport::statistics() const {
+        return m_statistics;
+    }
+
+    static void writeJsonString(std::ostream& str, const std::string& string) {
+        str << '"';
+        for (const char c : string) {
+            if (c == '"' || c == '\\') {
+                str << '\\';
+            }
+            str << c;
+        }
+        str << '"';
+    }
+
+    void BenchmarkReport::writeJson(std::ostream& str) const {
+        str << std::fixed << std::setprecision(4);
+        str << "{\n  \"benchmarks\": [";
+        for (size_t i = 0u; i < m_statistics.size(); ++i) {
+            const auto& statistics = m_statistics[i];
+            str << (i > 0u ? ",\n" : "\n") << "    { \"name\": ";
+            writeJsonString(str, statistics.name);
+            str << ", \"repetitions\": " << statistics.repetitions
+                << ", \"min\": " << statistics.min
+                << ", \"median\": " << statistics.median
+                << ", \"p95\": " << statistics.p95
+                << ", \"max\": " << statistics.max
+                << ", \"mean\": " << statistics.mean
+                << " }";
+        }
+        str << "\n  ]\n}\n";
+    }
+
+    std::vector<BenchmarkStatistics> BenchmarkReport::readJson(const std::string& str) {
+        const EL::Value root = IO::ELParser::parseStrict(str).evaluate(EL::EvaluationContext());
+
+        std::vector<BenchmarkStatistics> result;
+        for (const EL::Value& entry : root["benchmarks"].arrayValue()) {
+            result.push_back(BenchmarkStatistics{
+                entry["name"].stringValue(),
+                static_cast<size_t>(entry["repetitions"].numberValue()),
+                entry["min"].numberValue(),
+                entry["median"].numberValue(),
+                entry["p95"].numberValue(),
+                entry["max"].numberValue(),
+                entry["mean"].numberValue()
+            });
+        }
+        return result;
+    }
+
+    std::vector<BenchmarkComparison> BenchmarkReport::compare(const std::vector<BenchmarkStatistics>& baseline) const {
+        std::unordered_map<std::string, const BenchmarkStatistics*> baselineByName;
+        for (const auto& statistics : baseline) {
+            baselineByName[statistics.name] = &statistics;
+        }
+
+        std::vector<BenchmarkComparison> result;
+        for (const auto& statistics : m_statistics) {
+            const auto it = baselineByName.find(statistics.name);
+            if (it != std::end(baselineByName)) {
+                result.push_back(BenchmarkComparison{statistics.name, it->second->median, statistics.median});
+            }
+        }
+        return result;
+    }
+
+    static void writeReport(const BenchmarkReport& report) {
+        if (const auto jsonPath = getEnvironmentVariable("TB_BENCHMARK_JSON")) {
+            std::ofstream stream(*jsonPath);
+            if (stream) {
+                report.writeJson(stream);
+                std::printf("Wrote benchmark results to '%s'\n", jsonPath->c_str());
+            } else {
+                std::printf("Could not write benchmark results to '%s'\n", jsonPath->c_str());
+            }
+        }
+
+        if (const auto baselinePath = getEnvironmentVariable("TB_BENCHMARK_BASELINE")) {
+            std::ifstream stream(*baselinePath);
+            if (!stream) {
+                std::printf("Could not read benchmark baseline from '%s'\n", baselinePath->c_str());
+                return;
+            }
+
+            std::stringstream buffer;
+            buffer << stream.rdbuf();
+
+            const auto tolerance = getEnvironmentVariable("TB_BENCHMARK_TOLERANCE");
+            const double maxRatio = 1.0 + (tolerance ? std::atof(tolerance->c_str()) : 0.1);
+
+            size_t regressions = 0u;
+            std::printf("\nComparison against baseline '%s':\n", baselinePath->c_str());
+            for (const auto& comparison : report.compare(BenchmarkReport::readJson(buffer.str()))) {
+                const bool regressed = comparison.ratio() > maxRatio;
+                if (regressed) {
+                    ++regressions;
+                }
+                std::printf("%s %-70s %10.3fms -> %10.3fms (%+.1f%%)\n",
+                    regressed ? "REGRESSION" : "          ",
+                    comparison.name.c_str(),
+                    comparison.baselineMedian,
+                    comparison.currentMedian,
+                    (comparison.ratio() - 1.0) * 100.0);
+            }
+            std::printf("%zu regression(s) found\n", regressions);
+        }
+    }
+
+    class BenchmarkReportListener : public Catch::TestEventListenerBase {
+    public:
+        using TestEventListenerBase::TestEventListenerBase;
+
+        void testRunEnded(const Catch::TestRunStats& testRunStats) override {
+            writeReport(BenchmarkReport::instance());
+            TestEventListenerBase::testRunEnded(testRunStats);
+        }
+    };
+
+    CATCH_REGISTER_LISTENER(BenchmarkReportListener)
+}
@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    struct BenchmarkOptions {
+        /** The number of runs that are executed before measuring starts. */
+        size_t warmupRuns;
+        /** The number of runs that are measured. */
+        size_t measuredRuns;
+
+        /**
+         * Returns the given options unless the environment variable TB_BENCHMARK_REPETITIONS is set to a positive
+         * number, in which case the number of measured runs is replaced by that number.
+         */
+        static BenchmarkOptions fromEnvironment(size_t warmupRuns, size_t measuredRuns);
+    };
+
+    /**
+     * Statistics over the measured runs of a benchmark. All times are in milliseconds.
+     */
+    struct BenchmarkStatistics {
+        std::string name;
+        size_t repetitions;
+        double min;
+        double median;
+        double p95;
+        double max;
+        double mean;
+    };
+
+    BenchmarkStatistics computeStatistics(std::string name, std::vector<double> samples);
+
+    struct BenchmarkComparison {
+        std::string name;
+        double baselineMedian;
+        double currentMedian;
+
+        /** Returns the current median divided by the baseline median. */
+        double ratio() const;
+    };
+
+    /**
+     * Collects the statistics of all benchmarks executed in this run.
+     *
+     * When the test run ends, the collected statistics are written as JSON to the file named by the environment
+     * variable TB_BENCHMARK_JSON, if it is set. If TB_BENCHMARK_BASELINE names a JSON file written by an earlier run,
+     * the medians of this run are compared against it and every benchmark that is slower by more than the relative
+     * tolerance given by TB_BENCHMARK_TOLERANCE (default 0.1) is reported as a regression.
+     */
+    class BenchmarkReport {
+    private:
+        std::vector<BenchmarkStatistics> m_statistics;
+    public:
+        static BenchmarkReport& instance();
+
+        void add(BenchmarkStatistics statistics);
+        const std::vector<BenchmarkStatistics>& statistics() const;
+
+        void writeJson(std::ostream& str) const;
+        static std::vector<BenchmarkStatistics> readJson(const std::string& str);
+
+        std::vector<BenchmarkComparison> compare(const std::vector<BenchmarkStatistics>& baseline) const;
+    };
+}
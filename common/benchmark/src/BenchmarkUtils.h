@@ -19,8 +19,13 @@
 
 #pragma once
 
+#include "BenchmarkReport.h"
+
 #include <chrono>
+#include <cstdio>
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef __GNUC__
 #define TB_NOINLINE __attribute__((noinline))
@@ -39,4 +44,45 @@ TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message) {
            std::chrono::duration<double>(end - start).count() * 1000.0);
 }
 
+/**
+ * Computes statistics over the given samples, which are times in milliseconds, prints them and records them in the
+ * benchmark report. Use this for times that are measured by the benchmarked code itself.
+ */
+inline TrenchBroom::BenchmarkStatistics reportBenchmark(const std::string& name, std::vector<double> samples) {
+    auto statistics = TrenchBroom::computeStatistics(name, std::move(samples));
+    printf("%s: median %fms, p95 %fms, min %fms, max %fms (%zu runs)\n",
+           statistics.name.c_str(), statistics.median, statistics.p95, statistics.min, statistics.max, statistics.repetitions);
+
+    TrenchBroom::BenchmarkReport::instance().add(statistics);
+    return statistics;
+}
+
+/**
+ * Runs the given benchmark `options.warmupRuns + options.measuredRuns` times and records statistics over the measured
+ * runs in the benchmark report. `setup` is invoked before every run and is not measured; use it to restore the state
+ * that `run` modifies.
+ */
+template<class S, class L>
+TB_NOINLINE static TrenchBroom::BenchmarkStatistics runBenchmark(const std::string& name, const TrenchBroom::BenchmarkOptions& options, S&& setup, L&& run) {
+    for (size_t i = 0; i < options.warmupRuns; ++i) {
+        setup();
+        run();
+    }
 
+    std::vector<double> samples;
+    samples.reserve(options.measuredRuns);
+    for (size_t i = 0; i < options.measuredRuns; ++i) {
+        setup();
+        const auto start = std::chrono::high_resolution_clock::now();
+        run();
+        const auto end = std::chrono::high_resolution_clock::now();
+        samples.push_back(std::chrono::duration<double>(end - start).count() * 1000.0);
+    }
+
+    return reportBenchmark(name, std::move(samples));
+}
+
+template<class L>
+static TrenchBroom::BenchmarkStatistics runBenchmark(const std::string& name, const TrenchBroom::BenchmarkOptions& options, L&& run) {
+    return runBenchmark(name, options, [](){}, std::forward<L>(run));
+}
@@ -0,0 +1,292 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/NodeReader.h"
+#include "IO/NodeWriter.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/PickResult.h"
+#include "Model/TestGame.h"
+#include "Model/WorldNode.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/PasteType.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static std::string benchmarkName(const std::string& operation, const size_t brushCount) {
+            return "EndToEnd." + operation + " (" + std::to_string(brushCount) + " brushes)";
+        }
+
+        static std::shared_ptr<MapDocument> loadBenchmarkDocument(std::unique_ptr<Model::WorldNode> world) {
+            auto game = std::make_shared<Model::TestGame>();
+            const auto mapFormat = world->mapFormat();
+            game->setWorldNodeToLoad(std::move(world));
+
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->loadDocument(mapFormat, BenchmarkMaps::worldBounds(), game, IO::Path("benchmark.map"));
+            return document;
+        }
+
+        static std::vector<Model::Node*> collectEntityBrushes(Model::WorldNode& world, const size_t maxCount) {
+            std::vector<Model::Node*> result;
+            for (auto* brushNode : Model::filterBrushNodes(Model::collectDescendants({&world}))) {
+                if (result.size() == maxCount) {
+                    break;
+                }
+                if (dynamic_cast<Model::EntityNode*>(brushNode->parent()) != nullptr) {
+                    result.push_back(brushNode);
+                }
+            }
+            return result;
+        }
+
+        static void benchmarkLoadAndSave(const size_t brushCount, const BenchmarkOptions& options) {
+            const auto world = BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard);
+            const std::string mapText = BenchmarkMaps::writeMap(*world);
+
+            runBenchmark(benchmarkName("load", brushCount), options, [&]() {
+                IO::TestParserStatus status;
+                IO::WorldReader reader(mapText, Model::MapFormat::Standard);
+                const auto loadedWorld = reader.read(BenchmarkMaps::worldBounds(), status);
+                CHECK(loadedWorld != nullptr);
+            });
+
+            runBenchmark(benchmarkName("save", brushCount), options, [&]() {
+                const std::string savedText = BenchmarkMaps::writeMap(*world);
+                CHECK(savedText.size() == mapText.size());
+            });
+        }
+
+        static void benchmarkCopyPaste(const size_t brushCount, const BenchmarkOptions& options) {
+            auto document = loadBenchmarkDocument(BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+            document->selectAllNodes();
+
+            std::string clipboard;
+            runBenchmark(benchmarkName("copy", brushCount), options, [&]() {
+                clipboard = document->serializeSelectedNodes();
+            });
+
+            runBenchmark(benchmarkName("parse clipboard", brushCount), options, [&]() {
+                IO::TestParserStatus status;
+                auto nodes = IO::NodeReader::read(clipboard, Model::MapFormat::Standard, BenchmarkMaps::worldBounds(), status);
+                CHECK(!nodes.empty());
+                kdl::vec_clear_and_delete(nodes);
+            });
+
+            bool pasted = false;
+            runBenchmark(benchmarkName("paste", brushCount), options, [&]() {
+                if (pasted) {
+                    document->undoCommand();
+                }
+                document->deselectAll();
+            }, [&]() {
+                CHECK(document->paste(clipboard) == PasteType::Node);
+                pasted = true;
+            });
+
+            if (pasted) {
+                document->undoCommand();
+            }
+            document->selectAllNodes();
+
+            std::string binaryClipboard;
+            runBenchmark(benchmarkName("copy binary", brushCount), options, [&]() {
+                binaryClipboard = document->serializeSelectedNodesBinary();
+            });
+
+            bool pastedBinary = false;
+            runBenchmark(benchmarkName("paste binary", brushCount), options, [&]() {
+                if (pastedBinary) {
+                    document->undoCommand();
+                }
+                document->deselectAll();
+            }, [&]() {
+                CHECK(document->pasteBinary(binaryClipboard) == PasteType::Node);
+                pastedBinary = true;
+            });
+        }
+
+        static void benchmarkTransformAndUndo(const size_t brushCount, const BenchmarkOptions& options) {
+            auto document = loadBenchmarkDocument(BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+            document->selectAllNodes();
+
+            bool translated = false;
+            runBenchmark(benchmarkName("translate", brushCount), options, [&]() {
+                if (translated) {
+                    document->undoCommand();
+                }
+            }, [&]() {
+                CHECK(document->translateObjects(vm::vec3(16.0, 0.0, 0.0)));
+                translated = true;
+            });
+
+            // the translation is applied at this point
+            bool undone = false;
+            runBenchmark(benchmarkName("undo translate", brushCount), options, [&]() {
+                if (undone) {
+                    document->redoCommand();
+                }
+            }, [&]() {
+                document->undoCommand();
+                undone = true;
+            });
+
+            runBenchmark(benchmarkName("redo translate", brushCount), options, [&]() {
+                if (!undone) {
+                    document->undoCommand();
+                }
+            }, [&]() {
+                document->redoCommand();
+                undone = false;
+            });
+        }
+
+        static void benchmarkSelectTouching(const size_t brushCount, const BenchmarkOptions& options) {
+            auto document = loadBenchmarkDocument(BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+
+            // select about one percent of the brushes as the query
+            const auto queryBrushes = collectEntityBrushes(*document->world(), std::max(brushCount / 100u, size_t(1)));
+
+            runBenchmark(benchmarkName("select touching", brushCount), options, [&]() {
+                document->deselectAll();
+                document->select(queryBrushes);
+            }, [&]() {
+                document->selectTouching(false);
+            });
+        }
+
+        static void benchmarkPick(const size_t brushCount, const BenchmarkOptions& options) {
+            constexpr size_t RayCount = 1000;
+
+            auto document = loadBenchmarkDocument(BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+
+            // shoot rays from outside the grid at the centers of random cells
+            std::vector<vm::ray3> rays;
+            for (size_t i = 0; i < RayCount; ++i) {
+                const auto target = BenchmarkMaps::cellBounds((i * 7919u) % brushCount, brushCount).center();
+                const auto origin = vm::vec3(-4000.0, -4000.0, 4000.0);
+                rays.emplace_back(origin, vm::normalize(target - origin));
+            }
+
+            runBenchmark(benchmarkName("pick " + std::to_string(RayCount) + " rays", brushCount), options, [&]() {
+                size_t hits = 0;
+                for (const auto& ray : rays) {
+                    auto pickResult = Model::PickResult::byDistance();
+                    document->pick(ray, pickResult);
+                    hits += pickResult.size();
+                }
+                CHECK(hits > 0u);
+            });
+        }
+
+        static void benchmarkCsg(const size_t brushCount, const BenchmarkOptions& options) {
+            // CSG operates on loose world brushes, so we build a separate map that contains only those
+            auto world = std::make_unique<Model::WorldNode>(Model::Entity(), Model::MapFormat::Standard);
+            const Model::BrushBuilder builder(Model::MapFormat::Standard, BenchmarkMaps::worldBounds());
+
+            std::vector<Model::Node*> brushNodes;
+            for (size_t i = 0; i < brushCount; ++i) {
+                auto* brushNode = new Model::BrushNode(builder.createCuboid(BenchmarkMaps::cellBounds(i, brushCount), "texture").value());
+                world->defaultLayer()->addChild(brushNode);
+                brushNodes.push_back(brushNode);
+            }
+
+            // the subtrahend cuts through the center of the grid
+            auto* subtrahendNode = new Model::BrushNode(builder.createCuboid(vm::bbox3(vm::vec3(-100.0, -100.0, -4000.0), vm::vec3(100.0, 100.0, 4000.0)), "texture").value());
+            world->defaultLayer()->addChild(subtrahendNode);
+
+            auto document = loadBenchmarkDocument(std::move(world));
+
+            bool subtracted = false;
+            runBenchmark(benchmarkName("csg subtract", brushCount), options, [&]() {
+                if (subtracted) {
+                    document->undoCommand();
+                }
+                document->deselectAll();
+                document->select(subtrahendNode);
+            }, [&]() {
+                CHECK(document->csgSubtract());
+                subtracted = true;
+            });
+
+            if (subtracted) {
+                document->undoCommand();
+            }
+
+            // merging is quadratic in the number of vertices, so only merge a bounded number of brushes
+            const auto mergeNodes = kdl::vec_slice_prefix(brushNodes, std::min(brushNodes.size(), size_t(1000)));
+            bool merged = false;
+            runBenchmark(benchmarkName("csg convex merge " + std::to_string(mergeNodes.size()) + " brushes", brushCount), options, [&]() {
+                if (merged) {
+                    document->undoCommand();
+                }
+                document->deselectAll();
+                document->select(mergeNodes);
+            }, [&]() {
+                CHECK(document->csgConvexMerge());
+                merged = true;
+            });
+        }
+
+        static void benchmarkEndToEnd(const size_t brushCount, const BenchmarkOptions& options) {
+            benchmarkLoadAndSave(brushCount, options);
+            benchmarkCopyPaste(brushCount, options);
+            benchmarkTransformAndUndo(brushCount, options);
+            benchmarkSelectTouching(brushCount, options);
+            benchmarkPick(brushCount, options);
+            benchmarkCsg(brushCount, options);
+        }
+
+        TEST_CASE("EndToEndBenchmark.smallMap", "[EndToEndBenchmark]") {
+            benchmarkEndToEnd(BenchmarkMaps::SmallMap, BenchmarkOptions::fromEnvironment(2, 10));
+        }
+
+        TEST_CASE("EndToEndBenchmark.mediumMap", "[EndToEndBenchmark]") {
+            benchmarkEndToEnd(BenchmarkMaps::MediumMap, BenchmarkOptions::fromEnvironment(1, 5));
+        }
+
+        // hidden by default because it takes several minutes, run with "[EndToEndBenchmark][large]"
+        TEST_CASE("EndToEndBenchmark.largeMap", "[.][EndToEndBenchmark][large]") {
+            benchmarkEndToEnd(BenchmarkMaps::LargeMap, BenchmarkOptions::fromEnvironment(1, 3));
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+
+#include <kdl/vector_utils.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        /** The number of files that are included by the generated main definition file. */
+        static constexpr size_t IncludedFileCount = 4;
+        /** The number of entity definitions in every included file. */
+        static constexpr size_t DefinitionsPerFile = 200;
+
+        static std::string makeIncludedFile(const size_t fileIndex) {
+            std::stringstream str;
+            for (size_t i = 0; i < DefinitionsPerFile; ++i) {
+                const auto index = fileIndex * DefinitionsPerFile + i;
+                str << "@PointClass base(Targetable) size(-16 -16 -24, 16 16 32) color(" << (index % 256) << " 128 64) "
+                    << "model({ \"path\": \"progs/entity_" << index << ".mdl\", \"skin\": spawnflags & 1 }) = benchmark_entity_" << index << " : \"Benchmark entity " << index << "\"\n"
+                    << "[\n"
+                    << "    angle(integer) : \"Angle\" : 0\n"
+                    << "    health(integer) : \"Health\" : 100\n"
+                    << "    speed(float) : \"Speed\" : \"1.5\"\n"
+                    << "    message(string) : \"Message\"\n"
+                    << "    style(choices) : \"Style\" : 0 =\n"
+                    << "    [\n"
+                    << "        0 : \"Normal\"\n"
+                    << "        1 : \"Flicker\"\n"
+                    << "    ]\n"
+                    << "    spawnflags(flags) =\n"
+                    << "    [\n"
+                    << "        1 : \"Easy\" : 0\n"
+                    << "        2 : \"Medium\" : 0\n"
+                    << "        4 : \"Hard\" : 0\n"
+                    << "    ]\n"
+                    << "]\n";
+            }
+            return str.str();
+        }
+
+        static std::string makeMainFile() {
+            std::stringstream str;
+            str << "@BaseClass = Targetable [ targetname(target_source) : \"Name\" target(target_destination) : \"Target\" ]\n";
+            str << "@SolidClass = worldspawn : \"World entity\" [ message(string) : \"Text on entering the world\" ]\n";
+            for (size_t i = 0; i < IncludedFileCount; ++i) {
+                str << "@include \"part_" << i << ".fgd\"\n";
+            }
+            return str.str();
+        }
+
+        class DefinitionTestEnvironment : public TestEnvironment {
+        public:
+            DefinitionTestEnvironment() :
+            TestEnvironment("EntityDefinitionCacheBenchmark") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                createFile(Path("main.fgd"), makeMainFile());
+                for (size_t i = 0; i < IncludedFileCount; ++i) {
+                    createFile(Path("part_" + std::to_string(i) + ".fgd"), makeIncludedFile(i));
+                }
+            }
+        };
+
+        static std::vector<Assets::EntityDefinition*> parseDefinitions(const Path& path, const Color& defaultColor, std::vector<Path>& includedPaths) {
+            auto file = Disk::openFile(path);
+            auto reader = file->reader().buffer();
+
+            TestParserStatus status;
+            FgdParser parser(reader.stringView(), defaultColor, file->path());
+            auto result = parser.parseDefinitions(status);
+            includedPaths = parser.includedPaths();
+            return result;
+        }
+
+        TEST_CASE("EntityDefinitionCacheBenchmark.coldAndWarmLoad", "[EntityDefinitionCacheBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(1, 10);
+            const auto defaultColor = Color(0.6f, 0.6f, 0.6f, 1.0f);
+            const auto expectedCount = IncludedFileCount * DefinitionsPerFile + 1u;
+
+            DefinitionTestEnvironment env;
+            const auto mainPath = env.dir() + Path("main.fgd");
+            const auto cache = EntityDefinitionCache(env.dir() + Path("cache"));
+
+            std::vector<Path> includedPaths;
+            std::vector<Assets::EntityDefinition*> definitions;
+
+            runBenchmark("EntityDefinitionCache.parse (" + std::to_string(expectedCount) + " definitions)", options, [&]() {
+                kdl::vec_clear_and_delete(definitions);
+            }, [&]() {
+                definitions = parseDefinitions(mainPath, defaultColor, includedPaths);
+            });
+            CHECK(definitions.size() == expectedCount);
+
+            runBenchmark("EntityDefinitionCache.store (" + std::to_string(expectedCount) + " definitions)", options, []() {}, [&]() {
+                cache.store(mainPath, includedPaths, defaultColor, definitions);
+            });
+
+            std::vector<Assets::EntityDefinition*> cached;
+            runBenchmark("EntityDefinitionCache.load (" + std::to_string(expectedCount) + " definitions)", options, [&]() {
+                kdl::vec_clear_and_delete(cached);
+            }, [&]() {
+                cached = cache.load(mainPath, defaultColor).value_or(std::vector<Assets::EntityDefinition*>());
+            });
+            CHECK(cached.size() == expectedCount);
+
+            kdl::vec_clear_and_delete(cached);
+            kdl::vec_clear_and_delete(definitions);
+        }
+    }
+}
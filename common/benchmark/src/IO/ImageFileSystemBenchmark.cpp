@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/File.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/Path.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        /** The number of entries in the synthetic archive, which is about the size of a large pk3 file. */
+        static constexpr size_t EntryCount = 40'000;
+        static constexpr size_t EntriesPerDirectory = 100;
+        static constexpr size_t LookupCount = 10'000;
+
+        static Path entryPath(const size_t index) {
+            const auto category = index % 2u == 0u ? "Textures" : "Models";
+            return Path(std::string(category) + "/Set_" + std::to_string(index / EntriesPerDirectory) + "/Entry_" + std::to_string(index) + ".tga");
+        }
+
+        /**
+         * An image file system with a generated directory of files that all share the same contents.
+         */
+        class SyntheticImageFileSystem : public ImageFileSystemBase {
+        private:
+            char m_data[4];
+        public:
+            SyntheticImageFileSystem() :
+            ImageFileSystemBase(nullptr, Path("/synthetic.pk3")),
+            m_data{'d', 'a', 't', 'a'} {
+                initialize();
+            }
+        private:
+            void doReadDirectory() override {
+                for (size_t i = 0; i < EntryCount; ++i) {
+                    const auto path = entryPath(i);
+                    addFile(path, std::make_shared<NonOwningBufferFile>(path, std::begin(m_data), std::end(m_data)));
+                }
+            }
+        };
+
+        TEST_CASE("ImageFileSystemBenchmark.lookup", "[ImageFileSystemBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(2, 20);
+
+            auto fs = std::make_unique<SyntheticImageFileSystem>();
+
+            // look up entries spread over the archive, half of them with a different case than they were added with
+            std::vector<Path> lookups;
+            lookups.reserve(LookupCount);
+            for (size_t i = 0; i < LookupCount; ++i) {
+                const auto path = entryPath((i * 7919u) % EntryCount);
+                lookups.push_back(i % 2u == 0u ? path : path.makeLowerCase());
+            }
+
+            runBenchmark("ImageFileSystem.reload (" + std::to_string(EntryCount) + " entries)", options, []() {}, [&]() {
+                fs->reload();
+            });
+
+            runBenchmark("ImageFileSystem.fileExists (" + std::to_string(LookupCount) + " lookups)", options, []() {}, [&]() {
+                size_t found = 0;
+                for (const auto& path : lookups) {
+                    if (fs->fileExists(path)) {
+                        ++found;
+                    }
+                }
+                CHECK(found == LookupCount);
+            });
+
+            runBenchmark("ImageFileSystem.openFile (" + std::to_string(LookupCount) + " lookups)", options, []() {}, [&]() {
+                size_t size = 0;
+                for (const auto& path : lookups) {
+                    size += fs->openFile(path)->size();
+                }
+                CHECK(size == LookupCount * 4u);
+            });
+
+            runBenchmark("ImageFileSystem.directoryExists (" + std::to_string(LookupCount) + " lookups)", options, []() {}, [&]() {
+                size_t found = 0;
+                for (const auto& path : lookups) {
+                    if (fs->directoryExists(path.deleteLastComponent())) {
+                        ++found;
+                    }
+                }
+                CHECK(found == LookupCount);
+            });
+        }
+    }
+}
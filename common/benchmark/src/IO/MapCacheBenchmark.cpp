@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "IO/MapCache.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <memory>
+#include <string>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static void benchmarkColdAndWarmLoad(const size_t brushCount, const BenchmarkOptions& options) {
+            const auto mapText = BenchmarkMaps::writeMap(*BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+            const auto worldBounds = BenchmarkMaps::worldBounds();
+
+            TestEnvironment env("MapCacheBenchmark");
+            const auto mapPath = env.dir() + Path("benchmark.map");
+            const auto cache = MapCache(env.dir() + Path("cache"), "benchmark");
+            auto logger = NullLogger{};
+
+            const auto suffix = " (" + std::to_string(brushCount) + " brushes)";
+
+            std::unique_ptr<Model::WorldNode> worldNode;
+            runBenchmark("MapCache.cold load" + suffix, options, [&]() {
+                worldNode.reset();
+            }, [&]() {
+                TestParserStatus status;
+                worldNode = WorldReader(mapText, Model::MapFormat::Standard).read(worldBounds, status);
+            });
+            REQUIRE(worldNode != nullptr);
+
+            runBenchmark("MapCache.store" + suffix, options, []() {}, [&]() {
+                cache.store(mapPath, mapText, *worldNode, worldBounds, {});
+            });
+
+            std::unique_ptr<Model::WorldNode> cachedWorldNode;
+            runBenchmark("MapCache.warm load" + suffix, options, [&]() {
+                cachedWorldNode.reset();
+            }, [&]() {
+                cachedWorldNode = cache.load(mapPath, mapText, {Model::MapFormat::Standard}, worldBounds, logger);
+            });
+            CHECK(cachedWorldNode != nullptr);
+        }
+
+        TEST_CASE("MapCacheBenchmark.smallMap", "[MapCacheBenchmark]") {
+            benchmarkColdAndWarmLoad(BenchmarkMaps::SmallMap, BenchmarkOptions::fromEnvironment(1, 10));
+        }
+
+        TEST_CASE("MapCacheBenchmark.mediumMap", "[MapCacheBenchmark]") {
+            benchmarkColdAndWarmLoad(BenchmarkMaps::MediumMap, BenchmarkOptions::fromEnvironment(1, 5));
+        }
+
+        // hidden by default because it takes several minutes, run with "[MapCacheBenchmark][large]"
+        TEST_CASE("MapCacheBenchmark.largeMap", "[.][MapCacheBenchmark][large]") {
+            benchmarkColdAndWarmLoad(BenchmarkMaps::LargeMap, BenchmarkOptions::fromEnvironment(1, 3));
+        }
+    }
+}
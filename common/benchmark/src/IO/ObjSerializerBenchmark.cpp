@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static void benchmarkObjExport(const size_t brushCount, const BenchmarkOptions& options) {
+            const auto world = BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard);
+
+            runBenchmark("ObjSerializer.export (" + std::to_string(brushCount) + " brushes)", options, [&]() {
+                auto objStream = std::ostringstream{};
+                auto mtlStream = std::ostringstream{};
+
+                auto writer = NodeWriter{*world, std::make_unique<ObjSerializer>(objStream, mtlStream, "benchmark.mtl")};
+                writer.writeMap();
+
+                CHECK(!objStream.str().empty());
+            });
+        }
+
+        TEST_CASE("ObjSerializerBenchmark.smallMap", "[ObjSerializerBenchmark]") {
+            benchmarkObjExport(BenchmarkMaps::SmallMap, BenchmarkOptions::fromEnvironment(2, 10));
+        }
+
+        TEST_CASE("ObjSerializerBenchmark.mediumMap", "[ObjSerializerBenchmark]") {
+            benchmarkObjExport(BenchmarkMaps::MediumMap, BenchmarkOptions::fromEnvironment(1, 5));
+        }
+
+        // hidden by default because it takes a long time, run with "[ObjSerializerBenchmark][large]"
+        TEST_CASE("ObjSerializerBenchmark.largeMap", "[.][ObjSerializerBenchmark][large]") {
+            benchmarkObjExport(BenchmarkMaps::LargeMap, BenchmarkOptions::fromEnvironment(1, 3));
+        }
+    }
+}
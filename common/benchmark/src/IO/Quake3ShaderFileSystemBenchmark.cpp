@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Logger.h"
+#include "IO/File.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/Path.h"
+#include "IO/Quake3ShaderFileSystem.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t ShaderScriptCount = 64;
+        static constexpr size_t ShadersPerScript = 100;
+        /** Every other shader has a texture with the same name, and there are as many textures without a shader. */
+        static constexpr size_t ShaderTextureCount = ShaderScriptCount * ShadersPerScript;
+
+        static std::string shaderName(const size_t index) {
+            return "textures/set_" + std::to_string(index / ShadersPerScript) + "/shader_" + std::to_string(index);
+        }
+
+        static std::string makeShaderScript(const size_t fileIndex) {
+            std::stringstream str;
+            for (size_t i = 0; i < ShadersPerScript; ++i) {
+                const auto name = shaderName(fileIndex * ShadersPerScript + i);
+                str << name << "\n"
+                    << "{\n"
+                    << "    qer_editorimage " << name << ".tga\n"
+                    << "    surfaceparm nonsolid\n"
+                    << "    surfaceparm trans\n"
+                    << "    cull none\n"
+                    << "    {\n"
+                    << "        map " << name << ".tga\n"
+                    << "        blendFunc GL_ONE GL_ONE\n"
+                    << "        tcMod scroll 0.1 0\n"
+                    << "    }\n"
+                    << "    {\n"
+                    << "        map $lightmap\n"
+                    << "        blendFunc GL_DST_COLOR GL_ZERO\n"
+                    << "    }\n"
+                    << "}\n";
+            }
+            return str.str();
+        }
+
+        /**
+         * An in memory file system with shader scripts and textures, so that the benchmark does not measure disk access.
+         */
+        class ShaderTestFileSystem : public ImageFileSystemBase {
+        private:
+            std::vector<std::string> m_shaderScripts;
+        public:
+            ShaderTestFileSystem() :
+            ImageFileSystemBase(nullptr, Path()) {
+                for (size_t i = 0; i < ShaderScriptCount; ++i) {
+                    m_shaderScripts.push_back(makeShaderScript(i));
+                }
+                initialize();
+            }
+        private:
+            void doReadDirectory() override {
+                for (size_t i = 0; i < m_shaderScripts.size(); ++i) {
+                    const auto path = Path("scripts/set_" + std::to_string(i) + ".shader");
+                    const auto& contents = m_shaderScripts[i];
+                    addFile(path, std::make_shared<NonOwningBufferFile>(path, contents.data(), contents.data() + contents.size()));
+                }
+
+                for (size_t i = 0; i < ShaderTextureCount; ++i) {
+                    // textures with odd indices have no shader
+                    const auto name = i % 2u == 0u ? shaderName(i) : "textures/set_" + std::to_string(i / ShadersPerScript) + "/texture_" + std::to_string(i);
+                    const auto path = Path(name + ".tga");
+                    addFile(path, std::make_shared<NonOwningBufferFile>(path, nullptr, nullptr));
+                }
+            }
+        };
+
+        TEST_CASE("Quake3ShaderFileSystemBenchmark.loadAndLink", "[Quake3ShaderFileSystemBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(1, 10);
+            const auto fs = std::make_shared<ShaderTestFileSystem>();
+
+            NullLogger logger;
+            runBenchmark("Quake3ShaderFileSystem.load and link (" + std::to_string(ShaderScriptCount * ShadersPerScript) + " shaders, " + std::to_string(ShaderTextureCount) + " textures)", options, []() {}, [&]() {
+                const Quake3ShaderFileSystem shaderFs(fs, Path("scripts"), {Path("textures")}, logger);
+                CHECK(shaderFs.fileExists(Path(shaderName(0))));
+                CHECK(shaderFs.fileExists(Path(shaderName(1))));
+            });
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Logger.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "IO/File.h"
+#include "IO/FreeImageTextureReader.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/Path.h"
+#include "IO/TextureCollectionLoader.h"
+#include "IO/TextureReader.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t TgaTextureCount = 64;
+        static constexpr size_t TgaTextureSize = 512;
+
+        /**
+         * Returns an uncompressed 24 bit TGA image with a pattern that differs for every index. The image has no alpha
+         * channel so that it is loaded as an opaque texture and gets a full mip chain.
+         */
+        static std::vector<char> makeTgaImage(const size_t index) {
+            std::vector<char> result(18 + 3 * TgaTextureSize * TgaTextureSize);
+            result[2] = 2; // uncompressed true color
+            result[12] = static_cast<char>(TgaTextureSize & 0xFF);
+            result[13] = static_cast<char>(TgaTextureSize >> 8);
+            result[14] = static_cast<char>(TgaTextureSize & 0xFF);
+            result[15] = static_cast<char>(TgaTextureSize >> 8);
+            result[16] = 24;
+            result[17] = 0x20; // top left origin
+
+            auto* pixels = result.data() + 18;
+            for (size_t y = 0; y < TgaTextureSize; ++y) {
+                for (size_t x = 0; x < TgaTextureSize; ++x) {
+                    auto* pixel = pixels + 3 * (y * TgaTextureSize + x);
+                    pixel[0] = static_cast<char>((x + index) & 0xFF);
+                    pixel[1] = static_cast<char>((y * 3) & 0xFF);
+                    pixel[2] = static_cast<char>((x ^ y) & 0xFF);
+                }
+            }
+            return result;
+        }
+
+        /**
+         * An in memory file system with generated TGA images, so that the benchmark does not measure disk access.
+         */
+        class TgaTestFileSystem : public ImageFileSystemBase {
+        private:
+            std::vector<std::vector<char>> m_images;
+        public:
+            TgaTestFileSystem() :
+            ImageFileSystemBase(nullptr, Path()) {
+                for (size_t i = 0; i < TgaTextureCount; ++i) {
+                    m_images.push_back(makeTgaImage(i));
+                }
+                initialize();
+            }
+        private:
+            void doReadDirectory() override {
+                for (size_t i = 0; i < m_images.size(); ++i) {
+                    const auto path = Path("textures/texture_" + std::to_string(i) + ".tga");
+                    const auto& contents = m_images[i];
+                    addFile(path, std::make_shared<NonOwningBufferFile>(path, contents.data(), contents.data() + contents.size()));
+                }
+            }
+        };
+
+        TEST_CASE("TextureCollectionLoaderBenchmark.loadTgaTextures", "[TextureCollectionLoaderBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(1, 10);
+            const auto fs = std::make_shared<TgaTestFileSystem>();
+            const auto suffix = " (" + std::to_string(TgaTextureCount) + " textures, " + std::to_string(TgaTextureSize) + "x" + std::to_string(TgaTextureSize) + ")";
+
+            NullLogger logger;
+            const FreeImageTextureReader textureReader(TextureReader::PathSuffixNameStrategy(1), *fs, logger);
+            DirectoryTextureCollectionLoader directoryLoader(logger, *fs, {});
+            TextureCollectionLoader& loader = directoryLoader;
+
+            runBenchmark("TextureCollectionLoader.decode and generate mipmaps" + suffix, options, [&]() {
+                const auto collection = loader.loadTextureCollection(Path("textures"), {"tga"}, textureReader);
+                REQUIRE(collection.textureCount() == TgaTextureCount);
+                CHECK(collection.textures().front().buffersIfUnprepared().size() == Assets::fullMipLevelCount(TgaTextureSize, TgaTextureSize));
+            });
+
+            // measure the mip generation alone on the calling thread
+            std::vector<Assets::TextureBufferList> levels;
+            for (size_t i = 0; i < TgaTextureCount; ++i) {
+                Assets::TextureBufferList buffers;
+                Assets::setMipBufferSize(buffers, 1, TgaTextureSize, TgaTextureSize, GL_RGBA);
+                std::fill(buffers[0].data(), buffers[0].data() + buffers[0].size(), static_cast<unsigned char>(i));
+                levels.push_back(std::move(buffers));
+            }
+
+            runBenchmark("TextureBuffer.generateMipmaps" + suffix, options, [&]() {
+                for (auto& buffers : levels) {
+                    Assets::generateMipmaps(buffers, Assets::fullMipLevelCount(TgaTextureSize, TgaTextureSize), TgaTextureSize, TgaTextureSize, GL_RGBA);
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Logger.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Quake3ShaderFileSystem.h"
+#include "IO/TestEnvironment.h"
+#include "IO/ZipFileSystem.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <miniz/miniz.h>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        /** The number of generated pk3 files. */
+        static constexpr size_t ArchiveCount = 8;
+        static constexpr size_t TexturesPerArchive = 4'000;
+        static constexpr size_t ShaderFilesPerArchive = 16;
+        static constexpr size_t ShadersPerFile = 64;
+
+        static std::string makeShaderFile(const size_t archiveIndex, const size_t fileIndex) {
+            std::stringstream str;
+            for (size_t i = 0; i < ShadersPerFile; ++i) {
+                const auto name = "textures/set_" + std::to_string(archiveIndex) + "/shader_" + std::to_string(fileIndex * ShadersPerFile + i);
+                str << name << "\n"
+                    << "{\n"
+                    << "    qer_editorimage " << name << ".tga\n"
+                    << "    surfaceparm nonsolid\n"
+                    << "    {\n"
+                    << "        map " << name << ".tga\n"
+                    << "        rgbGen identity\n"
+                    << "    }\n"
+                    << "    {\n"
+                    << "        map $lightmap\n"
+                    << "        blendFunc GL_DST_COLOR GL_ZERO\n"
+                    << "    }\n"
+                    << "}\n";
+            }
+            return str.str();
+        }
+
+        static void writeArchive(const Path& path, const size_t archiveIndex) {
+            mz_zip_archive archive;
+            mz_zip_zero_struct(&archive);
+            REQUIRE(mz_zip_writer_init_file(&archive, path.asString().c_str(), 0));
+
+            // small images that compress well, like the textures of a real pk3 file
+            const auto imageData = std::string(1024, static_cast<char>(archiveIndex));
+            for (size_t i = 0; i < TexturesPerArchive; ++i) {
+                const auto name = "textures/set_" + std::to_string(archiveIndex) + "/texture_" + std::to_string(i) + ".tga";
+                REQUIRE(mz_zip_writer_add_mem(&archive, name.c_str(), imageData.data(), imageData.size(), MZ_DEFAULT_COMPRESSION));
+            }
+
+            for (size_t i = 0; i < ShaderFilesPerArchive; ++i) {
+                const auto name = "scripts/set_" + std::to_string(archiveIndex) + "_" + std::to_string(i) + ".shader";
+                const auto contents = makeShaderFile(archiveIndex, i);
+                REQUIRE(mz_zip_writer_add_mem(&archive, name.c_str(), contents.data(), contents.size(), MZ_DEFAULT_COMPRESSION));
+            }
+
+            REQUIRE(mz_zip_writer_finalize_archive(&archive));
+            REQUIRE(mz_zip_writer_end(&archive));
+        }
+
+        class ArchiveTestEnvironment : public TestEnvironment {
+        public:
+            ArchiveTestEnvironment() :
+            TestEnvironment("ZipFileSystemBenchmark") {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                for (size_t i = 0; i < ArchiveCount; ++i) {
+                    writeArchive(dir() + Path("pak" + std::to_string(i) + ".pk3"), i);
+                }
+            }
+        };
+
+        static std::shared_ptr<FileSystem> makeFileSystem(const ArchiveTestEnvironment& env) {
+            std::shared_ptr<FileSystem> fs = std::make_shared<DiskFileSystem>(env.dir());
+            for (size_t i = 0; i < ArchiveCount; ++i) {
+                fs = std::make_shared<ZipFileSystem>(fs, env.dir() + Path("pak" + std::to_string(i) + ".pk3"));
+            }
+            return fs;
+        }
+
+        TEST_CASE("ZipFileSystemBenchmark.loadArchives", "[ZipFileSystemBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(1, 10);
+            const auto archives = std::to_string(ArchiveCount) + " archives";
+
+            ArchiveTestEnvironment env;
+
+            runBenchmark("ZipFileSystem.create (" + archives + ")", options, []() {}, [&]() {
+                const auto fs = makeFileSystem(env);
+                CHECK(fs != nullptr);
+            });
+
+            // the lookup of a file in the first archive of the chain has to read the directories of all archives
+            std::shared_ptr<FileSystem> fs;
+            runBenchmark("ZipFileSystem.create and find (" + archives + ")", options, [&]() {
+                fs = makeFileSystem(env);
+            }, [&]() {
+                CHECK(fs->fileExists(Path("textures/set_0/texture_0.tga")));
+            });
+
+            runBenchmark("ZipFileSystem.load shaders (" + archives + ")", options, [&]() {
+                fs = makeFileSystem(env);
+            }, [&]() {
+                NullLogger logger;
+                const auto shaderFs = std::make_shared<Quake3ShaderFileSystem>(fs, Path("scripts"), std::vector<Path>{}, logger);
+                CHECK(shaderFs->fileExists(Path("textures/set_0/shader_0")));
+            });
+
+            // open the shader files of one archive repeatedly, which are all kept in the decompressed file cache
+            fs = makeFileSystem(env);
+            runBenchmark("ZipFileSystem.open cached files (" + std::to_string(ShaderFilesPerArchive * 100u) + " files)", options, []() {}, [&]() {
+                size_t size = 0;
+                for (size_t i = 0; i < 100u; ++i) {
+                    for (size_t j = 0; j < ShaderFilesPerArchive; ++j) {
+                        size += fs->openFile(Path("scripts/set_0_" + std::to_string(j) + ".shader"))->size();
+                    }
+                }
+                CHECK(size > 0u);
+            });
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/TexCoordSystem.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 64'000;
+
+        static std::vector<Brush> makeBrushes(const MapFormat mapFormat) {
+            const vm::bbox3 worldBounds(8192.0);
+            const BrushBuilder builder(mapFormat, worldBounds);
+
+            std::vector<Brush> result;
+            result.reserve(NumBrushes);
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                result.push_back(builder.createCube(64.0, "texture").value());
+            }
+            return result;
+        }
+
+        static void benchmarkFaceCopies(const MapFormat mapFormat, const std::string& formatName) {
+            const auto brushes = makeBrushes(mapFormat);
+            const auto options = BenchmarkOptions::fromEnvironment(2, 10);
+
+            std::vector<BrushFace> faces;
+            faces.reserve(brushes.size() * 6u);
+            runBenchmark("BrushFace.copy " + std::to_string(NumBrushes * 6u) + " " + formatName + " faces", options, [&]() {
+                faces.clear();
+            }, [&]() {
+                for (const auto& brush : brushes) {
+                    for (const auto& face : brush.faces()) {
+                        faces.push_back(face);
+                    }
+                }
+            });
+
+            std::vector<Brush> copies;
+            copies.reserve(brushes.size());
+            runBenchmark("Brush.copy " + std::to_string(NumBrushes) + " " + formatName + " brushes", options, [&]() {
+                copies.clear();
+            }, [&]() {
+                for (const auto& brush : brushes) {
+                    copies.push_back(brush);
+                }
+            });
+        }
+
+        static void benchmarkTextureLock(const MapFormat mapFormat, const std::string& formatName) {
+            const vm::bbox3 worldBounds(8192.0);
+            auto brushes = makeBrushes(mapFormat);
+
+            const auto transformation = vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(15.0));
+            runBenchmark("Brush.transform " + std::to_string(NumBrushes) + " " + formatName + " brushes with texture lock", BenchmarkOptions::fromEnvironment(1, 5), [&]() {
+                bool success = true;
+                for (auto& brush : brushes) {
+                    success = brush.transform(worldBounds, transformation, true).is_success() && success;
+                }
+                CHECK(success);
+            });
+        }
+
+        TEST_CASE("BrushFaceBenchmark.memoryPerFace", "[BrushFaceBenchmark]") {
+            // the texture coordinate system is stored inline, so this is the complete memory footprint of a face
+            // without its geometry
+            std::printf("sizeof(BrushFace): %zu bytes, of which sizeof(TexCoordSystemVariant): %zu bytes\n",
+                sizeof(BrushFace), sizeof(TexCoordSystemVariant));
+        }
+
+        TEST_CASE("BrushFaceBenchmark.copyFaces", "[BrushFaceBenchmark]") {
+            benchmarkFaceCopies(MapFormat::Standard, "paraxial");
+            benchmarkFaceCopies(MapFormat::Valve, "parallel");
+        }
+
+        TEST_CASE("BrushFaceBenchmark.transformWithTextureLock", "[BrushFaceBenchmark]") {
+            benchmarkTextureLock(MapFormat::Standard, "paraxial");
+            benchmarkTextureLock(MapFormat::Valve, "parallel");
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/Path.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/Issue.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/TestGame.h"
+#include "Model/WorldNode.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t IssueInterval = 20;
+
+        /**
+         * Adds nodes with known issues to a generated map: for every 20 brushes, there is a brush with non integer
+         * vertices, an entity with an empty property value, an entity with a missing link target and an entity without a
+         * classname.
+         */
+        static std::unique_ptr<WorldNode> makeIssueWorld(const size_t brushCount) {
+            auto world = BenchmarkMaps::makeWorld(brushCount, MapFormat::Standard);
+            auto* layer = world->defaultLayer();
+
+            const BrushBuilder builder(MapFormat::Standard, BenchmarkMaps::worldBounds());
+            for (size_t i = 0; i < brushCount; i += IssueInterval) {
+                const auto bounds = BenchmarkMaps::cellBounds(i, brushCount);
+                layer->addChild(new BrushNode(builder.createCuboid(bounds.translate(vm::vec3::fill(0.5)), "texture").value()));
+
+                layer->addChild(new EntityNode({
+                    {PropertyKeys::Classname, "info_notnull"},
+                    {"message", ""}
+                }));
+                layer->addChild(new EntityNode({
+                    {PropertyKeys::Classname, "trigger_relay"},
+                    {PropertyKeys::Target, "missing_" + std::to_string(i)}
+                }));
+                layer->addChild(new EntityNode({
+                    {"message", "no classname"}
+                }));
+            }
+
+            return world;
+        }
+
+        static void benchmarkIssueGenerators(const size_t brushCount, const BenchmarkOptions& options) {
+            auto game = std::make_shared<TestGame>();
+            game->setWorldNodeToLoad(makeIssueWorld(brushCount));
+
+            auto document = View::MapDocumentCommandFacade::newMapDocument();
+            document->loadDocument(MapFormat::Standard, BenchmarkMaps::worldBounds(), game, IO::Path("issues.map"));
+
+            const auto& issueGenerators = document->world()->registeredIssueGenerators();
+            const auto nodes = collectNodes({document->world()});
+            const auto suffix = " (" + std::to_string(brushCount) + " brushes)";
+
+            const auto invalidateIssues = [&]() {
+                for (const auto* node : nodes) {
+                    node->invalidateIssues();
+                }
+            };
+
+            const auto countIssues = [&]() {
+                size_t issueCount = 0;
+                for (auto* node : nodes) {
+                    issueCount += node->issues(issueGenerators).size();
+                }
+                return issueCount;
+            };
+
+            size_t expectedIssueCount = 0;
+            runBenchmark("IssueGenerator.generate per node" + suffix, options, invalidateIssues, [&]() {
+                expectedIssueCount = countIssues();
+            });
+
+            // there are at least four seeded issues for every 20 brushes
+            REQUIRE(expectedIssueCount >= 4u * (brushCount / IssueInterval));
+
+            runBenchmark("IssueGenerator.validate in parallel" + suffix, options, invalidateIssues, [&]() {
+                Node::validateIssues(nodes, issueGenerators);
+            });
+            CHECK(countIssues() == expectedIssueCount);
+        }
+
+        TEST_CASE("IssueGeneratorBenchmark.smallMap", "[IssueGeneratorBenchmark]") {
+            benchmarkIssueGenerators(BenchmarkMaps::SmallMap, BenchmarkOptions::fromEnvironment(2, 10));
+        }
+
+        TEST_CASE("IssueGeneratorBenchmark.mediumMap", "[IssueGeneratorBenchmark]") {
+            benchmarkIssueGenerators(BenchmarkMaps::MediumMap, BenchmarkOptions::fromEnvironment(1, 5));
+        }
+    }
+}
@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/BezierPatch.h"
+#include "Model/EditorContext.h"
+#include "Model/PatchGridCache.h"
+#include "Model/PatchNode.h"
+#include "Model/PickResult.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/intersection.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumPatches = 4'000;
+        static constexpr size_t PatchPointCount = 7;
+
+        /**
+         * Returns a 7*7 patch that is curved like a section of a cylinder, placed in a grid so that patches don't overlap.
+         */
+        static BezierPatch makeCurvedPatch(const size_t index) {
+            using P = BezierPatch::Point;
+
+            const auto origin = vm::vec3(static_cast<FloatType>(index % 64u) * 128.0, static_cast<FloatType>(index / 64u) * 128.0, 0.0);
+
+            auto controlPoints = std::vector<P>{};
+            controlPoints.reserve(PatchPointCount * PatchPointCount);
+            for (size_t row = 0u; row < PatchPointCount; ++row) {
+                for (size_t col = 0u; col < PatchPointCount; ++col) {
+                    const auto angle = vm::C::pi() * static_cast<FloatType>(col) / static_cast<FloatType>(PatchPointCount - 1u);
+                    const auto position = origin + vm::vec3(48.0 * std::cos(angle), static_cast<FloatType>(row) * 16.0, 48.0 * std::sin(angle));
+                    const auto u = static_cast<FloatType>(col) / static_cast<FloatType>(PatchPointCount - 1u);
+                    const auto v = static_cast<FloatType>(row) / static_cast<FloatType>(PatchPointCount - 1u);
+                    controlPoints.push_back(P{position.x(), position.y(), position.z(), u, v});
+                }
+            }
+            return BezierPatch{PatchPointCount, PatchPointCount, std::move(controlPoints), "texture"};
+        }
+
+        static std::vector<BezierPatch> makeCurvedPatches() {
+            auto result = std::vector<BezierPatch>{};
+            result.reserve(NumPatches);
+            for (size_t i = 0u; i < NumPatches; ++i) {
+                result.push_back(makeCurvedPatch(i));
+            }
+            return result;
+        }
+
+        TEST_CASE("PatchBenchmark.tessellate", "[PatchBenchmark]") {
+            const auto patches = makeCurvedPatches();
+            const auto patchPointers = kdl::vec_transform(patches, [](const auto& patch) { return &patch; });
+            const auto options = BenchmarkOptions::fromEnvironment(1, 5);
+
+            runBenchmark("Patch.tessellate " + std::to_string(NumPatches) + " patches, uniform", options, [&]() {
+                for (const auto& patch : patches) {
+                    makePatchGrid(patch, 3u);
+                }
+            });
+
+            runBenchmark("Patch.tessellate " + std::to_string(NumPatches) + " patches, adaptive", options, [&]() {
+                for (const auto& patch : patches) {
+                    PatchNode{patch};
+                }
+            });
+
+            auto gridCache = PatchGridCache{};
+            runBenchmark("Patch.tessellate " + std::to_string(NumPatches) + " patches, adaptive and parallel", options, [&]() {
+                gridCache.clear();
+            }, [&]() {
+                precomputePatchGrids(patchPointers, gridCache);
+            });
+
+            runBenchmark("Patch.tessellate " + std::to_string(NumPatches) + " patches, cached", options, [&]() {
+                precomputePatchGrids(patchPointers, gridCache);
+            });
+        }
+
+        TEST_CASE("PatchBenchmark.transformAndUndo", "[PatchBenchmark]") {
+            auto patchNodes = kdl::vec_transform(makeCurvedPatches(), [](auto patch) { return std::make_unique<PatchNode>(std::move(patch)); });
+            auto gridCache = PatchGridCache{};
+
+            // simulate translating all patches and undoing the translation, which swaps the patches back and forth
+            runBenchmark("Patch.transform and undo " + std::to_string(NumPatches) + " patches", BenchmarkOptions::fromEnvironment(1, 5), [&]() {
+                auto transformedPatches = kdl::vec_transform(patchNodes, [](const auto& patchNode) {
+                    auto patch = patchNode->patch();
+                    patch.transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)));
+                    return patch;
+                });
+
+                precomputePatchGrids(kdl::vec_transform(transformedPatches, [](const auto& patch) { return &patch; }), gridCache);
+                for (size_t i = 0u; i < patchNodes.size(); ++i) {
+                    transformedPatches[i] = patchNodes[i]->setPatch(std::move(transformedPatches[i]), gridCache);
+                }
+                for (size_t i = 0u; i < patchNodes.size(); ++i) {
+                    patchNodes[i]->setPatch(std::move(transformedPatches[i]), gridCache);
+                }
+            });
+        }
+
+        TEST_CASE("PatchBenchmark.pick", "[PatchBenchmark]") {
+            constexpr size_t RayCount = 100;
+
+            auto patchNodes = kdl::vec_transform(makeCurvedPatches(), [](auto patch) { return std::make_unique<PatchNode>(std::move(patch)); });
+
+            auto rays = std::vector<vm::ray3>{};
+            for (size_t i = 0u; i < RayCount; ++i) {
+                const auto target = patchNodes[(i * 7919u) % patchNodes.size()]->physicalBounds().center();
+                rays.emplace_back(target + vm::vec3(0.0, 0.0, 1000.0), vm::vec3::neg_z());
+            }
+
+            const auto editorContext = EditorContext{};
+            const auto options = BenchmarkOptions::fromEnvironment(1, 5);
+
+            runBenchmark("Patch.pick " + std::to_string(RayCount) + " rays against " + std::to_string(NumPatches) + " patches, bounds hierarchy", options, [&]() {
+                size_t hits = 0u;
+                for (const auto& ray : rays) {
+                    auto pickResult = PickResult{};
+                    for (auto& patchNode : patchNodes) {
+                        patchNode->pick(editorContext, ray, pickResult);
+                    }
+                    hits += pickResult.size();
+                }
+                CHECK(hits > 0u);
+            });
+
+            runBenchmark("Patch.pick " + std::to_string(RayCount) + " rays against " + std::to_string(NumPatches) + " patches, all triangles", options, [&]() {
+                size_t hits = 0u;
+                for (const auto& ray : rays) {
+                    for (const auto& patchNode : patchNodes) {
+                        const auto& grid = patchNode->grid();
+                        for (size_t row = 0u; row < grid.quadRowCount(); ++row) {
+                            for (size_t col = 0u; col < grid.quadColumnCount(); ++col) {
+                                const auto& v0 = grid.point(row, col).position;
+                                const auto& v1 = grid.point(row, col + 1u).position;
+                                const auto& v2 = grid.point(row + 1u, col + 1u).position;
+                                const auto& v3 = grid.point(row + 1u, col).position;
+                                if (!vm::is_nan(vm::intersect_ray_triangle(ray, v0, v1, v2)) || !vm::is_nan(vm::intersect_ray_triangle(ray, v2, v3, v0))) {
+                                    ++hits;
+                                }
+                            }
+                        }
+                    }
+                }
+                CHECK(hits > 0u);
+            });
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushGeometry.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron3.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Returns the vertices of the given number of cube brushes laid out in a grid, like a convex merge of a
+         * selection of brushes collects them.
+         */
+        static std::vector<vm::vec3> collectMergeVertices(const size_t brushCount) {
+            const BrushBuilder builder(MapFormat::Standard, BenchmarkMaps::worldBounds());
+
+            std::vector<vm::vec3> result;
+            for (size_t i = 0; i < brushCount; ++i) {
+                const auto brush = builder.createCuboid(BenchmarkMaps::cellBounds(i, brushCount), "texture").value();
+                for (const auto* vertex : brush.vertices()) {
+                    result.push_back(vertex->position());
+                }
+            }
+            return result;
+        }
+
+        static void benchmarkConvexMerge(const size_t brushCount, const BenchmarkOptions& options) {
+            const auto points = collectMergeVertices(brushCount);
+            const BrushBuilder builder(MapFormat::Standard, BenchmarkMaps::worldBounds());
+
+            runBenchmark("Polyhedron.convex merge " + std::to_string(brushCount) + " brushes (" + std::to_string(points.size()) + " points)", options, [&]() {
+                const Polyhedron3 polyhedron(points);
+                CHECK(polyhedron.closed());
+
+                const auto brush = builder.createBrush(polyhedron, "texture");
+                CHECK(brush.is_success());
+            });
+        }
+
+        TEST_CASE("PolyhedronBenchmark.convexMerge", "[PolyhedronBenchmark]") {
+            const auto options = BenchmarkOptions::fromEnvironment(2, 10);
+            benchmarkConvexMerge(100, options);
+            benchmarkConvexMerge(BenchmarkMaps::SmallMap, options);
+            benchmarkConvexMerge(BenchmarkMaps::MediumMap, options);
+        }
+    }
+}
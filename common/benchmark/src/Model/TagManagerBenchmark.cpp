@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/Tag.h"
+#include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/vector_set.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t TextureCount = 64;
+
+        /**
+         * Forwards to another matcher, but hides its input so that the tag manager evaluates it for every taggable.
+         */
+        class UncachedTagMatcher : public TagMatcher {
+        private:
+            std::unique_ptr<TagMatcher> m_matcher;
+        public:
+            explicit UncachedTagMatcher(std::unique_ptr<TagMatcher> matcher) :
+            m_matcher(std::move(matcher)) {}
+
+            bool matches(const Taggable& taggable) const override {
+                return m_matcher->matches(taggable);
+            }
+
+            std::unique_ptr<TagMatcher> clone() const override {
+                return std::make_unique<UncachedTagMatcher>(m_matcher->clone());
+            }
+        };
+
+        /**
+         * Returns smart tags which resemble those of the bundled Quake 2 and Quake 3 game configurations.
+         */
+        static std::vector<SmartTag> makeSmartTags(const bool cached) {
+            const auto wrap = [&](std::unique_ptr<TagMatcher> matcher) -> std::unique_ptr<TagMatcher> {
+                if (cached) {
+                    return matcher;
+                }
+                return std::make_unique<UncachedTagMatcher>(std::move(matcher));
+            };
+
+            return {
+                SmartTag("Detail", {}, wrap(std::make_unique<EntityClassNameTagMatcher>("func_detail*", ""))),
+                SmartTag("Trigger", {}, wrap(std::make_unique<EntityClassNameTagMatcher>("trigger*", "trigger"))),
+                SmartTag("Clip", {}, wrap(std::make_unique<TextureNameTagMatcher>("clip"))),
+                SmartTag("Skip", {}, wrap(std::make_unique<TextureNameTagMatcher>("skip"))),
+                SmartTag("Hint", {}, wrap(std::make_unique<TextureNameTagMatcher>("hint*"))),
+                SmartTag("Liquid", {}, wrap(std::make_unique<TextureNameTagMatcher>("texture_1*"))),
+                SmartTag("Nodraw", {}, wrap(std::make_unique<SurfaceParmTagMatcher>("nodraw"))),
+                SmartTag("Water", {}, wrap(std::make_unique<SurfaceParmTagMatcher>(kdl::vector_set<std::string>{"water", "slime", "lava"}))),
+                SmartTag("Translucent", {}, std::make_unique<SurfaceFlagsTagMatcher>(16))
+            };
+        }
+
+        TEST_CASE("TagManagerBenchmark.initializeTags", "[TagManagerBenchmark]") {
+            // every fourth texture has a surface parameter
+            std::vector<Assets::Texture> textures;
+            textures.reserve(TextureCount);
+            for (size_t i = 0; i < TextureCount; ++i) {
+                textures.emplace_back("texture_" + std::to_string(i), 16, 16);
+                if (i % 4u == 0u) {
+                    textures.back().setSurfaceParms({i % 8u == 0u ? "nodraw" : "water"});
+                }
+            }
+
+            // the world must be destroyed before the textures because the faces refer to them
+            const auto brushCount = BenchmarkMaps::MediumMap;
+            auto world = BenchmarkMaps::makeWorld(brushCount, MapFormat::Quake2);
+
+            auto nodes = collectDescendants({world.get()});
+            nodes.push_back(world.get());
+
+            size_t faceCount = 0;
+            for (auto* brushNode : filterBrushNodes(nodes)) {
+                const auto& faces = brushNode->brush().faces();
+                for (size_t i = 0; i < faces.size(); ++i) {
+                    const auto index = std::stoul(faces[i].attributes().textureName().substr(8));
+                    brushNode->setFaceTexture(i, &textures[index]);
+                }
+                faceCount += faces.size();
+            }
+
+            const auto options = BenchmarkOptions::fromEnvironment(2, 10);
+            const auto suffix = " (" + std::to_string(brushCount) + " brushes, " + std::to_string(faceCount) + " faces)";
+
+            for (const auto cached : {false, true}) {
+                TagManager tagManager;
+                tagManager.registerSmartTags(makeSmartTags(cached));
+
+                runBenchmark(std::string("TagManager.initializeTags ") + (cached ? "cached" : "uncached") + suffix, options, [&]() {
+                    for (auto* node : nodes) {
+                        node->initializeTags(tagManager);
+                    }
+                });
+
+                size_t detailBrushes = 0;
+                for (auto* brushNode : filterBrushNodes(nodes)) {
+                    if (brushNode->hasTag(tagManager.smartTag("Detail"))) {
+                        ++detailBrushes;
+                    }
+                }
+                CHECK(detailBrushes == brushCount / 10u);
+            }
+
+            // initializing the tags of the nodes makes them refer to the registered smart tags
+            for (auto* node : nodes) {
+                node->clearTags();
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "PreferenceManager.h"
+#include "PreferenceSnapshot.h"
+#include "Preferences.h"
+
+#include <string>
+#include <thread>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    static constexpr size_t LookupCount = 1'000'000;
+
+    static std::string lookupBenchmarkName(const std::string& method) {
+        return "PreferenceSnapshot." + method + " (" + std::to_string(LookupCount) + " lookups)";
+    }
+
+    TEST_CASE("PreferenceSnapshotBenchmark.lookup", "[PreferenceSnapshotBenchmark]") {
+        const auto options = BenchmarkOptions::fromEnvironment(1, 10);
+
+        // mix the value types that hot code paths read most often
+        const auto sumPrefs = [](auto&& get) {
+            float sum = 0.0f;
+            for (size_t i = 0; i < LookupCount; ++i) {
+                sum += get(Preferences::TextureLock) ? 1.0f : 0.0f;
+                sum += get(Preferences::GridAlpha);
+                sum += get(Preferences::BackgroundColor).r();
+            }
+            return sum;
+        };
+
+        float expected = 0.0f;
+        runBenchmark(lookupBenchmarkName("pref"), options, [&]() {
+            expected = sumPrefs([](auto& preference) { return pref(preference); });
+        });
+
+        runBenchmark(lookupBenchmarkName("preferenceSnapshot"), options, [&]() {
+            CHECK(sumPrefs([](auto& preference) { return preferenceSnapshot().get(preference); }) == expected);
+        });
+
+        const auto snapshot = PreferenceManager::instance().snapshot();
+        runBenchmark(lookupBenchmarkName("held snapshot"), options, [&]() {
+            CHECK(sumPrefs([&](auto& preference) { return snapshot->get(preference); }) == expected);
+        });
+
+        runBenchmark(lookupBenchmarkName("preferenceSnapshot on worker thread"), options, [&]() {
+            float sum = 0.0f;
+            std::thread thread([&]() {
+                sum = sumPrefs([](auto& preference) { return preferenceSnapshot().get(preference); });
+            });
+            thread.join();
+            CHECK(sum == expected);
+        });
+    }
+}
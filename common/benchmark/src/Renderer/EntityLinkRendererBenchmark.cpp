@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/EntityLinkRenderer.h"
+
+#include <kdl/string_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t LinkCount = 15'000;
+        static constexpr size_t ChangedEntityCount = 100;
+
+        TEST_CASE("EntityLinkRendererBenchmark.regenerateLinks", "[EntityLinkRendererBenchmark]") {
+            // the fixture map contains a linked pair of point entities for every 50 brushes, so we add more pairs
+            auto world = BenchmarkMaps::makeWorld(BenchmarkMaps::SmallMap, Model::MapFormat::Standard);
+            std::vector<Model::Node*> sourceNodes;
+            for (size_t i = 0; i < LinkCount; ++i) {
+                const auto targetName = "link_" + std::to_string(i);
+                const auto origin = kdl::str_to_string(BenchmarkMaps::cellBounds(i, LinkCount).center());
+
+                auto* sourceNode = new Model::EntityNode({
+                    {Model::PropertyKeys::Classname, "trigger_relay"},
+                    {Model::PropertyKeys::Origin, origin},
+                    {Model::PropertyKeys::Target, targetName}
+                });
+                world->defaultLayer()->addChild(sourceNode);
+                world->defaultLayer()->addChild(new Model::EntityNode({
+                    {Model::PropertyKeys::Classname, "info_notnull"},
+                    {Model::PropertyKeys::Origin, origin},
+                    {Model::PropertyKeys::Targetname, targetName}
+                }));
+                sourceNodes.push_back(sourceNode);
+            }
+
+            const Model::EditorContext editorContext;
+            const auto defaultColor = Color(0.5f, 1.0f, 0.5f, 1.0f);
+            const auto selectedColor = Color(1.0f, 0.0f, 0.0f, 1.0f);
+            const auto options = BenchmarkOptions::fromEnvironment(2, 20);
+
+            EntityLinkCache cache;
+            std::vector<LinkRenderer::LineVertex> lines;
+            std::vector<LinkRenderer::ArrowVertex> arrows;
+
+            const auto getVertices = [&]() {
+                lines.clear();
+                arrows.clear();
+                cache.getVertices(*world, editorContext, defaultColor, selectedColor, lines, arrows);
+            };
+
+            getVertices();
+            const auto totalLinks = lines.size() / 2u;
+            CHECK(totalLinks >= LinkCount);
+
+            const auto suffix = " (" + std::to_string(totalLinks) + " links)";
+            runBenchmark("EntityLinkRenderer.regenerate all links" + suffix, options, [&]() {
+                cache.invalidate();
+            }, [&]() {
+                getVertices();
+                CHECK(lines.size() == totalLinks * 2u);
+            });
+
+            // simulates selecting a few entities or changing their properties
+            const auto changedNodes = std::vector<Model::Node*>(std::begin(sourceNodes), std::begin(sourceNodes) + ChangedEntityCount);
+            runBenchmark("EntityLinkRenderer.regenerate links of " + std::to_string(ChangedEntityCount) + " entities" + suffix, options, [&]() {
+                cache.invalidateNodes(changedNodes);
+            }, [&]() {
+                getVertices();
+                CHECK(lines.size() == totalLinks * 2u);
+            });
+        }
+    }
+}
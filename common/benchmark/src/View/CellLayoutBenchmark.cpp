@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "View/CellLayout.h"
+#include "View/SubstringIndex.h"
+
+#include <kdl/string_compare.h>
+
+#include <string>
+#include <vector>
+
+#include <QVariant>
+
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t CellCount = 8'000;
+        static constexpr size_t CollectionCount = 16;
+        static constexpr float ViewHeight = 600.0f;
+
+        static std::vector<std::string> makeCellNames() {
+            static const auto prefixes = std::vector<std::string>{"base", "metal", "wood", "tech", "sky", "*water", "+0button", "rock"};
+
+            std::vector<std::string> result;
+            result.reserve(CellCount);
+            for (size_t i = 0; i < CellCount; ++i) {
+                result.push_back(prefixes[i % prefixes.size()] + "_" + std::to_string(i / prefixes.size()) + "_" + std::to_string(i % 7));
+            }
+            return result;
+        }
+
+        /**
+         * Sets up the layout like the texture browser does, with one group per collection and cells of varying sizes.
+         */
+        static void fillLayout(CellLayout& layout, const std::vector<std::string>& names) {
+            layout.setOuterMargin(5.0f);
+            layout.setGroupMargin(5.0f);
+            layout.setRowMargin(15.0f);
+            layout.setCellMargin(10.0f);
+            layout.setTitleMargin(2.0f);
+            layout.setCellWidth(64.0f, 64.0f);
+            layout.setCellHeight(64.0f, 128.0f);
+            layout.setWidth(800.0f);
+
+            const auto cellsPerGroup = CellCount / CollectionCount;
+            for (size_t i = 0; i < names.size(); ++i) {
+                if (i % cellsPerGroup == 0u) {
+                    layout.addGroup("collection " + std::to_string(i / cellsPerGroup), 14.0f);
+                }
+
+                const auto size = static_cast<float>(32u << (i % 3u));
+                layout.addItem(QVariant(static_cast<int>(i)), size, size, 64.0f, 30.0f);
+            }
+        }
+
+        TEST_CASE("CellLayoutBenchmark.browser", "[CellLayoutBenchmark]") {
+            const auto names = makeCellNames();
+            const auto options = BenchmarkOptions::fromEnvironment(2, 20);
+            const auto suffix = " (" + std::to_string(CellCount) + " cells)";
+
+            CellLayout layout;
+            fillLayout(layout, names);
+
+            auto width = 800.0f;
+            runBenchmark("CellLayout.relayout on resize" + suffix, options, [&]() {
+                width = width == 800.0f ? 1000.0f : 800.0f;
+                layout.setWidth(width);
+            }, [&]() {
+                CHECK(layout.height() > 0.0f);
+            });
+
+            // scroll through the entire layout one screen at a time
+            const auto totalHeight = layout.height();
+            runBenchmark("CellLayout.visit visible cells while scrolling" + suffix, options, [&]() {
+                size_t visited = 0u;
+                for (float y = 0.0f; y < totalHeight; y += ViewHeight) {
+                    layout.visitCellsIntersectingY(y, ViewHeight, [&](const LayoutCell&) { ++visited; });
+                }
+                CHECK(visited >= CellCount);
+            });
+
+            runBenchmark("CellLayout.scan all cells while scrolling" + suffix, options, [&]() {
+                size_t visited = 0u;
+                for (float y = 0.0f; y < totalHeight; y += ViewHeight) {
+                    for (size_t i = 0; i < layout.size(); ++i) {
+                        const auto& group = layout[i];
+                        if (group.intersectsY(y, ViewHeight)) {
+                            for (size_t j = 0; j < group.size(); ++j) {
+                                const auto& row = group[j];
+                                if (row.intersectsY(y, ViewHeight)) {
+                                    visited += row.size();
+                                }
+                            }
+                        }
+                    }
+                }
+                CHECK(visited >= CellCount);
+            });
+
+            runBenchmark("CellLayout.hit test 1000 points" + suffix, options, [&]() {
+                size_t hits = 0u;
+                for (size_t i = 0; i < 1000u; ++i) {
+                    const auto x = static_cast<float>((i * 37u) % 800u);
+                    const auto y = static_cast<float>((i * 7919u) % static_cast<size_t>(totalHeight));
+                    const LayoutCell* cell = nullptr;
+                    if (layout.cellAt(x, y, &cell)) {
+                        ++hits;
+                    }
+                }
+                CHECK(hits > 0u);
+            });
+        }
+
+        TEST_CASE("CellLayoutBenchmark.filter", "[CellLayoutBenchmark]") {
+            const auto names = makeCellNames();
+            const auto options = BenchmarkOptions::fromEnvironment(2, 20);
+            const auto suffix = " (" + std::to_string(CellCount) + " names)";
+            const auto patterns = std::vector<std::string>{"metal_1", "water", "button_9", "rock_12_", "ase_", "tech_99"};
+
+            SubstringIndex index;
+            runBenchmark("SubstringIndex.build" + suffix, options, [&]() {
+                index.clear();
+            }, [&]() {
+                for (const auto& name : names) {
+                    index.add(name);
+                }
+            });
+
+            size_t expectedMatches = 0u;
+            runBenchmark("SubstringIndex.linear scan " + std::to_string(patterns.size()) + " patterns" + suffix, options, [&]() {
+                expectedMatches = 0u;
+                for (const auto& pattern : patterns) {
+                    for (const auto& name : names) {
+                        if (kdl::ci::str_contains(name, pattern)) {
+                            ++expectedMatches;
+                        }
+                    }
+                }
+            });
+
+            runBenchmark("SubstringIndex.find " + std::to_string(patterns.size()) + " patterns" + suffix, options, [&]() {
+                size_t matches = 0u;
+                for (const auto& pattern : patterns) {
+                    matches += index.find(pattern).size();
+                }
+                CHECK(matches == expectedMatches);
+            });
+        }
+    }
+}
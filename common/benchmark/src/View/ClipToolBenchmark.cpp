@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/Path.h"
+#include "Model/MapFormat.h"
+#include "Model/TestGame.h"
+#include "Model/WorldNode.h"
+#include "View/ClipTool.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t ClipBrushCount = 3'000;
+
+        /**
+         * Creates a document containing a grid of world brushes and selects all of them.
+         */
+        static std::shared_ptr<MapDocument> makeClipBenchmarkDocument() {
+            auto game = std::make_shared<Model::TestGame>();
+            game->setWorldNodeToLoad(BenchmarkMaps::makeBrushWorld(ClipBrushCount, Model::MapFormat::Standard));
+
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->loadDocument(Model::MapFormat::Standard, BenchmarkMaps::worldBounds(), game, IO::Path("clip.map"));
+            document->selectAllNodes();
+            return document;
+        }
+
+        TEST_CASE("ClipToolBenchmark.largeSelection", "[ClipToolBenchmark]") {
+            auto document = makeClipBenchmarkDocument();
+            const auto options = BenchmarkOptions::fromEnvironment(2, 10);
+            const auto suffix = " (" + std::to_string(ClipBrushCount) + " brushes)";
+
+            ClipTool tool(document);
+            REQUIRE(tool.activate());
+
+            // the clip plane cuts through the middle of the grid and is tilted by dragging its third point
+            const auto point1 = vm::vec3(5.0, -1000.0, -1000.0);
+            const auto point2 = vm::vec3(5.0, 1000.0, -1000.0);
+            const auto point3 = vm::vec3(5.0, 0.0, 1000.0);
+
+            runBenchmark("ClipTool.add clip points" + suffix, options, [&]() {
+                tool.reset();
+            }, [&]() {
+                tool.addPoint(point1, {});
+                tool.addPoint(point2, {});
+                tool.addPoint(point3, {});
+            });
+            REQUIRE(tool.canClip());
+
+            tool.beginDragLastPoint();
+            size_t dragCount = 0;
+            runBenchmark("ClipTool.drag clip point" + suffix, options, [&]() {
+                const auto offset = static_cast<FloatType>(++dragCount % 8u) * BenchmarkMaps::CubeSize;
+                CHECK(tool.dragPoint(point3 + vm::vec3(offset, 0.0, 0.0), {}));
+            });
+            tool.endDragPoint();
+
+            runBenchmark("ClipTool.toggle side" + suffix, options, [&]() {
+                tool.toggleSide();
+            });
+
+            CHECK(tool.deactivate());
+        }
+    }
+}
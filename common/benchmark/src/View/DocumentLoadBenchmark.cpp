@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Assets/EntityDefinitionFileSpec.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Entity.h"
+#include "Model/MapFormat.h"
+#include "Model/TestGame.h"
+#include "Model/WorldNode.h"
+#include "View/DocumentLoadStage.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <kdl/string_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        /** The number of texture names used by the generated maps. */
+        static constexpr size_t TextureCount = 64;
+        static constexpr size_t TextureSize = 256;
+        static constexpr size_t TextureMipLevels = 4;
+
+        /** The number of entity definitions in the generated entity definition file. */
+        static constexpr size_t EntityDefinitionCount = 1'000;
+
+        static std::string makeEntityDefinitions() {
+            std::stringstream str;
+            str << "@SolidClass = worldspawn : \"World entity\" [ message(string) : \"Text on entering the world\" wad(string) : \"Texture collections\" ]\n";
+            str << "@SolidClass = func_detail : \"Detail brushes\" []\n";
+            str << "@PointClass size(-8 -8 -8, 8 8 8) color(255 128 0) = trigger_relay : \"Relay\" [ target(target_destination) : \"Target\" ]\n";
+            str << "@PointClass size(-8 -8 -8, 8 8 8) color(0 128 255) = info_notnull : \"Target\" [ targetname(target_source) : \"Name\" ]\n";
+
+            for (size_t i = 0; i < EntityDefinitionCount; ++i) {
+                str << "@PointClass size(-16 -16 -24, 16 16 32) color(" << (i % 256) << " 128 64) = benchmark_entity_" << i << " : \"Benchmark entity " << i << "\"\n"
+                    << "[\n"
+                    << "    targetname(target_source) : \"Name\"\n"
+                    << "    target(target_destination) : \"Target\"\n"
+                    << "    angle(integer) : \"Angle\" : 0\n"
+                    << "    health(integer) : \"Health\" : 100\n"
+                    << "    message(string) : \"Message\"\n"
+                    << "    spawnflags(flags) =\n"
+                    << "    [\n"
+                    << "        1 : \"Easy\" : 0\n"
+                    << "        2 : \"Medium\" : 0\n"
+                    << "        4 : \"Hard\" : 0\n"
+                    << "    ]\n"
+                    << "]\n";
+            }
+
+            return str.str();
+        }
+
+        /**
+         * Creates an RGBA texture with mip maps by expanding indexed pixel data through a palette, which is what a WAD
+         * texture reader does.
+         */
+        static Assets::Texture makeTexture(const std::string& name, const size_t seed) {
+            Assets::TextureBufferList buffers(TextureMipLevels);
+            Assets::setMipBufferSize(buffers, TextureMipLevels, TextureSize, TextureSize, GL_RGBA);
+
+            for (size_t level = 0; level < TextureMipLevels; ++level) {
+                const auto size = Assets::sizeAtMipLevel(TextureSize, TextureSize, level);
+                unsigned char* rgba = buffers[level].data();
+                for (size_t y = 0; y < size.y(); ++y) {
+                    for (size_t x = 0; x < size.x(); ++x) {
+                        const auto index = static_cast<unsigned char>((x * 7u + y * 13u + seed) % 256u);
+                        *rgba++ = index;
+                        *rgba++ = static_cast<unsigned char>(255u - index);
+                        *rgba++ = static_cast<unsigned char>(index / 2u);
+                        *rgba++ = 0xFF;
+                    }
+                }
+            }
+
+            return Assets::Texture(name, TextureSize, TextureSize, Color(0.5f, 0.5f, 0.5f), std::move(buffers), GL_RGBA, Assets::TextureType::Opaque);
+        }
+
+        /**
+         * A game which parses the map from text, parses a generated entity definition file and generates texture
+         * collections, so that every stage of loading a document does a realistic amount of work.
+         */
+        class BenchmarkGame : public Model::TestGame {
+        private:
+            std::string m_mapText;
+            std::string m_entityDefinitions;
+        public:
+            explicit BenchmarkGame(std::string mapText) :
+            m_mapText(std::move(mapText)),
+            m_entityDefinitions(makeEntityDefinitions()) {}
+        private:
+            std::unique_ptr<Model::WorldNode> doLoadMap(const Model::MapFormat format, const vm::bbox3& worldBounds, const IO::Path& /* path */, Logger& /* logger */) const override {
+                IO::TestParserStatus status;
+                IO::WorldReader reader(m_mapText, format);
+                return reader.read(worldBounds, status);
+            }
+
+            void doLoadTextureCollections(const Model::Entity& /* entity */, const IO::Path& /* documentPath */, Assets::TextureManager& textureManager, Logger& /* logger */) const override {
+                std::vector<Assets::Texture> textures;
+                for (size_t i = 0; i < TextureCount; ++i) {
+                    textures.push_back(makeTexture("texture_" + std::to_string(i), i));
+                }
+
+                std::vector<Assets::TextureCollection> collections;
+                collections.emplace_back(IO::Path("benchmark.wad"), std::move(textures));
+                textureManager.setTextureCollections(std::move(collections));
+            }
+
+            Assets::EntityDefinitionFileSpec doExtractEntityDefinitionFile(const Model::Entity& /* entity */) const override {
+                return Assets::EntityDefinitionFileSpec::builtin(IO::Path("benchmark.fgd"));
+            }
+
+            IO::Path doFindEntityDefinitionFile(const Assets::EntityDefinitionFileSpec& spec, const std::vector<IO::Path>& /* searchPaths */) const override {
+                return spec.path();
+            }
+
+            std::vector<Assets::EntityDefinition*> doLoadEntityDefinitions(IO::ParserStatus& status, const IO::Path& path) const override {
+                IO::FgdParser parser(m_entityDefinitions, Color(1.0f, 1.0f, 1.0f, 1.0f), path);
+                return parser.parseDefinitions(status);
+            }
+        };
+
+        static void benchmarkDocumentLoad(const size_t brushCount, const BenchmarkOptions& options) {
+            const auto mapText = BenchmarkMaps::writeMap(*BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+            auto game = std::make_shared<BenchmarkGame>(mapText);
+            auto document = MapDocumentCommandFacade::newMapDocument();
+
+            std::map<DocumentLoadStage, std::vector<double>> stageSamples;
+            const auto progress = [&](const DocumentLoadStage stage, const DocumentLoadDuration duration) {
+                stageSamples[stage].push_back(duration.count());
+            };
+
+            const auto suffix = " (" + std::to_string(brushCount) + " brushes)";
+            runBenchmark("DocumentLoad.wall clock" + suffix, options, [&]() {
+                document->loadDocument(Model::MapFormat::Standard, BenchmarkMaps::worldBounds(), game, IO::Path("benchmark.map"), progress);
+            });
+
+            for (auto& [stage, samples] : stageSamples) {
+                // every stage is reported once per load, so the first samples belong to the warmup runs
+                samples.erase(std::begin(samples), std::begin(samples) + static_cast<std::ptrdiff_t>(std::min(options.warmupRuns, samples.size())));
+                reportBenchmark(kdl::str_to_string("DocumentLoad.", stage, suffix), std::move(samples));
+            }
+        }
+
+        TEST_CASE("DocumentLoadBenchmark.smallMap", "[DocumentLoadBenchmark]") {
+            benchmarkDocumentLoad(BenchmarkMaps::SmallMap, BenchmarkOptions::fromEnvironment(2, 10));
+        }
+
+        TEST_CASE("DocumentLoadBenchmark.mediumMap", "[DocumentLoadBenchmark]") {
+            benchmarkDocumentLoad(BenchmarkMaps::MediumMap, BenchmarkOptions::fromEnvironment(1, 5));
+        }
+    }
+}
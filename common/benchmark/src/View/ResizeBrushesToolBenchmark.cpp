@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/Path.h"
+#include "Model/Hit.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/TestGame.h"
+#include "Model/WorldNode.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/ResizeBrushesTool.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t ResizeBrushCount = 5'000;
+        static constexpr size_t ResizeRayCount = 100;
+
+        static Model::PickResult pickResizeHandle(MapDocument& document, ResizeBrushesTool& tool, const vm::ray3& pickRay) {
+            auto pickResult = Model::PickResult::byDistance();
+            document.pick(pickRay, pickResult);
+
+            const auto hit = tool.pick3D(pickRay, pickResult);
+            if (hit.isMatch()) {
+                pickResult.addHit(hit);
+            }
+            return pickResult;
+        }
+
+        TEST_CASE("ResizeBrushesToolBenchmark.largeSelection", "[ResizeBrushesToolBenchmark]") {
+            auto game = std::make_shared<Model::TestGame>();
+            game->setWorldNodeToLoad(BenchmarkMaps::makeBrushWorld(ResizeBrushCount, Model::MapFormat::Standard));
+
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->loadDocument(Model::MapFormat::Standard, BenchmarkMaps::worldBounds(), game, IO::Path("resize.map"));
+
+            const auto options = BenchmarkOptions::fromEnvironment(2, 10);
+            const auto suffix = " (" + std::to_string(ResizeBrushCount) + " brushes)";
+
+            ResizeBrushesTool tool(document);
+            document->selectAllNodes();
+
+            // hover over the cells of the grid from outside so that every ray hits a face on the grid's boundary, which
+            // is coplanar with the faces of all other brushes on that boundary
+            std::vector<Model::PickResult> pickResults;
+            for (size_t i = 0; i < ResizeRayCount; ++i) {
+                const auto target = BenchmarkMaps::cellBounds((i * 7919u) % ResizeBrushCount, ResizeBrushCount).center();
+                const auto origin = vm::vec3(-4000.0, target.y(), target.z());
+                pickResults.push_back(pickResizeHandle(*document, tool, vm::ray3(origin, vm::vec3::pos_x())));
+            }
+
+            runBenchmark("ResizeBrushesTool.select all and update drag handles" + suffix, options, [&]() {
+                document->deselectAll();
+            }, [&]() {
+                document->selectAllNodes();
+                tool.updateProposedDragHandles(pickResults.front());
+            });
+            REQUIRE(tool.hasVisualHandles());
+
+            runBenchmark("ResizeBrushesTool.update drag handles for " + std::to_string(ResizeRayCount) + " rays" + suffix, options, [&]() {
+                size_t handleCount = 0;
+                for (const auto& pickResult : pickResults) {
+                    tool.updateProposedDragHandles(pickResult);
+                    handleCount += tool.visualHandles().size();
+                }
+                CHECK(handleCount > ResizeRayCount);
+            });
+        }
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/Path.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/TestGame.h"
+#include "Model/WorldNode.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <kdl/string_format.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        /** The number of textures in the generated texture collection, only the first 64 are used by the maps. */
+        static constexpr size_t TextureCount = 3'000;
+
+        /**
+         * A game which generates a texture collection of tiny textures, so that reloading the texture collections is
+         * dominated by binding the textures to the faces.
+         */
+        class TextureBindingGame : public Model::TestGame {
+        private:
+            void doLoadTextureCollections(const Model::Entity& /* entity */, const IO::Path& /* documentPath */, Assets::TextureManager& textureManager, Logger& /* logger */) const override {
+                std::vector<Assets::Texture> textures;
+                textures.reserve(TextureCount);
+                for (size_t i = 0; i < TextureCount; ++i) {
+                    textures.emplace_back("texture_" + std::to_string(i), 1, 1);
+                }
+
+                std::vector<Assets::TextureCollection> collections;
+                collections.emplace_back(IO::Path("benchmark.wad"), std::move(textures));
+                textureManager.setTextureCollections(std::move(collections));
+            }
+        };
+
+        static std::string benchmarkName(const std::string& operation, const size_t brushCount) {
+            return "TextureBinding." + operation + " (" + std::to_string(brushCount) + " brushes)";
+        }
+
+        static void benchmarkTextureBinding(const size_t brushCount, const BenchmarkOptions& options) {
+            auto game = std::make_shared<TextureBindingGame>();
+            game->setWorldNodeToLoad(BenchmarkMaps::makeWorld(brushCount, Model::MapFormat::Standard));
+
+            auto document = MapDocumentCommandFacade::newMapDocument();
+            document->loadDocument(Model::MapFormat::Standard, BenchmarkMaps::worldBounds(), game, IO::Path("benchmark.map"));
+
+            // look up every face's texture name, half of them in upper case to exercise the case insensitive index
+            std::vector<std::string> textureNames;
+            for (const auto* brushNode : Model::filterBrushNodes(Model::collectDescendants({document->world()}))) {
+                for (const auto& face : brushNode->brush().faces()) {
+                    const auto& name = face.attributes().textureName();
+                    textureNames.push_back(textureNames.size() % 2u == 0u ? name : kdl::str_to_upper(name));
+                }
+            }
+
+            const auto& textureManager = document->textureManager();
+            runBenchmark(benchmarkName("look up " + std::to_string(textureNames.size()) + " textures", brushCount), options, [&]() {
+                size_t found = 0;
+                for (const auto& name : textureNames) {
+                    if (textureManager.texture(name) != nullptr) {
+                        ++found;
+                    }
+                }
+                CHECK(found == textureNames.size());
+            });
+
+            runBenchmark(benchmarkName("reload texture collections", brushCount), options, [&]() {
+                document->reloadTextureCollections();
+            });
+
+            const auto* texture = document->textureManager().texture("texture_0");
+            REQUIRE(texture != nullptr);
+            CHECK(texture->usageCount() > 0u);
+        }
+
+        TEST_CASE("TextureBindingBenchmark.smallMap", "[TextureBindingBenchmark]") {
+            benchmarkTextureBinding(BenchmarkMaps::SmallMap, BenchmarkOptions::fromEnvironment(2, 10));
+        }
+
+        TEST_CASE("TextureBindingBenchmark.mediumMap", "[TextureBindingBenchmark]") {
+            benchmarkTextureBinding(BenchmarkMaps::MediumMap, BenchmarkOptions::fromEnvironment(1, 5));
+        }
+
+        // hidden by default because it takes a while, run with "[TextureBindingBenchmark][large]"
+        TEST_CASE("TextureBindingBenchmark.largeMap", "[.][TextureBindingBenchmark][large]") {
+            benchmarkTextureBinding(BenchmarkMaps::LargeMap, BenchmarkOptions::fromEnvironment(1, 3));
+        }
+    }
+}
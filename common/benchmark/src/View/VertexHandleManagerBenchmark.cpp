@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/VertexHandleManager.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkMaps.h"
+#include "BenchmarkUtils.h"
+#include "../../test/src/Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t BrushCount = 3'000;
+        static constexpr size_t PrismSides = 8;
+        static constexpr size_t QueryCount = 1'000;
+
+        /**
+         * Creates octagonal prisms that are slightly smaller than their grid cells, so that the brushes don't share any
+         * vertices and the handle managers contain 16 handles per brush.
+         */
+        static std::vector<std::unique_ptr<Model::BrushNode>> makeBrushNodes() {
+            const Model::BrushBuilder builder(Model::MapFormat::Standard, BenchmarkMaps::worldBounds());
+
+            std::vector<std::unique_ptr<Model::BrushNode>> result;
+            result.reserve(BrushCount);
+            for (size_t i = 0; i < BrushCount; ++i) {
+                const auto bounds = BenchmarkMaps::cellBounds(i, BrushCount);
+                const auto center = bounds.center();
+                const auto radius = bounds.size().x() / 2.0 - 1.0;
+                const auto halfHeight = bounds.size().z() / 2.0 - 1.0;
+
+                std::vector<vm::vec3> points;
+                for (size_t j = 0; j < PrismSides; ++j) {
+                    const auto angle = 2.0 * vm::C::pi() * static_cast<FloatType>(j) / static_cast<FloatType>(PrismSides);
+                    const auto offset = vm::vec3(radius * std::cos(angle), radius * std::sin(angle), 0.0);
+                    points.push_back(center + offset - vm::vec3(0, 0, halfHeight));
+                    points.push_back(center + offset + vm::vec3(0, 0, halfHeight));
+                }
+
+                result.push_back(std::make_unique<Model::BrushNode>(builder.createBrush(points, "texture").value()));
+            }
+            return result;
+        }
+
+        TEST_CASE("VertexHandleManagerBenchmark.largeSelection", "[VertexHandleManagerBenchmark]") {
+            const auto brushNodes = makeBrushNodes();
+            const auto options = BenchmarkOptions::fromEnvironment(2, 10);
+            const auto suffix = " (" + std::to_string(BrushCount) + " brushes)";
+
+            VertexHandleManager handles;
+            runBenchmark("VertexHandleManager.addHandles" + suffix, options, [&]() {
+                handles.clear();
+            }, [&]() {
+                for (const auto& brushNode : brushNodes) {
+                    handles.addHandles(brushNode.get());
+                }
+            });
+            REQUIRE(handles.totalHandleCount() == BrushCount * 2u * PrismSides);
+
+            const auto allHandles = handles.allHandles();
+            std::vector<vm::vec3> queryHandles;
+            for (size_t i = 0; i < QueryCount; ++i) {
+                queryHandles.push_back(allHandles[(i * 7919u) % allHandles.size()]);
+            }
+
+            Renderer::PerspectiveCamera camera;
+            camera.moveTo(vm::vec3f(-2000.0f, -2000.0f, 2000.0f));
+            camera.lookAt(vm::vec3f::zero(), vm::vec3f::pos_z());
+
+            runBenchmark("VertexHandleManager.pick " + std::to_string(QueryCount) + " rays" + suffix, options, [&]() {
+                size_t hits = 0;
+                for (const auto& handle : queryHandles) {
+                    const auto origin = vm::vec3(camera.position());
+                    const auto pickRay = vm::ray3(origin, vm::normalize(handle - origin));
+
+                    auto pickResult = Model::PickResult::byDistance();
+                    handles.pick(pickRay, camera, pickResult);
+                    hits += pickResult.size();
+                }
+                CHECK(hits >= QueryCount);
+            });
+
+            runBenchmark("VertexHandleManager.select " + std::to_string(QueryCount) + " handles" + suffix, options, [&]() {
+                handles.deselectAll();
+            }, [&]() {
+                handles.select(std::begin(queryHandles), std::end(queryHandles));
+            });
+
+            runBenchmark("VertexHandleManager.findIncidentBrushes " + std::to_string(QueryCount) + " handles" + suffix, options, [&]() {
+                size_t incidentBrushes = 0;
+                for (const auto& handle : queryHandles) {
+                    incidentBrushes += handles.findIncidentBrushes(handle).size();
+                }
+                CHECK(incidentBrushes == QueryCount);
+            });
+
+            runBenchmark("VertexHandleManager.removeHandles" + suffix, options, [&]() {
+                handles.clear();
+                for (const auto& brushNode : brushNodes) {
+                    handles.addHandles(brushNode.get());
+                }
+            }, [&]() {
+                for (const auto& brushNode : brushNodes) {
+                    handles.removeHandles(brushNode.get());
+                }
+            });
+        }
+    }
+}
@@ -58,6 +58,16 @@ namespace TrenchBroom {
                 swap(lhs.m_asset, rhs.m_asset);
             }
 
+            /**
+             * Replaces the referenced asset without changing the usage counts of the previous and the new asset. The
+             * caller is responsible for adjusting them.
+             *
+             * @return the previously referenced asset
+             */
+            T* exchangeUncounted(T* asset) {
+                return std::exchange(m_asset, asset);
+            }
+
             T* get() {
                 return m_asset;
             }
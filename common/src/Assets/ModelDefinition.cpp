@@ -99,6 +99,10 @@ namespace TrenchBroom {
             return !(lhs == rhs);
         }
 
+        const EL::Expression& ModelDefinition::expression() const {
+            return m_expression;
+        }
+
         std::ostream& operator<<(std::ostream& str, const ModelDefinition& def) {
             str << "ModelDefinition{ " << def.m_expression << " }";
             return str;
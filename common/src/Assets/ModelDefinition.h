@@ -59,6 +59,8 @@ namespace TrenchBroom {
 
             void append(const ModelDefinition& other);
 
+            const EL::Expression& expression() const;
+
             /**
              * Evaluates the model expresion, using the given variable store to interpolate variables.
              *
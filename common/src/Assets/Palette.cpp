@@ -29,9 +29,15 @@
 
 #include <kdl/string_format.h>
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TB_PALETTE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace TrenchBroom {
     namespace Assets {
         struct PaletteData {
@@ -137,38 +143,103 @@ namespace TrenchBroom {
             const unsigned char* indexedImage = reinterpret_cast<const unsigned char*>(reader.begin() + reader.position());
             reader.seekForward(pixelCount); // throws ReaderException if there aren't pixelCount bytes available
 
-            // Write rgba pixels
-            unsigned char* const rgbaData = rgbaImage.data();
-            for (size_t i = 0; i < pixelCount; ++i) {
-                const int index = static_cast<int>(indexedImage[i]);
+            const auto stats = convertIndexedToRgba(paletteData, indexedImage, pixelCount, rgbaImage.data());
 
-                std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
-            }
+            averageColor = Color(static_cast<float>(stats.colorSum[0]) / (255.0f * static_cast<float>(pixelCount)),
+                                 static_cast<float>(stats.colorSum[1]) / (255.0f * static_cast<float>(pixelCount)),
+                                 static_cast<float>(stats.colorSum[2]) / (255.0f * static_cast<float>(pixelCount)),
+                                 1.0f);
 
-            // Check average color
-            uint32_t colorSum[3] = {0, 0, 0};
+            // only the transparent palette has an entry with an alpha value other than 0xFF
+            return transparency == PaletteTransparency::Index255Transparent && stats.alphaAnd != 0xFF;
+        }
+
+        IndexedToRgbaStats convertIndexedToRgbaScalar(const unsigned char* paletteTable, const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage) {
+            IndexedToRgbaStats stats{{0, 0, 0}, 0xFF};
             for (size_t i = 0; i < pixelCount; ++i) {
-                colorSum[0] += static_cast<uint32_t>(rgbaData[(i * 4) + 0]);
-                colorSum[1] += static_cast<uint32_t>(rgbaData[(i * 4) + 1]);
-                colorSum[2] += static_cast<uint32_t>(rgbaData[(i * 4) + 2]);
+                const unsigned char* color = &paletteTable[static_cast<size_t>(indexedImage[i]) * 4];
+                std::memcpy(rgbaImage + (i * 4), color, 4);
+
+                stats.colorSum[0] += color[0];
+                stats.colorSum[1] += color[1];
+                stats.colorSum[2] += color[2];
+                stats.alphaAnd &= color[3];
             }
-            averageColor = Color(static_cast<float>(colorSum[0]) / (255.0f * static_cast<float>(pixelCount)),
-                                 static_cast<float>(colorSum[1]) / (255.0f * static_cast<float>(pixelCount)),
-                                 static_cast<float>(colorSum[2]) / (255.0f * static_cast<float>(pixelCount)),
-                                 1.0f);
+            return stats;
+        }
 
-            // Check for transparency
-            bool hasTransparency = false;
-            if (transparency == PaletteTransparency::Index255Transparent) {
-                // Take the bitwise AND of the alpha channel of all pixels
-                unsigned char andAlpha = 0xff;
-                for (size_t i = 0; i < pixelCount; ++i) {
-                    andAlpha &= rgbaData[(i * 4) + 3];
+#ifdef TB_PALETTE_USE_SSE2
+        /**
+         * Converts a multiple of four pixels. Every 32 bit lane of the accumulators sums up the channels of every fourth
+         * pixel. The lanes are flushed into the 64 bit sums after each block so that they cannot overflow.
+         */
+        static void convertIndexedToRgbaSSE2(const unsigned char* paletteTable, const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage, IndexedToRgbaStats& stats) {
+            assert(pixelCount % 4 == 0);
+
+            // 2^16 iterations add at most 2^16 * 255 to each lane
+            constexpr size_t BlockSize = 4 * (1u << 16);
+
+            const __m128i channelMask = _mm_set1_epi32(0xFF);
+            __m128i alphaAnd = _mm_set1_epi32(-1);
+
+            for (size_t blockStart = 0; blockStart < pixelCount; blockStart += BlockSize) {
+                const size_t blockEnd = std::min(blockStart + BlockSize, pixelCount);
+
+                __m128i redSum = _mm_setzero_si128();
+                __m128i greenSum = _mm_setzero_si128();
+                __m128i blueSum = _mm_setzero_si128();
+
+                for (size_t i = blockStart; i < blockEnd; i += 4) {
+                    // there is no byte gather in SSE2, so the palette lookups are scalar loads
+                    int32_t colors[4];
+                    std::memcpy(&colors[0], &paletteTable[static_cast<size_t>(indexedImage[i + 0]) * 4], 4);
+                    std::memcpy(&colors[1], &paletteTable[static_cast<size_t>(indexedImage[i + 1]) * 4], 4);
+                    std::memcpy(&colors[2], &paletteTable[static_cast<size_t>(indexedImage[i + 2]) * 4], 4);
+                    std::memcpy(&colors[3], &paletteTable[static_cast<size_t>(indexedImage[i + 3]) * 4], 4);
+
+                    const __m128i pixels = _mm_set_epi32(colors[3], colors[2], colors[1], colors[0]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgbaImage + (i * 4)), pixels);
+
+                    redSum = _mm_add_epi32(redSum, _mm_and_si128(pixels, channelMask));
+                    greenSum = _mm_add_epi32(greenSum, _mm_and_si128(_mm_srli_epi32(pixels, 8), channelMask));
+                    blueSum = _mm_add_epi32(blueSum, _mm_and_si128(_mm_srli_epi32(pixels, 16), channelMask));
+                    alphaAnd = _mm_and_si128(alphaAnd, pixels);
                 }
-                hasTransparency = (andAlpha != 0xff);
+
+                uint32_t lanes[3][4];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[0]), redSum);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[1]), greenSum);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[2]), blueSum);
+                for (size_t c = 0; c < 3; ++c) {
+                    stats.colorSum[c] += uint64_t(lanes[c][0]) + uint64_t(lanes[c][1]) + uint64_t(lanes[c][2]) + uint64_t(lanes[c][3]);
+                }
+            }
+
+            uint32_t alphaLanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(alphaLanes), alphaAnd);
+            for (size_t i = 0; i < 4; ++i) {
+                stats.alphaAnd &= static_cast<unsigned char>(alphaLanes[i] >> 24);
+            }
+        }
+#endif
+
+        IndexedToRgbaStats convertIndexedToRgba(const unsigned char* paletteTable, const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage) {
+#ifdef TB_PALETTE_USE_SSE2
+            IndexedToRgbaStats stats{{0, 0, 0}, 0xFF};
+
+            const size_t vectorCount = pixelCount - pixelCount % 4;
+            convertIndexedToRgbaSSE2(paletteTable, indexedImage, vectorCount, rgbaImage, stats);
+
+            const auto tailStats = convertIndexedToRgbaScalar(paletteTable, indexedImage + vectorCount, pixelCount - vectorCount, rgbaImage + (vectorCount * 4));
+            for (size_t c = 0; c < 3; ++c) {
+                stats.colorSum[c] += tailStats.colorSum[c];
             }
+            stats.alphaAnd &= tailStats.alphaAnd;
 
-            return hasTransparency;
+            return stats;
+#else
+            return convertIndexedToRgbaScalar(paletteTable, indexedImage, pixelCount, rgbaImage);
+#endif
         }
     }
 }
@@ -23,6 +23,7 @@
 #include "IO/Reader.h"
 
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -41,6 +42,32 @@ namespace TrenchBroom {
             Opaque, Index255Transparent
         };
 
+        /**
+         * Statistics that are gathered while converting an indexed image to RGBA.
+         */
+        struct IndexedToRgbaStats {
+            /** The sums of the red, green and blue channels of all converted pixels. */
+            uint64_t colorSum[3];
+            /** The bitwise AND of the alpha channels of all converted pixels. */
+            unsigned char alphaAnd;
+        };
+
+        /**
+         * Converts `pixelCount` palette indices to RGBA pixels and gathers the channel sums and the combined alpha of
+         * the converted pixels in the same pass over the image. Uses SSE2 where available.
+         *
+         * @param paletteTable 1024 bytes, the RGBA color of every palette index
+         * @param indexedImage the palette indices, must contain `pixelCount` bytes
+         * @param pixelCount the number of pixels to convert
+         * @param rgbaImage the destination buffer, must contain `pixelCount` * 4 bytes
+         */
+        IndexedToRgbaStats convertIndexedToRgba(const unsigned char* paletteTable, const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage);
+
+        /**
+         * Scalar implementation of `convertIndexedToRgba`, used as the reference for the vectorized implementation.
+         */
+        IndexedToRgbaStats convertIndexedToRgbaScalar(const unsigned char* paletteTable, const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage);
+
         class Palette {
         private:
             std::shared_ptr<PaletteData> m_data;
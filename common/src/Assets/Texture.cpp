@@ -38,6 +38,8 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_cachedTagMask(0),
+        m_cachedTagRevision(0),
         m_textureId(0) {
             assert(m_width > 0);
             assert(m_height > 0);
@@ -56,6 +58,8 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_cachedTagMask(0),
+        m_cachedTagRevision(0),
         m_textureId(0),
         m_buffers(std::move(buffers)) {
             assert(m_width > 0);
@@ -81,6 +85,8 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_cachedTagMask(0),
+        m_cachedTagRevision(0),
         m_textureId(0) {}
 
         Texture::~Texture() = default;
@@ -139,6 +145,8 @@ namespace TrenchBroom {
 
         void Texture::setSurfaceParms(const std::set<std::string>& surfaceParms) {
             m_surfaceParms = surfaceParms;
+            // smart tags can match surface parameters
+            m_cachedTagRevision = 0;
         }
 
         TextureCulling Texture::culling() const {
@@ -172,6 +180,11 @@ namespace TrenchBroom {
             --m_usageCount;
         }
 
+        void Texture::addUsageCount(const std::ptrdiff_t delta) {
+            assert(delta >= 0 || m_usageCount >= static_cast<size_t>(-delta));
+            m_usageCount = static_cast<size_t>(static_cast<std::ptrdiff_t>(m_usageCount) + delta);
+        }
+
         bool Texture::overridden() const {
             return m_overridden;
         }
@@ -180,6 +193,18 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
 
+        std::optional<uint64_t> Texture::cachedTagMask(const size_t revision) const {
+            if (revision == 0 || revision != m_cachedTagRevision) {
+                return std::nullopt;
+            }
+            return m_cachedTagMask;
+        }
+
+        void Texture::setCachedTagMask(const size_t revision, const uint64_t tagMask) const {
+            m_cachedTagMask = tagMask;
+            m_cachedTagRevision = revision;
+        }
+
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
@@ -315,5 +340,30 @@ namespace TrenchBroom {
         TextureType Texture::type() const {
             return m_type;
         }
+
+        void TextureUsageCounts::inc(Texture* texture) {
+            if (texture != nullptr) {
+                ++m_deltas[texture];
+            }
+        }
+
+        void TextureUsageCounts::dec(Texture* texture) {
+            if (texture != nullptr) {
+                --m_deltas[texture];
+            }
+        }
+
+        void TextureUsageCounts::merge(const TextureUsageCounts& other) {
+            for (const auto& [texture, delta] : other.m_deltas) {
+                m_deltas[texture] += delta;
+            }
+        }
+
+        void TextureUsageCounts::apply() {
+            for (const auto& [texture, delta] : m_deltas) {
+                texture->addUsageCount(delta);
+            }
+            m_deltas.clear();
+        }
     }
 }
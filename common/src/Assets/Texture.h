@@ -26,8 +26,12 @@
 
 #include <vecmath/forward.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -99,6 +103,10 @@ namespace TrenchBroom {
             // Quake 3 blend function, move to materials
             TextureBlendFunc m_blendFunc;
 
+            // the smart tags that match this texture, cached by Model::TagManager
+            mutable uint64_t m_cachedTagMask;
+            mutable size_t m_cachedTagRevision;
+
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
         public:
@@ -153,9 +161,17 @@ namespace TrenchBroom {
             size_t usageCount() const;
             void incUsageCount();
             void decUsageCount();
+            void addUsageCount(std::ptrdiff_t delta);
             bool overridden() const;
             void setOverridden(bool overridden);
 
+            /**
+             * Returns the mask of the smart tags that match this texture if it was cached for the given revision of a
+             * tag manager, and nothing otherwise. Revision 0 is never valid.
+             */
+            std::optional<uint64_t> cachedTagMask(size_t revision) const;
+            void setCachedTagMask(size_t revision, uint64_t tagMask) const;
+
             bool isPrepared() const;
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
@@ -174,6 +190,26 @@ namespace TrenchBroom {
             GLenum format() const;
             TextureType type() const;
         };
+
+        /**
+         * Accumulates changes to the usage counts of textures. This allows to bind textures to faces on several
+         * threads: every thread records its changes in its own instance, and the instances are merged and applied on
+         * a single thread afterwards.
+         */
+        class TextureUsageCounts {
+        private:
+            std::unordered_map<Texture*, std::ptrdiff_t> m_deltas;
+        public:
+            void inc(Texture* texture);
+            void dec(Texture* texture);
+
+            void merge(const TextureUsageCounts& other);
+
+            /**
+             * Adds the accumulated changes to the usage counts of the textures and resets this instance.
+             */
+            void apply();
+        };
     }
 }
 
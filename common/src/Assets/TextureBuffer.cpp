@@ -26,6 +26,8 @@
 #include <FreeImage.h>
 
 #include <algorithm> // for std::max
+#include <cmath>
+#include <cstdint>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -83,6 +85,90 @@ namespace TrenchBroom {
             }
         }
 
+        size_t fullMipLevelCount(const size_t width, const size_t height) {
+            size_t result = 1;
+            for (size_t size = std::max(width, height); size > 1; size >>= 1) {
+                ++result;
+            }
+            return result;
+        }
+
+        namespace {
+            /**
+             * Lookup tables to convert between 8 bit sRGB values and 16 bit linear values. The linear to sRGB table
+             * is indexed with the upper 12 bits of a linear value, which is more precise than 8 bit sRGB everywhere.
+             */
+            struct GammaTables {
+                uint16_t toLinear[256];
+                uint8_t toSrgb[4096];
+
+                GammaTables() {
+                    for (size_t i = 0; i < 256; ++i) {
+                        const auto srgb = static_cast<double>(i) / 255.0;
+                        const auto linear = srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+                        toLinear[i] = static_cast<uint16_t>(std::round(linear * 65535.0));
+                    }
+                    for (size_t i = 0; i < 4096; ++i) {
+                        // the center of the range of linear values that map to this entry
+                        const auto linear = (static_cast<double>(i) + 0.5) / 4096.0;
+                        const auto srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+                        toSrgb[i] = static_cast<uint8_t>(std::round(std::clamp(srgb, 0.0, 1.0) * 255.0));
+                    }
+                }
+            };
+        }
+
+        static const GammaTables& gammaTables() {
+            static const GammaTables tables;
+            return tables;
+        }
+
+        static void generateMipLevel(const unsigned char* src, const size_t srcWidth, const size_t srcHeight, unsigned char* dest, const size_t destWidth, const size_t destHeight, const size_t bytesPerPixel) {
+            const auto& tables = gammaTables();
+            const size_t colorChannels = std::min(bytesPerPixel, size_t(3));
+
+            for (size_t y = 0; y < destHeight; ++y) {
+                // a dimension that is already 1 is not halved, so both samples come from the same row or column
+                const auto* row0 = src + std::min(2 * y, srcHeight - 1) * srcWidth * bytesPerPixel;
+                const auto* row1 = src + std::min(2 * y + 1, srcHeight - 1) * srcWidth * bytesPerPixel;
+
+                for (size_t x = 0; x < destWidth; ++x) {
+                    const size_t offset0 = std::min(2 * x, srcWidth - 1) * bytesPerPixel;
+                    const size_t offset1 = std::min(2 * x + 1, srcWidth - 1) * bytesPerPixel;
+                    auto* texel = dest + (y * destWidth + x) * bytesPerPixel;
+
+                    for (size_t c = 0; c < colorChannels; ++c) {
+                        const uint32_t sum =
+                            uint32_t(tables.toLinear[row0[offset0 + c]]) + uint32_t(tables.toLinear[row0[offset1 + c]]) +
+                            uint32_t(tables.toLinear[row1[offset0 + c]]) + uint32_t(tables.toLinear[row1[offset1 + c]]);
+                        texel[c] = tables.toSrgb[((sum + 2) / 4) >> 4];
+                    }
+                    for (size_t c = colorChannels; c < bytesPerPixel; ++c) {
+                        const uint32_t sum =
+                            uint32_t(row0[offset0 + c]) + uint32_t(row0[offset1 + c]) +
+                            uint32_t(row1[offset0 + c]) + uint32_t(row1[offset1 + c]);
+                        texel[c] = static_cast<unsigned char>((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+
+        void generateMipmaps(TextureBufferList& buffers, const size_t mipLevels, const size_t width, const size_t height, const GLenum format) {
+            ensure(!buffers.empty(), "level 0 must be present");
+
+            const size_t bytesPerPixel = bytesPerPixelForFormat(format);
+            assert(buffers[0].size() >= bytesPerPixel * width * height);
+
+            buffers.resize(mipLevels);
+            for (size_t level = 1u; level < buffers.size(); ++level) {
+                const auto srcSize = sizeAtMipLevel(width, height, level - 1);
+                const auto destSize = sizeAtMipLevel(width, height, level);
+                buffers[level] = TextureBuffer(bytesPerPixel * destSize.x() * destSize.y());
+
+                generateMipLevel(buffers[level - 1].data(), srcSize.x(), srcSize.y(), buffers[level].data(), destSize.x(), destSize.y(), bytesPerPixel);
+            }
+        }
+
         void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize) {
             if (oldSize == newSize)
                 return;
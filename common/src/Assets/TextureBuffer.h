@@ -47,6 +47,21 @@ namespace TrenchBroom {
         size_t bytesPerPixelForFormat(GLenum format);
         void setMipBufferSize(TextureBufferList& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
+        /**
+         * Returns the number of mip levels of a full mip chain for an image of the given size, down to 1x1.
+         */
+        size_t fullMipLevelCount(size_t width, size_t height);
+
+        /**
+         * Computes mip levels 1 to `mipLevels - 1` from level 0 of the given buffers. Each texel of a level is the
+         * average of a 2x2 box of the previous level. The color channels are averaged in linear space and converted
+         * back to sRGB, the alpha channel is averaged as is.
+         *
+         * The given buffers must contain at least level 0 of an image with the given size and format. They are
+         * resized to `mipLevels` levels.
+         */
+        void generateMipmaps(TextureBufferList& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
+
         void resizeMips(TextureBufferList& buffers, const vm::vec2s& oldSize, const vm::vec2s& newSize);
     }
 }
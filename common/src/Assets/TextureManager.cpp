@@ -25,8 +25,7 @@
 #include "Assets/TextureCollection.h"
 #include "IO/TextureLoader.h"
 
-#include <kdl/map_utils.h>
-#include <kdl/string_format.h>
+#include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
@@ -104,6 +103,12 @@ namespace TrenchBroom {
             updateTextures();
         }
 
+        std::vector<TextureCollection> TextureManager::releaseCollections() {
+            auto result = std::move(m_collections);
+            clear();
+            return result;
+        }
+
         void TextureManager::addTextureCollection(Assets::TextureCollection collection) {
             const auto index = m_collections.size();
             m_collections.push_back(std::move(collection));
@@ -138,7 +143,7 @@ namespace TrenchBroom {
         }
 
         const Texture* TextureManager::texture(const std::string& name) const {
-            auto it = m_texturesByName.find(kdl::str_to_lower(name));
+            auto it = m_texturesByName.find(name);
             if (it == std::end(m_texturesByName)) {
                 return nullptr;
             } else {
@@ -181,20 +186,27 @@ namespace TrenchBroom {
 
             for (auto& collection : m_collections) {
                 for (auto& texture : collection.textures()) {
-                    const auto key = kdl::str_to_lower(texture.name());
                     texture.setOverridden(false);
 
-                    auto mIt = m_texturesByName.find(key);
+                    auto mIt = m_texturesByName.find(texture.name());
                     if (mIt != std::end(m_texturesByName)) {
                         mIt->second->setOverridden(true);
                         mIt->second = &texture;
                     } else {
-                        m_texturesByName.insert(std::make_pair(key, &texture));
+                        m_texturesByName.insert(std::make_pair(texture.name(), &texture));
                     }
                 }
             }
 
-            m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto* t) { return const_cast<const Texture*>(t); });
+            m_textures.reserve(m_texturesByName.size());
+            for (const auto& entry : m_texturesByName) {
+                m_textures.push_back(entry.second);
+            }
+
+            // the texture map is unordered, but the textures are expected to be sorted by name
+            std::sort(std::begin(m_textures), std::end(m_textures), [](const Texture* lhs, const Texture* rhs) {
+                return kdl::ci::string_less()(lhs->name(), rhs->name());
+            });
         }
     }
 }
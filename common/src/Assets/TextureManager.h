@@ -21,8 +21,10 @@
 
 #include "Assets/TextureCollection.h"
 
-#include <map>
+#include <kdl/string_compare.h>
+
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -39,7 +41,11 @@ namespace TrenchBroom {
 
         class TextureManager {
         private:
-            using TextureMap = std::map<std::string, Texture*>;
+            /**
+             * Texture names are case insensitive. The map hashes and compares its keys without case sensitivity, so
+             * that lookups don't need to convert the name to lower case first.
+             */
+            using TextureMap = std::unordered_map<std::string, Texture*, kdl::ci::string_hash, kdl::ci::string_equal>;
 
             Logger& m_logger;
 
@@ -60,6 +66,12 @@ namespace TrenchBroom {
 
             void setTextureCollections(const std::vector<IO::Path>& paths, IO::TextureLoader& loader);
             void setTextureCollections(std::vector<TextureCollection> collections);
+
+            /**
+             * Removes all texture collections from this manager and returns them, e.g. to transfer texture collections
+             * that were loaded into a separate manager on another thread.
+             */
+            std::vector<TextureCollection> releaseCollections();
         private:
             void addTextureCollection(Assets::TextureCollection collection);
         public:
@@ -68,6 +80,11 @@ namespace TrenchBroom {
             void setTextureMode(int minFilter, int magFilter);
             void commitChanges();
 
+            /**
+             * Returns the texture with the given name, ignoring case, or nullptr if no such texture exists. The const
+             * overload only reads the texture index, so it can be called from several threads as long as the texture
+             * collections are not modified concurrently.
+             */
             const Texture* texture(const std::string& name) const;
             Texture* texture(const std::string& name);
             
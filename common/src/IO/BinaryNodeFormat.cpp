@@ -0,0 +1,776 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryNodeFormat.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/IdType.h"
+#include "Model/Layer.h"
+#include "Model/LayerNode.h"
+#include "Model/LockState.h"
+#include "Model/MapFormat.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/PatchNode.h"
+#include "Model/VisibilityState.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/overload.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/mat.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace BinaryNodeFormat {
+            static const char Magic[] = { 'T', 'B', 'N', 'D' };
+            /** Must be incremented whenever the format changes. */
+            static constexpr uint32_t Version = 2;
+
+            enum class NodeKind : uint8_t {
+                Layer,
+                Group,
+                Entity,
+                Brush,
+                Patch
+            };
+
+            enum class TexCoordSystemKind : uint8_t {
+                Paraxial,
+                Parallel
+            };
+
+            class NodeDataWriter {
+            private:
+                std::string m_buffer;
+            public:
+                std::string takeBuffer() {
+                    return std::move(m_buffer);
+                }
+
+                template <typename T>
+                void write(const T value) {
+                    char bytes[sizeof(T)];
+                    std::memcpy(bytes, &value, sizeof(T));
+                    m_buffer.append(bytes, sizeof(T));
+                }
+
+                template <typename T, size_t S>
+                void writeVec(const vm::vec<T,S>& vec) {
+                    for (size_t i = 0; i < S; ++i) {
+                        write(vec[i]);
+                    }
+                }
+
+                void writeString(const std::string& str) {
+                    write(static_cast<uint32_t>(str.size()));
+                    m_buffer.append(str);
+                }
+            };
+
+            static std::string readNodeDataString(Reader& reader) {
+                const auto size = reader.readSize<uint32_t>();
+                return reader.readString(size);
+            }
+
+            /**
+             * Reads an element count and checks that the remaining data can hold that many elements of at least the
+             * given size, so that corrupted counts do not lead to huge allocations.
+             */
+            static size_t readElementCount(Reader& reader, const size_t minElementSize) {
+                const auto count = reader.readSize<uint32_t>();
+                if (!reader.canRead(count * minElementSize)) {
+                    throw ReaderException("Element count exceeds remaining data");
+                }
+                return count;
+            }
+
+            static void writeHeader(NodeDataWriter& writer, const Model::MapFormat mapFormat, const vm::bbox3& worldBounds) {
+                for (const char c : Magic) {
+                    writer.write(c);
+                }
+                writer.write(Version);
+                writer.write(static_cast<int32_t>(mapFormat));
+                writer.writeVec(worldBounds.min);
+                writer.writeVec(worldBounds.max);
+            }
+
+            /**
+             * Reads the header and returns the map format recorded in it, or nullopt if the header is invalid or if the
+             * recorded world bounds differ from the given world bounds.
+             */
+            static std::optional<Model::MapFormat> readHeader(Reader& reader, const vm::bbox3& worldBounds) {
+                if (!reader.canRead(sizeof(Magic))) {
+                    return std::nullopt;
+                }
+
+                char magic[sizeof(Magic)];
+                reader.read(magic, sizeof(magic));
+                if (std::memcmp(magic, Magic, sizeof(Magic)) != 0 || reader.readUnsignedInt<uint32_t>() != Version) {
+                    return std::nullopt;
+                }
+
+                const auto mapFormat = static_cast<Model::MapFormat>(reader.readInt<int32_t>());
+                const auto min = reader.readVec<FloatType, 3>();
+                const auto max = reader.readVec<FloatType, 3>();
+                if (vm::bbox3(min, max) != worldBounds) {
+                    return std::nullopt;
+                }
+                return mapFormat;
+            }
+
+            static void writeFilePosition(NodeDataWriter& writer, const size_t lineNumber, const size_t lineCount) {
+                writer.write(static_cast<uint64_t>(lineNumber));
+                writer.write(static_cast<uint64_t>(lineCount));
+            }
+
+            static void writeBrushFace(NodeDataWriter& writer, const Model::BrushFace& face, const std::unordered_map<const Model::BrushVertex*, uint32_t>& vertexIndices) {
+                writeFilePosition(writer, face.lineNumber(), face.lineCount());
+                for (const auto& point : face.points()) {
+                    writer.writeVec(point);
+                }
+                writer.writeVec(face.boundary().normal);
+                writer.write(face.boundary().distance);
+
+                const auto& attributes = face.attributes();
+                writer.writeString(attributes.textureName());
+                writer.writeVec(attributes.offset());
+                writer.writeVec(attributes.scale());
+                writer.write(attributes.rotation());
+                writer.write(static_cast<int32_t>(attributes.surfaceContents()));
+                writer.write(static_cast<int32_t>(attributes.surfaceFlags()));
+                writer.write(attributes.surfaceValue());
+                writer.write(attributes.color().r());
+                writer.write(attributes.color().g());
+                writer.write(attributes.color().b());
+                writer.write(attributes.color().a());
+
+                // paraxial texture coordinate systems are fully determined by the face points and attributes
+                if (dynamic_cast<const Model::ParallelTexCoordSystem*>(&face.texCoordSystem()) != nullptr) {
+                    writer.write(static_cast<uint8_t>(TexCoordSystemKind::Parallel));
+                    writer.writeVec(face.textureXAxis());
+                    writer.writeVec(face.textureYAxis());
+                } else {
+                    writer.write(static_cast<uint8_t>(TexCoordSystemKind::Paraxial));
+                }
+
+                const auto faceVertices = face.vertices();
+                writer.write(static_cast<uint32_t>(face.vertexCount()));
+                for (const Model::BrushVertex* vertex : faceVertices) {
+                    writer.write(vertexIndices.at(vertex));
+                }
+            }
+
+            static void writeBrushNode(NodeDataWriter& writer, const Model::BrushNode& brushNode) {
+                const auto& brush = brushNode.brush();
+
+                auto vertexIndices = std::unordered_map<const Model::BrushVertex*, uint32_t>{};
+                vertexIndices.reserve(brush.vertexCount());
+
+                writer.write(static_cast<uint8_t>(NodeKind::Brush));
+                writeFilePosition(writer, brushNode.lineNumber(), brushNode.lineCount());
+                writer.write(static_cast<uint32_t>(brush.vertexCount()));
+                for (const Model::BrushVertex* vertex : brush.vertices()) {
+                    vertexIndices.emplace(vertex, static_cast<uint32_t>(vertexIndices.size()));
+                    writer.writeVec(vertex->position());
+                }
+
+                writer.write(static_cast<uint32_t>(brush.faceCount()));
+                for (const auto& face : brush.faces()) {
+                    writeBrushFace(writer, face, vertexIndices);
+                }
+            }
+
+            static void writePatchNode(NodeDataWriter& writer, const Model::PatchNode& patchNode) {
+                const auto& patch = patchNode.patch();
+
+                writer.write(static_cast<uint8_t>(NodeKind::Patch));
+                writeFilePosition(writer, patchNode.lineNumber(), patchNode.lineCount());
+                writer.write(static_cast<uint32_t>(patch.pointRowCount()));
+                writer.write(static_cast<uint32_t>(patch.pointColumnCount()));
+                for (const auto& controlPoint : patch.controlPoints()) {
+                    writer.writeVec(controlPoint);
+                }
+                writer.writeString(patch.textureName());
+            }
+
+            static void writeChildNodes(NodeDataWriter& writer, const std::vector<Model::Node*>& children);
+
+            static void writeEntity(NodeDataWriter& writer, const Model::Entity& entity) {
+                writer.write(static_cast<uint32_t>(entity.properties().size()));
+                for (const auto& property : entity.properties()) {
+                    writer.writeString(property.key());
+                    writer.writeString(property.value());
+                }
+                writer.write(static_cast<uint32_t>(entity.protectedProperties().size()));
+                for (const auto& key : entity.protectedProperties()) {
+                    writer.writeString(key);
+                }
+            }
+
+            static void writeEntityNode(NodeDataWriter& writer, const Model::EntityNode& entityNode, const std::vector<Model::Node*>& children) {
+                writer.write(static_cast<uint8_t>(NodeKind::Entity));
+                writeFilePosition(writer, entityNode.lineNumber(), entityNode.lineCount());
+                writeEntity(writer, entityNode.entity());
+                writeChildNodes(writer, children);
+            }
+
+            static void writeGroupNode(NodeDataWriter& writer, const Model::GroupNode& groupNode) {
+                const auto& group = groupNode.group();
+
+                writer.write(static_cast<uint8_t>(NodeKind::Group));
+                writeFilePosition(writer, groupNode.lineNumber(), groupNode.lineCount());
+                writer.writeString(group.name());
+
+                const auto& persistentId = groupNode.persistentId();
+                writer.write(static_cast<uint8_t>(persistentId.has_value()));
+                writer.write(static_cast<uint64_t>(persistentId.value_or(0u)));
+
+                const auto linkedGroupId = group.linkedGroupId();
+                writer.write(static_cast<uint8_t>(linkedGroupId.has_value()));
+                writer.writeString(linkedGroupId.value_or(""));
+
+                const auto& transformation = group.transformation();
+                for (size_t i = 0; i < 4; ++i) {
+                    writer.writeVec(transformation[i]);
+                }
+
+                writeChildNodes(writer, groupNode.children());
+            }
+
+            static void writeLayerNode(NodeDataWriter& writer, const Model::LayerNode& layerNode) {
+                const auto& layer = layerNode.layer();
+
+                writer.write(static_cast<uint8_t>(NodeKind::Layer));
+                writeFilePosition(writer, layerNode.lineNumber(), layerNode.lineCount());
+                writer.writeString(layer.name());
+
+                writer.write(static_cast<uint8_t>(layer.hasSortIndex()));
+                writer.write(static_cast<int32_t>(layer.sortIndex()));
+
+                const auto& color = layer.color();
+                writer.write(static_cast<uint8_t>(color.has_value()));
+                const auto colorValue = color.value_or(Color());
+                writer.write(colorValue.r());
+                writer.write(colorValue.g());
+                writer.write(colorValue.b());
+                writer.write(colorValue.a());
+
+                writer.write(static_cast<uint8_t>(layer.omitFromExport()));
+
+                const auto& persistentId = layerNode.persistentId();
+                writer.write(static_cast<uint8_t>(persistentId.has_value()));
+                writer.write(static_cast<uint64_t>(persistentId.value_or(0u)));
+
+                writer.write(static_cast<uint8_t>(layerNode.lockState()));
+                writer.write(static_cast<uint8_t>(layerNode.visibilityState()));
+
+                writeChildNodes(writer, layerNode.children());
+            }
+
+            static void writeChildNodes(NodeDataWriter& writer, const std::vector<Model::Node*>& children) {
+                writer.write(static_cast<uint32_t>(children.size()));
+                for (const auto* child : children) {
+                    child->accept(kdl::overload(
+                        [] (const Model::WorldNode*) {},
+                        [] (const Model::LayerNode*) {},
+                        [&](const Model::GroupNode* groupNode) {
+                            writeGroupNode(writer, *groupNode);
+                        },
+                        [&](const Model::EntityNode* entityNode) {
+                            writeEntityNode(writer, *entityNode, entityNode->children());
+                        },
+                        [&](const Model::BrushNode* brushNode) {
+                            writeBrushNode(writer, *brushNode);
+                        },
+                        [&](const Model::PatchNode* patchNode) {
+                            writePatchNode(writer, *patchNode);
+                        }
+                    ));
+                }
+            }
+
+            std::string writeNodes(const std::vector<Model::Node*>& nodes, const Model::MapFormat mapFormat, const vm::bbox3& worldBounds) {
+                // Assort nodes like NodeWriter::writeNodes does, but keep the entities of selected entity brushes in
+                // the order in which they are encountered.
+                auto worldBrushes = std::vector<const Model::BrushNode*>{};
+                auto brushEntities = std::vector<const Model::EntityNode*>{};
+                auto entityBrushes = std::unordered_map<const Model::EntityNode*, std::vector<Model::Node*>>{};
+                auto groups = std::vector<const Model::GroupNode*>{};
+                auto entities = std::vector<const Model::EntityNode*>{};
+
+                for (auto* node : nodes) {
+                    node->accept(kdl::overload(
+                        [] (Model::WorldNode*) {},
+                        [] (Model::LayerNode*) {},
+                        [&](Model::GroupNode* groupNode) { groups.push_back(groupNode); },
+                        [&](Model::EntityNode* entityNode) { entities.push_back(entityNode); },
+                        [&](Model::BrushNode* brushNode) {
+                            if (const auto* entityNode = dynamic_cast<const Model::EntityNode*>(brushNode->parent())) {
+                                auto& brushes = entityBrushes[entityNode];
+                                if (brushes.empty()) {
+                                    brushEntities.push_back(entityNode);
+                                }
+                                brushes.push_back(brushNode);
+                            } else {
+                                worldBrushes.push_back(brushNode);
+                            }
+                        },
+                        [] (Model::PatchNode*) {}
+                    ));
+                }
+
+                auto writer = NodeDataWriter{};
+                writeHeader(writer, mapFormat, worldBounds);
+
+                writer.write(static_cast<uint32_t>(worldBrushes.size() + brushEntities.size() + groups.size() + entities.size()));
+                for (const auto* brushNode : worldBrushes) {
+                    writeBrushNode(writer, *brushNode);
+                }
+                for (const auto* entityNode : brushEntities) {
+                    writeEntityNode(writer, *entityNode, entityBrushes[entityNode]);
+                }
+                for (const auto* groupNode : groups) {
+                    writeGroupNode(writer, *groupNode);
+                }
+                for (const auto* entityNode : entities) {
+                    writeEntityNode(writer, *entityNode, entityNode->children());
+                }
+
+                return writer.takeBuffer();
+            }
+
+            std::string writeWorld(const Model::WorldNode& worldNode, const vm::bbox3& worldBounds) {
+                auto writer = NodeDataWriter{};
+                writeHeader(writer, worldNode.mapFormat(), worldBounds);
+
+                writeFilePosition(writer, worldNode.lineNumber(), worldNode.lineCount());
+                writeEntity(writer, worldNode.entity());
+                writeLayerNode(writer, *worldNode.defaultLayer());
+
+                const auto customLayers = worldNode.customLayers();
+                writer.write(static_cast<uint32_t>(customLayers.size()));
+                for (const auto* layerNode : customLayers) {
+                    writeLayerNode(writer, *layerNode);
+                }
+
+                return writer.takeBuffer();
+            }
+
+            static Model::BrushFaceAttributes readBrushFaceAttributes(Reader& reader) {
+                auto attributes = Model::BrushFaceAttributes{readNodeDataString(reader)};
+                attributes.setOffset(reader.readVec<float, 2>());
+                attributes.setScale(reader.readVec<float, 2>());
+                attributes.setRotation(reader.readFloat<float>());
+                attributes.setSurfaceContents(reader.readInt<int32_t>());
+                attributes.setSurfaceFlags(reader.readInt<int32_t>());
+                attributes.setSurfaceValue(reader.readFloat<float>());
+
+                const auto r = reader.readFloat<float>();
+                const auto g = reader.readFloat<float>();
+                const auto b = reader.readFloat<float>();
+                const auto a = reader.readFloat<float>();
+                attributes.setColor(Color(r, g, b, a));
+
+                return attributes;
+            }
+
+            /**
+             * Checks that the given faces form a closed surface in which every vertex is used, i.e. every directed edge
+             * occurs exactly once and so does its reverse.
+             */
+            static bool isClosedSurface(const size_t vertexCount, const std::vector<std::vector<size_t>>& faceVertexIndices) {
+                auto usedVertices = std::vector<bool>(vertexCount, false);
+                auto halfEdges = std::unordered_set<size_t>{};
+                for (const auto& vertexIndices : faceVertexIndices) {
+                    for (size_t i = 0; i < vertexIndices.size(); ++i) {
+                        const auto origin = vertexIndices[i];
+                        const auto destination = vertexIndices[(i + 1u) % vertexIndices.size()];
+                        if (origin == destination || !halfEdges.insert(origin * vertexCount + destination).second) {
+                            return false;
+                        }
+                        usedVertices[origin] = true;
+                    }
+                }
+
+                for (const auto halfEdge : halfEdges) {
+                    const auto origin = halfEdge / vertexCount;
+                    const auto destination = halfEdge % vertexCount;
+                    if (halfEdges.count(destination * vertexCount + origin) == 0u) {
+                        return false;
+                    }
+                }
+
+                return std::all_of(std::begin(usedVertices), std::end(usedVertices), [](const bool used) { return used; });
+            }
+
+            /**
+             * Checks that every vertex lies on the planes of its faces and that no vertex lies above any face plane,
+             * i.e. that the given surface is convex and agrees with the face planes.
+             */
+            static bool isConvexSurface(const std::vector<vm::vec3>& positions, const std::vector<std::vector<size_t>>& faceVertexIndices, const std::vector<vm::plane3>& facePlanes) {
+                const auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+                for (size_t i = 0; i < facePlanes.size(); ++i) {
+                    const auto& plane = facePlanes[i];
+                    for (const auto vertexIndex : faceVertexIndices[i]) {
+                        if (plane.point_status(positions[vertexIndex], epsilon) != vm::plane_status::inside) {
+                            return false;
+                        }
+                    }
+                    for (const auto& position : positions) {
+                        if (plane.point_status(position, epsilon) == vm::plane_status::above) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            static std::unique_ptr<Model::BrushNode> readBrushNode(Reader& reader) {
+                const auto vertexCount = readElementCount(reader, 3u * sizeof(FloatType));
+                auto positions = std::vector<vm::vec3>{};
+                positions.reserve(vertexCount);
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    positions.push_back(reader.readVec<FloatType, 3>());
+                }
+
+                const auto faceCount = readElementCount(reader, 13u * sizeof(FloatType));
+                auto faces = std::vector<Model::BrushFace>{};
+                auto faceVertexIndices = std::vector<std::vector<size_t>>{};
+                auto facePlanes = std::vector<vm::plane3>{};
+                faces.reserve(faceCount);
+                faceVertexIndices.reserve(faceCount);
+                facePlanes.reserve(faceCount);
+
+                for (size_t i = 0; i < faceCount; ++i) {
+                    const auto lineNumber = reader.readSize<uint64_t>();
+                    const auto lineCount = reader.readSize<uint64_t>();
+                    const auto points = Model::BrushFace::Points{{
+                        reader.readVec<FloatType, 3>(),
+                        reader.readVec<FloatType, 3>(),
+                        reader.readVec<FloatType, 3>()
+                    }};
+                    const auto normal = reader.readVec<FloatType, 3>();
+                    const auto distance = reader.read<FloatType, FloatType>();
+                    const auto boundary = vm::plane3(distance, normal);
+                    const auto attributes = readBrushFaceAttributes(reader);
+
+                    auto texCoordSystem = Model::TexCoordSystemVariant{Model::ParaxialTexCoordSystem(points[0], points[1], points[2], attributes)};
+                    if (static_cast<TexCoordSystemKind>(reader.readUnsignedChar<uint8_t>()) == TexCoordSystemKind::Parallel) {
+                        const auto xAxis = reader.readVec<FloatType, 3>();
+                        const auto yAxis = reader.readVec<FloatType, 3>();
+                        texCoordSystem = Model::ParallelTexCoordSystem(xAxis, yAxis);
+                    }
+
+                    const auto faceVertexCount = readElementCount(reader, sizeof(uint32_t));
+                    if (faceVertexCount < 3u) {
+                        throw ReaderException("Brush face has fewer than three vertices");
+                    }
+
+                    auto vertexIndices = std::vector<size_t>{};
+                    vertexIndices.reserve(faceVertexCount);
+                    for (size_t j = 0; j < faceVertexCount; ++j) {
+                        const auto vertexIndex = reader.readSize<uint32_t>();
+                        if (vertexIndex >= vertexCount) {
+                            throw ReaderException("Brush face vertex index out of range");
+                        }
+                        vertexIndices.push_back(vertexIndex);
+                    }
+
+                    faces.emplace_back(points, boundary, attributes, std::move(texCoordSystem));
+                    faces.back().setFilePosition(lineNumber, lineCount);
+                    faceVertexIndices.push_back(std::move(vertexIndices));
+                    facePlanes.push_back(boundary);
+                }
+
+                if (!isClosedSurface(vertexCount, faceVertexIndices)) {
+                    throw ReaderException("Brush geometry is not a closed surface");
+                }
+                if (!isConvexSurface(positions, faceVertexIndices, facePlanes)) {
+                    throw ReaderException("Brush geometry is not convex or does not lie on its face planes");
+                }
+
+                auto geometry = std::make_unique<Model::BrushGeometry>(std::move(positions), faceVertexIndices, facePlanes);
+                auto brush = Model::Brush::create(std::move(faces), std::move(geometry));
+                if (brush.is_error()) {
+                    throw ReaderException("Brush geometry does not match its faces");
+                }
+                return std::make_unique<Model::BrushNode>(std::move(brush).value());
+            }
+
+            static std::unique_ptr<Model::PatchNode> readPatchNode(Reader& reader) {
+                const auto rowCount = reader.readSize<uint32_t>();
+                const auto columnCount = reader.readSize<uint32_t>();
+                if (rowCount < 3u || columnCount < 3u || rowCount % 2u == 0u || columnCount % 2u == 0u) {
+                    throw ReaderException("Patch must have an odd number of at least three control points per row and column");
+                }
+
+                const auto pointSize = 5u * sizeof(FloatType);
+                if (columnCount > std::numeric_limits<size_t>::max() / pointSize / rowCount
+                    || !reader.canRead(rowCount * columnCount * pointSize)) {
+                    throw ReaderException("Control point count exceeds remaining data");
+                }
+
+                auto controlPoints = std::vector<Model::BezierPatch::Point>{};
+                controlPoints.reserve(rowCount * columnCount);
+                for (size_t i = 0; i < rowCount * columnCount; ++i) {
+                    controlPoints.push_back(reader.readVec<FloatType, 5>());
+                }
+
+                auto textureName = readNodeDataString(reader);
+                return std::make_unique<Model::PatchNode>(Model::BezierPatch{rowCount, columnCount, std::move(controlPoints), std::move(textureName)});
+            }
+
+            static std::unique_ptr<Model::Node> readNode(Reader& reader);
+
+            static void readChildNodes(Reader& reader, Model::Node& parent) {
+                const auto childCount = reader.readSize<uint32_t>();
+                for (size_t i = 0; i < childCount; ++i) {
+                    parent.addChild(readNode(reader).release());
+                }
+            }
+
+            static Model::Entity readEntity(Reader& reader) {
+                const auto propertyCount = readElementCount(reader, 2u * sizeof(uint32_t));
+                auto properties = std::vector<Model::EntityProperty>{};
+                properties.reserve(propertyCount);
+                for (size_t i = 0; i < propertyCount; ++i) {
+                    auto key = readNodeDataString(reader);
+                    auto value = readNodeDataString(reader);
+                    properties.emplace_back(std::move(key), std::move(value));
+                }
+
+                const auto protectedPropertyCount = readElementCount(reader, sizeof(uint32_t));
+                auto protectedProperties = std::vector<std::string>{};
+                protectedProperties.reserve(protectedPropertyCount);
+                for (size_t i = 0; i < protectedPropertyCount; ++i) {
+                    protectedProperties.push_back(readNodeDataString(reader));
+                }
+
+                auto entity = Model::Entity{std::move(properties)};
+                entity.setProtectedProperties(std::move(protectedProperties));
+                return entity;
+            }
+
+            static std::unique_ptr<Model::EntityNode> readEntityNode(Reader& reader) {
+                auto entityNode = std::make_unique<Model::EntityNode>(readEntity(reader));
+                readChildNodes(reader, *entityNode);
+                return entityNode;
+            }
+
+            static std::unique_ptr<Model::GroupNode> readGroupNode(Reader& reader) {
+                auto group = Model::Group{readNodeDataString(reader)};
+
+                const auto hasPersistentId = reader.readBool<uint8_t>();
+                const auto persistentId = reader.read<uint64_t, Model::IdType>();
+
+                const auto hasLinkedGroupId = reader.readBool<uint8_t>();
+                auto linkedGroupId = readNodeDataString(reader);
+                if (hasLinkedGroupId) {
+                    group.setLinkedGroupId(std::move(linkedGroupId));
+                }
+
+                auto transformation = vm::mat4x4{};
+                for (size_t i = 0; i < 4; ++i) {
+                    transformation[i] = reader.readVec<FloatType, 4>();
+                }
+                group.setTransformation(transformation);
+
+                auto groupNode = std::make_unique<Model::GroupNode>(std::move(group));
+                if (hasPersistentId) {
+                    groupNode->setPersistentId(persistentId);
+                }
+                readChildNodes(reader, *groupNode);
+                return groupNode;
+            }
+
+            static std::unique_ptr<Model::Node> readNode(Reader& reader, const NodeKind kind) {
+                switch (kind) {
+                    case NodeKind::Group:
+                        return readGroupNode(reader);
+                    case NodeKind::Entity:
+                        return readEntityNode(reader);
+                    case NodeKind::Brush:
+                        return readBrushNode(reader);
+                    case NodeKind::Patch:
+                        return readPatchNode(reader);
+                    case NodeKind::Layer:
+                        throw ReaderException("Unexpected layer node");
+                    default:
+                        throw ReaderException("Unknown node kind");
+                }
+            }
+
+            static std::unique_ptr<Model::Node> readNode(Reader& reader) {
+                const auto kind = static_cast<NodeKind>(reader.readUnsignedChar<uint8_t>());
+                const auto lineNumber = reader.readSize<uint64_t>();
+                const auto lineCount = reader.readSize<uint64_t>();
+
+                auto node = readNode(reader, kind);
+                node->setFilePosition(lineNumber, lineCount);
+                return node;
+            }
+
+            template <typename S>
+            static S readState(Reader& reader, const std::initializer_list<S> validStates) {
+                const auto state = static_cast<S>(reader.readUnsignedChar<uint8_t>());
+                if (std::find(std::begin(validStates), std::end(validStates), state) == std::end(validStates)) {
+                    throw ReaderException("Invalid node state");
+                }
+                return state;
+            }
+
+            /**
+             * Reads a layer into the given layer node, which must be a default layer node if and only if the layer was
+             * written from a default layer node.
+             */
+            static void readLayerNode(Reader& reader, Model::LayerNode& layerNode) {
+                if (static_cast<NodeKind>(reader.readUnsignedChar<uint8_t>()) != NodeKind::Layer) {
+                    throw ReaderException("Expected layer node");
+                }
+                const auto lineNumber = reader.readSize<uint64_t>();
+                const auto lineCount = reader.readSize<uint64_t>();
+                layerNode.setFilePosition(lineNumber, lineCount);
+
+                auto layer = Model::Layer{readNodeDataString(reader), layerNode.isDefaultLayer()};
+
+                const auto hasSortIndex = reader.readBool<uint8_t>();
+                const auto sortIndex = reader.readInt<int32_t>();
+                if (hasSortIndex) {
+                    layer.setSortIndex(sortIndex);
+                }
+
+                const auto hasColor = reader.readBool<uint8_t>();
+                const auto r = reader.readFloat<float>();
+                const auto g = reader.readFloat<float>();
+                const auto b = reader.readFloat<float>();
+                const auto a = reader.readFloat<float>();
+                if (hasColor) {
+                    layer.setColor(Color(r, g, b, a));
+                }
+
+                layer.setOmitFromExport(reader.readBool<uint8_t>());
+                layerNode.setLayer(std::move(layer));
+
+                const auto hasPersistentId = reader.readBool<uint8_t>();
+                const auto persistentId = reader.read<uint64_t, Model::IdType>();
+                if (hasPersistentId) {
+                    layerNode.setPersistentId(persistentId);
+                }
+
+                layerNode.setLockState(readState(reader, {Model::LockState::Inherited, Model::LockState::Locked, Model::LockState::Unlocked}));
+                layerNode.setVisibilityState(readState(reader, {Model::VisibilityState::Inherited, Model::VisibilityState::Hidden, Model::VisibilityState::Shown}));
+
+                readChildNodes(reader, layerNode);
+            }
+
+            std::optional<std::vector<Model::Node*>> readNodes(const std::string_view data, const Model::MapFormat mapFormat, const vm::bbox3& worldBounds) {
+                auto result = std::vector<std::unique_ptr<Model::Node>>{};
+                try {
+                    auto reader = Reader::from(data.data(), data.data() + data.size());
+                    if (readHeader(reader, worldBounds) != mapFormat) {
+                        return std::nullopt;
+                    }
+
+                    const auto nodeCount = reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < nodeCount; ++i) {
+                        result.push_back(readNode(reader));
+                    }
+
+                    if (reader.canRead(1u)) {
+                        return std::nullopt;
+                    }
+                } catch (const Exception&) {
+                    return std::nullopt;
+                }
+
+                auto nodes = std::vector<Model::Node*>{};
+                nodes.reserve(result.size());
+                for (auto& node : result) {
+                    nodes.push_back(node.release());
+                }
+                return nodes;
+            }
+
+            std::unique_ptr<Model::WorldNode> readWorld(const std::string_view data, const vm::bbox3& worldBounds) {
+                try {
+                    auto reader = Reader::from(data.data(), data.data() + data.size());
+                    const auto mapFormat = readHeader(reader, worldBounds);
+                    if (!mapFormat) {
+                        return nullptr;
+                    }
+
+                    const auto lineNumber = reader.readSize<uint64_t>();
+                    const auto lineCount = reader.readSize<uint64_t>();
+
+                    auto worldNode = std::make_unique<Model::WorldNode>(readEntity(reader), *mapFormat);
+                    worldNode->setFilePosition(lineNumber, lineCount);
+
+                    // like WorldReader, build the node tree once all nodes have been added
+                    worldNode->disableNodeTreeUpdates();
+                    readLayerNode(reader, *worldNode->defaultLayer());
+
+                    const auto customLayerCount = reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < customLayerCount; ++i) {
+                        auto layerNode = std::make_unique<Model::LayerNode>(Model::Layer{""});
+                        readLayerNode(reader, *layerNode);
+                        worldNode->addChild(layerNode.release());
+                    }
+
+                    if (reader.canRead(1u)) {
+                        return nullptr;
+                    }
+
+                    worldNode->rebuildNodeTree();
+                    worldNode->enableNodeTreeUpdates();
+                    return worldNode;
+                } catch (const Exception&) {
+                    return nullptr;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <vecmath/forward.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        enum class MapFormat;
+        class Node;
+        class WorldNode;
+    }
+
+    namespace IO {
+        /**
+         * A compact binary format for nodes that is used to copy and paste nodes between documents of the same
+         * process and to cache whole maps (see MapCache). Unlike the map file format, it stores the geometry of every
+         * brush, so reading the nodes neither tokenizes any text nor computes the brush geometry from the face planes.
+         *
+         * The format records the map format and the world bounds of the document the nodes were written from. It is
+         * only read by documents with the same map format and world bounds; other documents must read the textual
+         * representation of the nodes instead. The format is versioned and data written with another version is
+         * rejected, so it is not meant to be stored permanently.
+         */
+        namespace BinaryNodeFormat {
+            /**
+             * Writes the given nodes in the same way as NodeWriter::writeNodes, that is, selected world brushes are
+             * written as brushes, selected entity brushes are written as part of a copy of their entity, and groups
+             * and entities are written together with their children.
+             *
+             * @param nodes the nodes to write
+             * @param mapFormat the map format of the document that contains the nodes
+             * @param worldBounds the world bounds of the document that contains the nodes
+             * @return the binary data
+             */
+            std::string writeNodes(const std::vector<Model::Node*>& nodes, Model::MapFormat mapFormat, const vm::bbox3& worldBounds);
+
+            /**
+             * Reads nodes that were written by writeNodes.
+             *
+             * @param data the binary data
+             * @param mapFormat the map format of the document that reads the nodes
+             * @param worldBounds the world bounds of the document that reads the nodes
+             * @return the nodes, or nullopt if the given data is not valid binary node data or if it was written by a
+             * document with a different map format or different world bounds; the caller takes ownership of the
+             * returned nodes
+             */
+            std::optional<std::vector<Model::Node*>> readNodes(std::string_view data, Model::MapFormat mapFormat, const vm::bbox3& worldBounds);
+
+            /**
+             * Writes the given world including its layers and all of their descendants, and the lock and visibility
+             * states of the layers.
+             *
+             * @param worldNode the world to write
+             * @param worldBounds the world bounds of the document that contains the world
+             * @return the binary data
+             */
+            std::string writeWorld(const Model::WorldNode& worldNode, const vm::bbox3& worldBounds);
+
+            /**
+             * Reads a world that was written by writeWorld. The returned world has the map format that was recorded
+             * when writing it, and its node tree is built.
+             *
+             * @param data the binary data
+             * @param worldBounds the world bounds of the document that reads the world
+             * @return the world, or null if the given data is not a valid binary world or if it was written with
+             * different world bounds
+             */
+            std::unique_ptr<Model::WorldNode> readWorld(std::string_view data, const vm::bbox3& worldBounds);
+        }
+    }
+}
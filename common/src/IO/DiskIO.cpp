@@ -27,6 +27,7 @@
 
 #include <kdl/string_compare.h>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 
@@ -55,8 +56,11 @@ namespace TrenchBroom {
             }
 
             Path findCaseSensitivePath(const std::vector<Path>& list, const Path& path) {
+                // compare the components directly to avoid building a string for every directory entry
+                const auto& components = path.components();
                 for (const Path& entry : list) {
-                    if (kdl::ci::str_is_equal(entry.asString(), path.asString()))
+                    const auto& entryComponents = entry.components();
+                    if (std::equal(std::begin(entryComponents), std::end(entryComponents), std::begin(components), std::end(components), kdl::ci::string_equal()))
                         return entry;
                 }
                 return Path("");
@@ -115,9 +115,9 @@ namespace TrenchBroom {
                 auto entryFile = std::make_shared<FileView>(entryPath, m_file, entryAddress, entrySize);
 
                 if (compressed) {
-                    m_root.addFile(entryPath, std::make_unique<DkCompressedFile>(entryFile, uncompressedSize));
+                    addFile(entryPath, std::make_unique<DkCompressedFile>(entryFile, uncompressedSize));
                 } else {
-                    m_root.addFile(entryPath, std::make_unique<SimpleFileEntry>(entryFile));
+                    addFile(entryPath, std::make_unique<SimpleFileEntry>(entryFile));
                 }
             }
         }
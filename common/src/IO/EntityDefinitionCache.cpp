@@ -0,0 +1,409 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityDefinitionCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "FloatType.h"
+#include "Macros.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "EL/Expression.h"
+#include "IO/DiskIO.h"
+#include "IO/ELParser.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const char CacheMagic[] = { 'T', 'B', 'E', 'D' };
+        /** Must be incremented whenever the cache file format changes. */
+        static constexpr uint32_t CacheVersion = 2;
+
+        /**
+         * The kinds of property definitions. This differs from Assets::PropertyDefinitionType because unknown property
+         * definitions have the string type.
+         */
+        enum class CachedPropertyKind : uint8_t {
+            TargetSource,
+            TargetDestination,
+            String,
+            Unknown,
+            Boolean,
+            Integer,
+            Float,
+            Choice,
+            Flags
+        };
+
+        /**
+         * Returns the content hash of the file at the given path, or 0 if the file does not exist.
+         */
+        static uint64_t hashFile(const Path& path) {
+            const auto fixedPath = Disk::fixPath(path);
+            if (!Disk::fileExists(fixedPath)) {
+                return 0u;
+            }
+            const auto file = Disk::openFile(fixedPath);
+            const auto reader = file->reader().buffer();
+            return hashContents(reader.stringView());
+        }
+
+        class CacheWriter {
+        private:
+            std::string m_buffer;
+        public:
+            const std::string& buffer() const {
+                return m_buffer;
+            }
+
+            template <typename T>
+            void write(const T value) {
+                char bytes[sizeof(T)];
+                std::memcpy(bytes, &value, sizeof(T));
+                m_buffer.append(bytes, sizeof(T));
+            }
+
+            void writeString(const std::string& str) {
+                write(static_cast<uint32_t>(str.size()));
+                m_buffer.append(str);
+            }
+
+            void writeColor(const Color& color) {
+                write(color.r());
+                write(color.g());
+                write(color.b());
+                write(color.a());
+            }
+        };
+
+        static std::string readString(Reader& reader) {
+            const auto size = reader.readSize<uint32_t>();
+            return reader.readString(size);
+        }
+
+        static Color readColor(Reader& reader) {
+            const auto r = reader.readFloat<float>();
+            const auto g = reader.readFloat<float>();
+            const auto b = reader.readFloat<float>();
+            const auto a = reader.readFloat<float>();
+            return Color(r, g, b, a);
+        }
+
+        template <typename T>
+        static void writeDefaultValue(CacheWriter& writer, const Assets::PropertyDefinitionWithDefaultValue<T>& definition) {
+            writer.write(static_cast<uint8_t>(definition.hasDefaultValue()));
+            if (definition.hasDefaultValue()) {
+                if constexpr (std::is_same_v<T, std::string>) {
+                    writer.writeString(definition.defaultValue());
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    writer.write(static_cast<uint8_t>(definition.defaultValue()));
+                } else if constexpr (std::is_same_v<T, int>) {
+                    writer.write(static_cast<int32_t>(definition.defaultValue()));
+                } else {
+                    writer.write(definition.defaultValue());
+                }
+            }
+        }
+
+        static void writePropertyDefinition(CacheWriter& writer, const Assets::PropertyDefinition& definition) {
+            const auto writeHeader = [&](const CachedPropertyKind kind) {
+                writer.write(static_cast<uint8_t>(kind));
+                writer.writeString(definition.key());
+                writer.writeString(definition.shortDescription());
+                writer.writeString(definition.longDescription());
+                writer.write(static_cast<uint8_t>(definition.readOnly()));
+            };
+
+            switch (definition.type()) {
+                case Assets::PropertyDefinitionType::TargetSourceProperty:
+                    writeHeader(CachedPropertyKind::TargetSource);
+                    break;
+                case Assets::PropertyDefinitionType::TargetDestinationProperty:
+                    writeHeader(CachedPropertyKind::TargetDestination);
+                    break;
+                case Assets::PropertyDefinitionType::StringProperty: {
+                    const auto isUnknown = dynamic_cast<const Assets::UnknownPropertyDefinition*>(&definition) != nullptr;
+                    writeHeader(isUnknown ? CachedPropertyKind::Unknown : CachedPropertyKind::String);
+                    writeDefaultValue(writer, static_cast<const Assets::StringPropertyDefinition&>(definition));
+                    break;
+                }
+                case Assets::PropertyDefinitionType::BooleanProperty:
+                    writeHeader(CachedPropertyKind::Boolean);
+                    writeDefaultValue(writer, static_cast<const Assets::BooleanPropertyDefinition&>(definition));
+                    break;
+                case Assets::PropertyDefinitionType::IntegerProperty:
+                    writeHeader(CachedPropertyKind::Integer);
+                    writeDefaultValue(writer, static_cast<const Assets::IntegerPropertyDefinition&>(definition));
+                    break;
+                case Assets::PropertyDefinitionType::FloatProperty:
+                    writeHeader(CachedPropertyKind::Float);
+                    writeDefaultValue(writer, static_cast<const Assets::FloatPropertyDefinition&>(definition));
+                    break;
+                case Assets::PropertyDefinitionType::ChoiceProperty: {
+                    const auto& choiceDefinition = static_cast<const Assets::ChoicePropertyDefinition&>(definition);
+                    writeHeader(CachedPropertyKind::Choice);
+                    writeDefaultValue(writer, choiceDefinition);
+                    writer.write(static_cast<uint32_t>(choiceDefinition.options().size()));
+                    for (const auto& option : choiceDefinition.options()) {
+                        writer.writeString(option.value());
+                        writer.writeString(option.description());
+                    }
+                    break;
+                }
+                case Assets::PropertyDefinitionType::FlagsProperty: {
+                    const auto& flagsDefinition = static_cast<const Assets::FlagsPropertyDefinition&>(definition);
+                    writeHeader(CachedPropertyKind::Flags);
+                    writer.write(static_cast<uint32_t>(flagsDefinition.options().size()));
+                    for (const auto& option : flagsDefinition.options()) {
+                        writer.write(static_cast<int32_t>(option.value()));
+                        writer.writeString(option.shortDescription());
+                        writer.writeString(option.longDescription());
+                        writer.write(static_cast<uint8_t>(option.isDefault()));
+                    }
+                    break;
+                }
+                switchDefault()
+            }
+        }
+
+        template <typename T, typename R>
+        static std::optional<T> readDefaultValue(Reader& reader, R readValue) {
+            if (reader.readBool<uint8_t>()) {
+                return readValue();
+            }
+            return std::nullopt;
+        }
+
+        static std::shared_ptr<Assets::PropertyDefinition> readPropertyDefinition(Reader& reader) {
+            const auto kind = static_cast<CachedPropertyKind>(reader.readUnsignedChar<uint8_t>());
+            const auto key = readString(reader);
+            const auto shortDescription = readString(reader);
+            const auto longDescription = readString(reader);
+            const auto readOnly = reader.readBool<uint8_t>();
+
+            const auto readStringValue = [&]() { return readString(reader); };
+
+            switch (kind) {
+                case CachedPropertyKind::TargetSource:
+                    return std::make_shared<Assets::PropertyDefinition>(key, Assets::PropertyDefinitionType::TargetSourceProperty, shortDescription, longDescription, readOnly);
+                case CachedPropertyKind::TargetDestination:
+                    return std::make_shared<Assets::PropertyDefinition>(key, Assets::PropertyDefinitionType::TargetDestinationProperty, shortDescription, longDescription, readOnly);
+                case CachedPropertyKind::String:
+                    return std::make_shared<Assets::StringPropertyDefinition>(key, shortDescription, longDescription, readOnly, readDefaultValue<std::string>(reader, readStringValue));
+                case CachedPropertyKind::Unknown:
+                    return std::make_shared<Assets::UnknownPropertyDefinition>(key, shortDescription, longDescription, readOnly, readDefaultValue<std::string>(reader, readStringValue));
+                case CachedPropertyKind::Boolean:
+                    return std::make_shared<Assets::BooleanPropertyDefinition>(key, shortDescription, longDescription, readOnly, readDefaultValue<bool>(reader, [&]() { return reader.readBool<uint8_t>(); }));
+                case CachedPropertyKind::Integer:
+                    return std::make_shared<Assets::IntegerPropertyDefinition>(key, shortDescription, longDescription, readOnly, readDefaultValue<int>(reader, [&]() { return reader.readInt<int32_t>(); }));
+                case CachedPropertyKind::Float:
+                    return std::make_shared<Assets::FloatPropertyDefinition>(key, shortDescription, longDescription, readOnly, readDefaultValue<float>(reader, [&]() { return reader.readFloat<float>(); }));
+                case CachedPropertyKind::Choice: {
+                    auto defaultValue = readDefaultValue<std::string>(reader, readStringValue);
+                    const auto optionCount = reader.readSize<uint32_t>();
+                    auto options = Assets::ChoicePropertyOption::List();
+                    options.reserve(optionCount);
+                    for (size_t i = 0; i < optionCount; ++i) {
+                        auto value = readString(reader);
+                        auto description = readString(reader);
+                        options.emplace_back(value, description);
+                    }
+                    return std::make_shared<Assets::ChoicePropertyDefinition>(key, shortDescription, longDescription, options, readOnly, std::move(defaultValue));
+                }
+                case CachedPropertyKind::Flags: {
+                    auto result = std::make_shared<Assets::FlagsPropertyDefinition>(key);
+                    const auto optionCount = reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < optionCount; ++i) {
+                        const auto value = reader.readInt<int32_t>();
+                        const auto optionShortDescription = readString(reader);
+                        const auto optionLongDescription = readString(reader);
+                        const auto isDefault = reader.readBool<uint8_t>();
+                        result->addOption(value, optionShortDescription, optionLongDescription, isDefault);
+                    }
+                    return result;
+                }
+                default:
+                    throw ReaderException("Unknown property definition kind");
+            }
+        }
+
+        static void writeEntityDefinition(CacheWriter& writer, const Assets::EntityDefinition& definition) {
+            writer.write(static_cast<uint8_t>(definition.type()));
+            writer.writeString(definition.name());
+            writer.writeColor(definition.color());
+            writer.writeString(definition.description());
+
+            if (definition.type() == Assets::EntityDefinitionType::PointEntity) {
+                const auto& pointDefinition = static_cast<const Assets::PointEntityDefinition&>(definition);
+                const auto& bounds = pointDefinition.bounds();
+                for (size_t i = 0; i < 3; ++i) {
+                    writer.write(static_cast<double>(bounds.min[i]));
+                }
+                for (size_t i = 0; i < 3; ++i) {
+                    writer.write(static_cast<double>(bounds.max[i]));
+                }
+
+                // an empty string denotes the default model definition
+                const auto& modelDefinition = pointDefinition.modelDefinition();
+                writer.writeString(modelDefinition == Assets::ModelDefinition() ? "" : modelDefinition.expression().asString());
+            }
+
+            const auto& propertyDefinitions = definition.propertyDefinitions();
+            writer.write(static_cast<uint32_t>(propertyDefinitions.size()));
+            for (const auto& propertyDefinition : propertyDefinitions) {
+                writePropertyDefinition(writer, *propertyDefinition);
+            }
+        }
+
+        static std::unique_ptr<Assets::EntityDefinition> readEntityDefinition(Reader& reader) {
+            const auto type = static_cast<Assets::EntityDefinitionType>(reader.readUnsignedChar<uint8_t>());
+            const auto name = readString(reader);
+            const auto color = readColor(reader);
+            const auto description = readString(reader);
+
+            auto bounds = vm::bbox3();
+            auto modelDefinition = Assets::ModelDefinition();
+            if (type == Assets::EntityDefinitionType::PointEntity) {
+                for (size_t i = 0; i < 3; ++i) {
+                    bounds.min[i] = static_cast<FloatType>(reader.readDouble<double>());
+                }
+                for (size_t i = 0; i < 3; ++i) {
+                    bounds.max[i] = static_cast<FloatType>(reader.readDouble<double>());
+                }
+
+                const auto modelExpression = readString(reader);
+                if (!modelExpression.empty()) {
+                    modelDefinition = Assets::ModelDefinition(ELParser::parseStrict(modelExpression));
+                }
+            } else if (type != Assets::EntityDefinitionType::BrushEntity) {
+                throw ReaderException("Unknown entity definition type");
+            }
+
+            const auto propertyDefinitionCount = reader.readSize<uint32_t>();
+            auto propertyDefinitions = std::vector<std::shared_ptr<Assets::PropertyDefinition>>();
+            propertyDefinitions.reserve(propertyDefinitionCount);
+            for (size_t i = 0; i < propertyDefinitionCount; ++i) {
+                propertyDefinitions.push_back(readPropertyDefinition(reader));
+            }
+
+            if (type == Assets::EntityDefinitionType::PointEntity) {
+                return std::make_unique<Assets::PointEntityDefinition>(name, color, bounds, description, propertyDefinitions, modelDefinition);
+            } else {
+                return std::make_unique<Assets::BrushEntityDefinition>(name, color, description, propertyDefinitions);
+            }
+        }
+
+        EntityDefinitionCache::EntityDefinitionCache(Path directory, std::string appVersion) :
+        m_directory(std::move(directory)),
+        m_appVersion(std::move(appVersion)) {}
+
+        std::optional<std::vector<Assets::EntityDefinition*>> EntityDefinitionCache::load(const Path& path, const Color& defaultColor) const {
+            const auto cachePath = Disk::fixPath(cacheFilePath(path));
+            if (!Disk::fileExists(cachePath)) {
+                return std::nullopt;
+            }
+
+            std::vector<Assets::EntityDefinition*> result;
+            try {
+                const auto file = Disk::openFile(cachePath);
+                auto reader = file->reader().buffer();
+
+                char magic[sizeof(CacheMagic)];
+                reader.read(magic, sizeof(magic));
+                if (std::memcmp(magic, CacheMagic, sizeof(CacheMagic)) != 0 || reader.readUnsignedInt<uint32_t>() != CacheVersion) {
+                    return std::nullopt;
+                }
+                if (readString(reader) != m_appVersion || readColor(reader) != defaultColor) {
+                    return std::nullopt;
+                }
+
+                const auto fileCount = reader.readSize<uint32_t>();
+                for (size_t i = 0; i < fileCount; ++i) {
+                    const auto filePath = Path(readString(reader));
+                    const auto fileHash = reader.read<uint64_t, uint64_t>();
+                    if (hashFile(filePath) != fileHash) {
+                        return std::nullopt;
+                    }
+                }
+
+                const auto definitionCount = reader.readSize<uint32_t>();
+                result.reserve(definitionCount);
+                for (size_t i = 0; i < definitionCount; ++i) {
+                    result.push_back(readEntityDefinition(reader).release());
+                }
+                return result;
+            } catch (const Exception&) {
+                // the cache file is damaged or cannot be read, the definitions will be parsed again
+                kdl::vec_clear_and_delete(result);
+                return std::nullopt;
+            }
+        }
+
+        void EntityDefinitionCache::store(const Path& path, const std::vector<Path>& includedPaths, const Color& defaultColor, const std::vector<Assets::EntityDefinition*>& definitions) const {
+            try {
+                CacheWriter writer;
+                for (const char c : CacheMagic) {
+                    writer.write(c);
+                }
+                writer.write(CacheVersion);
+                writer.writeString(m_appVersion);
+                writer.writeColor(defaultColor);
+
+                writer.write(static_cast<uint32_t>(includedPaths.size() + 1u));
+                for (const auto& filePath : kdl::vec_concat(std::vector<Path>{path}, includedPaths)) {
+                    writer.writeString(filePath.asString());
+                    writer.write(hashFile(filePath));
+                }
+
+                writer.write(static_cast<uint32_t>(definitions.size()));
+                for (const auto* definition : definitions) {
+                    writeEntityDefinition(writer, *definition);
+                }
+
+                Disk::ensureDirectoryExists(m_directory);
+                auto stream = openPathAsOutputStream(cacheFilePath(path), std::ios::out | std::ios::binary);
+                stream.write(writer.buffer().data(), static_cast<std::streamsize>(writer.buffer().size()));
+            } catch (const Exception&) {
+                // the definitions will be parsed again next time
+            }
+        }
+
+        Path EntityDefinitionCache::cacheFilePath(const Path& path) const {
+            return m_directory + Path(std::to_string(hashContents(path.asString())) + ".defcache");
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "IO/Path.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    class Color;
+
+    namespace Assets {
+        class EntityDefinition;
+    }
+
+    namespace IO {
+        /**
+         * Caches parsed entity definition files in a compact binary format, so that a definition file and the files it
+         * includes don't have to be parsed again if none of them has changed.
+         *
+         * Every definition file has its own cache file in the cache directory. A cache file records the path and a
+         * content hash of the definition file and of every file it includes, the default entity color used to create
+         * the definitions, and the definitions themselves. A cache file is only used if its format version, the
+         * application version that wrote it and the default color match and if every recorded file still has the
+         * recorded content hash. The model expressions
+         * of point entity definitions are stored in their textual form and parsed again when loading.
+         *
+         * Messages that were reported when parsing the definition file are not reported again when the definitions
+         * are loaded from the cache.
+         */
+        class EntityDefinitionCache {
+        private:
+            Path m_directory;
+            std::string m_appVersion;
+        public:
+            /**
+             * Creates an entity definition cache that stores its files in the given directory.
+             *
+             * @param directory the cache directory
+             * @param appVersion the version of the application, cache files written by other versions are ignored
+             */
+            EntityDefinitionCache(Path directory, std::string appVersion);
+
+            /**
+             * Loads the cached definitions for the definition file at the given path. The cache file is read with a
+             * single read.
+             *
+             * @param path the absolute path of the definition file
+             * @param defaultColor the default entity color
+             * @return the cached definitions, or nullopt if there are no valid cached definitions; the caller takes
+             * ownership of the returned definitions
+             */
+            std::optional<std::vector<Assets::EntityDefinition*>> load(const Path& path, const Color& defaultColor) const;
+
+            /**
+             * Writes the given definitions to the cache. Failures to write the cache file are ignored.
+             *
+             * @param path the absolute path of the definition file
+             * @param includedPaths the absolute paths of all files that were included by the definition file
+             * @param defaultColor the default entity color that was used to create the definitions
+             * @param definitions the definitions to cache
+             */
+            void store(const Path& path, const std::vector<Path>& includedPaths, const Color& defaultColor, const std::vector<Assets::EntityDefinition*>& definitions) const;
+        private:
+            Path cacheFilePath(const Path& path) const;
+        };
+    }
+}
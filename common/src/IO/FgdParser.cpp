@@ -139,6 +139,10 @@ namespace TrenchBroom {
         FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor) :
         FgdParser(std::move(str), defaultEntityColor, Path()) {}
 
+        const std::vector<Path>& FgdParser::includedPaths() const {
+            return m_includedPaths;
+        }
+
         FgdParser::TokenNameMap FgdParser::tokenNames() const {
             using namespace FgdToken;
 
@@ -719,6 +723,7 @@ namespace TrenchBroom {
             auto result = std::vector<EntityDefinitionClassInfo>();
             try {
                 status.debug(m_tokenizer.line(), "Parsing included file '" + path.asString() + "'");
+                m_includedPaths.push_back(m_fs->makeAbsolute(currentRoot() + path));
                 const auto file = m_fs->openFile(currentRoot() + path);
                 const auto filePath = file->path();
                 status.debug(m_tokenizer.line(), "Resolved '" + path.asString() + "' to '" + filePath.asString() + "'");
@@ -73,11 +73,18 @@ namespace TrenchBroom {
 
             std::vector<Path> m_paths;
             std::shared_ptr<FileSystem> m_fs;
+            std::vector<Path> m_includedPaths;
 
             FgdTokenizer m_tokenizer;
         public:
             FgdParser(std::string_view str, const Color& defaultEntityColor, const Path& path);
             FgdParser(std::string_view str, const Color& defaultEntityColor);
+
+            /**
+             * Returns the absolute paths of all files that were included while parsing, including files that could not
+             * be opened.
+             */
+            const std::vector<Path>& includedPaths() const;
         private:
             class PushIncludePath;
             void pushIncludePath(const Path& path);
@@ -28,6 +28,7 @@
 #include "IO/File.h"
 #include "IO/ImageLoaderImpl.h"
 
+#include <cstdint>
 #include <stdexcept>
 
 namespace TrenchBroom {
@@ -66,14 +67,20 @@ namespace TrenchBroom {
             const unsigned char* const data = buffer.data();
             const std::size_t bufferSize = buffer.size();
 
-            Color average;
+            // accumulate integer sums and convert to float once
+            uint64_t sums[4] = {0, 0, 0, 0};
             for (std::size_t i = 0; i < bufferSize; i += 4) {
-                average = average + Color(data[i], data[i+1], data[i+2], data[i+3]);
+                sums[0] += data[i];
+                sums[1] += data[i+1];
+                sums[2] += data[i+2];
+                sums[3] += data[i+3];
             }
-            const std::size_t numPixels = bufferSize / 4;
-            average = average / static_cast<float>(numPixels);
+            const float divisor = 255.0f * static_cast<float>(bufferSize / 4);
 
-            return average;
+            return Color(static_cast<float>(sums[0]) / divisor,
+                         static_cast<float>(sums[1]) / divisor,
+                         static_cast<float>(sums[2]) / divisor,
+                         static_cast<float>(sums[3]) / divisor);
         }
 
         Assets::Texture FreeImageTextureReader::doReadTexture(std::shared_ptr<File> file) const {
@@ -108,10 +115,9 @@ namespace TrenchBroom {
             // This is supposed to indicate whether any pixels are transparent (alpha < 100%)
             const auto masked = FreeImage_IsTransparent(image);
 
-            const size_t mipCount = 1;
             constexpr auto format = freeImage32BPPFormatToGLFormat();
-            Assets::TextureBufferList buffers(mipCount);
-            Assets::setMipBufferSize(buffers, mipCount, imageWidth, imageHeight, format);
+            Assets::TextureBufferList buffers(1);
+            Assets::setMipBufferSize(buffers, 1, imageWidth, imageHeight, format);
 
             const auto inputBytesPerPixel = FreeImage_GetLine(image) / FreeImage_GetWidth(image);
             if (imageColourType != FIC_RGBALPHA || inputBytesPerPixel != 4) {
@@ -139,6 +145,11 @@ namespace TrenchBroom {
             const auto textureType = Assets::Texture::selectTextureType(masked);
             const Color averageColor = getAverageColor(buffers.at(0), format);
 
+            // only the first level of masked textures is uploaded, see Texture::prepare
+            if (textureType != Assets::TextureType::Masked) {
+                Assets::generateMipmaps(buffers, Assets::fullMipLevelCount(imageWidth, imageHeight), imageWidth, imageHeight, format);
+            }
+
             return Assets::Texture(textureName(path), imageWidth, imageHeight, averageColor, std::move(buffers), format, textureType);
         }
     }
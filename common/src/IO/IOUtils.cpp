@@ -125,5 +125,15 @@ namespace TrenchBroom {
             stream << "// Game: " << gameName << "\n"
                    << "// Format: " << mapFormat << "\n";
         }
+
+        uint64_t hashContents(const std::string_view contents) {
+            // FNV-1a
+            uint64_t result = 14695981039346656037ull;
+            for (const char c : contents) {
+                result ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
+                result *= 1099511628211ull;
+            }
+            return result;
+        }
     }
 }
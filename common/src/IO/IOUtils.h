@@ -21,10 +21,12 @@
 
 #include "Macros.h"
 
+#include <cstdint>
 #include <cstdio> // for FILE
 #include <iosfwd>
 #include <fstream>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -41,5 +43,10 @@ namespace TrenchBroom {
         std::string readInfoComment(std::istream& stream, const std::string& name);
 
         void writeGameComment(std::ostream& stream, const std::string& gameName, const std::string& mapFormat);
+
+        /**
+         * Returns a 64 bit FNV-1a hash of the given contents. Used to detect changes of files that are cached.
+         */
+        uint64_t hashContents(std::string_view contents);
     }
 }
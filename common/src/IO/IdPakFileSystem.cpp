@@ -66,7 +66,7 @@ namespace TrenchBroom {
 
                 const auto entryPath = Path(kdl::str_to_lower(entryName));
                 auto entryFile = std::make_shared<FileView>(entryPath, m_file, entryAddress, entrySize);
-                m_root.addFile(entryPath, entryFile);
+                addFile(entryPath, entryFile);
             }
         }
     }
@@ -23,8 +23,11 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
 
-#include <cassert>
+#include <kdl/string_format.h>
+
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace TrenchBroom {
     namespace IO {
@@ -50,152 +53,186 @@ namespace TrenchBroom {
             return std::make_shared<OwningBufferFile>(m_file->path(), std::move(data), m_uncompressedSize);
         }
 
-        ImageFileSystemBase::Directory::Directory(const Path& path) :
-        m_path(path) {}
-
-        void ImageFileSystemBase::Directory::addFile(const Path& path, std::shared_ptr<File> file) {
-            addFile(path, std::make_unique<SimpleFileEntry>(file));
+        ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const std::string& name) {
+            auto& directory = m_directories[name];
+            if (directory == nullptr) {
+                directory = std::make_unique<Directory>();
+            }
+            return *directory;
         }
 
-        void ImageFileSystemBase::Directory::addFile(const Path& path, std::unique_ptr<FileEntry> file) {
-            ensure(file != nullptr, "file is null");
-            const auto filename = path.lastComponent();
-            if (path.length() == 1) {
-                // silently overwrite duplicates, the latest entries win
-                m_files[filename] = std::move(file);
-            } else {
-                auto& dir = findOrCreateDirectory(path.deleteLastComponent());
-                dir.addFile(filename, std::move(file));
-            }
+        const ImageFileSystemBase::FileEntry& ImageFileSystemBase::Directory::addFile(const std::string& name, std::unique_ptr<FileEntry> file) {
+            // silently overwrite duplicates, the latest entries win
+            auto& entry = m_files[name];
+            entry = std::move(file);
+            return *entry;
         }
 
-        bool ImageFileSystemBase::Directory::directoryExists(const Path& path) const {
-            if (path.isEmpty()) {
-                return true;
-            }
+        std::vector<Path> ImageFileSystemBase::Directory::contents() const {
+            std::vector<Path> contents;
+            contents.reserve(m_directories.size() + m_files.size());
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->directoryExists(path.deleteFirstComponent());
+            for (const auto& [name, directory] : m_directories) {
+                contents.push_back(Path(name));
             }
-        }
 
-        bool ImageFileSystemBase::Directory::fileExists(const Path& path) const {
-            if (path.length() == 1) {
-                return m_files.count(path) > 0;
+            for (const auto& [name, file] : m_files) {
+                contents.push_back(Path(name));
             }
 
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                return false;
-            } else {
-                return it->second->fileExists(path.deleteFirstComponent());
-            }
+            return contents;
         }
 
-        const ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findDirectory(const Path& path) const {
-            if (path.isEmpty()) {
-                return *this;
+        static void appendKeyComponent(std::string& key, const std::string& component) {
+            if (!key.empty()) {
+                key.push_back('/');
             }
-
-            auto it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories)) {
-                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
-            } else {
-                return it->second->findDirectory(path.deleteFirstComponent());
+            for (const char c : component) {
+                key.push_back(kdl::str_to_lower(c));
             }
         }
 
-        const ImageFileSystemBase::FileEntry& ImageFileSystemBase::Directory::findFile(const Path& path) const {
-            assert(!path.isEmpty());
-
-            const auto name = path.firstComponent();
-            if (path.length() == 1) {
-                auto it = m_files.find(name);
-                if (it == std::end(m_files)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return *it->second;
+        /**
+         * Returns the index key of the given path, that is, its case folded components separated by '/' after "." and
+         * ".." components have been resolved. Returns nullopt if the path cannot be resolved.
+         */
+        static std::optional<std::string> makeIndexKey(const Path& path) {
+            auto result = std::string();
+            for (const auto& component : path.components()) {
+                if (component == ".") {
+                    continue;
                 }
-            } else {
-                auto it = m_directories.find(name);
-                if (it == std::end(m_directories)) {
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                } else {
-                    return it->second->findFile(path.deleteFirstComponent());
+                if (component == "..") {
+                    if (result.empty()) {
+                        return std::nullopt;
+                    }
+                    const auto separator = result.find_last_of('/');
+                    result.erase(separator == std::string::npos ? 0u : separator);
+                    continue;
                 }
+                appendKeyComponent(result, component);
             }
+            return result;
         }
 
-        std::vector<Path> ImageFileSystemBase::Directory::contents() const {
-            std::vector<Path> contents;
-
-            for (const auto& [path, directory] : m_directories) {
-                contents.push_back(Path(path));
-            }
+        ImageFileSystemBase::ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path) :
+        FileSystem(std::move(next)),
+        m_path(path),
+        m_directoryIndex({{"", &m_root}}),
+        m_directoryRead(true) {}
 
-            for (const auto& [path, file] : m_files) {
-                contents.push_back(Path(path));
-            }
+        ImageFileSystemBase::~ImageFileSystemBase() = default;
 
-            return contents;
+        void ImageFileSystemBase::initialize() {
+            readDirectory();
         }
 
-        ImageFileSystemBase::Directory& ImageFileSystemBase::Directory::findOrCreateDirectory(const Path& path) {
-            if (path.isEmpty()) {
-                return *this;
-            }
+        void ImageFileSystemBase::initializeLazily() {
+            m_directoryRead = false;
+        }
 
-            const auto name = path.firstComponent();
-            auto it = m_directories.lower_bound(name);
-            if (it == std::end(m_directories) || name != it->first) {
-                it = m_directories.insert(it, std::make_pair(name, new Directory(m_path + Path(name))));
-            }
-            return it->second->findOrCreateDirectory(path.deleteFirstComponent());
+        void ImageFileSystemBase::addFile(const Path& path, std::shared_ptr<File> file) {
+            addFile(path, std::make_unique<SimpleFileEntry>(std::move(file)));
         }
 
-        ImageFileSystemBase::ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path) :
-        FileSystem(std::move(next)),
-        m_path(path),
-        m_root(Path()) {}
+        void ImageFileSystemBase::addFile(const Path& path, std::unique_ptr<FileEntry> file) {
+            ensure(file != nullptr, "file is null");
+            ensure(!path.isEmpty(), "path is empty");
+
+            const auto& components = path.components();
+            auto key = std::string();
+            auto* directory = &m_root;
+            for (size_t i = 0; i < components.size() - 1u; ++i) {
+                appendKeyComponent(key, components[i]);
+                directory = &directory->findOrCreateDirectory(components[i]);
+                m_directoryIndex.emplace(key, directory);
+            }
 
+            appendKeyComponent(key, components.back());
+            m_fileIndex[key] = &directory->addFile(components.back(), std::move(file));
+        }
 
-        ImageFileSystemBase::~ImageFileSystemBase() = default;
+        void ImageFileSystemBase::reload() {
+            m_root = Directory();
+            m_directoryIndex = {{"", &m_root}};
+            m_fileIndex.clear();
+            readDirectory();
+        }
 
-        void ImageFileSystemBase::initialize() {
+        void ImageFileSystemBase::readDirectory() {
+            m_readDirectoryError = std::nullopt;
             try {
                 doReadDirectory();
             } catch (const std::exception& e) {
-                throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': " + e.what());
+                m_readDirectoryError = "Could not initialize image file system '" + m_path.asString() + "': " + e.what();
+            }
+            m_directoryRead = true;
+
+            if (m_readDirectoryError) {
+                throw FileSystemException(*m_readDirectoryError);
             }
         }
 
-        void ImageFileSystemBase::reload() {
-            m_root = Directory(Path());
-            initialize();
+        void ImageFileSystemBase::ensureDirectoryRead() const {
+            if (!m_directoryRead) {
+                const auto lock = std::lock_guard<std::mutex>(m_readDirectoryMutex);
+                if (!m_directoryRead) {
+                    // reading the directory is not observable by callers, so this is still a const operation
+                    const_cast<ImageFileSystemBase*>(this)->readDirectory();
+                    return;
+                }
+            }
+
+            // don't read the directory again if it failed, but report the failure to every caller
+            if (m_readDirectoryError) {
+                throw FileSystemException(*m_readDirectoryError);
+            }
+        }
+
+        const ImageFileSystemBase::Directory* ImageFileSystemBase::findDirectory(const Path& path) const {
+            ensureDirectoryRead();
+            if (const auto key = makeIndexKey(path)) {
+                const auto it = m_directoryIndex.find(*key);
+                if (it != std::end(m_directoryIndex)) {
+                    return it->second;
+                }
+            }
+            return nullptr;
+        }
+
+        const ImageFileSystemBase::FileEntry* ImageFileSystemBase::findFile(const Path& path) const {
+            ensureDirectoryRead();
+            if (const auto key = makeIndexKey(path)) {
+                const auto it = m_fileIndex.find(*key);
+                if (it != std::end(m_fileIndex)) {
+                    return it->second;
+                }
+            }
+            return nullptr;
         }
 
         bool ImageFileSystemBase::doDirectoryExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.directoryExists(searchPath);
+            return findDirectory(path) != nullptr;
         }
 
         bool ImageFileSystemBase::doFileExists(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.fileExists(searchPath);
+            return findFile(path) != nullptr;
         }
 
         std::vector<Path> ImageFileSystemBase::doGetDirectoryContents(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            const auto& directory = m_root.findDirectory(path);
-            return directory.contents();
+            const auto* directory = findDirectory(path);
+            if (directory == nullptr) {
+                throw FileSystemException("Path does not exist: '" + path.asString() + "'");
+            }
+            return directory->contents();
         }
 
         std::shared_ptr<File> ImageFileSystemBase::doOpenFile(const Path& path) const {
-            const auto searchPath = path.makeLowerCase().makeCanonical();
-            return m_root.findFile(path).open();
+            const auto* file = findFile(path);
+            if (file == nullptr) {
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            }
+            return file->open();
         }
 
         ImageFileSystem::ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
@@ -24,8 +24,13 @@
 
 #include <kdl/string_compare.h>
 
-#include <map>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -64,44 +69,70 @@ namespace TrenchBroom {
                 virtual std::unique_ptr<char[]> decompress(std::shared_ptr<File> file, size_t uncompressedSize) const = 0;
             };
 
+            class Directory;
+
+            /**
+             * Maps the case folded canonical path of every directory and file in this file system to the directory or
+             * file. The components of a key are separated by '/', and the key of the root directory is empty.
+             */
+            using DirectoryIndex = std::unordered_map<std::string, const Directory*>;
+            using FileIndex = std::unordered_map<std::string, const FileEntry*>;
+
             class Directory {
             private:
-                using DirMap  = std::map<Path, std::unique_ptr<Directory>, Path::Less<kdl::ci::string_less>>;
-                using FileMap = std::map<Path, std::unique_ptr<FileEntry>, Path::Less<kdl::ci::string_less>>;
+                using DirMap  = std::unordered_map<std::string, std::unique_ptr<Directory>, kdl::ci::string_hash, kdl::ci::string_equal>;
+                using FileMap = std::unordered_map<std::string, std::unique_ptr<FileEntry>, kdl::ci::string_hash, kdl::ci::string_equal>;
 
-                Path m_path;
                 DirMap m_directories;
                 FileMap m_files;
             public:
-                explicit Directory(const Path& path);
-
-                void addFile(const Path& path, std::shared_ptr<File> file);
-                void addFile(const Path& path, std::unique_ptr<FileEntry> file);
+                Directory& findOrCreateDirectory(const std::string& name);
+                const FileEntry& addFile(const std::string& name, std::unique_ptr<FileEntry> file);
 
-                bool directoryExists(const Path& path) const;
-                bool fileExists(const Path& path) const;
-
-                const Directory& findDirectory(const Path& path) const;
-                const FileEntry& findFile(const Path& path) const;
                 std::vector<Path> contents() const;
-            private:
-                Directory& findOrCreateDirectory(const Path& path);
             };
         protected:
             Path m_path;
+        private:
             Directory m_root;
+            DirectoryIndex m_directoryIndex;
+            FileIndex m_fileIndex;
+
+            mutable std::mutex m_readDirectoryMutex;
+            std::atomic<bool> m_directoryRead;
+            /** The error that occurred when the directory was read, if any. Reported by every access. */
+            std::optional<std::string> m_readDirectoryError;
         protected:
             ImageFileSystemBase(std::shared_ptr<FileSystem> next, const Path& path);
         public:
             ~ImageFileSystemBase() override;
         protected:
+            /**
+             * Reads the directory of this file system immediately.
+             */
             void initialize();
+
+            /**
+             * Defers reading the directory of this file system until it is accessed for the first time. The first
+             * access may happen on any thread, so doReadDirectory must not depend on the calling thread. If reading the
+             * directory fails, the error is remembered and reported by every access without reading the directory again.
+             */
+            void initializeLazily();
+
+            void addFile(const Path& path, std::shared_ptr<File> file);
+            void addFile(const Path& path, std::unique_ptr<FileEntry> file);
         public:
             /**
              * Reload this file system.
              */
             void reload();
         private:
+            void readDirectory();
+            void ensureDirectoryRead() const;
+
+            const Directory* findDirectory(const Path& path) const;
+            const FileEntry* findFile(const Path& path) const;
+
             bool doDirectoryExists(const Path& path) const override;
             bool doFileExists(const Path& path) const override;
 
@@ -0,0 +1,206 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "IO/BinaryNodeFormat.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+#include "IO/Reader.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const char MapCacheMagic[] = { 'T', 'B', 'M', 'C' };
+        /** Must be incremented whenever the cache file format changes. */
+        static constexpr uint32_t MapCacheVersion = 2;
+
+        static std::string readMapCacheString(Reader& reader) {
+            const auto size = reader.readSize<uint32_t>();
+            return reader.readString(size);
+        }
+
+        static void appendMapCacheString(std::string& buffer, const std::string& str) {
+            const auto size = static_cast<uint32_t>(str.size());
+            buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            buffer.append(str);
+        }
+
+        /**
+         * Temporary files that are older than this were left behind by writes that didn't complete.
+         */
+        static constexpr qint64 StaleTemporaryFileAgeSecs = 60 * 60;
+
+        static void removeMapCacheFile(const Path& path) {
+            try {
+                Disk::deleteFile(path);
+            } catch (const Exception&) {
+                // the file will be removed when the cache is pruned the next time
+            }
+        }
+
+        MapCache::MapCache(Path directory, std::string appVersion) :
+        m_directory(std::move(directory)),
+        m_appVersion(std::move(appVersion)) {}
+
+        std::unique_ptr<Model::WorldNode> MapCache::load(const Path& path, const std::string_view contents, const std::vector<Model::MapFormat>& mapFormats, const vm::bbox3& worldBounds, Logger& logger) const {
+            const auto cachePath = Disk::fixPath(cacheFilePath(path));
+            if (!Disk::fileExists(cachePath)) {
+                return nullptr;
+            }
+
+            try {
+                const auto file = Disk::openFile(cachePath);
+                auto reader = file->reader().buffer();
+
+                char magic[sizeof(MapCacheMagic)];
+                reader.read(magic, sizeof(magic));
+                if (std::memcmp(magic, MapCacheMagic, sizeof(MapCacheMagic)) != 0 || reader.readUnsignedInt<uint32_t>() != MapCacheVersion) {
+                    return nullptr;
+                }
+
+                if (readMapCacheString(reader) != m_appVersion || readMapCacheString(reader) != path.asString()) {
+                    return nullptr;
+                }
+
+                // check the size first because it's much cheaper than hashing the contents
+                if (reader.readSize<uint64_t>() != contents.size() || reader.read<uint64_t, uint64_t>() != hashContents(contents)) {
+                    return nullptr;
+                }
+
+                const auto messageCount = reader.readSize<uint32_t>();
+                auto messages = Messages{};
+                for (size_t i = 0; i < messageCount; ++i) {
+                    const auto level = reader.readUnsignedChar<uint8_t>();
+                    if (level > static_cast<uint8_t>(LogLevel::Error)) {
+                        return nullptr;
+                    }
+                    messages.emplace_back(static_cast<LogLevel>(level), readMapCacheString(reader));
+                }
+
+                auto worldNode = BinaryNodeFormat::readWorld(reader.stringView().substr(reader.position()), worldBounds);
+                if (worldNode == nullptr || !kdl::vec_contains(mapFormats, worldNode->mapFormat())) {
+                    return nullptr;
+                }
+
+                for (const auto& [level, message] : messages) {
+                    logger.log(level, message);
+                }
+                return worldNode;
+            } catch (const Exception&) {
+                return nullptr;
+            }
+        }
+
+        void MapCache::store(const Path& path, const std::string_view contents, const Model::WorldNode& worldNode, const vm::bbox3& worldBounds, const Messages& messages) const {
+            try {
+                auto header = std::string(MapCacheMagic, sizeof(MapCacheMagic));
+                const auto appendValue = [&](const auto value) {
+                    header.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                };
+                appendValue(MapCacheVersion);
+                appendMapCacheString(header, m_appVersion);
+                appendMapCacheString(header, path.asString());
+                appendValue(static_cast<uint64_t>(contents.size()));
+                appendValue(hashContents(contents));
+
+                appendValue(static_cast<uint32_t>(messages.size()));
+                for (const auto& [level, message] : messages) {
+                    appendValue(static_cast<uint8_t>(level));
+                    appendMapCacheString(header, message);
+                }
+
+                const auto world = BinaryNodeFormat::writeWorld(worldNode, worldBounds);
+
+                Disk::ensureDirectoryExists(m_directory);
+
+                // write to a temporary file first so that an interrupted write doesn't leave a damaged cache file
+                const auto cachePath = cacheFilePath(path);
+                const auto tempPath = cachePath.addExtension("tmp");
+                auto stream = openPathAsOutputStream(tempPath, std::ios::out | std::ios::binary);
+                stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+                stream.write(world.data(), static_cast<std::streamsize>(world.size()));
+                stream.close();
+
+                if (stream.fail()) {
+                    removeMapCacheFile(tempPath);
+                    return;
+                }
+
+                try {
+                    Disk::moveFile(tempPath, cachePath, true);
+                } catch (const FileSystemException&) {
+                    removeMapCacheFile(tempPath);
+                    return;
+                }
+
+                prune();
+            } catch (const Exception&) {
+                // the map will be parsed again next time
+            }
+        }
+
+        Path MapCache::cacheFilePath(const Path& path) const {
+            return m_directory + Path(std::to_string(hashContents(path.asString())) + ".mapcache");
+        }
+
+        void MapCache::prune() const {
+            const auto lastModified = [](const Path& path) {
+                return QFileInfo(pathAsQString(path)).lastModified();
+            };
+
+            auto cacheFiles = kdl::vec_transform(Disk::findItems(m_directory, FileExtensionMatcher("mapcache")), [&](Path cacheFile) {
+                const auto time = lastModified(cacheFile);
+                return std::make_pair(std::move(cacheFile), time);
+            });
+
+            if (cacheFiles.size() > MaxCacheFiles) {
+                std::sort(std::begin(cacheFiles), std::end(cacheFiles), [](const auto& lhs, const auto& rhs) {
+                    return lhs.second > rhs.second;
+                });
+                for (size_t i = MaxCacheFiles; i < cacheFiles.size(); ++i) {
+                    removeMapCacheFile(cacheFiles[i].first);
+                }
+            }
+
+            const auto staleTime = QDateTime::currentDateTime().addSecs(-StaleTemporaryFileAgeSecs);
+            for (const auto& tempFile : Disk::findItems(m_directory, FileExtensionMatcher("tmp"))) {
+                if (lastModified(tempFile) < staleTime) {
+                    removeMapCacheFile(tempFile);
+                }
+            }
+        }
+    }
+}
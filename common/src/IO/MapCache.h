@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "IO/Path.h"
+
+#include <vecmath/forward.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    class Logger;
+    enum class LogLevel;
+
+    namespace Model {
+        enum class MapFormat;
+        class WorldNode;
+    }
+
+    namespace IO {
+        /**
+         * Caches loaded maps in the binary node format, so that a map file which hasn't changed since it was last
+         * loaded can be loaded again without parsing it and without computing the brush geometry.
+         *
+         * Every map file has its own cache file in the cache directory. A cache file records the application version
+         * that wrote it, the path, the size and a content hash of the map file and the messages that were reported
+         * when the map file was parsed, followed by the world (see BinaryNodeFormat::writeWorld). A cache file is only
+         * used if its format version, the application version, the size and content hash of the map file and the
+         * world bounds match.
+         *
+         * Cache files are written to a temporary file first, which then replaces the cache file. The cache directory
+         * keeps at most MaxCacheFiles cache files; the least recently written ones are removed when a map is stored.
+         */
+        class MapCache {
+        public:
+            using Messages = std::vector<std::pair<LogLevel, std::string>>;
+
+            static constexpr size_t MaxCacheFiles = 32u;
+        private:
+            Path m_directory;
+            std::string m_appVersion;
+        public:
+            /**
+             * Creates a map cache that stores its files in the given directory.
+             *
+             * @param directory the cache directory
+             * @param appVersion the version of the application, cache files written by other versions are ignored
+             */
+            MapCache(Path directory, std::string appVersion);
+
+            /**
+             * Loads the cached world for the map file at the given path. If a cached world is returned, the messages
+             * that were reported when the map file was parsed are logged again.
+             *
+             * @param path the absolute path of the map file
+             * @param contents the current contents of the map file
+             * @param mapFormats the acceptable map formats of the cached world
+             * @param worldBounds the world bounds
+             * @param logger the logger to report the cached messages to
+             * @return the cached world, or null if there is no valid cached world
+             */
+            std::unique_ptr<Model::WorldNode> load(const Path& path, std::string_view contents, const std::vector<Model::MapFormat>& mapFormats, const vm::bbox3& worldBounds, Logger& logger) const;
+
+            /**
+             * Writes the given world to the cache. The world must have just been read from the given contents of the
+             * map file. Failures to write the cache file are ignored.
+             *
+             * @param path the absolute path of the map file
+             * @param contents the contents of the map file
+             * @param worldNode the world
+             * @param worldBounds the world bounds
+             * @param messages the messages that were reported when the map file was parsed
+             */
+            void store(const Path& path, std::string_view contents, const Model::WorldNode& worldNode, const vm::bbox3& worldBounds, const Messages& messages) const;
+        private:
+            Path cacheFilePath(const Path& path) const;
+            void prune() const;
+        };
+    }
+}
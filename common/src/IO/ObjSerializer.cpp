@@ -28,10 +28,16 @@
 #include "Model/Polyhedron.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/vec.h>
 
 #include <fmt/format.h>
 
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 namespace TrenchBroom {
     namespace IO {
@@ -81,29 +87,18 @@ namespace TrenchBroom {
         ObjSerializer::ObjSerializer(std::ostream& objStream, std::ostream& mtlStream, std::string mtlFilename) :
         m_objStream{objStream},
         m_mtlStream{mtlStream},
-        m_mtlFilename{std::move(mtlFilename)} {
+        m_mtlFilename{std::move(mtlFilename)},
+        m_chunkCount{0u},
+        m_vertexCount{0u} {
             ensure(m_objStream.good(), "obj stream is good");
             ensure(m_mtlStream.good(), "mtl stream is good");
         }
 
-        void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {}
-
-        static void writeMtlFile(std::ostream& str, const std::vector<ObjSerializer::Object>& objects) {
-            auto usedTextures = std::map<std::string, const Assets::Texture*>{};
-
-            for (const auto& object : objects) {
-                std::visit(kdl::overload(
-                    [&](const ObjSerializer::BrushObject& brushObject) {
-                        for (const auto& face : brushObject.faces) {
-                            usedTextures[face.textureName] = face.texture;
-                        }
-                    },
-                    [&](const ObjSerializer::PatchObject& patchObject) {
-                        usedTextures[patchObject.textureName] = patchObject.texture;
-                    }
-                ), object);
-            }
+        void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {
+            m_objStream << "mtllib " << m_mtlFilename << "\n";
+        }
 
+        static void writeMtlFile(std::ostream& str, const std::map<std::string, const Assets::Texture*>& usedTextures) {
             for (const auto& [textureName, texture] : usedTextures) {
                 str << "newmtl " << textureName << "\n";
                 if (texture != nullptr && !texture->relativePath().isEmpty()) {
@@ -112,12 +107,13 @@ namespace TrenchBroom {
             }
         }
 
-        static void writeVertices(std::ostream& str, const std::vector<vm::vec3>& vertices) {
-            str << "# vertices\n";
+        static std::string formatVertices(const std::vector<vm::vec3>& vertices) {
+            auto result = std::string{};
             for (const vm::vec3& elem : vertices) {
                 // no idea why I have to switch Y and Z
-                fmt::format_to(std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
+                fmt::format_to(std::back_inserter(result), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
             }
+            return result;
         }
 
         static void writeTexCoords(std::ostream& str, const std::vector<vm::vec2f>& texCoords) {
@@ -137,28 +133,12 @@ namespace TrenchBroom {
             }
         }
 
-        static void writeObjFile(
-            std::ostream& str, const std::string mtlFilename, 
-            const std::vector<vm::vec3>& vertices, const std::vector<vm::vec2f>& texCoords, const std::vector<vm::vec3>& normals, 
-            const std::vector<ObjSerializer::Object>& objects) {
-            
-            str << "mtllib " << mtlFilename << "\n";
-            writeVertices(str, vertices);
-            str << "\n";
-            writeTexCoords(str, texCoords);
-            str << "\n";
-            writeNormals(str, normals);
-            str << "\n";
-            
-            for (const auto& object : objects) {
-                str << object;
-                str << "\n";
-            }
-        }
-
         void ObjSerializer::doEndFile() {
-            writeMtlFile(m_mtlStream, m_objects);
-            writeObjFile(m_objStream, m_mtlFilename, m_vertices.list(), m_texCoords.list(), m_normals.list(), m_objects);
+            // an empty map still gets the section headers
+            if (!m_pendingObjects.empty() || m_chunkCount == 0u) {
+                writePendingObjects();
+            }
+            writeMtlFile(m_mtlStream, m_usedTextures);
         }
 
         void ObjSerializer::doBeginEntity(const Model::Node* /* node */) {}
@@ -166,62 +146,79 @@ namespace TrenchBroom {
         void ObjSerializer::doEntityProperty(const Model::EntityProperty& /* property */) {}
 
         void ObjSerializer::doBrush(const Model::BrushNode* brush) {
-            m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-            m_currentBrush->faces.reserve(brush->brush().faceCount());
+            addPendingObject(PendingObject{brush, entityNo(), brushNo()});
+        }
 
-            // Vertex positions inserted from now on should get new indices
-            m_vertices.clearIndices();
+        void ObjSerializer::doBrushFace(const Model::BrushFace& /* face */) {
+            // faces are written together with their brushes
+        }
 
-            for (const Model::BrushFace& face : brush->brush().faces()) {
-                doBrushFace(face);
-            }
+        void ObjSerializer::doPatch(const Model::PatchNode* patchNode) {
+            addPendingObject(PendingObject{patchNode, entityNo(), brushNo()});
+        }
 
-            m_objects.push_back(std::move(*m_currentBrush));
-            m_currentBrush = std::nullopt;
+        void ObjSerializer::addPendingObject(PendingObject pendingObject) {
+            m_pendingObjects.push_back(std::move(pendingObject));
+            if (m_pendingObjects.size() == ChunkSize) {
+                writePendingObjects();
+            }
         }
 
-        void ObjSerializer::doBrushFace(const Model::BrushFace& face) {
-            const vm::vec3& normal = face.boundary().normal;
-            const size_t normalIndex = m_normals.index(normal);
+        static ObjSerializer::ObjectGeometry makeBrushGeometry(const Model::BrushNode& brushNode, const size_t entityNo, const size_t brushNo) {
+            auto vertices = ObjSerializer::IndexMap<vm::vec3>{};
+            auto texCoords = ObjSerializer::IndexMap<vm::vec2f>{};
+            auto normals = ObjSerializer::IndexMap<vm::vec3>{};
+
+            const auto& brush = brushNode.brush();
+            auto brushObject = ObjSerializer::BrushObject{entityNo, brushNo, {}};
+            brushObject.faces.reserve(brush.faceCount());
 
-            auto indexedVertices = std::vector<IndexedVertex>{};
-            indexedVertices.reserve(face.vertexCount());
+            for (const Model::BrushFace& face : brush.faces()) {
+                const size_t normalIndex = normals.index(face.boundary().normal);
 
-            for (const Model::BrushVertex* vertex : face.vertices()) {
-                const vm::vec3& position = vertex->position();
-                const vm::vec2f texCoords = face.textureCoords(position);
+                auto indexedVertices = std::vector<ObjSerializer::IndexedVertex>{};
+                indexedVertices.reserve(face.vertexCount());
 
-                const size_t vertexIndex = m_vertices.index(position);
-                const size_t texCoordsIndex = m_texCoords.index(texCoords);
+                for (const Model::BrushVertex* vertex : face.vertices()) {
+                    const vm::vec3& position = vertex->position();
+                    const vm::vec2f faceTexCoords = face.textureCoords(position);
 
-                indexedVertices.push_back(IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
+                    const size_t vertexIndex = vertices.index(position);
+                    const size_t texCoordsIndex = texCoords.index(faceTexCoords);
+
+                    indexedVertices.push_back(ObjSerializer::IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
+                }
+
+                brushObject.faces.push_back(ObjSerializer::BrushFace{std::move(indexedVertices), face.attributes().textureName(), face.texture()});
             }
 
-            m_currentBrush->faces.push_back(BrushFace{std::move(indexedVertices), face.attributes().textureName(), face.texture()});
+            return ObjSerializer::ObjectGeometry{std::move(brushObject), vertices.takeNewValues(), texCoords.takeNewValues(), normals.takeNewValues()};
         }
 
-        void ObjSerializer::doPatch(const Model::PatchNode* patchNode) {
-            const auto& patch = patchNode->patch();
-            auto patchObject = PatchObject{entityNo(), brushNo(), {}, patch.textureName(), patch.texture()};
+        static ObjSerializer::ObjectGeometry makePatchGeometry(const Model::PatchNode& patchNode, const size_t entityNo, const size_t patchNo) {
+            auto vertices = ObjSerializer::IndexMap<vm::vec3>{};
+            auto texCoords = ObjSerializer::IndexMap<vm::vec2f>{};
+            auto normals = ObjSerializer::IndexMap<vm::vec3>{};
 
-            const auto& patchGrid = patchNode->grid();
-            patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+            const auto& patch = patchNode.patch();
+            auto patchObject = ObjSerializer::PatchObject{entityNo, patchNo, {}, patch.textureName(), patch.texture()};
 
-            // Vertex positions inserted from now on should get new indices
-            m_vertices.clearIndices();
+            // the node's grid is tessellated adaptively for rendering, but exported patches always use the full resolution
+            const auto patchGrid = Model::makePatchGrid(patch, Model::MaxSubdivisionsPerSurface);
+            patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
 
             const auto makeIndexedVertex = [&](const auto& p) {
-                const size_t positionIndex = m_vertices.index(p.position);
-                const size_t texCoordsIndex = m_texCoords.index(vm::vec2f{p.texCoords});
-                const size_t normalIndex = m_normals.index(p.normal);
+                const size_t positionIndex = vertices.index(p.position);
+                const size_t texCoordsIndex = texCoords.index(vm::vec2f{p.texCoords});
+                const size_t normalIndex = normals.index(p.normal);
 
-                return IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
+                return ObjSerializer::IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
             };
 
             for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row) {
                 for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col) {
                         // counter clockwise order
-                        patchObject.quads.push_back(PatchQuad{{
+                        patchObject.quads.push_back(ObjSerializer::PatchQuad{{
                             makeIndexedVertex(patchGrid.point(row, col)),
                             makeIndexedVertex(patchGrid.point(row + 1u, col)),
                             makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
@@ -230,8 +227,103 @@ namespace TrenchBroom {
                 }
             }
 
-            m_objects.push_back(std::move(patchObject));
+            return ObjSerializer::ObjectGeometry{std::move(patchObject), vertices.takeNewValues(), texCoords.takeNewValues(), normals.takeNewValues()};
+        }
+
+        /**
+         * Writes the buffered objects as one chunk of the obj file. Each chunk lists the vertex data of its objects
+         * followed by the objects themselves, whose faces only refer to the vertex data of their chunk.
+         */
+        void ObjSerializer::writePendingObjects() {
+            // generate the geometry in parallel, the indices are local to each object at this point
+            auto geometries = kdl::vec_parallel_transform(std::exchange(m_pendingObjects, {}), [](PendingObject&& pendingObject) {
+                return std::visit(kdl::overload(
+                    [&](const Model::BrushNode* brushNode) {
+                        return makeBrushGeometry(*brushNode, pendingObject.entityNo, pendingObject.brushNo);
+                    },
+                    [&](const Model::PatchNode* patchNode) {
+                        return makePatchGeometry(*patchNode, pendingObject.entityNo, pendingObject.brushNo);
+                    }
+                ), pendingObject.node);
+            });
+
+            // the indices are assigned in order so that the output does not depend on the scheduling of the threads
+            for (auto& geometry : geometries) {
+                assignIndices(geometry);
+            }
+
+            struct FormattedObject {
+                std::string vertices;
+                std::string object;
+            };
+
+            const auto formattedObjects = kdl::vec_parallel_transform(std::move(geometries), [](ObjectGeometry&& geometry) {
+                auto objectStr = std::stringstream{};
+                objectStr << geometry.object << "\n";
+                return FormattedObject{formatVertices(geometry.vertices), objectStr.str()};
+            });
+
+            m_objStream << "# vertices\n";
+            for (const auto& formattedObject : formattedObjects) {
+                m_objStream << formattedObject.vertices;
+            }
+            m_objStream << "\n";
+            writeTexCoords(m_objStream, m_texCoords.takeNewValues());
+            m_objStream << "\n";
+            writeNormals(m_objStream, m_normals.takeNewValues());
+            m_objStream << "\n";
+
+            // later chunks write their own texture coordinates and normals
+            m_texCoords.clear();
+            m_normals.clear();
+
+            for (const auto& formattedObject : formattedObjects) {
+                m_objStream << formattedObject.object;
+            }
+
+            ++m_chunkCount;
+        }
+
+        /**
+         * Replaces the object local indices of the given geometry by indices into the vertex data of the obj file.
+         * Vertex positions are not shared between objects, but texture coordinates and normals are shared by the
+         * objects of a chunk.
+         */
+        void ObjSerializer::assignIndices(ObjectGeometry& geometry) {
+            const size_t vertexOffset = m_vertexCount;
+            m_vertexCount += geometry.vertices.size();
+
+            const auto texCoordsIndices = kdl::vec_transform(geometry.texCoords, [&](const vm::vec2f& texCoords) {
+                return m_texCoords.index(texCoords);
+            });
+            const auto normalIndices = kdl::vec_transform(geometry.normals, [&](const vm::vec3& normal) {
+                return m_normals.index(normal);
+            });
+
+            const auto assignVertexIndices = [&](IndexedVertex& vertex) {
+                vertex.vertex += vertexOffset;
+                vertex.texCoords = texCoordsIndices[vertex.texCoords];
+                vertex.normal = normalIndices[vertex.normal];
+            };
+
+            std::visit(kdl::overload(
+                [&](BrushObject& brushObject) {
+                    for (auto& face : brushObject.faces) {
+                        for (auto& vertex : face.verts) {
+                            assignVertexIndices(vertex);
+                        }
+                        m_usedTextures[face.textureName] = face.texture;
+                    }
+                },
+                [&](PatchObject& patchObject) {
+                    for (auto& quad : patchObject.quads) {
+                        for (auto& vertex : quad.verts) {
+                            assignVertexIndices(vertex);
+                        }
+                    }
+                    m_usedTextures[patchObject.textureName] = patchObject.texture;
+                }
+            ), geometry.object);
         }
     }
 }
-
@@ -25,10 +25,12 @@
 #include <vecmath/forward.h>
 
 #include <array>
+#include <functional>
 #include <iosfwd>
 #include <map>
-#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -42,36 +44,65 @@ namespace TrenchBroom {
         class BrushFace;
         class EntityProperty;
         class Node;
+        class PatchNode;
     }
 
     namespace IO {
         class ObjSerializer : public NodeSerializer {
         public:
+            /**
+             * The number of brushes and patches that are buffered before their geometry is generated and written to
+             * the obj stream. Texture coordinates and normals are only shared within a chunk, so the memory used by
+             * the serializer is bounded regardless of the size of the map.
+             */
+            static constexpr size_t ChunkSize = 4096u;
+
+            /**
+             * Assigns consecutive indices to distinct values. Values that compare equal receive the same index, so
+             * positive and negative zero components are not distinguished.
+             */
             template <typename V>
             class IndexMap {
             private:
-                std::map<V, size_t> m_map;
-                std::vector<V> m_list;
-            public:
-                const std::vector<V>& list() const {
-                    return m_list;
-                }
+                struct Hash {
+                    template <typename T, size_t S>
+                    size_t operator()(const vm::vec<T, S>& v) const {
+                        size_t result = 0;
+                        for (size_t i = 0; i < S; ++i) {
+                            const T component = v[i] == T(0) ? T(0) : v[i];
+                            result ^= std::hash<T>{}(component) + 0x9e3779b9 + (result << 6) + (result >> 2);
+                        }
+                        return result;
+                    }
+                };
 
+                std::unordered_map<V, size_t, Hash> m_map;
+                std::vector<V> m_newValues;
+                size_t m_offset = 0u;
+            public:
                 size_t index(const V& v) {
-                    const auto it = m_map.emplace(v, m_list.size()).first;
-                    const size_t index = it->second;
-                    if (index == m_list.size()) {
-                        m_list.push_back(v);
+                    const auto [it, inserted] = m_map.emplace(v, m_offset + m_map.size());
+                    if (inserted) {
+                        m_newValues.push_back(v);
                     }
-                    return index;
+                    return it->second;
+                }
+
+                /**
+                 * Returns the values that were assigned an index since the last call, ordered by their indices.
+                 */
+                std::vector<V> takeNewValues() {
+                    return std::exchange(m_newValues, {});
                 }
 
                 /**
-                 * Values inserted after this is called will not reuse indices from before this
-                 * is called.
+                 * Forgets all values. Indices continue where they left off, so values that are added again receive
+                 * new indices.
                  */
-                void clearIndices() {
+                void clear() {
+                    m_offset += m_map.size();
                     m_map.clear();
+                    m_newValues.clear();
                 }
             };
 
@@ -107,6 +138,17 @@ namespace TrenchBroom {
 
             using Object = std::variant<BrushObject, PatchObject>;
 
+            /**
+             * A brush or patch together with its vertex data. The indices of the object refer to the lists of this
+             * struct until the object is assigned its indices in the obj file.
+             */
+            struct ObjectGeometry {
+                Object object;
+                std::vector<vm::vec3> vertices;
+                std::vector<vm::vec2f> texCoords;
+                std::vector<vm::vec3> normals;
+            };
+
             friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
             friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
             friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
@@ -118,12 +160,20 @@ namespace TrenchBroom {
             std::ostream& m_mtlStream;
             std::string m_mtlFilename;
 
-            IndexMap<vm::vec3> m_vertices;
+            struct PendingObject {
+                std::variant<const Model::BrushNode*, const Model::PatchNode*> node;
+                size_t entityNo;
+                size_t brushNo;
+            };
+
+            std::vector<PendingObject> m_pendingObjects;
+            size_t m_chunkCount;
+
+            size_t m_vertexCount;
             IndexMap<vm::vec2f> m_texCoords;
             IndexMap<vm::vec3> m_normals;
 
-            std::optional<BrushObject> m_currentBrush;
-            std::vector<Object> m_objects;
+            std::map<std::string, const Assets::Texture*> m_usedTextures;
         public:
             explicit ObjSerializer(std::ostream& objStream, std::ostream& mtlStream, std::string mtlFilename);
         private:
@@ -138,6 +188,10 @@ namespace TrenchBroom {
             void doBrushFace(const Model::BrushFace& face) override;
 
             void doPatch(const Model::PatchNode* patchNode) override;
+
+            void addPendingObject(PendingObject pendingObject);
+            void writePendingObjects();
+            void assignIndices(ObjectGeometry& geometry);
         };
     }
 }
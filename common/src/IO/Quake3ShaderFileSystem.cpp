@@ -19,17 +19,23 @@
 
 #include "Quake3ShaderFileSystem.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
 #include "Assets/Quake3Shader.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/ParserStatus.h"
 #include "IO/Quake3ShaderParser.h"
-#include "IO/SimpleParserStatus.h"
 
+#include <kdl/parallel.h>
+#include <kdl/string_compare.h>
 #include <kdl/vector_utils.h>
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -49,22 +55,67 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Collects the messages of a parser so that they can be logged after parsing on another thread has finished.
+         */
+        class BufferedParserStatus : public ParserStatus {
+        public:
+            std::vector<std::pair<LogLevel, std::string>> messages;
+        public:
+            BufferedParserStatus(Logger& logger, const std::string& prefix) :
+            ParserStatus(logger, prefix) {}
+        private:
+            void doProgress(const double /* progress */) override {}
+
+            void doLog(const LogLevel level, const std::string& str) override {
+                messages.emplace_back(level, str);
+            }
+        };
+
+        struct LoadedShaderFile {
+            std::vector<Assets::Quake3Shader> shaders;
+            std::vector<std::pair<LogLevel, std::string>> messages;
+            std::optional<std::string> error;
+        };
+
         std::vector<Assets::Quake3Shader> Quake3ShaderFileSystem::loadShaders() const {
             auto result = std::vector<Assets::Quake3Shader>();
 
             if (next().directoryExists(m_shaderSearchPath)) {
                 const auto paths = next().findItems(m_shaderSearchPath, FileExtensionMatcher("shader"));
-                for (const auto& path : paths) {
-                    const auto file = next().openFile(path);
-                    auto bufferedReader = file->reader().buffer();
+
+                // shader files are opened, which usually means decompressing them, and parsed in parallel; messages are
+                // logged afterwards in the order of the files
+                auto shaderFiles = std::vector<LoadedShaderFile>(paths.size());
+                kdl::parallel_for(paths.size(), [&](const size_t i) {
+                    const auto& path = paths[i];
+                    auto& shaderFile = shaderFiles[i];
 
                     try {
-                        Quake3ShaderParser parser(bufferedReader.stringView());
-                        SimpleParserStatus status(m_logger, file->path().asString());
-                        result = kdl::vec_concat(std::move(result), parser.parse(status));
-                    } catch (const ParserException& e) {
-                        m_logger.warn() << "Skipping malformed shader file " << path << ": " << e.what();
+                        const auto file = next().openFile(path);
+                        auto bufferedReader = file->reader().buffer();
+
+                        BufferedParserStatus status(m_logger, file->path().asString());
+                        try {
+                            Quake3ShaderParser parser(bufferedReader.stringView());
+                            shaderFile.shaders = parser.parse(status);
+                        } catch (const ParserException& e) {
+                            status.messages.emplace_back(LogLevel::Warn, "Skipping malformed shader file " + path.asString() + ": " + e.what());
+                        }
+                        shaderFile.messages = std::move(status.messages);
+                    } catch (const std::exception& e) {
+                        shaderFile.error = e.what();
+                    }
+                });
+
+                for (auto& shaderFile : shaderFiles) {
+                    if (shaderFile.error) {
+                        throw FileSystemException(std::move(*shaderFile.error));
+                    }
+                    for (const auto& [level, message] : shaderFile.messages) {
+                        m_logger.log(level, message);
                     }
+                    result = kdl::vec_concat(std::move(result), std::move(shaderFile.shaders));
                 }
             }
 
@@ -89,24 +140,30 @@ namespace TrenchBroom {
 
         void Quake3ShaderFileSystem::linkTextures(const std::vector<Path>& textures, std::vector<Assets::Quake3Shader>& shaders) {
             m_logger.debug() << "Linking textures...";
+
+            // join textures and shaders on their case insensitive names, the first shader with a given name wins
+            auto shadersByName = std::unordered_map<std::string, size_t, kdl::ci::string_hash, kdl::ci::string_equal>();
+            shadersByName.reserve(shaders.size());
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                shadersByName.emplace(shaders[i].shaderPath.asString("/"), i);
+            }
+
+            auto linked = std::vector<bool>(shaders.size(), false);
             for (const auto& texture : textures) {
                 const auto shaderPath = texture.deleteExtension();
 
                 // Only link a shader if it has not been linked yet.
                 if (!fileExists(shaderPath)) {
-                    const auto shaderIt = std::find_if(std::begin(shaders), std::end(shaders), [&shaderPath](const auto& shader){
-                        return shaderPath == shader.shaderPath;
-                    });
-
-                    if (shaderIt != std::end(shaders)) {
+                    const auto shaderIt = shadersByName.find(shaderPath.asString("/"));
+                    if (shaderIt != std::end(shadersByName)) {
                         // Found a matching shader.
-                        auto& shader = *shaderIt;
+                        const auto& shader = shaders[shaderIt->second];
 
                         auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
-                        m_root.addFile(shaderPath, shaderFile);
+                        addFile(shaderPath, shaderFile);
 
-                        // Remove the shader so that we don't revisit it when linking standalone shaders.
-                        shaders.erase(shaderIt);
+                        // Mark the shader so that we don't revisit it when linking standalone shaders.
+                        linked[shaderIt->second] = true;
                     } else {
                         // No matching shader found, generate one.
                         auto shader = Assets::Quake3Shader();
@@ -114,10 +171,19 @@ namespace TrenchBroom {
                         shader.editorImage = texture;
 
                         auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, std::move(shader));
-                        m_root.addFile(shaderPath, std::move(shaderFile));
+                        addFile(shaderPath, std::move(shaderFile));
                     }
                 }
             }
+
+            auto unlinked = std::vector<Assets::Quake3Shader>();
+            unlinked.reserve(shaders.size());
+            for (size_t i = 0; i < shaders.size(); ++i) {
+                if (!linked[i]) {
+                    unlinked.push_back(std::move(shaders[i]));
+                }
+            }
+            shaders = std::move(unlinked);
         }
 
         void Quake3ShaderFileSystem::linkStandaloneShaders(std::vector<Assets::Quake3Shader>& shaders) {
@@ -125,7 +191,7 @@ namespace TrenchBroom {
             for (auto& shader : shaders) {
                 const auto& shaderPath = shader.shaderPath;
                 auto shaderFile = std::make_shared<ObjectFile<Assets::Quake3Shader>>(shaderPath, shader);
-                m_root.addFile(shaderPath, std::move(shaderFile));
+                addFile(shaderPath, std::move(shaderFile));
             }
         }
     }
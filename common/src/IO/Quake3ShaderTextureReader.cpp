@@ -86,7 +86,8 @@ namespace TrenchBroom {
             }
 
             FreeImageTextureReader imageReader(StaticNameStrategy(name), m_fs, m_logger);
-            return imageReader.readTexture(m_fs.openFile(imagePath));
+            // errors are reported by readTexture when reading the shader
+            return imageReader.readTextureOrThrow(m_fs.openFile(imagePath));
         }
 
         Path Quake3ShaderTextureReader::findTexturePath(const Assets::Quake3Shader& shader) const {
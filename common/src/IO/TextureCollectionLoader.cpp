@@ -20,6 +20,7 @@
 #include "TextureCollectionLoader.h"
 
 #include "Logger.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
@@ -28,7 +29,10 @@
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <kdl/parallel.h>
+
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,6 +52,54 @@ namespace TrenchBroom {
             return false;
         }
 
+        /**
+         * Files in archives are views into a host file that is shared by all of its entries, and reading from the host
+         * file is not thread safe. Such files are read into memory here so that they can be decoded concurrently.
+         */
+        static std::shared_ptr<File> bufferFileView(std::shared_ptr<File> file) {
+            if (dynamic_cast<const FileView*>(file.get()) == nullptr) {
+                return file;
+            }
+
+            try {
+                const auto size = file->size();
+                auto buffer = std::make_unique<char[]>(size);
+                file->reader().read(buffer.get(), size);
+                return std::make_shared<OwningBufferFile>(file->path(), std::move(buffer), size);
+            } catch (const std::exception&) {
+                // the error is reported when the texture is read sequentially
+                return file;
+            }
+        }
+
+        std::vector<std::optional<Assets::Texture>> TextureCollectionLoader::readTextures(const FileList& files, const TextureReader& textureReader) {
+            auto bufferedFiles = FileList();
+            bufferedFiles.reserve(files.size());
+            for (const auto& file : files) {
+                bufferedFiles.push_back(bufferFileView(file));
+            }
+
+            auto textures = kdl::vec_parallel_transform(bufferedFiles, [&](std::shared_ptr<File>&& file) -> std::optional<Assets::Texture> {
+                try {
+                    return textureReader.readTextureOrThrow(file);
+                } catch (const std::exception&) {
+                    return std::nullopt;
+                }
+            });
+
+            for (size_t i = 0; i < bufferedFiles.size(); ++i) {
+                if (!textures[i]) {
+                    try {
+                        textures[i] = textureReader.readTexture(bufferedFiles[i]);
+                    } catch (const std::exception& e) {
+                        m_logger.warn() << e.what();
+                    }
+                }
+            }
+
+            return textures;
+        }
+
         FileTextureCollectionLoader::FileTextureCollectionLoader(Logger& logger, const std::vector<IO::Path>& searchPaths, const std::vector<std::string>& exclusions) :
         TextureCollectionLoader(logger, exclusions),
         m_searchPaths(searchPaths) {}
@@ -57,8 +109,8 @@ namespace TrenchBroom {
             WadFileSystem wadFS(wadPath, m_logger);
 
             const auto texturePaths = wadFS.findItems(Path(""), FileExtensionMatcher(textureExtensions));
-            auto textures = std::vector<Assets::Texture>();
-            textures.reserve(texturePaths.size());
+            auto files = FileList();
+            files.reserve(texturePaths.size());
             
             for (const auto& texturePath : texturePaths)  {
                 try {
@@ -67,12 +119,21 @@ namespace TrenchBroom {
                     if (shouldExclude(name)) {
                         continue;
                     }
-                    textures.push_back(textureReader.readTexture(file));
+                    files.push_back(std::move(file));
                 } catch (const std::exception& e) {
                     m_logger.warn() << e.what();
                 }
             }
 
+            auto textures = std::vector<Assets::Texture>();
+            textures.reserve(files.size());
+
+            for (auto& texture : readTextures(files, textureReader)) {
+                if (texture) {
+                    textures.push_back(std::move(*texture));
+                }
+            }
+
             return Assets::TextureCollection(path, std::move(textures));
         }
 
@@ -82,8 +143,12 @@ namespace TrenchBroom {
 
         Assets::TextureCollection DirectoryTextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
             const auto texturePaths = m_gameFS.findItems(path, FileExtensionMatcher(textureExtensions));
-            auto textures = std::vector<Assets::Texture>();
-            textures.reserve(texturePaths.size());
+            auto files = FileList();
+            auto absolutePaths = std::vector<Path>();
+            auto relativePaths = std::vector<Path>();
+            files.reserve(texturePaths.size());
+            absolutePaths.reserve(texturePaths.size());
+            relativePaths.reserve(texturePaths.size());
 
             for (const auto& texturePath : texturePaths) {
                 try {
@@ -101,14 +166,25 @@ namespace TrenchBroom {
                     if (shouldExclude(name)) {
                         continue;
                     }
-                    auto texture = textureReader.readTexture(file);
-                    texture.setAbsolutePath(absolutePath);
-                    texture.setRelativePath(texturePath);
-                    textures.push_back(std::move(texture));
+                    files.push_back(std::move(file));
+                    absolutePaths.push_back(absolutePath);
+                    relativePaths.push_back(texturePath);
                 } catch (const std::exception& e) {
                     m_logger.warn() << e.what();
                 }
             }
+
+            auto textures = std::vector<Assets::Texture>();
+            textures.reserve(files.size());
+
+            auto readResults = readTextures(files, textureReader);
+            for (size_t i = 0; i < readResults.size(); ++i) {
+                if (auto& texture = readResults[i]) {
+                    texture->setAbsolutePath(absolutePaths[i]);
+                    texture->setRelativePath(relativePaths[i]);
+                    textures.push_back(std::move(*texture));
+                }
+            }
             
             return Assets::TextureCollection(path, std::move(textures));
         }
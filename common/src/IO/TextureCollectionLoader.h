@@ -20,6 +20,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <string>
@@ -28,6 +29,7 @@ namespace TrenchBroom {
     class Logger;
 
     namespace Assets {
+        class Texture;
         class TextureCollection;
     }
 
@@ -51,6 +53,14 @@ namespace TrenchBroom {
             virtual Assets::TextureCollection loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) = 0;
         protected:
             bool shouldExclude(const std::string& textureName);
+
+            /**
+             * Reads the given files on worker threads. Since the readers may neither log nor load the default texture
+             * concurrently, every file that cannot be read on a worker thread is read again on the calling thread
+             * using TextureReader::readTexture. The returned vector contains an empty optional for every file that
+             * could not be read at all.
+             */
+            std::vector<std::optional<Assets::Texture>> readTextures(const FileList& files, const TextureReader& textureReader);
         };
 
         class FileTextureCollectionLoader : public TextureCollectionLoader {
@@ -96,6 +96,10 @@ namespace TrenchBroom {
             }
         }
 
+        Assets::Texture TextureReader::readTextureOrThrow(std::shared_ptr<File> file) const {
+            return doReadTexture(file);
+        }
+
         std::string TextureReader::textureName(const std::string& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
@@ -118,6 +118,17 @@ namespace TrenchBroom {
              * @return an Assets::Texture object
              */
             Assets::Texture readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Loads a texture from the given file and returns it. Unlike readTexture, this function neither logs errors
+             * nor falls back to the default texture, so it can be called from worker threads.
+             *
+             * @param file the file containing the texture
+             * @return an Assets::Texture object
+             *
+             * @throws AssetException if the texture cannot be read
+             */
+            Assets::Texture readTextureOrThrow(std::shared_ptr<File> file) const;
         protected:
             std::string textureName(const std::string& textureName, const Path& path) const;
             std::string textureName(const Path& path) const;
@@ -22,11 +22,61 @@
 #include "IO/File.h"
 #include "IO/DiskFileSystem.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
 namespace TrenchBroom {
     namespace IO {
+        // ZipFileSystem::DecompressedFileCache
+
+        ZipFileSystem::DecompressedFileCache::DecompressedFileCache(const size_t capacity) :
+        m_capacity(capacity),
+        m_size(0u) {}
+
+        std::shared_ptr<File> ZipFileSystem::DecompressedFileCache::get(const mz_uint fileIndex) {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            const auto it = m_index.find(fileIndex);
+            if (it == std::end(m_index)) {
+                return nullptr;
+            }
+
+            // mark the entry as most recently used
+            m_entries.splice(std::begin(m_entries), m_entries, it->second);
+            return it->second->second;
+        }
+
+        void ZipFileSystem::DecompressedFileCache::put(const mz_uint fileIndex, std::shared_ptr<File> file) {
+            const auto fileSize = file->size();
+            if (fileSize > m_capacity) {
+                return;
+            }
+
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            if (m_index.count(fileIndex) > 0u) {
+                // another thread has decompressed the same file in the meantime
+                return;
+            }
+
+            m_entries.emplace_front(fileIndex, std::move(file));
+            m_index.emplace(fileIndex, std::begin(m_entries));
+            m_size += fileSize;
+
+            while (m_size > m_capacity) {
+                const auto& [evictedIndex, evictedFile] = m_entries.back();
+                m_size -= evictedFile->size();
+                m_index.erase(evictedIndex);
+                m_entries.pop_back();
+            }
+        }
+
+        void ZipFileSystem::DecompressedFileCache::clear() {
+            const auto lock = std::lock_guard<std::mutex>(m_mutex);
+            m_entries.clear();
+            m_index.clear();
+            m_size = 0u;
+        }
+
         // ZipFileSystem::ZipCompressedFile
 
         ZipFileSystem::ZipCompressedFile::ZipCompressedFile(ZipFileSystem* owner, const mz_uint fileIndex) :
@@ -34,22 +84,13 @@ namespace TrenchBroom {
         m_fileIndex(fileIndex) {}
 
         std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
-            const auto path = Path(m_owner->filename(m_fileIndex));
-
-            mz_zip_archive_file_stat stat;
-            if (!mz_zip_reader_file_stat(&m_owner->m_archive, m_fileIndex, &stat)) {
-                throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
-            }
-
-            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
-            auto data = std::make_unique<char[]>(uncompressedSize);
-            auto* begin = data.get();
-
-            if (!mz_zip_reader_extract_to_mem(&m_owner->m_archive, m_fileIndex, begin, uncompressedSize, 0)) {
-                throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
+            if (auto file = m_owner->m_cache.get(m_fileIndex)) {
+                return file;
             }
 
-            return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
+            auto file = m_owner->extractFile(m_fileIndex);
+            m_owner->m_cache.put(m_fileIndex, file);
+            return file;
         }
 
         // ZipFileSystem
@@ -58,26 +99,51 @@ namespace TrenchBroom {
         ZipFileSystem(nullptr, path) {}
 
         ZipFileSystem::ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path) :
-        ImageFileSystem(std::move(next), path) {
-            initialize();
+        ImageFileSystem(std::move(next), path),
+        m_cache(DefaultCacheCapacity) {
+            mz_zip_zero_struct(&m_archive);
+
+            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
+                throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': Error calling mz_zip_reader_init_cfile");
+            }
+
+            try {
+                validateDirectory();
+            } catch (...) {
+                mz_zip_reader_end(&m_archive);
+                throw;
+            }
+
+            initializeLazily();
         }
 
         ZipFileSystem::~ZipFileSystem() {
             mz_zip_reader_end(&m_archive);
         }
 
-        void ZipFileSystem::doReadDirectory() {
-            mz_zip_zero_struct(&m_archive);
-
-            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-                throw FileSystemException("Error calling mz_zip_reader_init_cfile");
+        /**
+         * Checks that the central directory entry of every file in the archive can be read.
+         */
+        void ZipFileSystem::validateDirectory() {
+            const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
+            for (mz_uint i = 0; i < numFiles; ++i) {
+                mz_zip_archive_file_stat stat;
+                if (!mz_zip_reader_file_stat(&m_archive, i, &stat)) {
+                    const auto err = mz_zip_get_last_error(&m_archive);
+                    throw FileSystemException("Could not initialize image file system '" + m_path.asString() + "': " + mz_zip_get_error_string(err));
+                }
             }
+        }
 
+        void ZipFileSystem::doReadDirectory() {
+            m_cache.clear();
+
+            const auto lock = std::lock_guard<std::mutex>(m_archiveMutex);
             const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
             for (mz_uint i = 0; i < numFiles; ++i) {
                 if (!mz_zip_reader_is_file_a_directory(&m_archive, i)) {
                     const auto path = Path(filename(i));
-                    m_root.addFile(path, std::make_unique<ZipCompressedFile>(this, i));
+                    addFile(path, std::make_unique<ZipCompressedFile>(this, i));
                 }
             }
 
@@ -87,6 +153,59 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Reads the compressed data of the file with the given index while holding the archive lock and decompresses it
+         * afterwards, so that several files can be decompressed in parallel.
+         */
+        std::shared_ptr<File> ZipFileSystem::extractFile(const mz_uint fileIndex) {
+            auto path = Path();
+            mz_zip_archive_file_stat stat;
+            auto compressedData = std::unique_ptr<unsigned char[]>();
+
+            {
+                const auto lock = std::lock_guard<std::mutex>(m_archiveMutex);
+                path = Path(filename(fileIndex));
+
+                if (!mz_zip_reader_file_stat(&m_archive, fileIndex, &stat)) {
+                    throw FileSystemException("mz_zip_reader_file_stat failed for " + path.asString());
+                }
+
+                const auto compressedSize = static_cast<size_t>(stat.m_comp_size);
+                compressedData = std::make_unique<unsigned char[]>(compressedSize);
+                if (!mz_zip_reader_extract_to_mem(&m_archive, fileIndex, compressedData.get(), compressedSize, MZ_ZIP_FLAG_COMPRESSED_DATA)) {
+                    throw FileSystemException("mz_zip_reader_extract_to_mem failed for " + path.asString());
+                }
+            }
+
+            const auto compressedSize = static_cast<size_t>(stat.m_comp_size);
+            const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
+            auto data = std::make_unique<char[]>(uncompressedSize);
+
+            if (uncompressedSize == 0u) {
+                // nothing to decompress
+            } else if (stat.m_method == 0) {
+                // the file is stored without compression
+                if (compressedSize != uncompressedSize) {
+                    throw FileSystemException("Invalid size of stored file " + path.asString());
+                }
+                std::copy_n(compressedData.get(), uncompressedSize, data.get());
+            } else if (stat.m_method == MZ_DEFLATED) {
+                const auto size = tinfl_decompress_mem_to_mem(data.get(), uncompressedSize, compressedData.get(), compressedSize, 0);
+                if (size != uncompressedSize) {
+                    throw FileSystemException("Decompression failed for " + path.asString());
+                }
+            } else {
+                throw FileSystemException("Unsupported compression method for " + path.asString());
+            }
+
+            const auto crc = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(data.get()), uncompressedSize);
+            if (crc != stat.m_crc32) {
+                throw FileSystemException("CRC mismatch for " + path.asString());
+            }
+
+            return std::make_shared<OwningBufferFile>(path, std::move(data), uncompressedSize);
+        }
+
         /**
          * Helper to get the filename of a file in the zip archive
          */
@@ -21,7 +21,12 @@
 
 #include "IO/ImageFileSystem.h"
 
+#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <miniz/miniz.h>
 
@@ -29,10 +34,38 @@ namespace TrenchBroom {
     namespace IO {
         class Path;
 
+        /**
+         * A file system for zip archives such as pk3 files.
+         *
+         * The central directory of the archive is read and validated when the file system is created, so that a
+         * damaged archive is reported when it is mounted, but the directory tree is only built when the file system is
+         * accessed for the first time. Decompressed files are kept in a bounded
+         * cache, and files may be opened from several threads at once. Reading the compressed data is serialized,
+         * but decompressing it is not.
+         */
         class ZipFileSystem : public ImageFileSystem {
         private:
-            mz_zip_archive m_archive;
-        private:
+            /**
+             * Caches the most recently opened files up to a total uncompressed size. All functions are thread safe.
+             */
+            class DecompressedFileCache {
+            private:
+                using Entry = std::pair<mz_uint, std::shared_ptr<File>>;
+                using EntryList = std::list<Entry>;
+
+                size_t m_capacity;
+                size_t m_size;
+                EntryList m_entries;
+                std::unordered_map<mz_uint, EntryList::iterator> m_index;
+                mutable std::mutex m_mutex;
+            public:
+                explicit DecompressedFileCache(size_t capacity);
+
+                std::shared_ptr<File> get(mz_uint fileIndex);
+                void put(mz_uint fileIndex, std::shared_ptr<File> file);
+                void clear();
+            };
+
             class ZipCompressedFile : public FileEntry {
             private:
                 ZipFileSystem* m_owner;
@@ -43,15 +76,25 @@ namespace TrenchBroom {
                 std::shared_ptr<File> doOpen() const override;
             };
             friend class ZipCompressedFile;
+
+            mz_zip_archive m_archive;
+            /** Guards m_archive, which is not safe to use from several threads. */
+            std::mutex m_archiveMutex;
+            DecompressedFileCache m_cache;
         public:
+            /** The default capacity of the decompressed file cache in bytes. */
+            static constexpr size_t DefaultCacheCapacity = 32u * 1024u * 1024u;
+
             explicit ZipFileSystem(const Path& path);
             ZipFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
             ~ZipFileSystem() override;
         private:
+            void validateDirectory();
             void doReadDirectory() override;
+
+            std::shared_ptr<File> extractFile(mz_uint fileIndex);
         private:
             std::string filename(mz_uint fileIndex);
         };
     }
 }
-
@@ -100,6 +100,25 @@ namespace TrenchBroom {
                 .and_then([&]() { return std::move(brush); });
         }
 
+        kdl::result<Brush, BrushError> Brush::create(std::vector<BrushFace> faces, std::unique_ptr<BrushGeometry> geometry) {
+            if (geometry->faceCount() != faces.size()) {
+                return BrushError::InvalidBrush;
+            }
+
+            Brush brush(std::move(faces));
+
+            size_t faceIndex = 0u;
+            for (BrushFaceGeometry* faceGeometry : geometry->faces()) {
+                brush.m_faces[faceIndex].setGeometry(faceGeometry);
+                faceGeometry->setPayload(faceIndex);
+                ++faceIndex;
+            }
+            brush.m_geometry = std::move(geometry);
+
+            assert(brush.checkFaceLinks());
+            return brush;
+        }
+
         kdl::result<void, BrushError> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds) {
             // First, add all faces to the brush geometry
             BrushFace::sortFaces(m_faces);
@@ -894,8 +913,10 @@ namespace TrenchBroom {
         }
 
         kdl::result<void, BrushError> Brush::transform(const vm::bbox3& worldBounds, const vm::mat4x4& transformation, const bool lockTextures) {
+            // all faces share the same transformation, so the matrix inverse needed for texture lock is computed once
+            const TexCoordSystemTransform texCoordSystemTransform(transformation);
             for (auto& face : m_faces) {
-                if (const auto transformResult = face.transform(transformation, lockTextures); !transformResult) {
+                if (const auto transformResult = face.transform(texCoordSystemTransform, lockTextures); !transformResult) {
                     return BrushError::InvalidFace;
                 }
             }
@@ -65,6 +65,13 @@ namespace TrenchBroom {
             ~Brush();
             
             static kdl::result<Brush, BrushError> create(const vm::bbox3& worldBounds, std::vector<BrushFace> faces);
+
+            /**
+             * Creates a brush from the given faces and the given geometry instead of computing the geometry from the
+             * face boundaries. The faces of the geometry must correspond to the given faces in order, and the geometry
+             * must be the one that would be computed from the faces.
+             */
+            static kdl::result<Brush, BrushError> create(std::vector<BrushFace> faces, std::unique_ptr<BrushGeometry> geometry);
         private:
             Brush(std::vector<BrushFace> faces);
 
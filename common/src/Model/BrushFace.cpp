@@ -65,7 +65,7 @@ namespace TrenchBroom {
         m_boundary(other.m_boundary),
         m_attributes(other.m_attributes),
         m_textureReference(other.m_textureReference),
-        m_texCoordSystem(other.m_texCoordSystem ? other.m_texCoordSystem->clone() : nullptr),
+        m_texCoordSystem(other.m_texCoordSystem),
         m_geometry(nullptr),
         m_lineNumber(other.m_lineNumber),
         m_lineCount(other.m_lineCount),
@@ -110,60 +110,44 @@ namespace TrenchBroom {
 
         kdl::result<BrushFace, BrushError> BrushFace::create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, const MapFormat mapFormat) {
             return Model::isParallelTexCoordSystem(mapFormat)
-                   ? BrushFace::create(point0, point1, point2, attributes, std::make_unique<ParallelTexCoordSystem>(point0, point1, point2, attributes))
-                   : BrushFace::create(point0, point1, point2, attributes, std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, attributes));
+                   ? BrushFace::create(point0, point1, point2, attributes, ParallelTexCoordSystem(point0, point1, point2, attributes))
+                   : BrushFace::create(point0, point1, point2, attributes, ParaxialTexCoordSystem(point0, point1, point2, attributes));
         }
 
         kdl::result<BrushFace, BrushError> BrushFace::createFromStandard(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& inputAttribs, const MapFormat mapFormat) {
             assert(mapFormat != MapFormat::Unknown);
 
-            std::unique_ptr<TexCoordSystem> texCoordSystem;
-            BrushFaceAttributes attribs("");
-
             if (Model::isParallelTexCoordSystem(mapFormat)) {
                 // Convert paraxial to parallel
-                std::tie(texCoordSystem, attribs) = ParallelTexCoordSystem::fromParaxial(point0, point1, point2, inputAttribs);
+                auto [texCoordSystem, attribs] = ParallelTexCoordSystem::fromParaxial(point0, point1, point2, inputAttribs);
+                return BrushFace::create(point0, point1, point2, attribs, std::move(texCoordSystem));
             } else {
                 // Pass through paraxial
-                texCoordSystem = std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, inputAttribs);
-                attribs = inputAttribs;
+                return BrushFace::create(point0, point1, point2, inputAttribs, ParaxialTexCoordSystem(point0, point1, point2, inputAttribs));
             }
-
-            return BrushFace::create(point0, point1, point2, attribs, std::move(texCoordSystem));
         }
 
         kdl::result<BrushFace, BrushError> BrushFace::createFromValve(const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const BrushFaceAttributes& inputAttribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, MapFormat mapFormat) {
             assert(mapFormat != MapFormat::Unknown);
 
-            std::unique_ptr<TexCoordSystem> texCoordSystem;
-            BrushFaceAttributes attribs("");
-
             if (Model::isParallelTexCoordSystem(mapFormat)) {
                 // Pass through parallel
-                texCoordSystem = std::make_unique<ParallelTexCoordSystem>(texAxisX, texAxisY);
-                attribs = inputAttribs;
+                return BrushFace::create(point1, point2, point3, inputAttribs, ParallelTexCoordSystem(texAxisX, texAxisY));
             } else {
                 // Convert parallel to paraxial
-                std::tie(texCoordSystem, attribs) = ParaxialTexCoordSystem::fromParallel(point1, point2, point3, inputAttribs, texAxisX, texAxisY);
+                auto [texCoordSystem, attribs] = ParaxialTexCoordSystem::fromParallel(point1, point2, point3, inputAttribs, texAxisX, texAxisY);
+                return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
             }
-
-            return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
         }
 
         kdl::result<BrushFace, BrushError> BrushFace::createFromSource(const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const BrushFaceAttributes& inputAttribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, MapFormat mapFormat) {
             assert(mapFormat != MapFormat::Unknown);
 
-            std::unique_ptr<TexCoordSystem> texCoordSystem;
-            BrushFaceAttributes attribs("");
-
             // Pass through parallel
-            texCoordSystem = std::make_unique<ParallelTexCoordSystem>(texAxisX, texAxisY);
-            attribs = inputAttribs;
-
-            return BrushFace::create(point1, point2, point3, attribs, std::move(texCoordSystem));
+            return BrushFace::create(point1, point2, point3, inputAttribs, ParallelTexCoordSystem(texAxisX, texAxisY));
         }
 
-        kdl::result<BrushFace, BrushError> BrushFace::create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem) {
+        kdl::result<BrushFace, BrushError> BrushFace::create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem) {
             Points points = {{ vm::correct(point0), vm::correct(point1), vm::correct(point2) }};
             const auto [result, plane] = vm::from_points(points[0], points[1], points[2]);
             if (result) {
@@ -173,7 +157,7 @@ namespace TrenchBroom {
             }
         }
 
-        BrushFace::BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem) :
+        BrushFace::BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem) :
         m_points(points),
         m_boundary(boundary),
         m_attributes(attributes),
@@ -182,15 +166,13 @@ namespace TrenchBroom {
         m_lineNumber(0),
         m_lineCount(0),
         m_selected(false),
-        m_markedToRenderFace(false) {
-            ensure(m_texCoordSystem != nullptr, "texCoordSystem is null");
-        }
+        m_markedToRenderFace(false) {}
 
         bool operator==(const BrushFace& lhs, const BrushFace& rhs) {
             return lhs.m_points == rhs.m_points &&
             lhs.m_boundary == rhs.m_boundary &&
             lhs.m_attributes == rhs.m_attributes &&
-            *lhs.m_texCoordSystem == *rhs.m_texCoordSystem &&
+            asTexCoordSystem(lhs.m_texCoordSystem) == asTexCoordSystem(rhs.m_texCoordSystem) &&
             lhs.m_lineNumber == rhs.m_lineNumber &&
             lhs.m_lineCount == rhs.m_lineCount &&
             lhs.m_selected == rhs.m_selected;
@@ -228,11 +210,11 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const {
-            return m_texCoordSystem->takeSnapshot();
+            return asTexCoordSystem(m_texCoordSystem).takeSnapshot();
         }
 
         void BrushFace::restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot) {
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(asTexCoordSystem(m_texCoordSystem));
         }
 
         void BrushFace::copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attributes, const vm::plane3& sourceFacePlane, const WrapStyle wrapStyle) {
@@ -240,16 +222,16 @@ namespace TrenchBroom {
             const auto seam = vm::intersect_plane_plane(sourceFacePlane, m_boundary);
             const auto refPoint = vm::project_point(seam, center());
 
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(asTexCoordSystem(m_texCoordSystem));
 
             // Get the texcoords at the refPoint using the source face's attributes and tex coord system
-            const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, attributes, vm::vec2f::one());
+            const auto desriedCoords = asTexCoordSystem(m_texCoordSystem).getTexCoords(refPoint, attributes, vm::vec2f::one());
 
-            m_texCoordSystem->updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attributes, wrapStyle);
+            asTexCoordSystem(m_texCoordSystem).updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attributes, wrapStyle);
 
             // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
             if (!vm::is_zero(seam.direction, vm::C::almost_zero())) {
-                const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+                const auto currentCoords = asTexCoordSystem(m_texCoordSystem).getTexCoords(refPoint, m_attributes, vm::vec2f::one());
                 const auto offsetChange = desriedCoords - currentCoords;
                 m_attributes.setOffset(correct(modOffset(m_attributes.offset() + offsetChange), 4));
             }
@@ -345,7 +327,7 @@ namespace TrenchBroom {
         void BrushFace::setAttributes(const BrushFaceAttributes& attributes) {
             const float oldRotation = m_attributes.rotation();
             m_attributes = attributes;
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+            asTexCoordSystem(m_texCoordSystem).setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
         }
 
         bool BrushFace::setAttributes(const BrushFace& other) {
@@ -363,13 +345,11 @@ namespace TrenchBroom {
         }
 
         void BrushFace::resetTexCoordSystemCache() {
-            if (m_texCoordSystem != nullptr) {
-                m_texCoordSystem->resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
-            }
+            asTexCoordSystem(m_texCoordSystem).resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
         }
 
         const TexCoordSystem& BrushFace::texCoordSystem() const {
-            return *m_texCoordSystem;
+            return asTexCoordSystem(m_texCoordSystem);
         }
 
         const Assets::Texture* BrushFace::texture() const {
@@ -398,31 +378,41 @@ namespace TrenchBroom {
             return true;
         }
 
+        bool BrushFace::setTexture(Assets::Texture* texture, Assets::TextureUsageCounts& usageCounts) {
+            if (texture == this->texture()) {
+                return false;
+            }
+
+            usageCounts.dec(m_textureReference.exchangeUncounted(texture));
+            usageCounts.inc(texture);
+            return true;
+        }
+
         vm::vec3 BrushFace::textureXAxis() const {
-            return m_texCoordSystem->xAxis();
+            return asTexCoordSystem(m_texCoordSystem).xAxis();
         }
 
         vm::vec3 BrushFace::textureYAxis() const {
-            return m_texCoordSystem->yAxis();
+            return asTexCoordSystem(m_texCoordSystem).yAxis();
         }
 
         void BrushFace::resetTextureAxes() {
-            m_texCoordSystem->resetTextureAxes(m_boundary.normal);
+            asTexCoordSystem(m_texCoordSystem).resetTextureAxes(m_boundary.normal);
         }
 
         void BrushFace::resetTextureAxesToParaxial() {
-            m_texCoordSystem->resetTextureAxesToParaxial(m_boundary.normal, 0.0f);
+            asTexCoordSystem(m_texCoordSystem).resetTextureAxesToParaxial(m_boundary.normal, 0.0f);
         }
 
         void BrushFace::convertToParaxial() {
-            auto [newTexCoordSystem, newAttributes] = m_texCoordSystem->toParaxial(m_points[0], m_points[1], m_points[2], m_attributes);
+            auto [newTexCoordSystem, newAttributes] = asTexCoordSystem(m_texCoordSystem).toParaxial(m_points[0], m_points[1], m_points[2], m_attributes);
 
             m_attributes = newAttributes;
             m_texCoordSystem = std::move(newTexCoordSystem);
         }
 
         void BrushFace::convertToParallel() {
-            auto [newTexCoordSystem, newAttributes] = m_texCoordSystem->toParallel(m_points[0], m_points[1], m_points[2], m_attributes);
+            auto [newTexCoordSystem, newAttributes] = asTexCoordSystem(m_texCoordSystem).toParallel(m_points[0], m_points[1], m_points[2], m_attributes);
 
             m_attributes = newAttributes;
             m_texCoordSystem = std::move(newTexCoordSystem);
@@ -430,21 +420,21 @@ namespace TrenchBroom {
 
 
         void BrushFace::moveTexture(const vm::vec3& up, const vm::vec3& right, const vm::vec2f& offset) {
-            m_texCoordSystem->moveTexture(m_boundary.normal, up, right, offset, m_attributes);
+            asTexCoordSystem(m_texCoordSystem).moveTexture(m_boundary.normal, up, right, offset, m_attributes);
         }
 
         void BrushFace::rotateTexture(const float angle) {
             const float oldRotation = m_attributes.rotation();
-            m_texCoordSystem->rotateTexture(m_boundary.normal, angle, m_attributes);
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+            asTexCoordSystem(m_texCoordSystem).rotateTexture(m_boundary.normal, angle, m_attributes);
+            asTexCoordSystem(m_texCoordSystem).setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
         }
 
         void BrushFace::shearTexture(const vm::vec2f& factors) {
-            m_texCoordSystem->shearTexture(m_boundary.normal, factors);
+            asTexCoordSystem(m_texCoordSystem).shearTexture(m_boundary.normal, factors);
         }
 
         void BrushFace::flipTexture(const vm::vec3& /* cameraUp */, const vm::vec3& cameraRight, const vm::direction cameraRelativeFlipDirection) {
-            const vm::mat4x4 texToWorld = m_texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one());
+            const vm::mat4x4 texToWorld = asTexCoordSystem(m_texCoordSystem).fromMatrix(vm::vec2f::zero(), vm::vec2f::one());
 
             const vm::vec3 texUAxisInWorld = vm::normalize((texToWorld * vm::vec4d(1, 0, 0, 0)).xyz());
             const vm::vec3 texVAxisInWorld = vm::normalize((texToWorld * vm::vec4d(0, 1, 0, 0)).xyz());
@@ -477,14 +467,18 @@ namespace TrenchBroom {
         }
 
         kdl::result<void, BrushError> BrushFace::transform(const vm::mat4x4& transform, const bool lockTexture) {
+            return this->transform(TexCoordSystemTransform(transform), lockTexture);
+        }
+
+        kdl::result<void, BrushError> BrushFace::transform(const TexCoordSystemTransform& transform, const bool lockTexture) {
             using std::swap;
 
             const vm::vec3 invariant = m_geometry != nullptr ? center() : m_boundary.anchor();
             const vm::plane3 oldBoundary = m_boundary;
 
-            m_boundary = m_boundary.transform(transform);
+            m_boundary = m_boundary.transform(transform.transformation);
             for (size_t i = 0; i < 3; ++i) {
-                m_points[i] = transform * m_points[i];
+                m_points[i] = transform.transformation * m_points[i];
             }
 
             if (dot(cross(m_points[2] - m_points[0], m_points[1] - m_points[0]), m_boundary.normal) < 0.0) {
@@ -493,7 +487,7 @@ namespace TrenchBroom {
 
             return setPoints(m_points[0], m_points[1], m_points[2])
                 .and_then([&]() {
-                    m_texCoordSystem->transform(oldBoundary, m_boundary, transform, m_attributes, textureSize(), lockTexture, invariant);
+                    asTexCoordSystem(m_texCoordSystem).transform(oldBoundary, m_boundary, transform, m_attributes, textureSize(), lockTexture, invariant);
                 });
         }
 
@@ -521,12 +515,12 @@ namespace TrenchBroom {
                     const auto refPoint = project_point(seam, center());
 
                     // Get the texcoords at the refPoint using the old face's attribs and tex coord system
-                    const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+                    const auto desriedCoords = asTexCoordSystem(m_texCoordSystem).getTexCoords(refPoint, m_attributes, vm::vec2f::one());
 
-                    m_texCoordSystem->updateNormal(oldPlane.normal, m_boundary.normal, m_attributes, WrapStyle::Projection);
+                    asTexCoordSystem(m_texCoordSystem).updateNormal(oldPlane.normal, m_boundary.normal, m_attributes, WrapStyle::Projection);
 
                     // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
-                    const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attributes, vm::vec2f::one());
+                    const auto currentCoords = asTexCoordSystem(m_texCoordSystem).getTexCoords(refPoint, m_attributes, vm::vec2f::one());
                     const auto offsetChange = desriedCoords - currentCoords;
                     m_attributes.setOffset(correct(modOffset(m_attributes.offset() + offsetChange), 4));
                 }
@@ -534,7 +528,7 @@ namespace TrenchBroom {
         }
 
         vm::mat4x4 BrushFace::projectToBoundaryMatrix() const {
-            const auto texZAxis = m_texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
+            const auto texZAxis = asTexCoordSystem(m_texCoordSystem).fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
             const auto worldToPlaneMatrix = vm::plane_projection_matrix(m_boundary.distance, m_boundary.normal, texZAxis);
             const auto [invertible, planeToWorldMatrix] = vm::invert(worldToPlaneMatrix); assert(invertible); unused(invertible);
             return planeToWorldMatrix * vm::mat4x4::zero_out<2>() * worldToPlaneMatrix;
@@ -542,22 +536,22 @@ namespace TrenchBroom {
 
         vm::mat4x4 BrushFace::toTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, const bool project) const {
             if (project) {
-                return vm::mat4x4::zero_out<2>() * m_texCoordSystem->toMatrix(offset, scale);
+                return vm::mat4x4::zero_out<2>() * asTexCoordSystem(m_texCoordSystem).toMatrix(offset, scale);
             } else {
-                return m_texCoordSystem->toMatrix(offset, scale);
+                return asTexCoordSystem(m_texCoordSystem).toMatrix(offset, scale);
             }
         }
 
         vm::mat4x4 BrushFace::fromTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, const bool project) const {
             if (project) {
-                return projectToBoundaryMatrix() * m_texCoordSystem->fromMatrix(offset, scale);
+                return projectToBoundaryMatrix() * asTexCoordSystem(m_texCoordSystem).fromMatrix(offset, scale);
             } else {
-                return m_texCoordSystem->fromMatrix(offset, scale);
+                return asTexCoordSystem(m_texCoordSystem).fromMatrix(offset, scale);
             }
         }
 
         float BrushFace::measureTextureAngle(const vm::vec2f& center, const vm::vec2f& point) const {
-            return m_texCoordSystem->measureAngle(m_attributes.rotation(), center, point);
+            return asTexCoordSystem(m_texCoordSystem).measureAngle(m_attributes.rotation(), center, point);
         }
 
         size_t BrushFace::vertexCount() const {
@@ -602,6 +596,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) const {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -622,7 +620,7 @@ namespace TrenchBroom {
         }
 
         vm::vec2f BrushFace::textureCoords(const vm::vec3& point) const {
-            return m_texCoordSystem->getTexCoords(point, m_attributes, textureSize());
+            return asTexCoordSystem(m_texCoordSystem).getTexCoords(point, m_attributes, textureSize());
         }
 
         FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const {
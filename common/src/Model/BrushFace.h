@@ -24,7 +24,10 @@
 #include "Assets/AssetReference.h"
 #include "Model/BrushFaceAttributes.h"
 #include "Model/BrushGeometry.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
 #include "Model/Tag.h" // BrushFace inherits from Taggable
+#include "Model/TexCoordSystem.h"
 
 #include <kdl/result_forward.h>
 #include <kdl/transform_range.h>
@@ -42,12 +45,10 @@
 namespace TrenchBroom {
     namespace Assets {
         class Texture;
+        class TextureUsageCounts;
     }
 
     namespace Model {
-        class TexCoordSystem;
-        class TexCoordSystemSnapshot;
-        enum class WrapStyle;
         enum class BrushError;
         enum class MapFormat;
 
@@ -87,7 +88,7 @@ namespace TrenchBroom {
             BrushFaceAttributes m_attributes;
 
             Assets::AssetReference<Assets::Texture> m_textureReference;
-            std::unique_ptr<TexCoordSystem> m_texCoordSystem;
+            TexCoordSystemVariant m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
 
             mutable size_t m_lineNumber;
@@ -144,9 +145,9 @@ namespace TrenchBroom {
             static kdl::result<BrushFace, BrushError> createFromSource(const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const BrushFaceAttributes& attributes, const vm::vec3& texAxisX, const vm::vec3& texAxisY, MapFormat mapFormat);
 
 
-            static kdl::result<BrushFace, BrushError> create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem);
+            static kdl::result<BrushFace, BrushError> create(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem);
 
-            BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, std::unique_ptr<TexCoordSystem> texCoordSystem);
+            BrushFace(const BrushFace::Points& points, const vm::plane3& boundary, const BrushFaceAttributes& attributes, TexCoordSystemVariant texCoordSystem);
 
             friend bool operator==(const BrushFace& lhs, const BrushFace& rhs);
             friend bool operator!=(const BrushFace& lhs, const BrushFace& rhs);
@@ -179,6 +180,11 @@ namespace TrenchBroom {
             vm::vec2f modOffset(const vm::vec2f& offset) const;
 
             bool setTexture(Assets::Texture* texture);
+            /**
+             * Sets the texture like setTexture(Assets::Texture*), but records the changes to the usage counts of the
+             * previous and the new texture in the given usage counts instead of applying them.
+             */
+            bool setTexture(Assets::Texture* texture, Assets::TextureUsageCounts& usageCounts);
 
             vm::vec3 textureXAxis() const;
             vm::vec3 textureYAxis() const;
@@ -194,6 +200,7 @@ namespace TrenchBroom {
             void flipTexture(const vm::vec3& cameraUp, const vm::vec3& cameraRight, vm::direction cameraRelativeFlipDirection);
 
             kdl::result<void, BrushError> transform(const vm::mat4x4& transform, bool lockTexture);
+            kdl::result<void, BrushError> transform(const TexCoordSystemTransform& transform, bool lockTexture);
             void invert();
 
             kdl::result<void, BrushError> updatePointsFromVertices();
@@ -215,6 +222,7 @@ namespace TrenchBroom {
             void setGeometry(BrushFaceGeometry* geometry);
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount) const;
 
             bool selected() const;
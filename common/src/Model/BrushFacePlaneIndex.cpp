@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BrushFacePlaneIndex.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+
+#include <vecmath/plane.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace TrenchBroom {
+    namespace Model {
+        /** The size of the cells into which the normal components are quantized. */
+        static constexpr FloatType NormalCellSize = 1.0 / 64.0;
+
+        static int64_t normalCell(const FloatType component) {
+            // rounding centers the cells on multiples of the cell size, so axis aligned normals are far from the cell borders
+            return static_cast<int64_t>(std::round(component / NormalCellSize));
+        }
+
+        /**
+         * The largest difference of any component of two normals that BrushFace::coplanarWith accepts as colinear. For
+         * unit vectors a and b, it holds that |a - b|^2 = 2 * (1 - a * b).
+         */
+        static FloatType normalTolerance() {
+            return std::sqrt(2.0 * vm::constants<FloatType>::colinear_epsilon());
+        }
+
+        /** The largest distance of a face center from the reference plane that BrushFace::coplanarWith accepts. */
+        static FloatType distanceTolerance() {
+            return vm::constants<FloatType>::almost_zero() * 10.0;
+        }
+
+        BrushFacePlaneIndex::BrushFacePlaneIndex() :
+        m_maxCenterDistance(0.0) {}
+
+        bool BrushFacePlaneIndex::empty() const {
+            return m_entries.empty();
+        }
+
+        bool BrushFacePlaneIndex::contains(const BrushNode* brushNode) const {
+            return m_entries.find(brushNode) != std::end(m_entries);
+        }
+
+        void BrushFacePlaneIndex::addBrush(BrushNode* brushNode) {
+            removeBrush(brushNode);
+
+            const auto& brush = brushNode->brush();
+            auto& entries = m_entries[brushNode];
+            entries.reserve(brush.faceCount());
+
+            for (size_t i = 0; i < brush.faceCount(); ++i) {
+                const auto& face = brush.face(i);
+                const auto& plane = face.boundary();
+                const auto key = NormalKey{ normalCell(plane.normal.x()), normalCell(plane.normal.y()), normalCell(plane.normal.z()) };
+
+                auto& bucket = m_buckets[key];
+                entries.emplace_back(&bucket, bucket.emplace(plane.distance, BrushFaceHandle(brushNode, i)));
+                m_maxCenterDistance = std::max(m_maxCenterDistance, vm::length(face.center()));
+            }
+        }
+
+        void BrushFacePlaneIndex::removeBrush(const BrushNode* brushNode) {
+            const auto it = m_entries.find(brushNode);
+            if (it != std::end(m_entries)) {
+                for (const auto& [bucket, entry] : it->second) {
+                    bucket->erase(entry);
+                }
+                m_entries.erase(it);
+            }
+        }
+
+        void BrushFacePlaneIndex::clear() {
+            m_buckets.clear();
+            m_entries.clear();
+            m_maxCenterDistance = 0.0;
+        }
+
+        std::vector<BrushFaceHandle> BrushFacePlaneIndex::findCoplanarFaces(const vm::plane3& plane) const {
+            std::vector<BrushFaceHandle> result;
+
+            const auto normalEpsilon = normalTolerance();
+            const auto minKey = NormalKey{ normalCell(plane.normal.x() - normalEpsilon), normalCell(plane.normal.y() - normalEpsilon), normalCell(plane.normal.z() - normalEpsilon) };
+            const auto maxKey = NormalKey{ normalCell(plane.normal.x() + normalEpsilon), normalCell(plane.normal.y() + normalEpsilon), normalCell(plane.normal.z() + normalEpsilon) };
+
+            // The plane distance of a coplanar face differs from the given plane's distance by at most the distance
+            // tolerance plus the normal deviation times the distance of the face center from the origin.
+            const auto distanceEpsilon = normalEpsilon * m_maxCenterDistance + distanceTolerance();
+
+            for (auto x = minKey[0]; x <= maxKey[0]; ++x) {
+                for (auto y = minKey[1]; y <= maxKey[1]; ++y) {
+                    for (auto z = minKey[2]; z <= maxKey[2]; ++z) {
+                        const auto bucketIt = m_buckets.find(NormalKey{ x, y, z });
+                        if (bucketIt == std::end(m_buckets)) {
+                            continue;
+                        }
+
+                        const auto& bucket = bucketIt->second;
+                        const auto end = bucket.upper_bound(plane.distance + distanceEpsilon);
+                        for (auto it = bucket.lower_bound(plane.distance - distanceEpsilon); it != end; ++it) {
+                            const auto& faceHandle = it->second;
+                            if (faceHandle.face().coplanarWith(plane)) {
+                                result.push_back(faceHandle);
+                            }
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+    }
+}
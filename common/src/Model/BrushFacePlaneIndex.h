@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "FloatType.h"
+#include "Model/BrushFaceHandle.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushNode;
+
+        /**
+         * Indexes the faces of a set of brushes by their planes so that the faces which are coplanar with a given plane
+         * can be found without testing every face.
+         *
+         * The faces are grouped by their quantized normals and sorted by their plane distances within each group. A
+         * query visits only the groups whose normals are within the normal tolerance of BrushFace::coplanarWith and
+         * only the range of distances that a coplanar face can have, and it tests the faces found there with
+         * BrushFace::coplanarWith. Therefore, the result is the same as if every indexed face was tested.
+         *
+         * The index does not observe the brushes. A brush must be removed before it is modified and added again
+         * afterwards.
+         */
+        class BrushFacePlaneIndex {
+        private:
+            using NormalKey = std::array<int64_t, 3>;
+            using Bucket = std::multimap<FloatType, BrushFaceHandle>;
+            using Entry = std::pair<Bucket*, Bucket::iterator>;
+
+            std::map<NormalKey, Bucket> m_buckets;
+            std::unordered_map<const BrushNode*, std::vector<Entry>> m_entries;
+            /** The largest distance of an indexed face center from the origin, never decreases until cleared. */
+            FloatType m_maxCenterDistance;
+        public:
+            BrushFacePlaneIndex();
+
+            bool empty() const;
+            bool contains(const BrushNode* brushNode) const;
+
+            /**
+             * Adds the faces of the given brush to this index. If the brush was already added, its faces are replaced.
+             */
+            void addBrush(BrushNode* brushNode);
+
+            /**
+             * Removes the faces of the given brush from this index. Does nothing if the brush was not added.
+             */
+            void removeBrush(const BrushNode* brushNode);
+            void clear();
+
+            /**
+             * Returns handles for every indexed face that is coplanar with the given plane according to
+             * BrushFace::coplanarWith.
+             */
+            std::vector<BrushFaceHandle> findCoplanarFaces(const vm::plane3& plane) const;
+        };
+    }
+}
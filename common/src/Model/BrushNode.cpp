@@ -136,6 +136,13 @@ namespace TrenchBroom {
             invalidateVertexCache();
         }
 
+        void BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture, Assets::TextureUsageCounts& usageCounts) {
+            m_brush.face(faceIndex).setTexture(texture, usageCounts);
+
+            invalidateIssues();
+            invalidateVertexCache();
+        }
+
         static bool containsPatch(const Brush& brush, const PatchGrid& grid) {
             if (!brush.bounds().contains(grid.bounds)) {
                 return false;
@@ -40,6 +40,7 @@
 namespace TrenchBroom {
     namespace Assets {
         class Texture;
+        class TextureUsageCounts;
     }
     
     namespace Renderer {
@@ -82,6 +83,11 @@ namespace TrenchBroom {
             void updateFaceTags(size_t faceIndex, TagManager& tagManager);
             
             void setFaceTexture(size_t faceIndex, Assets::Texture* texture);
+            /**
+             * Sets the texture of the face with the given index, but records the changes to the texture usage counts in
+             * the given usage counts. Can be called for different brush nodes on different threads.
+             */
+            void setFaceTexture(size_t faceIndex, Assets::Texture* texture, Assets::TextureUsageCounts& usageCounts);
 
             bool contains(const Node* node) const;
             bool intersects(const Node* node) const;
@@ -23,6 +23,9 @@
 #include "Exceptions.h"
 #include "Logger.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Version.h"
 #include "Assets/Palette.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -33,12 +36,14 @@
 #include "IO/DiskIO.h"
 #include "IO/DkmParser.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/EntParser.h"
 #include "IO/FgdParser.h"
 #include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
+#include "IO/MapCache.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -47,6 +52,7 @@
 #include "IO/NodeWriter.h"
 #include "IO/ObjParser.h"
 #include "IO/ObjSerializer.h"
+#include "IO/ParserStatus.h"
 #include "IO/WorldReader.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
@@ -78,10 +84,20 @@ namespace TrenchBroom {
     namespace Model {
         GameImpl::GameImpl(GameConfig& config, const IO::Path& gamePath, Logger& logger) :
         m_config(config),
-        m_gamePath(gamePath) {
+        m_gamePath(gamePath),
+        m_mapCacheDirectory(IO::SystemPaths::userDataDirectory() + IO::Path("cache/maps")),
+        m_entityDefinitionCacheDirectory(IO::SystemPaths::userDataDirectory() + IO::Path("cache/entity_definitions")) {
             initializeFileSystem(logger);
         }
 
+        void GameImpl::setMapCacheDirectory(std::optional<IO::Path> mapCacheDirectory) {
+            m_mapCacheDirectory = std::move(mapCacheDirectory);
+        }
+
+        void GameImpl::setEntityDefinitionCacheDirectory(std::optional<IO::Path> entityDefinitionCacheDirectory) {
+            m_entityDefinitionCacheDirectory = std::move(entityDefinitionCacheDirectory);
+        }
+
         void GameImpl::initializeFileSystem(Logger& logger) {
             m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
         }
@@ -175,20 +191,59 @@ namespace TrenchBroom {
             }
         }
 
+        /**
+         * Logs the messages of the map parser and records them so that they can be stored in the map cache.
+         */
+        class MapParserStatus : public IO::ParserStatus {
+        private:
+            Logger& m_logger;
+            IO::MapCache::Messages m_messages;
+        public:
+            explicit MapParserStatus(Logger& logger) :
+            ParserStatus(logger, ""),
+            m_logger(logger) {}
+
+            const IO::MapCache::Messages& messages() const {
+                return m_messages;
+            }
+        private:
+            void doProgress(const double /* progress */) override {}
+
+            void doLog(const LogLevel level, const std::string& str) override {
+                m_messages.emplace_back(level, str);
+                m_logger.log(level, str);
+            }
+        };
+
         std::unique_ptr<WorldNode> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
-            IO::SimpleParserStatus parserStatus(logger);
+            MapParserStatus parserStatus(logger);
             auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
             auto fileReader = file->reader().buffer();
-            if (format == MapFormat::Unknown) {
-                // Try all formats listed in the game config
-                const auto possibleFormats = kdl::vec_transform(m_config.fileFormats(), [](const MapFormatConfig& config) {
+
+            // Try all formats listed in the game config if the format is unknown
+            const auto possibleFormats = format == MapFormat::Unknown
+                ? kdl::vec_transform(m_config.fileFormats(), [](const MapFormatConfig& config) {
                     return Model::formatFromName(config.format);
-                });
-                return IO::WorldReader::tryRead(fileReader.stringView(), possibleFormats, worldBounds, parserStatus);
-            } else {
-                IO::WorldReader worldReader(fileReader.stringView(), format);
-                return worldReader.read(worldBounds, parserStatus);
+                })
+                : std::vector<MapFormat>{format};
+
+            const auto cache = m_mapCacheDirectory && pref(Preferences::CacheLoadedMaps)
+                ? std::optional<IO::MapCache>(IO::MapCache(*m_mapCacheDirectory, BUILD_ID_STR))
+                : std::nullopt;
+            if (cache) {
+                if (auto worldNode = cache->load(file->path(), fileReader.stringView(), possibleFormats, worldBounds, logger)) {
+                    logger.info() << "Loaded map from cache";
+                    return worldNode;
+                }
+            }
+
+            auto worldNode = format == MapFormat::Unknown
+                ? IO::WorldReader::tryRead(fileReader.stringView(), possibleFormats, worldBounds, parserStatus)
+                : IO::WorldReader(fileReader.stringView(), format).read(worldBounds, parserStatus);
+            if (cache) {
+                cache->store(file->path(), fileReader.stringView(), *worldNode, worldBounds, parserStatus.messages());
             }
+            return worldNode;
         }
 
         void GameImpl::doWriteMap(WorldNode& world, const IO::Path& path, const bool exporting) const {
@@ -363,22 +418,52 @@ namespace TrenchBroom {
         std::vector<Assets::EntityDefinition*> GameImpl::doLoadEntityDefinitions(IO::ParserStatus& status, const IO::Path& path) const {
             const auto extension = path.extension();
             const auto& defaultColor = m_config.entityConfig().defaultColor;
+            const auto cache = m_entityDefinitionCacheDirectory
+                ? std::optional<IO::EntityDefinitionCache>(IO::EntityDefinitionCache(*m_entityDefinitionCacheDirectory, BUILD_ID_STR))
+                : std::nullopt;
+
+            const auto loadCached = [&](const IO::Path& filePath) -> std::optional<std::vector<Assets::EntityDefinition*>> {
+                return cache ? cache->load(filePath, defaultColor) : std::nullopt;
+            };
+            const auto storeCached = [&](const IO::Path& filePath, const std::vector<IO::Path>& includedPaths, const std::vector<Assets::EntityDefinition*>& definitions) {
+                if (cache) {
+                    cache->store(filePath, includedPaths, defaultColor, definitions);
+                }
+            };
 
             if (kdl::ci::str_is_equal("fgd", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+                if (auto cached = loadCached(file->path())) {
+                    return std::move(*cached);
+                }
+
                 auto reader = file->reader().buffer();
                 IO::FgdParser parser(reader.stringView(), defaultColor, file->path());
-                return parser.parseDefinitions(status);
+                auto definitions = parser.parseDefinitions(status);
+                storeCached(file->path(), parser.includedPaths(), definitions);
+                return definitions;
             } else if (kdl::ci::str_is_equal("def", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+                if (auto cached = loadCached(file->path())) {
+                    return std::move(*cached);
+                }
+
                 auto reader = file->reader().buffer();
                 IO::DefParser parser(reader.stringView(), defaultColor);
-                return parser.parseDefinitions(status);
+                auto definitions = parser.parseDefinitions(status);
+                storeCached(file->path(), {}, definitions);
+                return definitions;
             } else if (kdl::ci::str_is_equal("ent", extension)) {
                 auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+                if (auto cached = loadCached(file->path())) {
+                    return std::move(*cached);
+                }
+
                 auto reader = file->reader().buffer();
                 IO::EntParser parser(reader.stringView(), defaultColor);
-                return parser.parseDefinitions(status);
+                auto definitions = parser.parseDefinitions(status);
+                storeCached(file->path(), {}, definitions);
+                return definitions;
             } else {
                 throw GameException("Unknown entity definition format: '" + path.asString() + "'");
             }
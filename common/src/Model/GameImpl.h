@@ -43,8 +43,22 @@ namespace TrenchBroom {
             GameFileSystem m_fs;
             IO::Path m_gamePath;
             std::vector<IO::Path> m_additionalSearchPaths;
+            std::optional<IO::Path> m_mapCacheDirectory;
+            std::optional<IO::Path> m_entityDefinitionCacheDirectory;
         public:
             GameImpl(GameConfig& config, const IO::Path& gamePath, Logger& logger);
+
+            /**
+             * Sets the directory in which loaded maps are cached. If no directory is set, maps are not cached. By
+             * default, maps are cached in the user data directory.
+             */
+            void setMapCacheDirectory(std::optional<IO::Path> mapCacheDirectory);
+
+            /**
+             * Sets the directory in which parsed entity definition files are cached. If no directory is set, entity
+             * definitions are not cached. By default, they are cached in the user data directory.
+             */
+            void setEntityDefinitionCacheDirectory(std::optional<IO::Path> entityDefinitionCacheDirectory);
         private:
             void initializeFileSystem(Logger& logger);
         private:
@@ -32,6 +32,7 @@
 #include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 
+#include <atomic>
 #include <string>
 
 namespace TrenchBroom {
@@ -42,6 +43,10 @@ namespace TrenchBroom {
             return m_seqId;
         }
 
+        void Issue::renewSeqId() {
+            m_seqId = nextSeqId();
+        }
+
         size_t Issue::lineNumber() const {
             return doGetLineNumber();
         }
@@ -96,7 +101,7 @@ namespace TrenchBroom {
         }
 
         size_t Issue::nextSeqId() {
-            static size_t seqId = 0;
+            static std::atomic<size_t> seqId(0);
             return seqId++;
         }
 
@@ -39,6 +39,11 @@ namespace TrenchBroom {
             virtual ~Issue();
 
             size_t seqId() const;
+            /**
+             * Assigns a new sequence number to this issue. Issues that were generated in parallel receive their sequence
+             * numbers in an arbitrary order, and this is used to renumber them in a deterministic order afterwards.
+             */
+            void renewSeqId();
             size_t lineNumber() const;
             std::string description() const;
 
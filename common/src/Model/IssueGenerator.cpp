@@ -47,6 +47,14 @@ namespace TrenchBroom {
             return m_quickFixes;
         }
 
+        void IssueGenerator::beginBatch() const {
+            doBeginBatch();
+        }
+
+        void IssueGenerator::endBatch() const {
+            doEndBatch();
+        }
+
         void IssueGenerator::generate(WorldNode* worldNode, IssueList& issues) const {
             doGenerate(worldNode, issues);
         }
@@ -76,6 +84,9 @@ namespace TrenchBroom {
             assert(!kdl::vec_contains(m_quickFixes, quickFix));
             m_quickFixes.push_back(quickFix);
         }
+
+        void IssueGenerator::doBeginBatch() const {}
+        void IssueGenerator::doEndBatch() const {}
  
         void IssueGenerator::doGenerate(WorldNode* worldNode,   IssueList& issues) const { doGenerate(static_cast<EntityNodeBase*>(worldNode), issues); }
         void IssueGenerator::doGenerate(LayerNode*,             IssueList&) const        {}
@@ -50,6 +50,15 @@ namespace TrenchBroom {
             const std::string& description() const;
             const IssueQuickFixList& quickFixes() const;
 
+            /**
+             * Called before and after issues are generated for a batch of nodes. Between these calls, generate may be
+             * called concurrently for different nodes, but the document does not change. A generator can use this to
+             * compute data that it needs for every node only once per batch. Generators must still produce the same
+             * issues if generate is called outside of a batch.
+             */
+            void beginBatch() const;
+            void endBatch() const;
+
             void generate(WorldNode* worldNode,   IssueList& issues) const;
             void generate(LayerNode* layerNode,   IssueList& issues) const;
             void generate(GroupNode* groupNode,   IssueList& issues) const;
@@ -59,6 +68,9 @@ namespace TrenchBroom {
             IssueGenerator(IssueType type, const std::string& description);
             void addQuickFix(IssueQuickFix* quickFix);
         private:
+            virtual void doBeginBatch() const;
+            virtual void doEndBatch() const;
+
             virtual void doGenerate(WorldNode* worldNode,           IssueList& issues) const;
             virtual void doGenerate(LayerNode* layerNode,           IssueList& issues) const;
             virtual void doGenerate(GroupNode* groupNode,           IssueList& issues) const;
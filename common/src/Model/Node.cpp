@@ -21,11 +21,14 @@
 
 #include "Ensure.h"
 #include "Macros.h"
+#include "Model/Entity.h"
+#include "Model/EntityNodeBase.h"
 #include "Model/Issue.h"
 #include "Model/IssueGenerator.h"
 #include "Model/LockState.h"
 #include "Model/VisibilityState.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
@@ -665,6 +668,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t Node::lineCount() const {
+            return m_lineCount;
+        }
+
         void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) const {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -679,6 +686,41 @@ namespace TrenchBroom {
             return m_issues;
         }
 
+        void Node::validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators) {
+            // compute the lazily cached data of all nodes up front because the generators may access other nodes than
+            // the one they are generating issues for
+            for (const auto* node : nodes) {
+                node->logicalBounds();
+                node->physicalBounds();
+                if (const auto* entityNode = dynamic_cast<const EntityNodeBase*>(node)) {
+                    entityNode->entity().classname();
+                }
+            }
+
+            const auto invalidNodes = kdl::vec_filter(nodes, [](const auto* node) { return !node->m_issuesValid; });
+            if (invalidNodes.empty()) {
+                return;
+            }
+
+            for (const auto* generator : issueGenerators) {
+                generator->beginBatch();
+            }
+
+            kdl::parallel_for(invalidNodes.size(), [&](const size_t i) {
+                invalidNodes[i]->validateIssues(issueGenerators);
+            });
+
+            for (const auto* generator : issueGenerators) {
+                generator->endBatch();
+            }
+
+            for (const auto* node : invalidNodes) {
+                for (auto* issue : node->m_issues) {
+                    issue->renewSeqId();
+                }
+            }
+        }
+
         bool Node::issueHidden(const IssueType type) const {
             return (type & m_hiddenIssues) != 0;
         }
@@ -324,11 +324,22 @@ namespace TrenchBroom {
             void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
         public: // file position
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount) const;
             bool containsLine(size_t lineNumber) const;
         public: // issue management
             const std::vector<Issue*>& issues(const std::vector<IssueGenerator*>& issueGenerators);
 
+            /**
+             * Generates the issues of all given nodes whose issues are not valid. The nodes are processed in parallel.
+             *
+             * Before the issues are generated, the lazily computed data of every given node, such as its bounds and its
+             * cached entity properties, is computed once so that the generators only read shared state. Afterwards, the
+             * sequence numbers of the new issues are renewed in the order of the given nodes, so the result does not
+             * depend on the order in which the nodes were processed.
+             */
+            static void validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators);
+
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
         public: // should only be called from this and from the world
@@ -73,13 +73,9 @@ namespace TrenchBroom {
         m_xAxis(xAxis),
         m_yAxis(yAxis) {}
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoordSystem::fromParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> ParallelTexCoordSystem::fromParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) {
             const auto tempParaxial = ParaxialTexCoordSystem(point0, point1, point2, attribs);
-            return { ParallelTexCoordSystem(tempParaxial.xAxis(), tempParaxial.yAxis()).clone(), attribs };
-        }
-
-        std::unique_ptr<TexCoordSystem> ParallelTexCoordSystem::doClone() const {
-            return std::make_unique<ParallelTexCoordSystem>(m_xAxis, m_yAxis);
+            return { ParallelTexCoordSystem(tempParaxial.xAxis(), tempParaxial.yAxis()), attribs };
         }
 
         std::unique_ptr<TexCoordSystemSnapshot> ParallelTexCoordSystem::doTakeSnapshot() const {
@@ -151,7 +147,7 @@ namespace TrenchBroom {
             m_yAxis = rot * m_yAxis;
         }
 
-        void ParallelTexCoordSystem::doTransform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, const bool lockTexture, const vm::vec3& oldInvariant) {
+        void ParallelTexCoordSystem::doTransform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const TexCoordSystemTransform& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, const bool lockTexture, const vm::vec3& oldInvariant) {
             if (attribs.xScale() == 0.0f || attribs.yScale() == 0.0f) {
                 return;
             }
@@ -162,10 +158,8 @@ namespace TrenchBroom {
                 return;
             }
 
-            const auto effectiveTransformation = transformation;
-
             // determine the rotation by which the texture coordinate system will be rotated about its normal
-            const auto angleDelta = computeTextureAngle(oldBoundary, effectiveTransformation);
+            const auto angleDelta = computeTextureAngle(oldBoundary, transformation.rotationScale);
             const auto newAngle = vm::correct(vm::normalize_degrees(attribs.rotation() + angleDelta), 4);
             assert(!vm::is_nan(newAngle));
             attribs.setRotation(newAngle);
@@ -188,9 +182,8 @@ namespace TrenchBroom {
             //     uv = ? * transform * point
             //
             // The solution for ? is (worldToTexSpace * transform_inverse)
-            const auto [invertible, inverseTransform] = invert(effectiveTransformation);
-            assert(invertible); unused(invertible);
-            const auto newWorldToTexSpace = worldToTexSpace * inverseTransform;
+            assert(transformation.invertible);
+            const auto newWorldToTexSpace = worldToTexSpace * transformation.inverseTransformation;
 
             // extract the new m_xAxis and m_yAxis from newWorldToTexSpace.
             // note, the matrix is in column major format.
@@ -202,7 +195,7 @@ namespace TrenchBroom {
             assert(!vm::is_nan(m_yAxis));
 
             // determine the new texture coordinates of the transformed center of the face, sans offsets
-            const auto newInvariant = effectiveTransformation * oldInvariant;
+            const auto newInvariant = transformation.transformation * oldInvariant;
             const auto newInvariantTexCoords = computeTexCoords(newInvariant, attribs.scale());
 
             // since the center should be invariant, the offsets are determined by the difference of the current and
@@ -212,8 +205,7 @@ namespace TrenchBroom {
             attribs.setOffset(newOffset);
         }
 
-        float ParallelTexCoordSystem::computeTextureAngle(const vm::plane3& oldBoundary, const vm::mat4x4& transformation) const {
-            const vm::mat4x4& rotationScale = vm::strip_translation(transformation);
+        float ParallelTexCoordSystem::computeTextureAngle(const vm::plane3& oldBoundary, const vm::mat4x4& rotationScale) const {
             const vm::vec3& oldNormal = oldBoundary.normal;
             const vm::vec3  newNormal = vm::normalize(rotationScale * oldNormal);
 
@@ -338,11 +330,11 @@ namespace TrenchBroom {
             yAxis = vm::normalize(vm::cross(m_xAxis, normal));
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoordSystem::doToParallel(const vm::vec3&, const vm::vec3&, const vm::vec3&, const BrushFaceAttributes& attribs) const {
-            return { clone(), attribs };
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> ParallelTexCoordSystem::doToParallel(const vm::vec3&, const vm::vec3&, const vm::vec3&, const BrushFaceAttributes& attribs) const {
+            return { *this, attribs };
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParallelTexCoordSystem::doToParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> ParallelTexCoordSystem::doToParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
             return ParaxialTexCoordSystem::fromParallel(point0, point1, point2, attribs, m_xAxis, m_yAxis);
         }
     }
@@ -90,10 +90,6 @@ namespace TrenchBroom {
             return vm::plane3(point0, normal);
         }
 
-        std::unique_ptr<TexCoordSystem> ParaxialTexCoordSystem::doClone() const {
-            return std::make_unique<ParaxialTexCoordSystem>(m_index, m_xAxis, m_yAxis);
-        }
-
         std::unique_ptr<TexCoordSystemSnapshot> ParaxialTexCoordSystem::doTakeSnapshot() const {
             return std::unique_ptr<TexCoordSystemSnapshot>();
         }
@@ -138,8 +134,8 @@ namespace TrenchBroom {
             rotateAxes(m_xAxis, m_yAxis, vm::to_radians(static_cast<FloatType>(newAngle)), m_index);
         }
 
-        void ParaxialTexCoordSystem::doTransform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& oldInvariant) {
-            const vm::vec3 offset     = transformation * vm::vec3::zero();
+        void ParaxialTexCoordSystem::doTransform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const TexCoordSystemTransform& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& oldInvariant) {
+            const vm::vec3& offset    = transformation.translation;
             const vm::vec3& oldNormal = oldBoundary.normal;
                   vm::vec3 newNormal  = newBoundary.normal;
             assert(vm::is_unit(newNormal, vm::C::almost_zero()));
@@ -164,8 +160,8 @@ namespace TrenchBroom {
             const vm::vec3 oldYAxisOnBoundary = oldBoundary.project_point(m_yAxis * scale.y(), getZAxis()) - boundaryOffset;
 
             // transform the projected texture axes and compensate the translational component
-            const vm::vec3 transformedXAxis = transformation * oldXAxisOnBoundary - offset;
-            const vm::vec3 transformedYAxis = transformation * oldYAxisOnBoundary - offset;
+            const vm::vec3 transformedXAxis = transformation.transformation * oldXAxisOnBoundary - offset;
+            const vm::vec3 transformedYAxis = transformation.transformation * oldYAxisOnBoundary - offset;
 
             const bool preferX = textureSize.x() >= textureSize.y();
 
@@ -221,7 +217,7 @@ namespace TrenchBroom {
                 newScale[1] *= -1.0f;
 
             // compute the parameters of the transformed texture coordinate system
-            const vm::vec3 newInvariant = transformation * oldInvariant;
+            const vm::vec3 newInvariant = transformation.transformation * oldInvariant;
 
             // determine the new texture coordinates of the transformed center of the face, sans offsets
             const vm::vec2f newInvariantTexCoords = computeTexCoords(newInvariant, newScale);
@@ -263,13 +259,13 @@ namespace TrenchBroom {
             return vm::to_degrees(angleInRadians);
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::doToParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> ParaxialTexCoordSystem::doToParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
             return ParallelTexCoordSystem::fromParaxial(point0, point1, point2, attribs);
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::doToParaxial(const vm::vec3&, const vm::vec3&, const vm::vec3&, const BrushFaceAttributes& attribs) const {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> ParaxialTexCoordSystem::doToParaxial(const vm::vec3&, const vm::vec3&, const vm::vec3&, const BrushFaceAttributes& attribs) const {
             // Already in the requested format
-            return { clone(), attribs };
+            return { *this, attribs };
         }
 
         void ParaxialTexCoordSystem::rotateAxes(vm::vec3& xAxis, vm::vec3& yAxis, const FloatType angleInRadians, const size_t planeNormIndex) const {
@@ -610,7 +606,7 @@ namespace TrenchBroom {
             }
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> ParaxialTexCoordSystem::fromParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, const vm::vec3& xAxis, const vm::vec3& yAxis) {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> ParaxialTexCoordSystem::fromParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, const vm::vec3& xAxis, const vm::vec3& yAxis) {
             const vm::plane3 facePlane = planeFromPoints(point0, point1, point2);
             const vm::mat4x4f worldToTexSpace = FromParallel::valveTo4x4Matrix(facePlane, attribs, xAxis, yAxis);
             const auto facePoints = std::array<vm::vec3f, 3>{vm::vec3f(point0), vm::vec3f(point1), vm::vec3f(point2)};
@@ -628,7 +624,7 @@ namespace TrenchBroom {
                 newAttribs.setRotation(0.0f);
             }
 
-            return { std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, newAttribs),
+            return { ParaxialTexCoordSystem(point0, point1, point2, newAttribs),
                      newAttribs };
         }
     }
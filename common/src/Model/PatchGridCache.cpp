@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PatchGridCache.h"
+
+#include "Model/PatchNode.h"
+
+#include <functional>
+
+namespace TrenchBroom {
+    namespace Model {
+        size_t PatchGridCache::KeyHash::operator()(const Key& key) const {
+            const auto hash = std::hash<FloatType>{};
+            auto result = key.pointRowCount;
+            const auto combine = [&](const size_t value) {
+                result ^= value + 0x9e3779b9 + (result << 6) + (result >> 2);
+            };
+
+            combine(key.pointColumnCount);
+            combine(key.subdivisionsPerSurface);
+            for (const auto& point : key.controlPoints) {
+                for (const auto component : point.v) {
+                    combine(hash(component));
+                }
+            }
+            return result;
+        }
+
+        bool PatchGridCache::KeyEqual::operator()(const Key& lhs, const Key& rhs) const {
+            return lhs.pointRowCount == rhs.pointRowCount &&
+                lhs.pointColumnCount == rhs.pointColumnCount &&
+                lhs.subdivisionsPerSurface == rhs.subdivisionsPerSurface &&
+                lhs.controlPoints == rhs.controlPoints;
+        }
+
+        PatchGridCache::PatchGridCache(const size_t capacity) :
+        m_capacity{capacity},
+        m_hits{0u},
+        m_misses{0u} {}
+
+        std::shared_ptr<const PatchGrid> PatchGridCache::get(const BezierPatch& patch, const size_t subdivisionsPerSurface) {
+            auto key = Key{patch.pointRowCount(), patch.pointColumnCount(), subdivisionsPerSurface, patch.controlPoints()};
+
+            {
+                const auto lock = std::lock_guard<std::mutex>{m_mutex};
+                if (const auto it = m_entries.find(key); it != std::end(m_entries)) {
+                    m_usage.splice(std::begin(m_usage), m_usage, it->second.usage);
+                    ++m_hits;
+                    return it->second.grid;
+                }
+                ++m_misses;
+            }
+
+            auto grid = std::make_shared<const PatchGrid>(makePatchGrid(patch, subdivisionsPerSurface));
+
+            const auto lock = std::lock_guard<std::mutex>{m_mutex};
+            const auto [it, inserted] = m_entries.try_emplace(std::move(key), Entry{grid, std::end(m_usage)});
+            if (!inserted) {
+                // another thread tessellated the same patch in the meantime
+                return it->second.grid;
+            }
+
+            m_usage.push_front(&it->first);
+            it->second.usage = std::begin(m_usage);
+
+            while (m_usage.size() > m_capacity) {
+                m_entries.erase(m_entries.find(*m_usage.back()));
+                m_usage.pop_back();
+            }
+
+            return grid;
+        }
+
+        size_t PatchGridCache::size() const {
+            const auto lock = std::lock_guard<std::mutex>{m_mutex};
+            return m_entries.size();
+        }
+
+        size_t PatchGridCache::hits() const {
+            const auto lock = std::lock_guard<std::mutex>{m_mutex};
+            return m_hits;
+        }
+
+        size_t PatchGridCache::misses() const {
+            const auto lock = std::lock_guard<std::mutex>{m_mutex};
+            return m_misses;
+        }
+
+        void PatchGridCache::clear() {
+            const auto lock = std::lock_guard<std::mutex>{m_mutex};
+            m_usage.clear();
+            m_entries.clear();
+            m_hits = 0u;
+            m_misses = 0u;
+        }
+    }
+}
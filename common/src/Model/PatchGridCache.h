@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+#include "Model/BezierPatch.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        struct PatchGrid;
+
+        /**
+         * Caches patch tessellations keyed by the control points of the patch and the number of subdivisions.
+         *
+         * Patch nodes are cloned and have their patches swapped on every transformation, undo and redo, and most of
+         * these operations restore control points that were tessellated before. The cache holds on to the least recently
+         * used tessellations up to its capacity, and tessellations that are still in use by a node are shared.
+         *
+         * Every document owns a cache, which is cleared together with the document, so that no tessellations outlive it.
+         *
+         * The cache can be used from multiple threads concurrently. Tessellation is performed outside of the lock.
+         */
+        class PatchGridCache {
+        private:
+            struct Key {
+                size_t pointRowCount;
+                size_t pointColumnCount;
+                size_t subdivisionsPerSurface;
+                std::vector<BezierPatch::Point> controlPoints;
+            };
+
+            struct KeyHash {
+                size_t operator()(const Key& key) const;
+            };
+
+            struct KeyEqual {
+                bool operator()(const Key& lhs, const Key& rhs) const;
+            };
+
+            /** Keys in order of their last use, most recently used first. Points to the keys in m_entries. */
+            using UsageList = std::list<const Key*>;
+
+            struct Entry {
+                std::shared_ptr<const PatchGrid> grid;
+                UsageList::iterator usage;
+            };
+
+            size_t m_capacity;
+            UsageList m_usage;
+            std::unordered_map<Key, Entry, KeyHash, KeyEqual> m_entries;
+            size_t m_hits;
+            size_t m_misses;
+            mutable std::mutex m_mutex;
+        public:
+            static constexpr size_t DefaultCapacity = 4096u;
+
+            explicit PatchGridCache(size_t capacity = DefaultCapacity);
+
+            /**
+             * Returns the tessellation of the given patch with the given number of subdivisions per surface, computing
+             * and caching it if it is not cached already.
+             */
+            std::shared_ptr<const PatchGrid> get(const BezierPatch& patch, size_t subdivisionsPerSurface);
+
+            size_t size() const;
+            size_t hits() const;
+            size_t misses() const;
+
+            void clear();
+
+            deleteCopyAndMove(PatchGridCache)
+        };
+    }
+}
@@ -27,23 +27,36 @@
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/ModelUtils.h"
+#include "Model/PatchGridCache.h"
 #include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 #include "Model/WorldNode.h"
 
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/zip_iterator.h>
 
 #include <vecmath/intersection.h>
+#include <vecmath/ray.h>
 #include <vecmath/vec_io.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <ostream>
 #include <string>
 
 namespace TrenchBroom {
     namespace Model {
-        constexpr static size_t DefaultSubdivisionsPerSurface = 3u;
+        constexpr static FloatType MaxTessellationPositionError = 0.5;
+        constexpr static FloatType MaxTessellationTexCoordError = 1.0 / 64.0;
+
+        /* The maximum number of quads in a leaf of a grid's bounding volume hierarchy. */
+        constexpr static size_t MaxQuadsPerBoundsLeaf = 4u;
+
+        /* Precomputing grids for fewer patches than this is not worth the overhead of spawning threads. */
+        constexpr static size_t MinPatchCountForParallelTessellation = 16u;
 
         const PatchGrid::Point& PatchGrid::point(const size_t row, const size_t col) const {
             const auto index = row * pointColumnCount + col;
@@ -72,6 +85,97 @@ namespace TrenchBroom {
             return pointColumnCount - 1u;
         }
 
+        static FloatType intersectQuad(const PatchGrid& grid, const vm::ray3& ray, const size_t row, const size_t col) {
+            const auto& v0 = grid.point(row, col).position;
+            const auto& v1 = grid.point(row, col + 1u).position;
+            const auto& v2 = grid.point(row + 1u, col + 1u).position;
+            const auto& v3 = grid.point(row + 1u, col).position;
+
+            const auto distance0 = vm::intersect_ray_triangle(ray, v0, v1, v2);
+            const auto distance1 = vm::intersect_ray_triangle(ray, v2, v3, v0);
+            if (vm::is_nan(distance0)) {
+                return distance1;
+            } else if (vm::is_nan(distance1)) {
+                return distance0;
+            } else {
+                return std::min(distance0, distance1);
+            }
+        }
+
+        FloatType PatchGrid::intersectWithRay(const vm::ray3& ray) const {
+            auto closestDistance = vm::nan<FloatType>();
+            if (boundsHierarchy.empty()) {
+                return closestDistance;
+            }
+
+            auto stack = std::vector<size_t>{0u};
+            while (!stack.empty()) {
+                const auto nodeIndex = stack.back();
+                const auto& node = boundsHierarchy[nodeIndex];
+                stack.pop_back();
+
+                if (!node.bounds.contains(ray.origin)) {
+                    const auto distanceToBounds = vm::intersect_ray_bbox(ray, node.bounds);
+                    if (vm::is_nan(distanceToBounds) || (!vm::is_nan(closestDistance) && distanceToBounds > closestDistance)) {
+                        continue;
+                    }
+                }
+
+                if (node.rightChild) {
+                    stack.push_back(*node.rightChild);
+                    stack.push_back(nodeIndex + 1u);
+                } else {
+                    for (size_t row = node.firstQuadRow; row <= node.lastQuadRow; ++row) {
+                        for (size_t col = node.firstQuadColumn; col <= node.lastQuadColumn; ++col) {
+                            const auto distance = intersectQuad(*this, ray, row, col);
+                            if (!vm::is_nan(distance) && (vm::is_nan(closestDistance) || distance < closestDistance)) {
+                                closestDistance = distance;
+                            }
+                        }
+                    }
+                }
+            }
+
+            return closestDistance;
+        }
+
+        /**
+         * Appends the bounds hierarchy for the given quad range of the given grid to the given nodes, splitting the
+         * longer side of the range in half until the ranges are small enough. Returns the index of the appended node.
+         */
+        static size_t buildBoundsHierarchy(const PatchGrid& grid, const size_t firstRow, const size_t lastRow, const size_t firstCol, const size_t lastCol, std::vector<PatchGrid::BoundsNode>& nodes) {
+            const auto nodeIndex = nodes.size();
+            nodes.push_back(PatchGrid::BoundsNode{vm::bbox3{}, firstRow, lastRow, firstCol, lastCol, std::nullopt});
+
+            const auto rowCount = lastRow - firstRow + 1u;
+            const auto colCount = lastCol - firstCol + 1u;
+            if (rowCount * colCount <= MaxQuadsPerBoundsLeaf) {
+                auto boundsBuilder = vm::bbox3::builder{};
+                for (size_t row = firstRow; row <= lastRow + 1u; ++row) {
+                    for (size_t col = firstCol; col <= lastCol + 1u; ++col) {
+                        boundsBuilder.add(grid.point(row, col).position);
+                    }
+                }
+                nodes[nodeIndex].bounds = boundsBuilder.bounds();
+                return nodeIndex;
+            }
+
+            size_t rightChild;
+            if (rowCount >= colCount) {
+                const auto midRow = firstRow + rowCount / 2u;
+                buildBoundsHierarchy(grid, firstRow, midRow - 1u, firstCol, lastCol, nodes);
+                rightChild = buildBoundsHierarchy(grid, midRow, lastRow, firstCol, lastCol, nodes);
+            } else {
+                const auto midCol = firstCol + colCount / 2u;
+                buildBoundsHierarchy(grid, firstRow, lastRow, firstCol, midCol - 1u, nodes);
+                rightChild = buildBoundsHierarchy(grid, firstRow, lastRow, midCol, lastCol, nodes);
+            }
+
+            nodes[nodeIndex].bounds = vm::merge(nodes[nodeIndex + 1u].bounds, nodes[rightChild].bounds);
+            nodes[nodeIndex].rightChild = rightChild;
+            return nodeIndex;
+        }
+
         /**
          * Compute the normals for the given patch grid points.
          *
@@ -243,19 +347,106 @@ namespace TrenchBroom {
                 boundsBuilder.add(position);
             }
 
-            return {
+            auto grid = PatchGrid{
                 gridPointRowCount,
                 gridPointColumnCount,
                 std::move(points),
-                boundsBuilder.bounds()
+                boundsBuilder.bounds(),
+                {}
             };
+
+            buildBoundsHierarchy(grid, 0u, grid.quadRowCount() - 1u, 0u, grid.quadColumnCount() - 1u, grid.boundsHierarchy);
+            return grid;
+        }
+
+        /**
+         * Returns the number of segments per direction required so that the triangulated grid over the biquadratic
+         * Bezier surface with the given 3x3 control points deviates from the surface by at most the given error.
+         *
+         * With k segments per direction, the deviation is bounded by (M_uu + 2*M_uv + M_vv) / (8*k^2), where M_uu and M_vv
+         * bound the second derivatives along the rows and columns and M_uv bounds the mixed derivative of the surface.
+         */
+        template <size_t S>
+        static FloatType requiredSegments(const std::array<vm::vec<FloatType, S>, 9u>& points, const FloatType maxError) {
+            const auto at = [&](const size_t row, const size_t col) -> const vm::vec<FloatType, S>& {
+                return points[row * 3u + col];
+            };
+
+            auto maxRowDerivative = static_cast<FloatType>(0);
+            auto maxColumnDerivative = static_cast<FloatType>(0);
+            for (size_t i = 0u; i < 3u; ++i) {
+                maxRowDerivative = std::max(maxRowDerivative, static_cast<FloatType>(2) * vm::length(at(i, 0u) - static_cast<FloatType>(2) * at(i, 1u) + at(i, 2u)));
+                maxColumnDerivative = std::max(maxColumnDerivative, static_cast<FloatType>(2) * vm::length(at(0u, i) - static_cast<FloatType>(2) * at(1u, i) + at(2u, i)));
+            }
+
+            auto maxMixedDerivative = static_cast<FloatType>(0);
+            for (size_t row = 0u; row < 2u; ++row) {
+                for (size_t col = 0u; col < 2u; ++col) {
+                    maxMixedDerivative = std::max(maxMixedDerivative, static_cast<FloatType>(4) * vm::length(at(row + 1u, col + 1u) - at(row + 1u, col) - at(row, col + 1u) + at(row, col)));
+                }
+            }
+
+            const auto bound = maxRowDerivative + static_cast<FloatType>(2) * maxMixedDerivative + maxColumnDerivative;
+            return std::sqrt(bound / (static_cast<FloatType>(8) * maxError));
+        }
+
+        size_t computeSubdivisionsPerSurface(const BezierPatch& patch, const FloatType maxPositionError, const FloatType maxTexCoordError, const size_t maxSubdivisionsPerSurface) {
+            auto segments = static_cast<FloatType>(1);
+
+            for (size_t surfaceRow = 0u; surfaceRow < patch.surfaceRowCount(); ++surfaceRow) {
+                for (size_t surfaceCol = 0u; surfaceCol < patch.surfaceColumnCount(); ++surfaceCol) {
+                    auto positions = std::array<vm::vec3, 9u>{};
+                    auto texCoords = std::array<vm::vec2, 9u>{};
+                    for (size_t row = 0u; row < 3u; ++row) {
+                        for (size_t col = 0u; col < 3u; ++col) {
+                            const auto& point = patch.controlPoint(2u * surfaceRow + row, 2u * surfaceCol + col);
+                            positions[row * 3u + col] = point.xyz();
+                            texCoords[row * 3u + col] = vm::slice<2>(point, 3);
+                        }
+                    }
+
+                    segments = std::max({
+                        segments,
+                        requiredSegments(positions, maxPositionError),
+                        requiredSegments(texCoords, maxTexCoordError)
+                    });
+                }
+            }
+
+            size_t subdivisions = 0u;
+            while (subdivisions < maxSubdivisionsPerSurface && static_cast<FloatType>(size_t(1) << subdivisions) < segments) {
+                ++subdivisions;
+            }
+            return subdivisions;
+        }
+
+        static size_t adaptiveSubdivisionsPerSurface(const BezierPatch& patch) {
+            return computeSubdivisionsPerSurface(patch, MaxTessellationPositionError, MaxTessellationTexCoordError, MaxSubdivisionsPerSurface);
+        }
+
+        static std::shared_ptr<const PatchGrid> makeSharedPatchGrid(const BezierPatch& patch) {
+            return std::make_shared<const PatchGrid>(makePatchGrid(patch, adaptiveSubdivisionsPerSurface(patch)));
+        }
+
+        void precomputePatchGrids(const std::vector<const BezierPatch*>& patches, PatchGridCache& gridCache) {
+            if (patches.size() < MinPatchCountForParallelTessellation) {
+                return;
+            }
+
+            kdl::parallel_for(patches.size(), [&](const size_t i) {
+                gridCache.get(*patches[i], adaptiveSubdivisionsPerSurface(*patches[i]));
+            });
         }
 
         const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
         PatchNode::PatchNode(BezierPatch patch) :
         m_patch{std::move(patch)},
-        m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)} {}
+        m_grid{makeSharedPatchGrid(m_patch)} {}
+
+        PatchNode::PatchNode(BezierPatch patch, std::shared_ptr<const PatchGrid> grid) :
+        m_patch{std::move(patch)},
+        m_grid{std::move(grid)} {}
 
         const EntityNodeBase* PatchNode::entity() const {
             return visitParent(kdl::overload(
@@ -281,7 +472,16 @@ namespace TrenchBroom {
             const NotifyPhysicalBoundsChange boundsChange(this);
 
             auto previousPatch = std::exchange(m_patch, std::move(patch));
-            m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+            m_grid = makeSharedPatchGrid(m_patch);
+            return previousPatch;
+        }
+
+        BezierPatch PatchNode::setPatch(BezierPatch patch, PatchGridCache& gridCache) {
+            const NotifyNodeChange nodeChange(this);
+            const NotifyPhysicalBoundsChange boundsChange(this);
+
+            auto previousPatch = std::exchange(m_patch, std::move(patch));
+            m_grid = gridCache.get(m_patch, adaptiveSubdivisionsPerSurface(m_patch));
             return previousPatch;
         }
 
@@ -290,7 +490,7 @@ namespace TrenchBroom {
         }
 
         const PatchGrid& PatchNode::grid() const {
-            return m_grid;
+            return *m_grid;
         }
 
         const std::string& PatchNode::doGetName() const {
@@ -303,7 +503,7 @@ namespace TrenchBroom {
         }
 
         const vm::bbox3& PatchNode::doGetPhysicalBounds() const {
-            return m_grid.bounds;
+            return m_grid->bounds;
         }
 
         FloatType PatchNode::doGetProjectedArea(const vm::axis::type axis) const {
@@ -322,7 +522,8 @@ namespace TrenchBroom {
         }
 
         Node* PatchNode::doClone(const vm::bbox3&) const {
-            return new PatchNode(m_patch);
+            // the clone shares the tessellation since it has the same control points
+            return new PatchNode(m_patch, m_grid);
         }
 
         bool PatchNode::doCanAddChild(const Node*) const {
@@ -349,26 +550,10 @@ namespace TrenchBroom {
             if (!editorContext.visible(this)) {
                 return;
             }
-            const auto pickTriangle = [&](const auto& p0, const auto& p1, const auto& p2) {
-                if (const auto distance = vm::intersect_ray_triangle(pickRay, p0, p1, p2); !vm::is_nan(distance)) {
-                    const auto hitPoint = vm::point_at_distance(pickRay, distance);
-                    pickResult.addHit(Hit(PatchHitType, distance, hitPoint, this));
-                    return true;
-                }
-                return false;
-            };
-
-            for (size_t row = 0u; row < m_grid.pointRowCount - 1u; ++row) {
-                for (size_t col = 0u; col < m_grid.pointColumnCount - 1u; ++col) {
-                    const auto v0 = m_grid.point(row, col).position;
-                    const auto v1 = m_grid.point(row, col + 1u).position;
-                    const auto v2 = m_grid.point(row + 1u, col + 1u).position;
-                    const auto v3 = m_grid.point(row + 1u, col).position;
 
-                    if (pickTriangle(v0, v1, v2) || pickTriangle(v2, v3, v0)) {
-                        return;
-                    }
-                }
+            if (const auto distance = m_grid->intersectWithRay(pickRay); !vm::is_nan(distance)) {
+                const auto hitPoint = vm::point_at_distance(pickRay, distance);
+                pickResult.addHit(Hit(PatchHitType, distance, hitPoint, this));
             }
         }
 
@@ -25,7 +25,9 @@
 #include "Model/Object.h"
 
 #include <iosfwd>
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -34,6 +36,13 @@ namespace TrenchBroom {
 
     namespace Model {
         class EntityNodeBase;
+        class PatchGridCache;
+
+        /**
+         * The number of subdivisions per surface that is used to export patches. Rendering and picking use an adaptive
+         * number of subdivisions per surface that never exceeds this.
+         */
+        constexpr size_t MaxSubdivisionsPerSurface = 3u;
 
         struct PatchGrid {
             struct Point {
@@ -42,15 +51,36 @@ namespace TrenchBroom {
                 vm::vec3 normal;
             };
 
+            /**
+             * A node of the bounding volume hierarchy over the quads of the grid. Each node covers a rectangular range
+             * of quads. An inner node's left child immediately follows it, and its right child is at the given index.
+             * Leaf nodes have no right child.
+             */
+            struct BoundsNode {
+                vm::bbox3 bounds;
+                size_t firstQuadRow;
+                size_t lastQuadRow;
+                size_t firstQuadColumn;
+                size_t lastQuadColumn;
+                std::optional<size_t> rightChild;
+            };
+
             size_t pointRowCount;
             size_t pointColumnCount;
             std::vector<Point> points;
             vm::bbox3 bounds;
+            std::vector<BoundsNode> boundsHierarchy;
 
             const Point& point(size_t row, size_t col) const;
             
             size_t quadRowCount() const;
             size_t quadColumnCount() const;
+
+            /**
+             * Returns the distance to the closest intersection of the given ray with the triangles of this grid, or NaN
+             * if the ray does not hit the grid.
+             */
+            FloatType intersectWithRay(const vm::ray3& ray) const;
         };
 
         // public for testing
@@ -59,6 +89,23 @@ namespace TrenchBroom {
         // public for testing
         PatchGrid makePatchGrid(const BezierPatch& patch, size_t subdivisionsPerSurface);
 
+        /**
+         * Returns the number of subdivisions per surface that is necessary so that the tessellation of the given patch
+         * deviates from the true surface by at most the given errors, but no more than the given maximum.
+         *
+         * The deviation of the triangulated grid with k segments per direction from a biquadratic surface is bounded
+         * by (M_uu + 2*M_uv + M_vv) / (8*k^2), where M_uu and M_vv bound the second derivatives along the rows and
+         * columns of the surface, and M_uv bounds its mixed derivative, which accounts for twisted surfaces. We compute
+         * this bound for every surface in the patch, separately for the positions and the texture coordinates.
+         */
+        size_t computeSubdivisionsPerSurface(const BezierPatch& patch, FloatType maxPositionError, FloatType maxTexCoordError, size_t maxSubdivisionsPerSurface);
+
+        /**
+         * Tessellates the given patches in parallel and stores the results in the given patch grid cache, so that patch
+         * nodes which are subsequently set to these patches using the same cache find their grids in it.
+         */
+        void precomputePatchGrids(const std::vector<const BezierPatch*>& patches, PatchGridCache& gridCache);
+
         bool operator==(const PatchGrid::Point& lhs, const PatchGrid::Point& rhs);
         bool operator!=(const PatchGrid::Point& lhs, const PatchGrid::Point& rhs);
         std::ostream& operator<<(std::ostream& str, const PatchGrid::Point& p);
@@ -68,15 +115,22 @@ namespace TrenchBroom {
             static const HitType::Type PatchHitType;
         private:
             BezierPatch m_patch;
-            PatchGrid m_grid;
+            std::shared_ptr<const PatchGrid> m_grid;
         public:
             explicit PatchNode(BezierPatch patch);
+        private:
+            PatchNode(BezierPatch patch, std::shared_ptr<const PatchGrid> grid);
+        public:
 
             EntityNodeBase* entity();
             const EntityNodeBase* entity() const;
 
             const BezierPatch& patch() const;
             BezierPatch setPatch(BezierPatch patch);
+            /**
+             * Sets the given patch and looks up its tessellation in the given cache.
+             */
+            BezierPatch setPatch(BezierPatch patch, PatchGridCache& gridCache);
 
             void setTexture(Assets::Texture* texture);
 
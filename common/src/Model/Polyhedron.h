@@ -1003,6 +1003,14 @@ namespace TrenchBroom {
             using VertexPayloadType = VP;
         private:
             static constexpr const auto MinEdgeLength = T(0.01);
+            /**
+             * Point sets with fewer points are added to a polyhedron without culling them first.
+             */
+            static constexpr const size_t ConvexHullCullingMinPointCount = 64u;
+            /**
+             * Point sets with more points are divided into chunks of this size which are culled in parallel.
+             */
+            static constexpr const size_t ConvexHullCullingChunkSize = 2048u;
         public:
             using Vertex = Polyhedron_Vertex<T,FP,VP>;
             using Edge = Polyhedron_Edge<T,FP,VP>;
@@ -1097,6 +1105,19 @@ namespace TrenchBroom {
              */
             explicit Polyhedron(std::vector<vm::vec<T,3>> positions);
 
+            /**
+             * Constructs a polyhedron from the given vertex positions and faces without computing a convex hull. Every
+             * face is given by the indices of its vertices in the order of its boundary and by its plane.
+             *
+             * The given data must describe a valid convex polyhedron such as the one returned by vertexPositions() and
+             * the boundaries of faces(). This is not checked.
+             *
+             * @param positions the vertex positions
+             * @param faceVertexIndices for each face, the indices of its vertices in the order of its boundary
+             * @param facePlanes for each face, its plane
+             */
+            Polyhedron(std::vector<vm::vec<T,3>> positions, const std::vector<std::vector<size_t>>& faceVertexIndices, const std::vector<vm::plane<T,3>>& facePlanes);
+
             /**
              * Copy constructor.
              */
@@ -1519,18 +1540,49 @@ namespace TrenchBroom {
             std::string exportObjSelectedFaces(const std::vector<const Face*>& faces) const;
 
             /* ====================== Implementation in Polyhedron_ConvexHull.h ====================== */
+        public: // exposed for tests only
+            /**
+             * Adds the given points like addPoints(), but adds every point by calling addPoint() without culling any of
+             * them first. The result must be identical to the result of addPoints().
+             *
+             * @param points the points to add to this polyhedron
+             */
+            void addPointsWithoutCulling(std::vector<vm::vec<T,3>> points);
         private: // Convex hull; adding and removing points
             /**
              * Adds the given points to this polyhedron. The effect of adding the given points to a polyhedron is that
              * the resulting polyhedron is the convex hull of the union of the polyhedron's vertices and the given points.
              *
-             * Duplicates in the given vector are discarded. Furthermore, the remaining points are sorted in descending
-             * order of their distance from the center of their bounding box. Therefore, the result of calling this
-             * method is different from the result of repeatedly calling addPoint() for every point in the given vector.
+             * Duplicates in the given vector are discarded, and the remaining points are sorted. Furthermore, points
+             * which cannot be vertices of the convex hull are culled before the remaining points are added one by one.
+             * Therefore, the result of calling this method is different from the result of repeatedly calling
+             * addPoint() for every point in the given vector.
              *
              * @param points the points to add to this polyhedron
              */
             void addPoints(std::vector<vm::vec<T,3>> points);
+            /**
+             * Returns those of the given points which may be vertices of their convex hull, in their original order.
+             *
+             * This performs the culling steps of the quickhull algorithm: A polyhedron is built from the extreme points
+             * of the given points and then repeatedly extended by the point which is farthest above each of its faces.
+             * Every point which is inside of this polyhedron by more than the plane epsilon plus the minimum edge length
+             * is removed. Such a point can neither be a vertex of the convex hull nor prevent another point from
+             * becoming one, so adding the remaining points yields the same polyhedron as adding all of the given points.
+             *
+             * Large point sets are divided into chunks of consecutive points which are culled in parallel, and then the
+             * remaining points of all chunks are culled together. This is valid because a point inside the convex hull
+             * of its chunk is also inside the convex hull of all points.
+             *
+             * @param points the points to cull, must be sorted and must not contain duplicates
+             * @param planeEpsilon the plane epsilon to use for point status checks
+             * @return the points that were not culled
+             */
+            static std::vector<vm::vec<T,3>> cullConvexHullPoints(std::vector<vm::vec<T,3>> points, T planeEpsilon);
+            /**
+             * Culls the given points sequentially as described in cullConvexHullPoints().
+             */
+            static std::vector<vm::vec<T,3>> cullConvexHullPointChunk(std::vector<vm::vec<T,3>> points, T planeEpsilon);
             /**
              * Adds the given point to this polyhedron. The effect of adding the given point to a polyhedron is that the
              * resulting polyhedron is the convex hull of the union of the polyhedron's vertices and the given point.
@@ -23,6 +23,7 @@
 
 #include "Polyhedron.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
@@ -31,8 +32,13 @@
 #include <vecmath/segment.h>
 #include <vecmath/util.h>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <optional>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -54,12 +60,132 @@ namespace TrenchBroom {
                 points = kdl::vec_sort_and_remove_duplicates(std::move(points));
                 
                 const auto planeEpsilon = computePlaneEpsilon(points);
+                points = cullConvexHullPoints(std::move(points), planeEpsilon);
                 for (const auto& point : points) {
                     addPoint(point, planeEpsilon);
                 }
             }
         }
 
+        template <typename T, typename FP, typename VP>
+        void Polyhedron<T,FP,VP>::addPointsWithoutCulling(std::vector<vm::vec<T,3>> points) {
+            if (!points.empty()) {
+                points = kdl::vec_sort_and_remove_duplicates(std::move(points));
+
+                const auto planeEpsilon = computePlaneEpsilon(points);
+                for (const auto& point : points) {
+                    addPoint(point, planeEpsilon);
+                }
+            }
+        }
+
+        template <typename T>
+        static std::vector<vm::vec<T,3>> findConvexHullExtremePoints(const std::vector<vm::vec<T,3>>& points) {
+            // the coordinate axes and the diagonals of the unit cube
+            const auto directions = std::vector<vm::vec<T,3>>{
+                vm::vec<T,3>::pos_x(),
+                vm::vec<T,3>::pos_y(),
+                vm::vec<T,3>::pos_z(),
+                vm::vec<T,3>(static_cast<T>(1), static_cast<T>(1), static_cast<T>(1)),
+                vm::vec<T,3>(static_cast<T>(1), static_cast<T>(1), static_cast<T>(-1)),
+                vm::vec<T,3>(static_cast<T>(1), static_cast<T>(-1), static_cast<T>(1)),
+                vm::vec<T,3>(static_cast<T>(1), static_cast<T>(-1), static_cast<T>(-1))
+            };
+
+            std::vector<vm::vec<T,3>> result;
+            for (const auto& direction : directions) {
+                const auto [minPoint, maxPoint] = std::minmax_element(std::begin(points), std::end(points), [&](const auto& lhs, const auto& rhs) {
+                    return vm::dot(lhs, direction) < vm::dot(rhs, direction);
+                });
+                result.push_back(*minPoint);
+                result.push_back(*maxPoint);
+            }
+            return kdl::vec_sort_and_remove_duplicates(std::move(result));
+        }
+
+        template <typename T, typename FP, typename VP>
+        std::vector<vm::vec<T,3>> Polyhedron<T,FP,VP>::cullConvexHullPoints(std::vector<vm::vec<T,3>> points, const T planeEpsilon) {
+            if (points.size() < ConvexHullCullingMinPointCount) {
+                return points;
+            }
+
+            if (points.size() > ConvexHullCullingChunkSize) {
+                // since the points are sorted, the chunks are slabs of space which cull each other's points well
+                const auto chunkCount = (points.size() + ConvexHullCullingChunkSize - 1u) / ConvexHullCullingChunkSize;
+                auto chunks = std::vector<std::vector<vm::vec<T,3>>>(chunkCount);
+                kdl::parallel_for(chunkCount, [&](const size_t i) {
+                    const auto first = i * ConvexHullCullingChunkSize;
+                    const auto last = std::min(first + ConvexHullCullingChunkSize, points.size());
+                    chunks[i] = cullConvexHullPointChunk(
+                        std::vector<vm::vec<T,3>>(
+                            std::next(std::begin(points), static_cast<std::ptrdiff_t>(first)),
+                            std::next(std::begin(points), static_cast<std::ptrdiff_t>(last))),
+                        planeEpsilon);
+                });
+                points = kdl::vec_flatten(std::move(chunks));
+            }
+
+            return cullConvexHullPointChunk(std::move(points), planeEpsilon);
+        }
+
+        template <typename T, typename FP, typename VP>
+        std::vector<vm::vec<T,3>> Polyhedron<T,FP,VP>::cullConvexHullPointChunk(std::vector<vm::vec<T,3>> points, const T planeEpsilon) {
+            // faces of the culling polyhedron may deviate from the convex hull by the plane epsilon due to merging of
+            // coplanar faces, and a point closer than the minimum edge length to a vertex of the convex hull would
+            // prevent that vertex from being added
+            const auto margin = planeEpsilon + MinEdgeLength;
+
+            Polyhedron hull;
+            for (const auto& point : findConvexHullExtremePoints(points)) {
+                hull.addPoint(point, planeEpsilon);
+            }
+
+            while (hull.polyhedron()) {
+                std::vector<const Face*> faces;
+                for (const Face* face : hull.faces()) {
+                    faces.push_back(face);
+                }
+
+                // for every face, the index of the point which is farthest above it and its distance
+                auto farthestPoints = std::vector<std::optional<std::pair<size_t, T>>>(faces.size());
+
+                std::vector<vm::vec<T,3>> remainingPoints;
+                for (const auto& point : points) {
+                    auto maxDistance = std::numeric_limits<T>::lowest();
+                    size_t maxFaceIndex = 0u;
+                    for (size_t i = 0u; i < faces.size(); ++i) {
+                        const auto distance = faces[i]->plane().point_distance(point);
+                        if (distance > maxDistance) {
+                            maxDistance = distance;
+                            maxFaceIndex = i;
+                        }
+                    }
+
+                    if (maxDistance >= -margin) {
+                        auto& farthestPoint = farthestPoints[maxFaceIndex];
+                        if (maxDistance > margin && (!farthestPoint || maxDistance > farthestPoint->second)) {
+                            farthestPoint = std::make_pair(remainingPoints.size(), maxDistance);
+                        }
+                        remainingPoints.push_back(point);
+                    }
+                }
+                points = std::move(remainingPoints);
+
+                auto addedPoint = false;
+                for (const auto& farthestPoint : farthestPoints) {
+                    if (farthestPoint && hull.addPoint(points[farthestPoint->first], planeEpsilon) != nullptr) {
+                        addedPoint = true;
+                    }
+                }
+
+                if (!addedPoint) {
+                    break;
+                }
+            }
+
+            return points;
+        }
+
         template <typename T, typename FP, typename VP>
         typename Polyhedron<T,FP,VP>::Vertex* Polyhedron<T,FP,VP>::addPoint(const vm::vec<T,3>& position, const T planeEpsilon) {
             assert(checkInvariant());
@@ -194,6 +194,58 @@ namespace TrenchBroom {
             addPoints(std::move(positions));
         }
 
+        template <typename T, typename FP, typename VP>
+        Polyhedron<T,FP,VP>::Polyhedron(std::vector<vm::vec<T,3>> positions, const std::vector<std::vector<size_t>>& faceVertexIndices, const std::vector<vm::plane<T,3>>& facePlanes) {
+            assert(faceVertexIndices.size() == facePlanes.size());
+
+            std::vector<Vertex*> vertices;
+            vertices.reserve(positions.size());
+            for (const auto& position : positions) {
+                Vertex* vertex = new Vertex(position);
+                vertices.push_back(vertex);
+                m_vertices.push_back(vertex);
+            }
+
+            // maps the indices of the origin and the destination of every half edge to the half edge
+            std::unordered_map<size_t, HalfEdge*> halfEdges;
+            const auto halfEdgeKey = [&](const size_t origin, const size_t destination) {
+                return origin * positions.size() + destination;
+            };
+
+            for (size_t i = 0u; i < faceVertexIndices.size(); ++i) {
+                const auto& vertexIndices = faceVertexIndices[i];
+                assert(vertexIndices.size() >= 3u);
+
+                HalfEdgeList boundary;
+                for (size_t j = 0u; j < vertexIndices.size(); ++j) {
+                    const size_t origin = vertexIndices[j];
+                    const size_t destination = vertexIndices[(j + 1u) % vertexIndices.size()];
+
+                    HalfEdge* halfEdge = new HalfEdge(vertices[origin]);
+                    boundary.push_back(halfEdge);
+                    halfEdges.emplace(halfEdgeKey(origin, destination), halfEdge);
+                }
+                m_faces.push_back(new Face(std::move(boundary), facePlanes[i]));
+            }
+
+            for (const auto& vertexIndices : faceVertexIndices) {
+                for (size_t j = 0u; j < vertexIndices.size(); ++j) {
+                    const size_t origin = vertexIndices[j];
+                    const size_t destination = vertexIndices[(j + 1u) % vertexIndices.size()];
+
+                    // every edge is created once from the half edge whose origin has the lower index
+                    if (origin < destination) {
+                        HalfEdge* first = halfEdges[halfEdgeKey(origin, destination)];
+                        HalfEdge* second = halfEdges[halfEdgeKey(destination, origin)];
+                        assert(first != nullptr && second != nullptr);
+                        m_edges.push_back(new Edge(first, second));
+                    }
+                }
+            }
+
+            updateBounds();
+        }
+
         template <typename T, typename FP, typename VP>
         Polyhedron<T,FP,VP>::Polyhedron(const Polyhedron<T,FP,VP>& other) {
             Copy copy(other.faces(), other.edges(), other.vertices(), *this, CopyCallback());
@@ -70,9 +70,26 @@ namespace TrenchBroom {
             addQuickFix(new SoftMapBoundsIssueQuickFix());
         }
 
-        void SoftMapBoundsIssueGenerator::generateInternal(Node* node, IssueList& issues) const {
+        void SoftMapBoundsIssueGenerator::doBeginBatch() const {
+            // the soft map bounds are the same for every node, so we extract them only once per batch
+            m_batchBounds = softMapBounds();
+        }
+
+        void SoftMapBoundsIssueGenerator::doEndBatch() const {
+            m_batchBounds = std::nullopt;
+        }
+
+        Game::SoftMapBounds SoftMapBoundsIssueGenerator::softMapBounds() const {
+            if (m_batchBounds.has_value()) {
+                return *m_batchBounds;
+            }
+
             auto game = kdl::mem_lock(m_game);
-            const Game::SoftMapBounds bounds = game->extractSoftMapBounds(m_world->entity());
+            return game->extractSoftMapBounds(m_world->entity());
+        }
+
+        void SoftMapBoundsIssueGenerator::generateInternal(Node* node, IssueList& issues) const {
+            const Game::SoftMapBounds bounds = softMapBounds();
 
             if (!bounds.bounds.has_value()) {
                 return;
@@ -20,17 +20,18 @@
 #pragma once
 
 #include "FloatType.h"
+#include "Model/Game.h"
 #include "Model/IssueGenerator.h"
 
 #include <vecmath/bbox.h>
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         class WorldNode;
-        class Game;
         class Node;
 
         class SoftMapBoundsIssueGenerator : public IssueGenerator {
@@ -40,9 +41,14 @@ namespace TrenchBroom {
         private:
             std::weak_ptr<Game> m_game;
             const WorldNode* m_world;
+            mutable std::optional<Game::SoftMapBounds> m_batchBounds;
         public:
             explicit SoftMapBoundsIssueGenerator(std::weak_ptr<Game> game, const WorldNode* world);
         private:
+            void doBeginBatch() const override;
+            void doEndBatch() const override;
+
+            Game::SoftMapBounds softMapBounds() const;
             void generateInternal(Node* node, IssueList& issues) const;
             void doGenerate(EntityNode* brush, IssueList& issues) const override;
             void doGenerate(BrushNode* brush, IssueList& issues) const override;
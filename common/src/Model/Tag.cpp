@@ -149,6 +149,10 @@ namespace TrenchBroom {
         }
 
         bool Taggable::removeTag(const Tag& tag) {
+            if (!hasTag(tag)) {
+                return false;
+            }
+
             const auto it = m_tags.find(TagReference(tag));
             if (it == std::end(m_tags)) {
                 return false;
@@ -204,6 +208,18 @@ namespace TrenchBroom {
 
         TagMatcher::~TagMatcher() = default;
 
+        TagMatcherInput TagMatcher::input() const {
+            return TagMatcherInput::Taggable;
+        }
+
+        bool TagMatcher::matchesFaceTexture(std::string_view /* textureName */, const Assets::Texture* /* texture */) const {
+            return false;
+        }
+
+        bool TagMatcher::matchesBrushEntityClassname(const std::string& /* classname */) const {
+            return false;
+        }
+
         void TagMatcher::enable(TagMatcherCallback& /* callback */, MapFacade& /* facade */) const {}
         void TagMatcher::disable(TagMatcherCallback& /* callback */, MapFacade& /* facade */) const {}
 
@@ -239,6 +255,10 @@ namespace TrenchBroom {
             return m_matcher->matches(taggable) ;
         }
 
+        const TagMatcher& SmartTag::matcher() const {
+            return *m_matcher;
+        }
+
         void SmartTag::update(Taggable& taggable) const {
             if (matches(taggable)) {
                 taggable.addTag(*this);
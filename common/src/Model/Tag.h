@@ -26,9 +26,14 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
         class ConstTagVisitor;
         class TagManager;
@@ -283,6 +288,24 @@ namespace TrenchBroom {
             virtual size_t selectOption(const std::vector<std::string>& options) = 0;
         };
 
+        /**
+         * Describes which inputs the result of a tag matcher depends on.
+         */
+        enum class TagMatcherInput {
+            /**
+             * The matcher must be evaluated against the taggable itself.
+             */
+            Taggable,
+            /**
+             * The matcher only matches brush faces, and only depends on the texture of a face.
+             */
+            FaceTexture,
+            /**
+             * The matcher only matches brushes, and only depends on the classname of the entity containing a brush.
+             */
+            BrushEntityClassname
+        };
+
         /**
          * Decides whether a taggable object should be tagged with a particular smart tag.
          */
@@ -298,6 +321,25 @@ namespace TrenchBroom {
              */
             virtual bool matches(const Taggable& taggable) const = 0;
 
+            /**
+             * Returns the input that the result of this matcher depends on. The tag manager evaluates matchers which
+             * depend on a face texture or an entity classname only once per texture or classname and caches the
+             * result.
+             */
+            virtual TagMatcherInput input() const;
+
+            /**
+             * Evaluates this tag matcher against a brush face with the given texture name and texture. The texture may
+             * be null if the face's texture is not loaded. Only called if input() returns TagMatcherInput::FaceTexture.
+             */
+            virtual bool matchesFaceTexture(std::string_view textureName, const Assets::Texture* texture) const;
+
+            /**
+             * Evaluates this tag matcher against a brush that belongs to an entity with the given classname. Only
+             * called if input() returns TagMatcherInput::BrushEntityClassname.
+             */
+            virtual bool matchesBrushEntityClassname(const std::string& classname) const;
+
             /**
              * Modifies the current selection so that this tag matcher would match it.
              *
@@ -364,6 +406,11 @@ namespace TrenchBroom {
              */
             bool matches(const Taggable& taggable) const;
 
+            /**
+             * Returns the matcher of this smart tag.
+             */
+            const TagMatcher& matcher() const;
+
             /**
              * Updates the given tag depending on whether or not the matcher matches against it.
              *
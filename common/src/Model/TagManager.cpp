@@ -20,10 +20,19 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "Macros.h"
+#include "Assets/Texture.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNodeBase.h"
 #include "Model/Tag.h"
 #include "Model/TagType.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <string>
 
@@ -45,6 +54,41 @@ namespace TrenchBroom {
             return lhs < rhs;
         }
 
+        static size_t nextTagManagerRevision() {
+            static std::atomic<size_t> revision(0);
+            return ++revision;
+        }
+
+        /**
+         * Computes the masks of the tags with cached matchers that match the visited face or brush.
+         */
+        class TagManager::MatchCachedTags : public ConstTagVisitor {
+        private:
+            const TagManager& m_tagManager;
+            TagType::Type m_tags;
+        public:
+            explicit MatchCachedTags(const TagManager& tagManager) :
+            m_tagManager(tagManager),
+            m_tags(TagType::NoType) {}
+
+            TagType::Type tags() const {
+                return m_tags;
+            }
+
+            void visit(const BrushNode& brush) override {
+                m_tags = m_tagManager.matchBrushEntity(brush);
+            }
+
+            void visit(const BrushFace& face) override {
+                m_tags = m_tagManager.matchFaceTexture(face);
+            }
+        };
+
+        TagManager::TagManager() :
+        m_revision(nextTagManagerRevision()),
+        m_faceTextureTags(TagType::NoType),
+        m_brushEntityTags(TagType::NoType) {}
+
         const std::vector<SmartTag>& TagManager::smartTags() const {
             return m_smartTags.get_data();
         }
@@ -91,15 +135,34 @@ namespace TrenchBroom {
 
                 it->setIndex(nextIndex);
             }
+            resetCachedTags();
         }
 
         void TagManager::clearSmartTags() {
             m_smartTags.clear();
+            resetCachedTags();
         }
 
         void TagManager::updateTags(Taggable& taggable) const {
+            const auto cachedTags = m_faceTextureTags | m_brushEntityTags;
+
+            auto matchedTags = TagType::NoType;
+            if (cachedTags != TagType::NoType) {
+                MatchCachedTags visitor(*this);
+                taggable.accept(visitor);
+                matchedTags = visitor.tags();
+            }
+
             for (const auto& tag : m_smartTags) {
-                tag.update(taggable);
+                const auto matches = (cachedTags & tag.type()) != 0
+                    ? (matchedTags & tag.type()) != 0
+                    : tag.matches(taggable);
+
+                if (matches) {
+                    taggable.addTag(tag);
+                } else {
+                    taggable.removeTag(tag);
+                }
             }
         }
 
@@ -109,5 +172,85 @@ namespace TrenchBroom {
             ensure(index <= Bits, "no more tag types");
             return index;
         }
+
+        void TagManager::resetCachedTags() {
+            m_revision = nextTagManagerRevision();
+            m_faceTextureTags = TagType::NoType;
+            m_brushEntityTags = TagType::NoType;
+            m_untexturedFaceTags.clear();
+            m_brushEntityTagsByClassname.clear();
+
+            for (const auto& tag : m_smartTags) {
+                switch (tag.matcher().input()) {
+                    case TagMatcherInput::FaceTexture:
+                        m_faceTextureTags |= tag.type();
+                        break;
+                    case TagMatcherInput::BrushEntityClassname:
+                        m_brushEntityTags |= tag.type();
+                        break;
+                    case TagMatcherInput::Taggable:
+                        break;
+                    switchDefault()
+                }
+            }
+        }
+
+        TagType::Type TagManager::matchFaceTexture(const BrushFace& face) const {
+            if (m_faceTextureTags == TagType::NoType) {
+                return TagType::NoType;
+            }
+
+            const auto& textureName = face.attributes().textureName();
+            if (const auto* texture = face.texture()) {
+                // the texture was found by its name, so the name matches the name of the face up to case
+                if (const auto cachedTags = texture->cachedTagMask(m_revision)) {
+                    return *cachedTags;
+                }
+
+                const auto tags = matchFaceTexture(textureName, texture);
+                texture->setCachedTagMask(m_revision, tags);
+                return tags;
+            }
+
+            auto it = m_untexturedFaceTags.find(textureName);
+            if (it == std::end(m_untexturedFaceTags)) {
+                it = m_untexturedFaceTags.emplace(textureName, matchFaceTexture(textureName, nullptr)).first;
+            }
+            return it->second;
+        }
+
+        TagType::Type TagManager::matchFaceTexture(const std::string_view textureName, const Assets::Texture* texture) const {
+            auto tags = TagType::NoType;
+            for (const auto& tag : m_smartTags) {
+                if ((m_faceTextureTags & tag.type()) != 0 && tag.matcher().matchesFaceTexture(textureName, texture)) {
+                    tags |= tag.type();
+                }
+            }
+            return tags;
+        }
+
+        TagType::Type TagManager::matchBrushEntity(const BrushNode& brush) const {
+            if (m_brushEntityTags == TagType::NoType) {
+                return TagType::NoType;
+            }
+
+            const auto* entityNode = brush.entity();
+            if (entityNode == nullptr) {
+                return TagType::NoType;
+            }
+
+            const auto& classname = entityNode->entity().classname();
+            auto it = m_brushEntityTagsByClassname.find(classname);
+            if (it == std::end(m_brushEntityTagsByClassname)) {
+                auto tags = TagType::NoType;
+                for (const auto& tag : m_smartTags) {
+                    if ((m_brushEntityTags & tag.type()) != 0 && tag.matcher().matchesBrushEntityClassname(classname)) {
+                        tags |= tag.type();
+                    }
+                }
+                it = m_brushEntityTagsByClassname.emplace(classname, tags).first;
+            }
+            return it->second;
+        }
     }
 }
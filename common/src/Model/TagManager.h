@@ -20,15 +20,30 @@
 #pragma once
 
 #include "Model/Tag.h"
+#include "Model/TagType.h"
 
 #include <kdl/vector_set.h>
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
+        class BrushFace;
+        class BrushNode;
+
         /**
          * Manages the tags used in a document and updates smart tags on taggable objects.
+         *
+         * Smart tags whose matchers only depend on the texture of a brush face or on the classname of the entity
+         * containing a brush are evaluated once per texture or classname. The results are cached as bit masks of the
+         * matching tags, so updating the tags of a face or brush does not evaluate these matchers again. Textures
+         * store their mask themselves, see Assets::Texture::cachedTagMask.
          */
         class TagManager {
         private:
@@ -40,7 +55,20 @@ namespace TrenchBroom {
             };
 
             kdl::vector_set<SmartTag, TagCmp> m_smartTags;
+
+            /**
+             * Identifies the currently registered smart tags in the masks cached by textures. Changes whenever the
+             * registered smart tags change, and is unique across all tag managers.
+             */
+            size_t m_revision;
+            TagType::Type m_faceTextureTags;
+            TagType::Type m_brushEntityTags;
+
+            mutable std::unordered_map<std::string, TagType::Type> m_untexturedFaceTags;
+            mutable std::unordered_map<std::string, TagType::Type> m_brushEntityTagsByClassname;
         public:
+            TagManager();
+
             /**
              * Returns a vector containing all smart tags registered with this manager.
              */
@@ -107,6 +135,12 @@ namespace TrenchBroom {
             void updateTags(Taggable& taggable) const;
         private:
             size_t freeTagIndex();
+            void resetCachedTags();
+
+            class MatchCachedTags;
+            TagType::Type matchFaceTexture(const BrushFace& face) const;
+            TagType::Type matchFaceTexture(std::string_view textureName, const Assets::Texture* texture) const;
+            TagType::Type matchBrushEntity(const BrushNode& brush) const;
         };
     }
 }
@@ -119,6 +119,14 @@ namespace TrenchBroom {
             return visitor.matches();
         }
 
+        TagMatcherInput TextureNameTagMatcher::input() const {
+            return TagMatcherInput::FaceTexture;
+        }
+
+        bool TextureNameTagMatcher::matchesFaceTexture(const std::string_view textureName, const Assets::Texture* /* texture */) const {
+            return matchesTextureName(textureName);
+        }
+
         bool TextureNameTagMatcher::matchesTexture(const Assets::Texture* texture) const {
             if (texture == nullptr) {
                 return false;
@@ -158,6 +166,14 @@ namespace TrenchBroom {
             return visitor.matches();
         }
 
+        TagMatcherInput SurfaceParmTagMatcher::input() const {
+            return TagMatcherInput::FaceTexture;
+        }
+
+        bool SurfaceParmTagMatcher::matchesFaceTexture(const std::string_view /* textureName */, const Assets::Texture* texture) const {
+            return matchesTexture(texture);
+        }
+
         bool SurfaceParmTagMatcher::matchesTexture(const Assets::Texture* texture) const {
             if (texture == nullptr) {
                 return false;
@@ -297,6 +313,14 @@ namespace TrenchBroom {
             return visitor.matches();
         }
 
+        TagMatcherInput EntityClassNameTagMatcher::input() const {
+            return TagMatcherInput::BrushEntityClassname;
+        }
+
+        bool EntityClassNameTagMatcher::matchesBrushEntityClassname(const std::string& classname) const {
+            return matchesClassname(classname);
+        }
+
         void EntityClassNameTagMatcher::enable(TagMatcherCallback& callback, MapFacade& facade) const {
             if (!facade.selectedNodes().hasOnlyBrushes()) {
                 return;
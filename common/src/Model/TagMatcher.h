@@ -85,6 +85,8 @@ namespace TrenchBroom {
             explicit TextureNameTagMatcher(const std::string& pattern);
             std::unique_ptr<TagMatcher> clone() const override;
             bool matches(const Taggable& taggable) const override;
+            TagMatcherInput input() const override;
+            bool matchesFaceTexture(std::string_view textureName, const Assets::Texture* texture) const override;
         private:
             bool matchesTexture(const Assets::Texture* texture) const override;
             bool matchesTextureName(std::string_view textureName) const;
@@ -98,6 +100,8 @@ namespace TrenchBroom {
             explicit SurfaceParmTagMatcher(const kdl::vector_set<std::string>& parameters);
             std::unique_ptr<TagMatcher> clone() const override;
             bool matches(const Taggable& taggable) const override;
+            TagMatcherInput input() const override;
+            bool matchesFaceTexture(std::string_view textureName, const Assets::Texture* texture) const override;
         private:
             bool matchesTexture(const Assets::Texture* texture) const override;
         };
@@ -147,6 +151,8 @@ namespace TrenchBroom {
             std::unique_ptr<TagMatcher> clone() const override;
         public:
             bool matches(const Taggable& taggable) const override;
+            TagMatcherInput input() const override;
+            bool matchesBrushEntityClassname(const std::string& classname) const override;
             void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
             void disable(TagMatcherCallback& callback, MapFacade& facade) const override;
             bool canEnable() const override;
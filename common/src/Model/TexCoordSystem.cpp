@@ -28,6 +28,21 @@
 
 namespace TrenchBroom {
     namespace Model {
+        const TexCoordSystem& asTexCoordSystem(const TexCoordSystemVariant& texCoordSystem) {
+            return std::visit([](const auto& x) -> const TexCoordSystem& { return x; }, texCoordSystem);
+        }
+
+        TexCoordSystem& asTexCoordSystem(TexCoordSystemVariant& texCoordSystem) {
+            return std::visit([](auto& x) -> TexCoordSystem& { return x; }, texCoordSystem);
+        }
+
+        TexCoordSystemTransform::TexCoordSystemTransform(const vm::mat4x4& i_transformation) :
+        transformation(i_transformation),
+        rotationScale(vm::strip_translation(i_transformation)),
+        translation(i_transformation * vm::vec3::zero()) {
+            std::tie(invertible, inverseTransformation) = vm::invert(i_transformation);
+        }
+
         TexCoordSystemSnapshot::~TexCoordSystemSnapshot() = default;
 
         void TexCoordSystemSnapshot::restore(TexCoordSystem& coordSystem) const {
@@ -42,6 +57,11 @@ namespace TrenchBroom {
 
         TexCoordSystem::~TexCoordSystem() = default;
 
+        TexCoordSystem::TexCoordSystem(const TexCoordSystem& other) = default;
+        TexCoordSystem::TexCoordSystem(TexCoordSystem&& other) noexcept = default;
+        TexCoordSystem& TexCoordSystem::operator=(const TexCoordSystem& other) = default;
+        TexCoordSystem& TexCoordSystem::operator=(TexCoordSystem&& other) noexcept = default;
+
         bool operator==(const TexCoordSystem& lhs, const TexCoordSystem& rhs) {
             return lhs.xAxis() == rhs.xAxis() && lhs.yAxis() == rhs.yAxis();
         }
@@ -50,10 +70,6 @@ namespace TrenchBroom {
             return !(lhs == rhs);
         }
 
-        std::unique_ptr<TexCoordSystem> TexCoordSystem::clone() const {
-            return doClone();
-        }
-
         std::unique_ptr<TexCoordSystemSnapshot> TexCoordSystem::takeSnapshot() const {
             return doTakeSnapshot();
         }
@@ -91,6 +107,10 @@ namespace TrenchBroom {
         }
 
         void TexCoordSystem::transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant) {
+            doTransform(oldBoundary, newBoundary, TexCoordSystemTransform(transformation), attribs, textureSize, lockTexture, invariant);
+        }
+
+        void TexCoordSystem::transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const TexCoordSystemTransform& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant) {
             doTransform(oldBoundary, newBoundary, transformation, attribs, textureSize, lockTexture, invariant);
         }
 
@@ -226,11 +246,11 @@ namespace TrenchBroom {
                          dot(point, safeScaleAxis(getYAxis(), scale.y())));
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> TexCoordSystem::toParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> TexCoordSystem::toParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
             return doToParallel(point0, point1, point2, attribs);
         }
 
-        std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> TexCoordSystem::toParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
+        std::tuple<TexCoordSystemVariant, BrushFaceAttributes> TexCoordSystem::toParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const {
             return doToParaxial(point0, point1, point2, attribs);
         }
     }
@@ -24,10 +24,12 @@
 
 #include "Model/BrushFaceAttributes.h"
 
+#include <vecmath/mat.h>
 #include <vecmath/vec.h>
 
 #include <memory>
 #include <tuple>
+#include <variant>
 
 namespace TrenchBroom {
     namespace Model {
@@ -35,6 +37,15 @@ namespace TrenchBroom {
         class ParaxialTexCoordSystem;
         class TexCoordSystem;
 
+        /**
+         * Stores either kind of texture coordinate system by value, so that brush faces do not need to allocate their
+         * texture coordinate systems on the heap.
+         */
+        using TexCoordSystemVariant = std::variant<ParaxialTexCoordSystem, ParallelTexCoordSystem>;
+
+        const TexCoordSystem& asTexCoordSystem(const TexCoordSystemVariant& texCoordSystem);
+        TexCoordSystem& asTexCoordSystem(TexCoordSystemVariant& texCoordSystem);
+
         class TexCoordSystemSnapshot {
         public:
             virtual ~TexCoordSystemSnapshot();
@@ -54,6 +65,20 @@ namespace TrenchBroom {
             Rotation
         };
 
+        /**
+         * The quantities that texture lock derives from a transformation matrix. When all faces of a brush are
+         * transformed by the same matrix, these are computed once and shared by all faces.
+         */
+        struct TexCoordSystemTransform {
+            vm::mat4x4 transformation;
+            vm::mat4x4 inverseTransformation;
+            vm::mat4x4 rotationScale;
+            vm::vec3 translation;
+            bool invertible;
+
+            explicit TexCoordSystemTransform(const vm::mat4x4& transformation);
+        };
+
         class TexCoordSystem {
         public:
             TexCoordSystem();
@@ -62,7 +87,6 @@ namespace TrenchBroom {
             friend bool operator==(const TexCoordSystem& lhs, const TexCoordSystem& rhs);
             friend bool operator!=(const TexCoordSystem& lhs, const TexCoordSystem& rhs);
 
-            std::unique_ptr<TexCoordSystem> clone() const;
             std::unique_ptr<TexCoordSystemSnapshot> takeSnapshot() const;
 
             vm::vec3 xAxis() const;
@@ -77,6 +101,7 @@ namespace TrenchBroom {
 
             void setRotation(const vm::vec3& normal, float oldAngle, float newAngle);
             void transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant);
+            void transform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const TexCoordSystemTransform& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant);
             void updateNormal(const vm::vec3& oldNormal, const vm::vec3& newNormal, const BrushFaceAttributes& attribs, const WrapStyle style);
 
             void moveTexture(const vm::vec3& normal, const vm::vec3& up, const vm::vec3& right, const vm::vec2f& offset, BrushFaceAttributes& attribs) const;
@@ -87,10 +112,9 @@ namespace TrenchBroom {
             vm::mat4x4 fromMatrix(const vm::vec2f& offset, const vm::vec2f& scale) const;
             float measureAngle(float currentAngle, const vm::vec2f& center, const vm::vec2f& point) const;
 
-            std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> toParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const;
-            std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> toParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const;
+            std::tuple<TexCoordSystemVariant, BrushFaceAttributes> toParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const;
+            std::tuple<TexCoordSystemVariant, BrushFaceAttributes> toParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const;
         private:
-            virtual std::unique_ptr<TexCoordSystem> doClone() const = 0;
             virtual std::unique_ptr<TexCoordSystemSnapshot> doTakeSnapshot() const = 0;
             virtual void doRestoreSnapshot(const TexCoordSystemSnapshot& snapshot) = 0;
             friend class TexCoordSystemSnapshot;
@@ -108,7 +132,7 @@ namespace TrenchBroom {
             virtual vm::vec2f doGetTexCoords(const vm::vec3& point, const BrushFaceAttributes& attribs, const vm::vec2f& textureSize) const = 0;
 
             virtual void doSetRotation(const vm::vec3& normal, float oldAngle, float newAngle) = 0;
-            virtual void doTransform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const vm::mat4x4& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant) = 0;
+            virtual void doTransform(const vm::plane3& oldBoundary, const vm::plane3& newBoundary, const TexCoordSystemTransform& transformation, BrushFaceAttributes& attribs, const vm::vec2f& textureSize, bool lockTexture, const vm::vec3& invariant) = 0;
             virtual void doUpdateNormalWithProjection(const vm::vec3& newNormal, const BrushFaceAttributes& attribs) = 0;
             virtual void doUpdateNormalWithRotation(const vm::vec3& oldNormal, const vm::vec3& newNormal, const BrushFaceAttributes& attribs) = 0;
 
@@ -116,9 +140,14 @@ namespace TrenchBroom {
 
             virtual float doMeasureAngle(float currentAngle, const vm::vec2f& center, const vm::vec2f& point) const = 0;
 
-            virtual std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> doToParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const = 0;
-            virtual std::tuple<std::unique_ptr<TexCoordSystem>, BrushFaceAttributes> doToParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const = 0;
+            virtual std::tuple<TexCoordSystemVariant, BrushFaceAttributes> doToParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const = 0;
+            virtual std::tuple<TexCoordSystemVariant, BrushFaceAttributes> doToParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs) const = 0;
         protected:
+            TexCoordSystem(const TexCoordSystem& other);
+            TexCoordSystem(TexCoordSystem&& other) noexcept;
+            TexCoordSystem& operator=(const TexCoordSystem& other);
+            TexCoordSystem& operator=(TexCoordSystem&& other) noexcept;
+
             vm::vec2f computeTexCoords(const vm::vec3& point, const vm::vec2f& scale) const;
 
             template <typename T>
@@ -130,8 +159,6 @@ namespace TrenchBroom {
             vm::vec<T1,3> safeScaleAxis(const vm::vec<T1,3>& axis, const T2 factor) const {
                 return axis / safeScale(T1(factor));
             }
-
-            deleteCopyAndMove(TexCoordSystem)
         };
     }
 }
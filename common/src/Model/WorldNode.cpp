@@ -21,6 +21,7 @@
 
 #include "AABBTree.h"
 #include "Ensure.h"
+#include "Profiler.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/EntityNode.h"
@@ -339,6 +340,9 @@ namespace TrenchBroom {
         }
 
         void WorldNode::doPick(const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult) {
+            TB_PROFILE_SCOPE("WorldNode::pick");
+            TB_PROFILE_COUNT(ProfilerCounter::PicksPerformed, 1);
+
             for (auto* node : m_nodeTree->findIntersectors(ray)) {
                 node->pick(editorContext, ray, pickResult);
             }
@@ -23,6 +23,7 @@
 #include "IO/Path.h"
 #include "View/KeyboardShortcut.h"
 
+#include <limits>
 #include <optional>
 
 #include <QString>
@@ -66,6 +67,10 @@ namespace TrenchBroom {
     }
 
     class PreferenceBase {
+    public:
+        static constexpr size_t NoSnapshotIndex = std::numeric_limits<size_t>::max();
+    private:
+        size_t m_snapshotIndex = NoSnapshotIndex;
     public:
         PreferenceBase() = default;
         virtual ~PreferenceBase();
@@ -80,7 +85,19 @@ namespace TrenchBroom {
         }
 
         virtual const IO::Path& path() const = 0;
+
+        /**
+         * Returns the index of this preference's value in a PreferenceSnapshot, or NoSnapshotIndex if the value is not
+         * part of preference snapshots.
+         */
+        size_t snapshotIndex() const {
+            return m_snapshotIndex;
+        }
     public: // private to PreferenceManager
+        void setSnapshotIndex(const size_t snapshotIndex) {
+            m_snapshotIndex = snapshotIndex;
+        }
+
         virtual void resetToDefault() = 0;
         virtual bool valid() const = 0;
         virtual void setValid(bool _valid) = 0;
@@ -19,6 +19,8 @@
 
 #include "PreferenceManager.h"
 
+#include "Color.h"
+#include "PreferenceSnapshot.h"
 #include "Preferences.h"
 #include "IO/PathQt.h"
 #include "IO/SystemPaths.h"
@@ -243,17 +245,65 @@ namespace TrenchBroom {
     // PreferenceManager
 
     std::unique_ptr<PreferenceManager> PreferenceManager::m_instance;
-    bool PreferenceManager::m_initialized = false;
+    std::atomic<bool> PreferenceManager::m_initialized{false};
 
     PreferenceManager& PreferenceManager::instance() {
         ensure(m_instance != nullptr, "Preference manager is set");
         if (!m_initialized) {
+            // only the main thread may initialize the preferences, other threads must find them initialized
+            ensure(qApp != nullptr && qApp->thread() == QThread::currentThread(), "PreferenceManager is initialized on the main thread");
             m_instance->initialize();
+            m_instance->publishSnapshot();
+            // publish the snapshot before other threads can observe the initialized flag
             m_initialized = true;
         }
         return *m_instance;
     }
 
+    std::shared_ptr<const PreferenceSnapshot> PreferenceManager::snapshot() const {
+        return std::atomic_load(&m_snapshot);
+    }
+
+    uint64_t PreferenceManager::snapshotVersion() const {
+        return m_snapshotVersion.load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    static bool appendSnapshotValue(PreferenceManager& prefs, PreferenceBase& preference, std::vector<PreferenceSnapshot::Value>& values) {
+        if (auto* typedPreference = dynamic_cast<Preference<T>*>(&preference)) {
+            values.emplace_back(prefs.get(*typedPreference));
+            return true;
+        }
+        return false;
+    }
+
+    void PreferenceManager::publishSnapshot() {
+        const auto& preferences = Preferences::staticPreferences();
+
+        std::vector<PreferenceSnapshot::Value> values;
+        values.reserve(preferences.size());
+
+        for (auto* preference : preferences) {
+            if (appendSnapshotValue<bool>(*this, *preference, values) ||
+                appendSnapshotValue<int>(*this, *preference, values) ||
+                appendSnapshotValue<float>(*this, *preference, values) ||
+                appendSnapshotValue<Color>(*this, *preference, values)) {
+                // the layout of a snapshot never changes, so the indices only need to be assigned once, before any
+                // other thread can read them
+                if (preference->snapshotIndex() == PreferenceBase::NoSnapshotIndex) {
+                    preference->setSnapshotIndex(values.size() - 1u);
+                }
+                assert(preference->snapshotIndex() == values.size() - 1u);
+            }
+        }
+
+        auto snapshot = std::make_shared<const PreferenceSnapshot>(PreferenceSnapshot::nextVersion(), std::move(values));
+        const auto version = snapshot->version();
+
+        std::atomic_store(&m_snapshot, std::shared_ptr<const PreferenceSnapshot>(std::move(snapshot)));
+        m_snapshotVersion.store(version, std::memory_order_release);
+    }
+
     AppPreferenceManager::AppPreferenceManager() :
     m_fileSystemWatcher(nullptr),
     m_fileReadWriteDisabled(false) {
@@ -410,6 +460,8 @@ namespace TrenchBroom {
             unused(path);
             prefPtr->setValid(false);
         }
+
+        publishSnapshot();
     }
 
     /**
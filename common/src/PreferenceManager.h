@@ -27,6 +27,8 @@
 #include <kdl/vector_set.h>
 #include <kdl/result.h>
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <vector>
@@ -42,6 +44,7 @@ class QFileSystemWatcher;
 
 namespace TrenchBroom {
     class Color;
+    class PreferenceSnapshot;
 
     /**
      * Used by wxWidgets versions of TB
@@ -91,12 +94,22 @@ namespace TrenchBroom {
         Q_OBJECT
     private:
         static std::unique_ptr<PreferenceManager> m_instance;
-        static bool m_initialized;
+        static std::atomic<bool> m_initialized;
     protected:
         std::map<IO::Path, std::unique_ptr<PreferenceBase>> m_dynamicPreferences;
+    private:
+        /**
+         * The most recently published snapshot. Only accessed using the atomic shared_ptr functions.
+         */
+        std::shared_ptr<const PreferenceSnapshot> m_snapshot;
+        std::atomic<uint64_t> m_snapshotVersion{0};
     public:
         Notifier<const IO::Path&> preferenceDidChangeNotifier;
     public:
+        /**
+         * Returns the preference manager and initializes it on the first call. The first call must happen on the main
+         * thread before any other thread accesses the preferences, e.g. by calling preferenceSnapshot().
+         */
         static PreferenceManager& instance();
         
         template <typename T>
@@ -142,6 +155,7 @@ namespace TrenchBroom {
 
             preference.setValue(value);
             preference.setValid(true);
+            publishSnapshot();
 
             savePreference(preference);
             if (saveInstantly()) {
@@ -156,11 +170,27 @@ namespace TrenchBroom {
             set(preference, preference.defaultValue());
         }
 
+        /**
+         * Returns the most recently published preference snapshot. Can be called on any thread.
+         */
+        std::shared_ptr<const PreferenceSnapshot> snapshot() const;
+
+        /**
+         * Returns the version of the most recently published preference snapshot. Can be called on any thread.
+         */
+        uint64_t snapshotVersion() const;
+
         virtual void initialize() = 0;
 
         virtual bool saveInstantly() const = 0;
         virtual void saveChanges() = 0;
         virtual void discardChanges() = 0;
+    protected:
+        /**
+         * Creates a snapshot of the current values of all static preferences and publishes it, replacing the previous
+         * snapshot. Must be called on the main thread whenever the value of a preference may have changed.
+         */
+        void publishSnapshot();
     private:
         virtual void validatePreference(PreferenceBase&) = 0;
         virtual void savePreference(PreferenceBase&) = 0;
@@ -0,0 +1,53 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreferenceSnapshot.h"
+
+#include "PreferenceManager.h"
+
+#include <atomic>
+#include <memory>
+
+namespace TrenchBroom {
+    PreferenceSnapshot::PreferenceSnapshot(const uint64_t version, std::vector<Value> values) :
+    m_version(version),
+    m_values(std::move(values)) {}
+
+    uint64_t PreferenceSnapshot::version() const {
+        return m_version;
+    }
+
+    uint64_t PreferenceSnapshot::nextVersion() {
+        // version 0 means that no snapshot has been published yet
+        static std::atomic<uint64_t> version(1u);
+        return version++;
+    }
+
+    const PreferenceSnapshot& preferenceSnapshot() {
+        thread_local std::shared_ptr<const PreferenceSnapshot> snapshot;
+
+        const auto& prefs = PreferenceManager::instance();
+        if (snapshot == nullptr || snapshot->version() != prefs.snapshotVersion()) {
+            snapshot = prefs.snapshot();
+        }
+
+        ensure(snapshot != nullptr, "a preference snapshot has been published");
+        return *snapshot;
+    }
+}
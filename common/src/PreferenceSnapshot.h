@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Color.h"
+#include "Ensure.h"
+#include "Preference.h"
+
+#include <cstdint>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace TrenchBroom {
+    /**
+     * An immutable copy of the values of all static preferences of type bool, int, float and Color.
+     *
+     * The preference manager publishes a new snapshot on the main thread whenever a preference changes. Unlike
+     * PreferenceManager::get, a snapshot can be read on any thread, and since the values are stored by the snapshot
+     * index of their preference, reading a value takes constant time.
+     */
+    class PreferenceSnapshot {
+    public:
+        using Value = std::variant<bool, int, float, Color>;
+    private:
+        uint64_t m_version;
+        std::vector<Value> m_values;
+    public:
+        PreferenceSnapshot(uint64_t version, std::vector<Value> values);
+
+        /**
+         * Returns the version of this snapshot. Every published snapshot has a unique version, and later snapshots
+         * have greater versions than earlier ones.
+         */
+        uint64_t version() const;
+
+        /**
+         * Returns the value of the given preference at the time this snapshot was created. The preference must be a
+         * static preference.
+         */
+        template <typename T>
+        const T& get(const Preference<T>& preference) const {
+            static_assert(std::is_same_v<T, bool> || std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, Color>,
+                          "only preferences of type bool, int, float and Color are part of a snapshot");
+
+            const auto index = preference.snapshotIndex();
+            ensure(index < m_values.size(), "preference is part of the snapshot");
+            return std::get<T>(m_values[index]);
+        }
+
+        /**
+         * Returns the next unused snapshot version.
+         */
+        static uint64_t nextVersion();
+    };
+
+    /**
+     * Returns the most recently published preference snapshot. Can be called on any thread.
+     *
+     * Each thread caches the snapshot it last retrieved and only fetches the current snapshot from the preference
+     * manager if a newer one has been published since, so in the common case, this function does not lock. The
+     * returned reference remains valid until the calling thread calls this function again; to keep a snapshot for
+     * longer, use PreferenceManager::snapshot.
+     */
+    const PreferenceSnapshot& preferenceSnapshot();
+}
@@ -48,6 +48,7 @@ namespace TrenchBroom {
         Preference<Color> PortalFileBorderColor(IO::Path("Renderer/Colors/Portal file border"), Color(1.0f, 1.0f, 1.0f, 0.5f));
         Preference<Color> PortalFileFillColor(IO::Path("Renderer/Colors/Portal file fill"), Color(1.0f, 0.4f, 0.4f, 0.2f));
         Preference<bool>  ShowFPS(IO::Path("Renderer/Show FPS"), false);
+        Preference<bool>  ShowProfiler(IO::Path("Renderer/Show profiler"), false);
 
         Preference<Color>& axisColor(vm::axis::type axis) {
             switch (axis) {
@@ -136,6 +137,8 @@ namespace TrenchBroom {
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
+        Preference<bool> CacheLoadedMaps(IO::Path("Editor/Cache loaded maps"), true);
+
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
             return fontPath;
@@ -243,6 +246,7 @@ namespace TrenchBroom {
                 &PortalFileBorderColor,
                 &PortalFileFillColor,
                 &ShowFPS,
+                &ShowProfiler,
                 &CompassBackgroundColor,
                 &CompassBackgroundOutlineColor,
                 &CompassAxisOutlineColor,
@@ -298,6 +302,7 @@ namespace TrenchBroom {
                 &TextureMagFilter,
                 &TextureLock,
                 &UVLock,
+                &CacheLoadedMaps,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
@@ -51,6 +51,7 @@ namespace TrenchBroom {
         extern Preference<Color> PortalFileBorderColor;
         extern Preference<Color> PortalFileFillColor;
         extern Preference<bool>  ShowFPS;
+        extern Preference<bool>  ShowProfiler;
 
         Preference<Color>& axisColor(vm::axis::type axis);
 
@@ -129,6 +130,8 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        extern Preference<bool> CacheLoadedMaps;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
@@ -0,0 +1,327 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Profiler {
+        static constexpr size_t CounterCount = static_cast<size_t>(ProfilerCounter::PicksPerformed) + 1u;
+
+        /**
+         * A single producer ring buffer. Only the owning thread writes into it, any thread may read from it. The slots
+         * consist of atomics so that concurrent reads and writes are well defined; readers detect and discard slots
+         * that may have been overwritten while they were being read.
+         */
+        class ThreadEventBuffer {
+        private:
+            // one spare slot for the writer, so that a reader can always keep EventsPerThread events
+            static constexpr size_t SlotCount = EventsPerThread + 1u;
+
+            struct Slot {
+                std::atomic<const char*> name;
+                std::atomic<std::int64_t> start;
+                std::atomic<std::int64_t> duration;
+            };
+
+            size_t m_threadIndex;
+            std::unique_ptr<std::array<Slot, SlotCount>> m_slots;
+            std::atomic<size_t> m_written;
+        public:
+            explicit ThreadEventBuffer(const size_t threadIndex) :
+            m_threadIndex(threadIndex),
+            m_slots(std::make_unique<std::array<Slot, SlotCount>>()),
+            m_written(0u) {}
+
+            void record(const char* name, const std::int64_t start, const std::int64_t duration) {
+                const size_t index = m_written.load(std::memory_order_relaxed);
+                Slot& slot = (*m_slots)[index % SlotCount];
+                slot.name.store(name, std::memory_order_relaxed);
+                slot.start.store(start, std::memory_order_relaxed);
+                slot.duration.store(duration, std::memory_order_relaxed);
+                m_written.store(index + 1u, std::memory_order_release);
+            }
+
+            void collect(const std::int64_t since, std::vector<Event>& result) const {
+                const size_t last = m_written.load(std::memory_order_acquire);
+                const size_t first = last > EventsPerThread ? last - EventsPerThread : 0u;
+
+                const size_t offset = result.size();
+                std::vector<size_t> indices;
+                for (size_t i = first; i < last; ++i) {
+                    const Slot& slot = (*m_slots)[i % SlotCount];
+                    const std::int64_t start = slot.start.load(std::memory_order_relaxed);
+                    if (start >= since) {
+                        result.push_back(Event{slot.name.load(std::memory_order_relaxed), m_threadIndex, start, slot.duration.load(std::memory_order_relaxed)});
+                        indices.push_back(i);
+                    }
+                }
+
+                // The writer may have wrapped around while we were reading. The slot it is currently writing to
+                // belongs to index `current`, so every index at or below `current - SlotCount` is suspect. The fence
+                // keeps the relaxed slot reads above from being reordered after the following load.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const size_t current = m_written.load(std::memory_order_acquire);
+                if (current + 1u > SlotCount) {
+                    const size_t firstValid = current + 1u - SlotCount;
+                    size_t keep = offset;
+                    for (size_t i = 0u; i < indices.size(); ++i) {
+                        if (indices[i] >= firstValid) {
+                            result[keep++] = result[offset + i];
+                        }
+                    }
+                    result.resize(keep);
+                }
+            }
+        };
+
+        static std::chrono::steady_clock::time_point epoch() {
+            static const auto epoch = std::chrono::steady_clock::now();
+            return epoch;
+        }
+
+        static std::atomic<std::int64_t>& clearTime() {
+            static std::atomic<std::int64_t> clearTime(0);
+            return clearTime;
+        }
+
+        static std::array<std::atomic<std::uint64_t>, CounterCount>& counters() {
+            static std::array<std::atomic<std::uint64_t>, CounterCount> counters{};
+            return counters;
+        }
+
+        /**
+         * Owns all thread buffers. Buffers outlive their threads so that events recorded by worker threads remain
+         * available after the workers have finished. When a thread exits, its buffer is handed to the next thread
+         * that starts recording, since kdl::parallel_for spawns fresh threads for every invocation.
+         */
+        class BufferRegistry {
+        private:
+            mutable std::mutex m_mutex;
+            std::vector<std::shared_ptr<ThreadEventBuffer>> m_buffers;
+            std::vector<std::shared_ptr<ThreadEventBuffer>> m_unusedBuffers;
+        public:
+            std::shared_ptr<ThreadEventBuffer> acquireBuffer() {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_unusedBuffers.empty()) {
+                    auto buffer = std::move(m_unusedBuffers.back());
+                    m_unusedBuffers.pop_back();
+                    return buffer;
+                }
+
+                auto buffer = std::make_shared<ThreadEventBuffer>(m_buffers.size());
+                m_buffers.push_back(buffer);
+                return buffer;
+            }
+
+            void releaseBuffer(std::shared_ptr<ThreadEventBuffer> buffer) {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                m_unusedBuffers.push_back(std::move(buffer));
+            }
+
+            std::vector<std::shared_ptr<ThreadEventBuffer>> buffers() const {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                return m_buffers;
+            }
+        };
+
+        static BufferRegistry& registry() {
+            static BufferRegistry registry;
+            return registry;
+        }
+
+        class ThreadBufferLease {
+        private:
+            std::shared_ptr<ThreadEventBuffer> m_buffer;
+        public:
+            ThreadBufferLease() :
+            m_buffer(registry().acquireBuffer()) {}
+
+            ~ThreadBufferLease() {
+                registry().releaseBuffer(std::move(m_buffer));
+            }
+
+            deleteCopyAndMove(ThreadBufferLease)
+
+            ThreadEventBuffer& buffer() {
+                return *m_buffer;
+            }
+        };
+
+        static ThreadEventBuffer& threadBuffer() {
+            // acquiring a buffer locks the registry, but this only happens once per thread
+            thread_local ThreadBufferLease lease;
+            return lease.buffer();
+        }
+
+        std::int64_t now() {
+            const auto elapsed = std::chrono::steady_clock::now() - epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        }
+
+        void recordEvent(const char* name, const std::int64_t start, const std::int64_t end) {
+            threadBuffer().record(name, start, end - start);
+        }
+
+        void addToCounter(const ProfilerCounter counter, const std::uint64_t value) {
+            counters()[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        std::uint64_t counterValue(const ProfilerCounter counter) {
+            return counters()[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        }
+
+        const char* counterName(const ProfilerCounter counter) {
+            switch (counter) {
+                case ProfilerCounter::VboBytesUploaded:
+                    return "VBO bytes uploaded";
+                case ProfilerCounter::BrushesValidated:
+                    return "Brushes validated";
+                case ProfilerCounter::PicksPerformed:
+                    return "Picks performed";
+                switchDefault()
+            }
+        }
+
+        std::vector<Event> events() {
+            const std::int64_t since = clearTime().load(std::memory_order_relaxed);
+
+            std::vector<Event> result;
+            for (const auto& buffer : registry().buffers()) {
+                buffer->collect(since, result);
+            }
+
+            std::sort(std::begin(result), std::end(result), [](const Event& lhs, const Event& rhs) {
+                return lhs.start < rhs.start;
+            });
+            return result;
+        }
+
+        std::vector<EventSummary> summarize(const std::int64_t since) {
+            std::vector<EventSummary> result;
+            std::unordered_map<std::string_view, size_t> indices;
+
+            for (const Event& event : events()) {
+                if (event.start >= since) {
+                    const auto [it, inserted] = indices.emplace(event.name, result.size());
+                    if (inserted) {
+                        result.push_back(EventSummary{event.name, 0u, 0, 0});
+                    }
+
+                    EventSummary& summary = result[it->second];
+                    ++summary.count;
+                    summary.totalDuration += event.duration;
+                    summary.maxDuration = std::max(summary.maxDuration, event.duration);
+                }
+            }
+
+            std::sort(std::begin(result), std::end(result), [](const EventSummary& lhs, const EventSummary& rhs) {
+                return lhs.totalDuration > rhs.totalDuration;
+            });
+            return result;
+        }
+
+        void clear() {
+            clearTime().store(now(), std::memory_order_relaxed);
+            for (auto& counter : counters()) {
+                counter.store(0u, std::memory_order_relaxed);
+            }
+        }
+
+        static void writeJsonString(std::ostream& str, const char* string) {
+            str << '"';
+            for (const char* c = string; *c != '\0'; ++c) {
+                switch (*c) {
+                    case '"':
+                        str << "\\\"";
+                        break;
+                    case '\\':
+                        str << "\\\\";
+                        break;
+                    case '\n':
+                        str << "\\n";
+                        break;
+                    default:
+                        str << *c;
+                        break;
+                }
+            }
+            str << '"';
+        }
+
+        static void writeMicroseconds(std::ostream& str, const std::int64_t nanoseconds) {
+            str << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+        }
+
+        void writeChromeTrace(std::ostream& str) {
+            const std::vector<Event> allEvents = events();
+
+            str << "{\"traceEvents\":[";
+            bool first = true;
+            for (const Event& event : allEvents) {
+                if (!first) {
+                    str << ",";
+                }
+                first = false;
+
+                str << "\n{\"name\":";
+                writeJsonString(str, event.name);
+                str << ",\"cat\":\"TrenchBroom\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadIndex << ",\"ts\":";
+                writeMicroseconds(str, event.start);
+                str << ",\"dur\":";
+                writeMicroseconds(str, event.duration);
+                str << "}";
+            }
+
+            if (!first) {
+                str << ",";
+            }
+            str << "\n{\"name\":\"Counters\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":";
+            writeMicroseconds(str, now());
+            str << ",\"args\":{";
+            for (size_t i = 0u; i < CounterCount; ++i) {
+                const auto counter = static_cast<ProfilerCounter>(i);
+                if (i > 0u) {
+                    str << ",";
+                }
+                writeJsonString(str, counterName(counter));
+                str << ":" << counterValue(counter);
+            }
+            str << "}}\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+
+        ScopedTimer::ScopedTimer(const char* name) :
+        m_name(name),
+        m_start(now()) {}
+
+        ScopedTimer::~ScopedTimer() {
+            recordEvent(m_name, m_start, now());
+        }
+    }
+}
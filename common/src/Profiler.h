@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/*
+ * Lightweight instrumentation for hot code paths.
+ *
+ * Use TB_PROFILE_SCOPE("Name") at the beginning of a block to record the time spent in that block, and
+ * TB_PROFILE_COUNT(ProfilerCounter::X, value) to add to one of the global counters. Both macros expand to nothing
+ * unless TB_ENABLE_PROFILER is defined (pass -DTB_ENABLE_PROFILER=ON to cmake), so they can be left in place
+ * without any cost in regular builds.
+ *
+ * The name passed to TB_PROFILE_SCOPE must be a string literal or otherwise have static storage duration, since only
+ * the pointer is recorded.
+ */
+#ifdef TB_ENABLE_PROFILER
+#define TB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TB_PROFILE_CONCAT(a, b) TB_PROFILE_CONCAT_IMPL(a, b)
+#define TB_PROFILE_SCOPE(name) const TrenchBroom::Profiler::ScopedTimer TB_PROFILE_CONCAT(profilerScope_, __LINE__)(name)
+#define TB_PROFILE_COUNT(counter, value) TrenchBroom::Profiler::addToCounter(counter, static_cast<std::uint64_t>(value))
+#else
+#define TB_PROFILE_SCOPE(name)
+#define TB_PROFILE_COUNT(counter, value)
+#endif
+
+namespace TrenchBroom {
+    enum class ProfilerCounter {
+        VboBytesUploaded,
+        BrushesValidated,
+        PicksPerformed
+    };
+
+    namespace Profiler {
+        /**
+         * The number of events that are retained per thread. Once a thread has recorded more events, the oldest
+         * events are overwritten.
+         */
+        constexpr size_t EventsPerThread = 1u << 14;
+
+        struct Event {
+            const char* name;
+            size_t threadIndex;
+            /** Start time in nanoseconds since the profiler epoch. */
+            std::int64_t start;
+            /** Duration in nanoseconds. */
+            std::int64_t duration;
+        };
+
+        struct EventSummary {
+            const char* name;
+            size_t count;
+            std::int64_t totalDuration;
+            std::int64_t maxDuration;
+        };
+
+        /**
+         * Returns the number of nanoseconds elapsed since the profiler epoch, which is the time at which the profiler
+         * was first used.
+         */
+        std::int64_t now();
+
+        /**
+         * Records an event for the calling thread. This function does not block; every thread writes into its own
+         * ring buffer.
+         */
+        void recordEvent(const char* name, std::int64_t start, std::int64_t end);
+
+        void addToCounter(ProfilerCounter counter, std::uint64_t value);
+        std::uint64_t counterValue(ProfilerCounter counter);
+        const char* counterName(ProfilerCounter counter);
+
+        /**
+         * Returns a snapshot of the events recorded by all threads since the last call to clear(), sorted by start
+         * time. Events that are overwritten while the snapshot is taken are omitted.
+         */
+        std::vector<Event> events();
+
+        /**
+         * Aggregates the events that started at or after the given time by name. The result is sorted by total
+         * duration, longest first.
+         */
+        std::vector<EventSummary> summarize(std::int64_t since);
+
+        /**
+         * Discards all events recorded so far and resets the counters.
+         */
+        void clear();
+
+        /**
+         * Writes the recorded events and the current counter values in the Chrome trace event format. The output can be
+         * loaded into chrome://tracing or https://ui.perfetto.dev.
+         */
+        void writeChromeTrace(std::ostream& str);
+
+        class ScopedTimer {
+        private:
+            const char* m_name;
+            std::int64_t m_start;
+        public:
+            explicit ScopedTimer(const char* name);
+            ~ScopedTimer();
+
+            deleteCopyAndMove(ScopedTimer)
+        };
+    }
+}
@@ -21,6 +21,7 @@
 
 #include "Preferences.h"
 #include "PreferenceManager.h"
+#include "Profiler.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
@@ -339,8 +340,11 @@ namespace TrenchBroom {
         };
 
         void BrushRenderer::validate() {
+            TB_PROFILE_SCOPE("BrushRenderer::validate");
             assert(!valid());
 
+            TB_PROFILE_COUNT(ProfilerCounter::BrushesValidated, m_invalidBrushes.size());
+
             for (auto brush : m_invalidBrushes) {
                 validateBrush(brush);
             }
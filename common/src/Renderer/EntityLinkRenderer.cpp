@@ -27,6 +27,7 @@
 #include "Model/EntityNodeBase.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
@@ -35,11 +36,213 @@
 
 #include <vecmath/vec.h>
 
+#include <algorithm>
 #include <cassert>
 #include <unordered_set>
 
 namespace TrenchBroom {
     namespace Renderer {
+        EntityLinkCache::EntityLinkCache() :
+        m_valid(false) {}
+
+        void EntityLinkCache::invalidate() {
+            m_linksBySource.clear();
+            m_sourcesByTarget.clear();
+            m_invalidSources.clear();
+            m_valid = false;
+        }
+
+        static void addParentEntityNode(Model::Node* node, std::vector<Model::EntityNode*>& entityNodes) {
+            if (auto* entityNode = dynamic_cast<Model::EntityNode*>(node->parent())) {
+                entityNodes.push_back(entityNode);
+            }
+        }
+
+        static std::vector<Model::EntityNode*> collectLinkedEntityNodes(const std::vector<Model::Node*>& nodes) {
+            auto result = std::vector<Model::EntityNode*>{};
+            for (auto* node : nodes) {
+                node->accept(kdl::overload(
+                    [](Model::WorldNode*) {},
+                    [](auto&& thisLambda, Model::LayerNode* layer) {
+                        layer->visitChildren(thisLambda);
+                    },
+                    [](auto&& thisLambda, Model::GroupNode* group) {
+                        group->visitChildren(thisLambda);
+                    },
+                    [&](Model::EntityNode* entity) {
+                        result.push_back(entity);
+                    },
+                    [&](Model::BrushNode* brush) {
+                        addParentEntityNode(brush, result);
+                    },
+                    [&](Model::PatchNode* patch) {
+                        addParentEntityNode(patch, result);
+                    }
+                ));
+            }
+            return result;
+        }
+
+        static void insertEntityNodes(const std::vector<Model::EntityNodeBase*>& nodes, std::unordered_set<Model::EntityNode*>& result) {
+            for (auto* node : nodes) {
+                if (auto* entityNode = dynamic_cast<Model::EntityNode*>(node)) {
+                    result.insert(entityNode);
+                }
+            }
+        }
+
+        void EntityLinkCache::invalidateNodes(const std::vector<Model::Node*>& nodes) {
+            if (!m_valid) {
+                return;
+            }
+
+            for (auto* entityNode : collectLinkedEntityNodes(nodes)) {
+                invalidateEntity(entityNode);
+            }
+        }
+
+        void EntityLinkCache::invalidateEntity(Model::EntityNode* entityNode) {
+            // the links starting at the entity
+            m_invalidSources.insert(entityNode);
+
+            // the links that ended at the entity when they were cached
+            const auto it = m_sourcesByTarget.find(entityNode);
+            if (it != std::end(m_sourcesByTarget)) {
+                m_invalidSources.insert(std::begin(it->second), std::end(it->second));
+            }
+
+            // the links that end at the entity now
+            insertEntityNodes(entityNode->linkSources(), m_invalidSources);
+            insertEntityNodes(entityNode->killSources(), m_invalidSources);
+        }
+
+        void EntityLinkCache::removeNodes(const std::vector<Model::Node*>& nodes) {
+            if (!m_valid) {
+                return;
+            }
+
+            // brushes and patches have already been detached from their entities, which are invalidated separately
+            const auto removedEntityNodes = collectLinkedEntityNodes(nodes);
+            const auto removed = std::unordered_set<Model::EntityNode*>(std::begin(removedEntityNodes), std::end(removedEntityNodes));
+
+            for (auto* entityNode : removedEntityNodes) {
+                // the removed entity has already been unlinked, so only the cache knows which links ended at it
+                const auto it = m_sourcesByTarget.find(entityNode);
+                if (it != std::end(m_sourcesByTarget)) {
+                    for (auto* source : it->second) {
+                        if (removed.count(source) == 0u) {
+                            m_invalidSources.insert(source);
+                        }
+                    }
+                    m_sourcesByTarget.erase(it);
+                }
+
+                removeLinks(entityNode);
+                m_invalidSources.erase(entityNode);
+            }
+        }
+
+        void EntityLinkCache::getVertices(Model::WorldNode& world, const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, std::vector<LinkRenderer::LineVertex>& lines, std::vector<LinkRenderer::ArrowVertex>& arrows) {
+            if (!m_valid) {
+                world.accept(kdl::overload(
+                    [](auto&& thisLambda, Model::WorldNode* worldNode) {
+                        worldNode->visitChildren(thisLambda);
+                    },
+                    [](auto&& thisLambda, Model::LayerNode* layer) {
+                        layer->visitChildren(thisLambda);
+                    },
+                    [](auto&& thisLambda, Model::GroupNode* group) {
+                        group->visitChildren(thisLambda);
+                    },
+                    [&](Model::EntityNode* entity) {
+                        updateLinks(entity, editorContext, defaultColor, selectedColor);
+                    },
+                    [](Model::BrushNode*) {},
+                    [](Model::PatchNode*) {}
+                ));
+                m_valid = true;
+            } else {
+                for (auto* source : m_invalidSources) {
+                    updateLinks(source, editorContext, defaultColor, selectedColor);
+                }
+            }
+            m_invalidSources.clear();
+
+            auto lineCount = lines.size();
+            auto arrowCount = arrows.size();
+            for (const auto& [source, links] : m_linksBySource) {
+                unused(source);
+                lineCount += links.lines.size();
+                arrowCount += links.arrows.size();
+            }
+
+            lines.reserve(lineCount);
+            arrows.reserve(arrowCount);
+            for (const auto& [source, links] : m_linksBySource) {
+                unused(source);
+                lines.insert(std::end(lines), std::begin(links.lines), std::end(links.lines));
+                arrows.insert(std::end(arrows), std::begin(links.arrows), std::end(links.arrows));
+            }
+        }
+
+        void EntityLinkCache::removeLinks(Model::EntityNode* source) {
+            const auto it = m_linksBySource.find(source);
+            if (it == std::end(m_linksBySource)) {
+                return;
+            }
+
+            for (auto* target : it->second.targets) {
+                const auto sourcesIt = m_sourcesByTarget.find(target);
+                if (sourcesIt != std::end(m_sourcesByTarget)) {
+                    auto& sources = sourcesIt->second;
+                    sources.erase(std::remove(std::begin(sources), std::end(sources), source), std::end(sources));
+                    if (sources.empty()) {
+                        m_sourcesByTarget.erase(sourcesIt);
+                    }
+                }
+            }
+
+            m_linksBySource.erase(it);
+        }
+
+        static bool selectedOrDescendantSelected(const Model::EntityNodeBase* node) {
+            return node->selected() || node->descendantSelected();
+        }
+
+        static void addSourceLinks(Model::EntityNode* source, const std::vector<Model::EntityNodeBase*>& targets, const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, std::vector<Model::EntityNodeBase*>& linkedTargets, std::vector<LinkRenderer::LineVertex>& lines) {
+            for (auto* target : targets) {
+                if (editorContext.visible(target)) {
+                    const auto anySelected = selectedOrDescendantSelected(source) || selectedOrDescendantSelected(target);
+                    const auto& color = anySelected ? selectedColor : defaultColor;
+
+                    linkedTargets.push_back(target);
+                    lines.emplace_back(vm::vec3f(source->linkSourceAnchor()), color);
+                    lines.emplace_back(vm::vec3f(target->linkTargetAnchor()), color);
+                }
+            }
+        }
+
+        void EntityLinkCache::updateLinks(Model::EntityNode* source, const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor) {
+            removeLinks(source);
+            if (!editorContext.visible(source)) {
+                return;
+            }
+
+            auto links = SourceLinks{};
+            addSourceLinks(source, source->linkTargets(), editorContext, defaultColor, selectedColor, links.targets, links.lines);
+            addSourceLinks(source, source->killTargets(), editorContext, defaultColor, selectedColor, links.targets, links.lines);
+            if (links.targets.empty()) {
+                return;
+            }
+
+            for (auto* target : links.targets) {
+                m_sourcesByTarget[target].push_back(source);
+            }
+
+            links.arrows = LinkRenderer::getArrows(links.lines);
+            m_linksBySource.emplace(source, std::move(links));
+        }
+
         EntityLinkRenderer::EntityLinkRenderer(std::weak_ptr<View::MapDocument> document) :
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
@@ -59,6 +262,21 @@ namespace TrenchBroom {
             invalidate();
         }
 
+        void EntityLinkRenderer::invalidate() {
+            m_linkCache.invalidate();
+            LinkRenderer::invalidate();
+        }
+
+        void EntityLinkRenderer::invalidateNodes(const std::vector<Model::Node*>& nodes) {
+            m_linkCache.invalidateNodes(nodes);
+            LinkRenderer::invalidate();
+        }
+
+        void EntityLinkRenderer::removeNodes(const std::vector<Model::Node*>& nodes) {
+            m_linkCache.removeNodes(nodes);
+            LinkRenderer::invalidate();
+        }
+
         namespace {
             class CollectLinksVisitor {
             protected:
@@ -86,26 +304,6 @@ namespace TrenchBroom {
                 }
             };
 
-            class CollectAllLinksVisitor : public CollectLinksVisitor {
-            public:
-                CollectAllLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, std::vector<LinkRenderer::LineVertex>& links) :
-                CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
-
-                void visit(Model::EntityNodeBase* node) override {
-                    if (m_editorContext.visible(node)) {
-                        addTargets(node, node->linkTargets());
-                        addTargets(node, node->killTargets());
-                    }
-                }
-            private:
-                void addTargets(Model::EntityNodeBase* source, const std::vector<Model::EntityNodeBase*>& targets) {
-                    for (const Model::EntityNodeBase* target : targets) {
-                        if (m_editorContext.visible(target))
-                            addLink(source, target);
-                    }
-                }
-            };
-
             class CollectTransitiveSelectedLinksVisitor : public CollectLinksVisitor {
             private:
                 std::unordered_set<Model::Node*> m_visited;
@@ -191,31 +389,6 @@ namespace TrenchBroom {
             }
         }
 
-        static void getAllLinks(View::MapDocument& document, const Color& defaultColor, const Color& selectedColor, std::vector<LinkRenderer::LineVertex>& links) {
-            const Model::EditorContext& editorContext = document.editorContext();
-
-            CollectAllLinksVisitor collectLinks(editorContext, defaultColor, selectedColor, links);
-
-            if (document.world() != nullptr) {
-                document.world()->accept(kdl::overload(
-                    [](auto&& thisLambda, Model::WorldNode* world) {
-                        world->visitChildren(thisLambda);
-                    },
-                    [](auto&& thisLambda, Model::LayerNode* layer) {
-                        layer->visitChildren(thisLambda);
-                    },
-                    [](auto&& thisLambda, Model::GroupNode* group) {
-                        group->visitChildren(thisLambda);
-                    },
-                    [&](Model::EntityNode* entity) {
-                        collectLinks.visit(entity);
-                    },
-                    [](Model::BrushNode*) {},
-                    [](Model::PatchNode*) {}
-                ));
-            }
-        }
-
         static void getTransitiveSelectedLinks(View::MapDocument& document, const Color& defaultColor, const Color& selectedColor, std::vector<LinkRenderer::LineVertex>& links) {
             const Model::EditorContext& editorContext = document.editorContext();
 
@@ -233,15 +406,25 @@ namespace TrenchBroom {
         static void getLinks(View::MapDocument& document, const Color& defaultColor, const Color& selectedColor, std::vector<LinkRenderer::LineVertex>& links) {
             const QString entityLinkMode = pref(Preferences::EntityLinkMode);
 
-            if (entityLinkMode == Preferences::entityLinkModeAll()) {
-                getAllLinks(document, defaultColor, selectedColor, links);
-            } else if (entityLinkMode == Preferences::entityLinkModeTransitive()) {
+            if (entityLinkMode == Preferences::entityLinkModeTransitive()) {
                 getTransitiveSelectedLinks(document, defaultColor, selectedColor, links);
             } else if (entityLinkMode == Preferences::entityLinkModeDirect()) {
                 getDirectSelectedLinks(document, defaultColor, selectedColor, links);
             }
         }
 
+        void EntityLinkRenderer::getVertices(std::vector<LineVertex>& links, std::vector<ArrowVertex>& arrows) {
+            auto document = kdl::mem_lock(m_document);
+            if (pref(Preferences::EntityLinkMode) != Preferences::entityLinkModeAll() || document->world() == nullptr) {
+                // the links of the selected entities are few, so they are collected from scratch every time
+                m_linkCache.invalidate();
+                LinkRenderer::getVertices(links, arrows);
+                return;
+            }
+
+            m_linkCache.getVertices(*document->world(), document->editorContext(), m_defaultColor, m_selectedColor, links, arrows);
+        }
+
         std::vector<LinkRenderer::LineVertex> EntityLinkRenderer::getLinks() {
             auto document = kdl::mem_lock(m_document);
             auto links = std::vector<LineVertex>{};
@@ -24,25 +24,88 @@
 #include "Renderer/LinkRenderer.h"
 
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Model {
+        class EditorContext;
+        class EntityNode;
+        class EntityNodeBase;
+        class Node;
+        class WorldNode;
+    }
+
     namespace View {
         class MapDocument; // FIXME: Renderer should not depend on View
     }
 
     namespace Renderer {
+        /**
+         * Caches the vertices of the links between all visible entities, grouped by the entity at which each link
+         * starts. When entities change, only the links that start or end at those entities are regenerated.
+         */
+        class EntityLinkCache {
+        private:
+            struct SourceLinks {
+                std::vector<Model::EntityNodeBase*> targets;
+                std::vector<LinkRenderer::LineVertex> lines;
+                std::vector<LinkRenderer::ArrowVertex> arrows;
+            };
+
+            std::unordered_map<Model::EntityNode*, SourceLinks> m_linksBySource;
+            std::unordered_map<Model::EntityNodeBase*, std::vector<Model::EntityNode*>> m_sourcesByTarget;
+            std::unordered_set<Model::EntityNode*> m_invalidSources;
+            bool m_valid;
+        public:
+            EntityLinkCache();
+
+            /**
+             * Discards all cached links, so that they are regenerated from the entire world.
+             */
+            void invalidate();
+
+            /**
+             * Invalidates the links of the entities among the given nodes and their descendants, and the links of the
+             * entities containing any of the given brushes or patches. Must be called after the nodes have changed.
+             */
+            void invalidateNodes(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Discards the links of the entities among the given nodes and their descendants. Must be called after the
+             * nodes have been removed from the world.
+             */
+            void removeNodes(const std::vector<Model::Node*>& nodes);
+
+            /**
+             * Regenerates the invalid links and appends the vertices of all links to the given vectors.
+             */
+            void getVertices(Model::WorldNode& world, const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, std::vector<LinkRenderer::LineVertex>& lines, std::vector<LinkRenderer::ArrowVertex>& arrows);
+        private:
+            void invalidateEntity(Model::EntityNode* entityNode);
+            void removeLinks(Model::EntityNode* source);
+            void updateLinks(Model::EntityNode* source, const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor);
+        };
+
         class EntityLinkRenderer : public LinkRenderer {
             std::weak_ptr<View::MapDocument> m_document;
 
             Color m_defaultColor;
             Color m_selectedColor;
+
+            EntityLinkCache m_linkCache;
         public:
             EntityLinkRenderer(std::weak_ptr<View::MapDocument> document);
 
             void setDefaultColor(const Color& color);
             void setSelectedColor(const Color& color);
+
+            void invalidate() override;
+            void invalidateNodes(const std::vector<Model::Node*>& nodes);
+            void removeNodes(const std::vector<Model::Node*>& nodes);
         private:
+            void getVertices(std::vector<LineVertex>& links, std::vector<ArrowVertex>& arrows) override;
             std::vector<LinkRenderer::LineVertex> getLinks() override;
 
             deleteCopy(EntityLinkRenderer)
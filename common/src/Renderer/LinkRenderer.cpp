@@ -96,7 +96,7 @@ namespace TrenchBroom {
             arrows.emplace_back(vm::vec3f{0,-3, 0}, color, arrowPosition, lineDir);
         }
 
-        static std::vector<LinkRenderer::ArrowVertex> getArrows(const std::vector<LinkRenderer::LineVertex>& links) {
+        std::vector<LinkRenderer::ArrowVertex> LinkRenderer::getArrows(const std::vector<LineVertex>& links) {
             assert((links.size() % 2) == 0);
             auto arrows = std::vector<LinkRenderer::ArrowVertex>{};
             for (size_t i = 0; i < links.size(); i += 2) {
@@ -132,13 +132,19 @@ namespace TrenchBroom {
 
 
         void LinkRenderer::validate() {
-            auto links = getLinks();
-            auto arrows = getArrows(links);
+            auto links = std::vector<LineVertex>{};
+            auto arrows = std::vector<ArrowVertex>{};
+            getVertices(links, arrows);
 
             m_lines = VertexArray::move(std::move(links));
             m_arrows = VertexArray::move(std::move(arrows));
 
             m_valid = true;
         }
+
+        void LinkRenderer::getVertices(std::vector<LineVertex>& links, std::vector<ArrowVertex>& arrows) {
+            links = getLinks();
+            arrows = getArrows(links);
+        }
     }
 }
@@ -55,7 +55,13 @@ namespace TrenchBroom {
             LinkRenderer();
 
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
-            void invalidate();
+            virtual void invalidate();
+
+            /**
+             * Returns the arrow vertices for the given line vertices, which must contain a start and an end vertex for
+             * each line.
+             */
+            static std::vector<ArrowVertex> getArrows(const std::vector<LineVertex>& links);
         private:
             void doPrepareVertices(VboManager& vboManager) override;
             void doRender(RenderContext& renderContext) override;
@@ -65,6 +71,11 @@ namespace TrenchBroom {
 
             void validate();
 
+            /**
+             * Returns the line and arrow vertices to render. By default, this computes the arrows for the lines
+             * returned by getLinks.
+             */
+            virtual void getVertices(std::vector<LineVertex>& links, std::vector<ArrowVertex>& arrows);
             virtual std::vector<LinkRenderer::LineVertex> getLinks() = 0;
 
             deleteCopy(LinkRenderer)
@@ -21,6 +21,7 @@
 
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Assets/EntityDefinitionManager.h"
 #include "Model/Brush.h"
 #include "Model/BrushNode.h"
@@ -191,6 +192,7 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            TB_PROFILE_SCOPE("MapRenderer::render");
             commitPendingChanges();
             setupGL(renderBatch);
             renderDefaultOpaque(renderContext, renderBatch);
@@ -411,7 +413,6 @@ namespace TrenchBroom {
                                              lockedNodes.brushes,
                                              lockedNodes.patches);
             }
-            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::invalidateRenderers(Renderer renderers) {
@@ -507,47 +508,61 @@ namespace TrenchBroom {
             updateRenderers(Renderer_All);
         }
 
-        void MapRenderer::nodesWereAdded(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesWereAdded(const std::vector<Model::Node*>& nodes) {
             updateRenderers(Renderer_All);
+            m_entityLinkRenderer->invalidateNodes(nodes);
             invalidateGroupLinkRenderer();
         }
 
-        void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesWereRemoved(const std::vector<Model::Node*>& nodes) {
             updateRenderers(Renderer_All);
+            m_entityLinkRenderer->removeNodes(nodes);
             invalidateGroupLinkRenderer();
         }
 
-        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>&) {
+        void MapRenderer::nodesDidChange(const std::vector<Model::Node*>& nodes) {
             invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
+            m_entityLinkRenderer->invalidateNodes(nodes);
             invalidateGroupLinkRenderer();
         }
 
         void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node*>&) {
             invalidateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::nodeLockingDidChange(const std::vector<Model::Node*>&) {
             updateRenderers(Renderer_Default_Locked);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::groupWasOpened(Model::GroupNode*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
             invalidateGroupLinkRenderer();
         }
 
         void MapRenderer::groupWasClosed(Model::GroupNode*) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
             invalidateGroupLinkRenderer();
         }
 
-        void MapRenderer::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
+        void MapRenderer::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>& faces) {
             invalidateRenderers(Renderer_Selection);
+
+            // changing the textures of faces may hide their brushes and thereby their entities
+            const auto brushes = kdl::vec_transform(faces, [](const auto& handle) -> Model::Node* { return handle.node(); });
+            m_entityLinkRenderer->invalidateNodes(kdl::vec_sort_and_remove_duplicates(brushes));
         }
 
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
             updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
 
+            // the links of selected entities are drawn in a different color, and selected entities are always visible
+            m_entityLinkRenderer->invalidateNodes(selection.selectedNodes());
+            m_entityLinkRenderer->invalidateNodes(selection.deselectedNodes());
+
             // selecting faces needs to invalidate the brushes
             if (!selection.selectedBrushFaces().empty()
                 || !selection.deselectedBrushFaces().empty()) {
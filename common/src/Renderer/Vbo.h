@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Profiler.h"
 #include "Renderer/VboManager.h"
 
 #include <cassert>
@@ -97,6 +98,7 @@ namespace TrenchBroom {
                 const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
                 glAssert(glBindBuffer(m_type, m_bufferId));
                 glAssert(glBufferSubData(m_type, offset, sizei, ptr));
+                TB_PROFILE_COUNT(ProfilerCounter::VboBytesUploaded, size);
 
                 return size;
             }
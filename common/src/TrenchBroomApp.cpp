@@ -117,6 +117,9 @@ namespace TrenchBroom {
             setOrganizationName("");
             setOrganizationDomain("io.github.trenchbroom");
 
+            // initialize the preferences before any worker thread can read a preference snapshot
+            PreferenceManager::instance();
+
             if (!initializeGameFactory()) {
                 QCoreApplication::exit(1);
                 return;
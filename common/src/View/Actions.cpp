@@ -1619,6 +1619,15 @@ namespace TrenchBroom {
                 [](ActionExecutionContext& context) {
                     return context.hasDocument();
                 }));
+#ifdef TB_ENABLE_PROFILER
+            debugMenu.addItem(createMenuAction(IO::Path("Menu/Debug/Save Profiler Trace..."), QObject::tr("Save Profiler Trace..."), 0,
+                [](ActionExecutionContext& context) {
+                    context.frame()->debugSaveProfilerTrace();
+                },
+                [](ActionExecutionContext& context) {
+                    return context.hasDocument();
+                }));
+#endif
 #endif
         }
 
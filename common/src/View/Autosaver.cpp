@@ -20,11 +20,20 @@
 #include "Autosaver.h"
 
 #include "Exceptions.h"
+#include "Logger.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/Game.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
+#include <kdl/overload.h>
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
@@ -62,6 +71,25 @@ namespace TrenchBroom {
             return backupNo > 0u;
         }
 
+        Autosaver::PendingSave::PendingSave(std::unique_ptr<Model::WorldNode> i_snapshot, std::unique_ptr<PendingSave> i_superseded) :
+        snapshot(std::move(i_snapshot)),
+        superseded(std::move(i_superseded)),
+        cancelled(false) {}
+
+        Autosaver::PendingSave::~PendingSave() {
+            // the background thread accesses the snapshot and the logger
+            if (result.valid()) {
+                result.wait();
+            }
+        }
+
+        void Autosaver::PendingSave::reportMessages(Logger& parentLogger) {
+            if (superseded) {
+                superseded->reportMessages(parentLogger);
+            }
+            logger.setParentLogger(&parentLogger);
+        }
+
         Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups) :
         m_document(document),
         m_saveInterval(saveInterval),
@@ -69,7 +97,14 @@ namespace TrenchBroom {
         m_lastSaveTime(Clock::now()),
         m_lastModificationCount(kdl::mem_lock(m_document)->modificationCount()) {}
 
+        Autosaver::~Autosaver() {
+            // the background thread calls member functions of this autosaver
+            m_pendingSave.reset();
+        }
+
         void Autosaver::triggerAutosave(Logger& logger) {
+            reportFinishedAutosave(logger);
+
             if (kdl::mem_expired(m_document)) {
                 return;
             }
@@ -95,13 +130,106 @@ namespace TrenchBroom {
                 return;
             }
 
-            autosave(logger, document);
+            autosave(document);
         }
 
-        void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document) {
+        void Autosaver::waitForAutosave(Logger& logger) {
+            if (m_pendingSave) {
+                m_pendingSave->result.wait();
+                reportFinishedAutosave(logger);
+            }
+        }
+
+        /**
+         * Copies the state which is written to the map file, but not copied when cloning the given node, to the given
+         * snapshot node, and removes all asset references from it. The snapshot then doesn't share any mutable state
+         * with the document, so it can be written and destroyed on another thread.
+         */
+        static void prepareSnapshot(const Model::Node& original, Model::Node& snapshot) {
+            assert(original.childCount() == snapshot.childCount());
+
+            snapshot.setVisibilityState(original.visibilityState());
+            snapshot.setLockState(original.lockState());
+            snapshot.accept(kdl::overload(
+                [](Model::WorldNode* world) {
+                    world->setDefinition(nullptr);
+                },
+                [&](Model::LayerNode* layer) {
+                    const auto& originalLayer = static_cast<const Model::LayerNode&>(original);
+                    layer->setLayer(originalLayer.layer());
+                    if (const auto& persistentId = originalLayer.persistentId()) {
+                        layer->setPersistentId(*persistentId);
+                    }
+                },
+                [&](Model::GroupNode* group) {
+                    const auto& originalGroup = static_cast<const Model::GroupNode&>(original);
+                    if (const auto& persistentId = originalGroup.persistentId()) {
+                        group->setPersistentId(*persistentId);
+                    }
+                },
+                [](Model::EntityNode* entity) {
+                    entity->setDefinition(nullptr);
+                    entity->setModelFrame(nullptr);
+                },
+                [](Model::BrushNode* brushNode) {
+                    for (size_t i = 0u; i < brushNode->brush().faceCount(); ++i) {
+                        brushNode->setFaceTexture(i, nullptr);
+                    }
+                },
+                [](Model::PatchNode* patchNode) {
+                    patchNode->setTexture(nullptr);
+                }
+            ));
+
+            const auto& originalChildren = original.children();
+            const auto& snapshotChildren = snapshot.children();
+            for (size_t i = 0u; i < originalChildren.size(); ++i) {
+                prepareSnapshot(*originalChildren[i], *snapshotChildren[i]);
+            }
+        }
+
+        static std::unique_ptr<Model::WorldNode> createSnapshot(const MapDocument& document) {
+            const auto* world = document.world();
+            auto snapshot = std::unique_ptr<Model::WorldNode>(static_cast<Model::WorldNode*>(world->cloneRecursively(document.worldBounds())));
+            prepareSnapshot(*world, *snapshot);
+            return snapshot;
+        }
+
+        void Autosaver::autosave(std::shared_ptr<MapDocument> document) {
             const auto& mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
 
+            m_lastSaveTime = Clock::now();
+            m_lastModificationCount = document->modificationCount();
+
+            auto superseded = std::move(m_pendingSave);
+            if (superseded) {
+                superseded->cancelled = true;
+            }
+
+            m_pendingSave = std::make_unique<PendingSave>(createSnapshot(*document), std::move(superseded));
+            m_pendingSave->result = std::async(std::launch::async, [this, save = m_pendingSave.get(), game = document->game(), mapPath]() {
+                if (save->superseded) {
+                    save->superseded->result.wait();
+                }
+                if (!save->cancelled) {
+                    writeBackup(save->logger, *game, *save->snapshot, mapPath, save->cancelled);
+                }
+                // the snapshot doesn't reference any assets, so it can be released here
+                save->snapshot.reset();
+            });
+        }
+
+        void Autosaver::reportFinishedAutosave(Logger& logger) {
+            using namespace std::chrono_literals;
+
+            if (m_pendingSave && m_pendingSave->result.wait_for(0s) == std::future_status::ready) {
+                auto finishedSave = std::move(m_pendingSave);
+                finishedSave->reportMessages(logger);
+            }
+        }
+
+        void Autosaver::writeBackup(Logger& logger, const Model::Game& game, Model::WorldNode& snapshot, const IO::Path& mapPath, const std::atomic<bool>& cancelled) const {
             const auto mapFilename = mapPath.lastComponent();
             const auto mapBasename = mapFilename.deleteExtension();
 
@@ -111,17 +239,31 @@ namespace TrenchBroom {
 
                 thinBackups(logger, fs, backups);
                 cleanBackups(fs, backups, mapBasename);
+                deleteTemporaryBackups(logger, fs, mapBasename);
 
                 assert(backups.size() < m_maxBackups);
                 const auto backupNo = backups.size() + 1;
+                const auto backupName = makeBackupName(mapBasename, backupNo);
 
-                const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
+                // write to a temporary file first so that a cancelled autosave doesn't leave an incomplete backup
+                const auto tempName = backupName.addExtension("tmp");
+                try {
+                    game.writeMap(snapshot, fs.makeAbsolute(tempName));
+                } catch (const std::exception&) {
+                    if (fs.fileExists(tempName)) {
+                        fs.deleteFile(tempName);
+                    }
+                    throw;
+                }
 
-                m_lastSaveTime = Clock::now();
-                m_lastModificationCount = document->modificationCount();
-                document->saveDocumentTo(backupFilePath);
+                if (cancelled) {
+                    fs.deleteFile(tempName);
+                    logger.debug() << "Discarded autosave backup superseded by a newer autosave";
+                    return;
+                }
 
-                logger.info() << "Created autosave backup at " << backupFilePath;
+                fs.moveFile(tempName, backupName, false);
+                logger.info() << "Created autosave backup at " << fs.makeAbsolute(backupName);
             } catch (const FileSystemException& e) {
                 logger.error() << "Aborting autosave: " << e.what();
             }
@@ -176,6 +318,24 @@ namespace TrenchBroom {
             }
         }
 
+        void Autosaver::deleteTemporaryBackups(Logger& logger, IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const {
+            // autosaves are written one after another, so any temporary backup was left behind by an autosave that
+            // didn't complete
+            const auto backupFileMatcher = BackupFileMatcher(mapBasename);
+            const auto temporaryBackups = fs.findItems(IO::Path(), [&](const IO::Path& path, const bool directory) {
+                return kdl::ci::str_is_equal(path.extension(), "tmp") && backupFileMatcher(path.deleteExtension(), directory);
+            });
+
+            for (const auto& filename : temporaryBackups) {
+                try {
+                    fs.deleteFile(filename);
+                    logger.debug() << "Deleted temporary autosave backup " << filename;
+                } catch (const FileSystemException&) {
+                    logger.warn() << "Cannot delete temporary autosave backup " << filename;
+                }
+            }
+        }
+
         IO::Path Autosaver::makeBackupName(const IO::Path& mapBasename, const size_t index) const {
             return IO::Path(kdl::str_to_string(mapBasename,".", index, ".map"));
         }
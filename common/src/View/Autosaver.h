@@ -20,9 +20,13 @@
 #pragma once
 
 #include "IO/Path.h"
+#include "View/CachingLogger.h"
 
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     class Logger;
@@ -31,10 +35,26 @@ namespace TrenchBroom {
         class WritableDiskFileSystem;
     }
 
+    namespace Model {
+        class Game;
+        class WorldNode;
+    }
+
     namespace View {
         class Command;
         class MapDocument;
 
+        /**
+         * Periodically writes backups of a document.
+         *
+         * To avoid blocking the UI, an autosave only takes a snapshot of the world on the calling thread. The snapshot
+         * is written to the backup file on a background thread, which also thins and renames the existing backups.
+         * Messages from the background thread are cached and passed to the logger when the autosave is finished and
+         * the autosaver is triggered again, or when waitForAutosave is called.
+         *
+         * If a new autosave is started while the previous one is still running, the previous one is cancelled and the
+         * new one waits for it to finish before it touches the backup directory.
+         */
         class Autosaver {
         public:
             class BackupFileMatcher {
@@ -46,6 +66,25 @@ namespace TrenchBroom {
             };
         private:
             using Clock = std::chrono::system_clock;
+
+            /**
+             * An autosave that is written on a background thread.
+             */
+            struct PendingSave {
+                std::unique_ptr<Model::WorldNode> snapshot;
+                std::unique_ptr<PendingSave> superseded;
+                std::atomic<bool> cancelled;
+                CachingLogger logger;
+                std::future<void> result;
+
+                PendingSave(std::unique_ptr<Model::WorldNode> i_snapshot, std::unique_ptr<PendingSave> i_superseded);
+                ~PendingSave();
+
+                /**
+                 * Passes the cached messages of the superseded autosaves and of this autosave to the given logger.
+                 */
+                void reportMessages(Logger& logger);
+            };
             
             std::weak_ptr<MapDocument> m_document;
 
@@ -69,17 +108,30 @@ namespace TrenchBroom {
              * The modification count that was last recorded.
              */
             size_t m_lastModificationCount;
-            
+
+            /**
+             * The autosave that is currently being written, if any.
+             */
+            std::unique_ptr<PendingSave> m_pendingSave;
         public:
             explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50);
+            ~Autosaver();
 
             void triggerAutosave(Logger& logger);
+
+            /**
+             * Blocks until the pending autosave, if any, is written and passes its messages to the given logger.
+             */
+            void waitForAutosave(Logger& logger);
         private:
-            void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
+            void autosave(std::shared_ptr<View::MapDocument> document);
+            void reportFinishedAutosave(Logger& logger);
+            void writeBackup(Logger& logger, const Model::Game& game, Model::WorldNode& snapshot, const IO::Path& mapPath, const std::atomic<bool>& cancelled) const;
             IO::WritableDiskFileSystem createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const;
             std::vector<IO::Path> collectBackups(const IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             void thinBackups(Logger& logger, IO::WritableDiskFileSystem& fs, std::vector<IO::Path>& backups) const;
             void cleanBackups(IO::WritableDiskFileSystem& fs, std::vector<IO::Path>& backups, const IO::Path& mapBasename) const;
+            void deleteTemporaryBackups(Logger& logger, IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             IO::Path makeBackupName(const IO::Path& mapBasename, const size_t index) const;
         };
 
@@ -27,6 +27,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include <QVariant>
@@ -410,14 +412,21 @@ namespace TrenchBroom {
             }
 
             size_t indexOfRowAt(const float y) const {
-                for (size_t i = 0; i < m_rows.size(); ++i) {
-                    const Row& row = m_rows[i];
-                    const LayoutBounds& rowBounds = row.bounds();
-                    if (y < rowBounds.bottom())
-                        return i;
-                }
+                // the rows are stacked vertically, so they are sorted by their top and bottom coordinates
+                const auto it = std::partition_point(std::begin(m_rows), std::end(m_rows), [&](const Row& row) { return row.bounds().bottom() <= y; });
+                return static_cast<size_t>(std::distance(std::begin(m_rows), it));
+            }
 
-                return m_rows.size();
+            /**
+             * Returns the half open range of the indices of the rows that intersect the given vertical range.
+             */
+            std::pair<size_t, size_t> rowsIntersectingY(const float y, const float height) const {
+                const auto first = std::partition_point(std::begin(m_rows), std::end(m_rows), [&](const Row& row) { return row.bounds().bottom() < y; });
+                const auto last = std::partition_point(first, std::end(m_rows), [&](const Row& row) { return row.bounds().top() <= y + height; });
+                return {
+                    static_cast<size_t>(std::distance(std::begin(m_rows), first)),
+                    static_cast<size_t>(std::distance(std::begin(m_rows), last))
+                };
             }
 
             bool rowAt(const float y, const Row** result) const {
@@ -430,14 +439,9 @@ namespace TrenchBroom {
             }
 
             bool cellAt(const float x, const float y, const LayoutCell** result) const {
-                for (size_t i = 0; i < m_rows.size(); ++i) {
-                    const Row& row = m_rows[i];
-                    const LayoutBounds& rowBounds = row.bounds();
-                    if (y > rowBounds.bottom())
-                        continue;
-                    else if (y < rowBounds.top())
-                        break;
-                    if (row.cellAt(x, y, result))
+                const auto [first, last] = rowsIntersectingY(y, 0.0f);
+                for (size_t i = first; i < last; ++i) {
+                    if (m_rows[i].cellAt(x, y, result))
                         return true;
                 }
 
@@ -512,7 +516,7 @@ namespace TrenchBroom {
                 m_height = 2.0f * m_outerMargin;
                 m_valid = true;
                 if (!m_groups.empty()) {
-                    auto copy = m_groups;
+                    auto copy = std::move(m_groups);
                     m_groups.clear();
 
                     for (size_t i = 0; i < copy.size(); ++i) {
@@ -634,18 +638,44 @@ namespace TrenchBroom {
                 invalidate();
             }
 
-            bool cellAt(const float x, const float y, const LayoutCell** result) {
+            /**
+             * Returns the half open range of the indices of the groups that intersect the given vertical range.
+             */
+            std::pair<size_t, size_t> groupsIntersectingY(const float y, const float height) {
                 if (!m_valid)
                     validate();
 
-                for (size_t i = 0; i < m_groups.size(); ++i) {
+                // the groups are stacked vertically, so they are sorted by their top and bottom coordinates
+                const auto first = std::partition_point(std::begin(m_groups), std::end(m_groups), [&](const Group& group) { return group.bounds().bottom() < y; });
+                const auto last = std::partition_point(first, std::end(m_groups), [&](const Group& group) { return group.bounds().top() <= y + height; });
+                return {
+                    static_cast<size_t>(std::distance(std::begin(m_groups), first)),
+                    static_cast<size_t>(std::distance(std::begin(m_groups), last))
+                };
+            }
+
+            /**
+             * Calls the given visitor with every cell in the rows that intersect the given vertical range. The visible
+             * groups and rows are found by binary search, so the cost does not depend on the size of the layout.
+             */
+            template <typename L>
+            void visitCellsIntersectingY(const float y, const float height, L&& visitor) {
+                const auto [firstGroup, lastGroup] = groupsIntersectingY(y, height);
+                for (size_t i = firstGroup; i < lastGroup; ++i) {
                     const Group& group = m_groups[i];
-                    const LayoutBounds groupBounds = group.bounds();
-                    if (y > groupBounds.bottom())
-                        continue;
-                    else if (y < groupBounds.top())
-                        break;
-                    if (group.cellAt(x, y, result))
+                    const auto [firstRow, lastRow] = group.rowsIntersectingY(y, height);
+                    for (size_t j = firstRow; j < lastRow; ++j) {
+                        for (const LayoutCell& cell : group[j].cells()) {
+                            visitor(cell);
+                        }
+                    }
+                }
+            }
+
+            bool cellAt(const float x, const float y, const LayoutCell** result) {
+                const auto [first, last] = groupsIntersectingY(y, 0.0f);
+                for (size_t i = first; i < last; ++i) {
+                    if (m_groups[i].cellAt(x, y, result))
                         return true;
                 }
 
@@ -653,18 +683,10 @@ namespace TrenchBroom {
             }
 
             bool groupAt(const float x, const float y, Group*& result) {
-                if (!m_valid)
-                    validate();
-
-                for (size_t i = 0; i < m_groups.size(); ++i) {
-                    Group* group = &m_groups[i];
-                    const LayoutBounds groupBounds = group->bounds();
-                    if (y > groupBounds.bottom())
-                        continue;
-                    else if (y < groupBounds.top())
-                        break;
-                    if (group->hitTest(x, y)) {
-                        result = group;
+                const auto [first, last] = groupsIntersectingY(y, 0.0f);
+                for (size_t i = first; i < last; ++i) {
+                    if (m_groups[i].hitTest(x, y)) {
+                        result = &m_groups[i];
                         return true;
                     }
                 }
@@ -680,15 +702,8 @@ namespace TrenchBroom {
                 if (!m_valid)
                     validate();
 
-                size_t groupIndex = m_groups.size();
-                for (size_t i = 0; i < m_groups.size(); ++i) {
-                    const Group& candidate = m_groups[i];
-                    const LayoutBounds groupBounds = candidate.bounds();
-                    if (y + m_rowMargin > groupBounds.bottom())
-                        continue;
-                    groupIndex = i;
-                    break;
-                }
+                const auto groupIt = std::partition_point(std::begin(m_groups), std::end(m_groups), [&](const Group& group) { return y + m_rowMargin > group.bounds().bottom(); });
+                size_t groupIndex = static_cast<size_t>(std::distance(std::begin(m_groups), groupIt));
 
                 if (groupIndex == m_groups.size())
                     return y;
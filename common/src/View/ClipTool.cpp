@@ -38,20 +38,24 @@
 #include "View/MapDocument.h"
 #include "View/Selection.h"
 
-#include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/set_temp.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -505,10 +509,7 @@ namespace TrenchBroom {
         m_ignoreNotifications(false),
         m_dragging(false) {}
 
-        ClipTool::~ClipTool() {
-            kdl::map_clear_and_delete(m_frontBrushes);
-            kdl::map_clear_and_delete(m_backBrushes);
-        }
+        ClipTool::~ClipTool() = default;
 
         const Grid& ClipTool::grid() const {
             return kdl::mem_lock(m_document)->grid();
@@ -606,25 +607,24 @@ namespace TrenchBroom {
 
         std::map<Model::Node*, std::vector<Model::Node*>> ClipTool::clipBrushes() {
             std::map<Model::Node*, std::vector<Model::Node*>> result;
-            if (!m_frontBrushes.empty()) {
-                if (keepFrontBrushes()) {
-                    result = kdl::map_merge(result, m_frontBrushes);
-                    m_frontBrushes.clear();
-                } else {
-                    kdl::map_clear_and_delete(m_frontBrushes);
+            if (keepFrontBrushes()) {
+                for (auto& clipResult : m_clipResults) {
+                    if (clipResult.frontBrush) {
+                        result[clipResult.brushNode->parent()].push_back(clipResult.frontBrush.release());
+                    }
                 }
             }
 
-            if (!m_backBrushes.empty()) {
-                if (keepBackBrushes()) {
-                    result = kdl::map_merge(result, m_backBrushes);
-                    m_backBrushes.clear();
-                } else {
-                    kdl::map_clear_and_delete(m_backBrushes);
+            if (keepBackBrushes()) {
+                for (auto& clipResult : m_clipResults) {
+                    if (clipResult.backBrush) {
+                        result[clipResult.brushNode->parent()].push_back(clipResult.backBrush.release());
+                    }
                 }
             }
 
-            resetStrategy();
+            m_strategy.reset();
+            rebuildBrushes();
             return result;
         }
 
@@ -732,54 +732,164 @@ namespace TrenchBroom {
         }
 
         void ClipTool::update() {
-            clearRenderers();
-            clearBrushes();
-
-            updateBrushes();
+            // the previous preview brushes are deleted only after the renderers have been updated, otherwise a new
+            // preview brush could be allocated at the address of a deleted one and the renderers would not notice
+            const auto previousClipResults = updateBrushes();
             updateRenderers();
 
             refreshViews();
         }
 
+        void ClipTool::rebuildBrushes() {
+            clearRenderers();
+            clearBrushes();
+            update();
+        }
+
         void ClipTool::clearBrushes() {
-            kdl::map_clear_and_delete(m_frontBrushes);
-            kdl::map_clear_and_delete(m_backBrushes);
+            m_clipPoints.clear();
+            m_clipResults.clear();
+        }
+
+        /**
+         * Returns below or above if the given bounds lie entirely on that side of the given plane, and inside if they
+         * intersect it.
+         */
+        static vm::plane_status boundsStatus(const vm::bbox3& bounds, const vm::plane3& plane) {
+            bool above = false;
+            bool below = false;
+            for (const auto x : { vm::bbox3::Corner::min, vm::bbox3::Corner::max }) {
+                for (const auto y : { vm::bbox3::Corner::min, vm::bbox3::Corner::max }) {
+                    for (const auto z : { vm::bbox3::Corner::min, vm::bbox3::Corner::max }) {
+                        const auto status = plane.point_status(bounds.corner(x, y, z));
+                        above |= status == vm::plane_status::above;
+                        below |= status == vm::plane_status::below;
+                    }
+                }
+            }
+
+            if (above && below) {
+                return vm::plane_status::inside;
+            } else {
+                return above ? vm::plane_status::above : vm::plane_status::below;
+            }
         }
 
-        void ClipTool::updateBrushes() {
+        std::vector<ClipTool::ClipResult> ClipTool::updateBrushes() {
             auto document = kdl::mem_lock(m_document);
 
             const auto& brushNodes = document->selectedNodes().brushes();
             const auto& worldBounds = document->worldBounds();
 
-            const auto clip = [&](auto* node, const auto& p1, const auto& p2, const auto& p3, auto& brushMap) {
-                auto brush = node->brush();
-                Model::BrushFace::create(p1, p2, p3, Model::BrushFaceAttributes(document->currentTextureName()), document->world()->mapFormat())
-                    .and_then([&](Model::BrushFace&& clipFace) {
-                            setFaceAttributes(brush.faces(), clipFace);
-                            return brush.clip(worldBounds, std::move(clipFace));
-                    }).and_then([&]() {
-                            brushMap[node->parent()].push_back(new Model::BrushNode(std::move(brush)));
-                    }).handle_errors([&](const Model::BrushError e) {
-                            document->error() << "Could not clip brush: " << e;
-                    });
-            };
-
+            std::vector<vm::vec3> clipPoints;
             if (canClip()) {
                 vm::vec3 point1, point2, point3;
                 const auto numPoints = m_strategy->getPoints(point1, point2, point3);
                 ensure(numPoints == 3, "invalid number of points");
+                clipPoints = { point1, point2, point3 };
+            }
+
+            // the cached results can only be reused if they belong to the selected brushes
+            const auto cacheValid = m_clipResults.size() == brushNodes.size() && std::equal(
+                std::begin(m_clipResults), std::end(m_clipResults), std::begin(brushNodes),
+                [](const ClipResult& clipResult, const Model::BrushNode* brushNode) { return clipResult.brushNode == brushNode; });
+            if (cacheValid && clipPoints == m_clipPoints) {
+                return {};
+            }
+
+            std::optional<Model::BrushFace> frontFace;
+            std::optional<Model::BrushFace> backFace;
+            if (!clipPoints.empty()) {
+                const auto attributes = Model::BrushFaceAttributes(document->currentTextureName());
+                const auto mapFormat = document->world()->mapFormat();
+                Model::BrushFace::create(clipPoints[0], clipPoints[1], clipPoints[2], attributes, mapFormat)
+                    .and_then([&](Model::BrushFace&& face) {
+                        frontFace = std::move(face);
+                        return Model::BrushFace::create(clipPoints[0], clipPoints[2], clipPoints[1], attributes, mapFormat);
+                    }).and_then([&](Model::BrushFace&& face) {
+                        backFace = std::move(face);
+                    }).handle_errors([&](const Model::BrushError e) {
+                        document->error() << "Could not clip brushes: " << e;
+                    });
+            }
 
-                for (auto* brushNode : brushNodes) {
-                    clip(brushNode, point1, point2, point3, m_frontBrushes);
-                    clip(brushNode, point1, point3, point2, m_backBrushes);
-               }
-            } else {
-                for (auto* brushNode : brushNodes) {
-                    auto* parent = brushNode->parent();
-                    m_frontBrushes[parent].push_back(new Model::BrushNode(brushNode->brush()));
+            const auto clip = [&](const Model::BrushNode* brushNode, const Model::BrushFace& clipFace, std::vector<Model::BrushError>& errors) {
+                auto brush = brushNode->brush();
+                auto face = clipFace;
+                setFaceAttributes(brush.faces(), face);
+
+                std::unique_ptr<Model::BrushNode> result;
+                brush.clip(worldBounds, std::move(face))
+                    .and_then([&]() {
+                        result = std::make_unique<Model::BrushNode>(std::move(brush));
+                    }).handle_errors([&](const Model::BrushError e) {
+                        errors.push_back(e);
+                    });
+                return result;
+            };
+
+            auto previousClipResults = std::exchange(m_clipResults, std::vector<ClipResult>(brushNodes.size()));
+            auto errors = std::vector<std::vector<Model::BrushError>>(brushNodes.size());
+
+            kdl::parallel_for(brushNodes.size(), [&](const size_t i) {
+                auto* brushNode = brushNodes[i];
+                auto& clipResult = m_clipResults[i];
+                clipResult.brushNode = brushNode;
+
+                if (clipPoints.empty()) {
+                    clipResult.type = ClipResultType::Front;
+                } else if (!frontFace || !backFace) {
+                    clipResult.type = ClipResultType::Split;
+                } else {
+                    switch (boundsStatus(brushNode->logicalBounds(), frontFace->boundary())) {
+                        case vm::plane_status::below:
+                            clipResult.type = ClipResultType::Front;
+                            break;
+                        case vm::plane_status::above:
+                            clipResult.type = ClipResultType::Back;
+                            break;
+                        case vm::plane_status::inside:
+                            clipResult.type = ClipResultType::Split;
+                            break;
+                        switchDefault()
+                    }
+                }
+
+                if (cacheValid && clipResult.type != ClipResultType::Split) {
+                    auto& previousClipResult = previousClipResults[i];
+                    if (clipResult.type == previousClipResult.type) {
+                        // the brush is still entirely on the same side of the clip plane, so its preview brush is unchanged
+                        clipResult.frontBrush = std::move(previousClipResult.frontBrush);
+                        clipResult.backBrush = std::move(previousClipResult.backBrush);
+                        return;
+                    }
+                }
+
+                switch (clipResult.type) {
+                    case ClipResultType::Front:
+                        clipResult.frontBrush = std::make_unique<Model::BrushNode>(brushNode->brush());
+                        break;
+                    case ClipResultType::Back:
+                        clipResult.backBrush = std::make_unique<Model::BrushNode>(brushNode->brush());
+                        break;
+                    case ClipResultType::Split:
+                        if (frontFace && backFace) {
+                            clipResult.frontBrush = clip(brushNode, *frontFace, errors[i]);
+                            clipResult.backBrush = clip(brushNode, *backFace, errors[i]);
+                        }
+                        break;
+                    switchDefault()
+                }
+            });
+
+            for (const auto& brushErrors : errors) {
+                for (const auto error : brushErrors) {
+                    document->error() << "Could not clip brush: " << error;
                 }
             }
+
+            m_clipPoints = std::move(clipPoints);
+            return previousClipResults;
         }
 
         void ClipTool::setFaceAttributes(const std::vector<Model::BrushFace>& faces, Model::BrushFace& toSet) const {
@@ -810,41 +920,23 @@ namespace TrenchBroom {
         }
 
         void ClipTool::updateRenderers() {
-            if (canClip()) {
-                if (keepFrontBrushes()) {
-                    addBrushesToRenderer(m_frontBrushes, *m_remainingBrushRenderer);
-                } else {
-                    addBrushesToRenderer(m_frontBrushes, *m_clippedBrushRenderer);
+            const auto keepFront = !canClip() || keepFrontBrushes();
+            const auto keepBack = !canClip() || keepBackBrushes();
+
+            std::vector<Model::BrushNode*> remainingBrushes;
+            std::vector<Model::BrushNode*> clippedBrushes;
+            for (const auto& clipResult : m_clipResults) {
+                if (clipResult.frontBrush) {
+                    (keepFront ? remainingBrushes : clippedBrushes).push_back(clipResult.frontBrush.get());
                 }
-
-                if (keepBackBrushes()) {
-                    addBrushesToRenderer(m_backBrushes, *m_remainingBrushRenderer);
-                } else {
-                    addBrushesToRenderer(m_backBrushes, *m_clippedBrushRenderer);
+                if (clipResult.backBrush) {
+                    (keepBack ? remainingBrushes : clippedBrushes).push_back(clipResult.backBrush.get());
                 }
-            } else {
-                addBrushesToRenderer(m_frontBrushes, *m_remainingBrushRenderer);
-                addBrushesToRenderer(m_backBrushes, *m_remainingBrushRenderer);
             }
-        }
 
-        void ClipTool::addBrushesToRenderer(const std::map<Model::Node*, std::vector<Model::Node*>>& map, Renderer::BrushRenderer& renderer) {
-            std::vector<Model::BrushNode*> brushes;
-
-            for (const auto& [parent, nodes] : map) {
-                for (auto* node : nodes) {
-                    node->accept(kdl::overload(
-                        [] (const Model::WorldNode*)  {},
-                        [] (const Model::LayerNode*)  {},
-                        [] (const Model::GroupNode*)  {},
-                        [] (const Model::EntityNode*) {},
-                        [&](Model::BrushNode* brush)  { brushes.push_back(brush); },
-                        [] (Model::PatchNode*)        {}
-                    ));
-                }
-            }
-            
-            renderer.addBrushes(brushes);
+            // only the preview brushes that are new to a renderer are invalidated, the others keep their vertex data
+            m_remainingBrushRenderer->setBrushes(remainingBrushes);
+            m_clippedBrushRenderer->setBrushes(clippedBrushes);
         }
 
         bool ClipTool::keepFrontBrushes() const {
@@ -900,25 +992,25 @@ namespace TrenchBroom {
 
         void ClipTool::selectionDidChange(const Selection&) {
             if (!m_ignoreNotifications) {
-                update();
+                rebuildBrushes();
             }
         }
 
         void ClipTool::nodesWillChange(const std::vector<Model::Node*>&) {
             if (!m_ignoreNotifications) {
-                update();
+                rebuildBrushes();
             }
         }
 
         void ClipTool::nodesDidChange(const std::vector<Model::Node*>&) {
             if (!m_ignoreNotifications) {
-                update();
+                rebuildBrushes();
             }
         }
 
         void ClipTool::brushFacesDidChange(const std::vector<Model::BrushFaceHandle>&) {
             if (!m_ignoreNotifications) {
-                update();
+                rebuildBrushes();
             }
         }
     }
@@ -23,6 +23,8 @@
 #include "Model/HitType.h"
 #include "View/Tool.h"
 
+#include <vecmath/vec.h>
+
 #include <map>
 #include <memory>
 #include <vector>
@@ -31,6 +33,7 @@ namespace TrenchBroom {
     namespace Model {
         class BrushFace;
         class BrushFaceHandle;
+        class BrushNode;
         class Node;
         class PickResult;
     }
@@ -112,14 +115,37 @@ namespace TrenchBroom {
 
             class PointClipStrategy;
             class FaceClipStrategy;
+
+            enum class ClipResultType {
+                /** The brush lies entirely on the front side of the clip plane, or there is no clip plane. */
+                Front,
+                /** The brush lies entirely on the back side of the clip plane. */
+                Back,
+                /** The brush was clipped into a front and a back part. */
+                Split
+            };
+
+            /**
+             * The preview brushes computed for a selected brush. A brush that lies entirely on one side of the clip
+             * plane is copied to that side without clipping it, and its preview brush is reused as long as it stays on
+             * that side.
+             */
+            struct ClipResult {
+                Model::BrushNode* brushNode;
+                ClipResultType type;
+                std::unique_ptr<Model::BrushNode> frontBrush;
+                std::unique_ptr<Model::BrushNode> backBrush;
+            };
         private:
             std::weak_ptr<MapDocument> m_document;
 
             ClipSide m_clipSide;
             std::unique_ptr<ClipStrategy> m_strategy;
 
-            std::map<Model::Node*, std::vector<Model::Node*>> m_frontBrushes;
-            std::map<Model::Node*, std::vector<Model::Node*>> m_backBrushes;
+            /** The points that m_clipResults were computed for, empty if there was no clip plane. */
+            std::vector<vm::vec3> m_clipPoints;
+            /** The clip results of the selected brushes, in selection order. */
+            std::vector<ClipResult> m_clipResults;
 
             std::unique_ptr<Renderer::BrushRenderer> m_remainingBrushRenderer;
             std::unique_ptr<Renderer::BrushRenderer> m_clippedBrushRenderer;
@@ -169,15 +195,15 @@ namespace TrenchBroom {
         private:
             void resetStrategy();
             void update();
+            void rebuildBrushes();
 
             void clearBrushes();
-            void updateBrushes();
+            std::vector<ClipResult> updateBrushes();
 
             void setFaceAttributes(const std::vector<Model::BrushFace>& faces, Model::BrushFace& toSet) const;
 
             void clearRenderers();
             void updateRenderers();
-            void addBrushesToRenderer(const std::map<Model::Node*, std::vector<Model::Node*>>& map, Renderer::BrushRenderer& renderer);
 
             bool keepFrontBrushes() const;
             bool keepBackBrushes() const;
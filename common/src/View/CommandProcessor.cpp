@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "Notifier.h"
+#include "Profiler.h"
 #include "View/Command.h"
 #include "View/UndoableCommand.h"
 
@@ -177,6 +178,7 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<CommandResult> CommandProcessor::executeAndStore(std::unique_ptr<UndoableCommand> command) {
+            TB_PROFILE_SCOPE("CommandProcessor::executeAndStore");
             return executeAndStoreCommand(std::move(command), true).commandResult;
         }
 
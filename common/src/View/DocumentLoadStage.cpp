@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DocumentLoadStage.h"
+
+#include "Macros.h"
+
+#include <ostream>
+
+namespace TrenchBroom {
+    namespace View {
+        std::ostream& operator<<(std::ostream& str, const DocumentLoadStage stage) {
+            switch (stage) {
+                case DocumentLoadStage::World:
+                    str << "world";
+                    break;
+                case DocumentLoadStage::EntityDefinitions:
+                    str << "entity definitions";
+                    break;
+                case DocumentLoadStage::Textures:
+                    str << "textures";
+                    break;
+                case DocumentLoadStage::BindEntityDefinitions:
+                    str << "bind entity definitions";
+                    break;
+                case DocumentLoadStage::BindTextures:
+                    str << "bind textures";
+                    break;
+                case DocumentLoadStage::EntityModels:
+                    str << "entity models";
+                    break;
+                case DocumentLoadStage::IssueGenerators:
+                    str << "issue generators";
+                    break;
+                case DocumentLoadStage::SmartTags:
+                    str << "smart tags";
+                    break;
+                switchDefault()
+            }
+            return str;
+        }
+    }
+}
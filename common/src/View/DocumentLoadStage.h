@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * The stages of loading a document.
+         *
+         * The world is parsed first because the entity definition file and the texture collections are named by the
+         * properties of the world entity. Then entity definitions and texture collections are loaded concurrently on
+         * worker threads, while the stages which bind the loaded assets to the nodes run on the thread that loads the
+         * document as soon as the assets they depend on are available. Entity models are loaded last because they are
+         * read from the game file system, which the texture loader may be using.
+         */
+        enum class DocumentLoadStage {
+            World,
+            EntityDefinitions,
+            Textures,
+            BindEntityDefinitions,
+            BindTextures,
+            EntityModels,
+            IssueGenerators,
+            SmartTags
+        };
+
+        std::ostream& operator<<(std::ostream& str, DocumentLoadStage stage);
+
+        using DocumentLoadDuration = std::chrono::duration<double, std::milli>;
+
+        /**
+         * Called on the thread that loads the document whenever a stage has finished, with the time the stage took.
+         * Stages which run concurrently are reported in the order in which they finish.
+         */
+        using DocumentLoadProgress = std::function<void(DocumentLoadStage stage, DocumentLoadDuration duration)>;
+    }
+}
@@ -46,7 +46,6 @@
 #include <kdl/overload.h>
 #include <kdl/skip_iterator.h>
 #include <kdl/string_compare.h>
-#include <kdl/vector_utils.h>
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
@@ -267,28 +266,17 @@ namespace TrenchBroom {
             using BoundsVertex = Renderer::GLVertexTypes::P3C4::Vertex;
             std::vector<BoundsVertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
-                const auto& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
-                        const auto& row = group[j];
-                        if (row.intersectsY(y, height)) {
-                            for (size_t k = 0; k < row.size(); ++k) {
-                                const auto& cell = row[k];
-                                const auto* definition = cellData(cell).entityDefinition;
-                                auto* modelRenderer = cellData(cell).modelRenderer;
-
-                                if (modelRenderer == nullptr) {
-                                    const auto itemTrans = itemTransformation(cell, y, height);
-                                    const auto& color = definition->color();
-                                    CollectBoundsVertices<BoundsVertex> collect(itemTrans, color, vertices);
-                                    vm::bbox3f(definition->bounds()).for_each_edge(collect);
-                                }
-                            }
-                        }
-                    }
+            layout.visitCellsIntersectingY(y, height, [&](const Cell& cell) {
+                const auto* definition = cellData(cell).entityDefinition;
+                auto* modelRenderer = cellData(cell).modelRenderer;
+
+                if (modelRenderer == nullptr) {
+                    const auto itemTrans = itemTransformation(cell, y, height);
+                    const auto& color = definition->color();
+                    CollectBoundsVertices<BoundsVertex> collect(itemTrans, color, vertices);
+                    vm::bbox3f(definition->bounds()).for_each_edge(collect);
                 }
-            }
+            });
 
             Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::VaryingPCShader);
             Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::move(vertices));
@@ -307,26 +295,15 @@ namespace TrenchBroom {
 
             m_entityModelManager.prepare(vboManager());
 
-            for (size_t i = 0; i < layout.size(); ++i) {
-                const auto& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
-                        const auto& row = group[j];
-                        if (row.intersectsY(y, height)) {
-                            for (size_t k = 0; k < row.size(); ++k) {
-                                const auto& cell = row[k];
-                                auto* modelRenderer = cellData(cell).modelRenderer;
-
-                                if (modelRenderer != nullptr) {
-                                    const auto itemTrans = itemTransformation(cell, y, height);
-                                    Renderer::MultiplyModelMatrix multMatrix(transformation, itemTrans);
-                                    modelRenderer->render();
-                                }
-                            }
-                        }
-                    }
+            layout.visitCellsIntersectingY(y, height, [&](const Cell& cell) {
+                auto* modelRenderer = cellData(cell).modelRenderer;
+
+                if (modelRenderer != nullptr) {
+                    const auto itemTrans = itemTransformation(cell, y, height);
+                    Renderer::MultiplyModelMatrix multMatrix(transformation, itemTrans);
+                    modelRenderer->render();
                 }
-            }
+            });
         }
 
         void EntityBrowserView::renderNames(Layout& layout, const float y, const float height, const vm::mat4x4f& projection) {
@@ -343,15 +320,14 @@ namespace TrenchBroom {
             using Vertex = Renderer::GLVertexTypes::P2::Vertex;
             std::vector<Vertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.groupsIntersectingY(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    const LayoutBounds titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y))));
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.bottom() - y))));
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.bottom() - y))));
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.top() - y))));
-                }
+                const LayoutBounds titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y))));
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.bottom() - y))));
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.bottom() - y))));
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.top() - y))));
             }
 
             Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::move(vertices));
@@ -395,48 +371,42 @@ namespace TrenchBroom {
             const std::vector<Color> textColor{ pref(Preferences::BrowserTextColor) };
 
             StringMap stringVertices;
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.groupsIntersectingY(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    const auto& title = group.item();
-                    if (!title.empty()) {
-                        const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
-                        const auto offset = vm::vec2f(titleBounds.left() + 2.0f, height - (titleBounds.top() - y) - titleBounds.height());
-
-                        auto& font = fontManager().font(defaultDescriptor);
-                        const auto quads = font.quads(title, false, offset);
-                        const auto titleVertices = TextVertex::toList(
-                            quads.size() / 2,
-                            kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
-                            kdl::skip_iterator(std::begin(quads), std::end(quads), 1, 2),
-                            kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
-                        auto& allTitleVertices = stringVertices[defaultDescriptor];
-                        allTitleVertices = kdl::vec_concat(std::move(allTitleVertices), titleVertices);
-                    }
-
-                    for (size_t j = 0; j < group.size(); ++j) {
-                        const auto& row = group[j];
-                        if (row.intersectsY(y, height)) {
-                            for (unsigned int k = 0; k < row.size(); k++) {
-                                const auto& cell = row[k];
-                                const auto titleBounds = cell.titleBounds();
-                                const auto offset = vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y) - titleBounds.height());
-
-                                Renderer::TextureFont& font = fontManager().font(cellData(cell).fontDescriptor);
-                                const auto quads = font.quads(cellData(cell).entityDefinition->name(), false, offset);
-                                const auto titleVertices = TextVertex::toList(
-                                    quads.size() / 2,
-                                    kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
-                                    kdl::skip_iterator(std::begin(quads), std::end(quads), 1, 2),
-                                    kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
-                                auto& allTitleVertices = stringVertices[cellData(cell).fontDescriptor];
-                                allTitleVertices = kdl::vec_concat(std::move(allTitleVertices), titleVertices);
-                            }
-                        }
-                    }
+                const auto& title = group.item();
+                if (!title.empty()) {
+                    const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
+                    const auto offset = vm::vec2f(titleBounds.left() + 2.0f, height - (titleBounds.top() - y) - titleBounds.height());
+
+                    auto& font = fontManager().font(defaultDescriptor);
+                    const auto quads = font.quads(title, false, offset);
+                    const auto titleVertices = TextVertex::toList(
+                        quads.size() / 2,
+                        kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
+                        kdl::skip_iterator(std::begin(quads), std::end(quads), 1, 2),
+                        kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
+                    auto& allTitleVertices = stringVertices[defaultDescriptor];
+                    allTitleVertices.insert(std::end(allTitleVertices), std::begin(titleVertices), std::end(titleVertices));
                 }
             }
 
+            layout.visitCellsIntersectingY(y, height, [&](const Cell& cell) {
+                const auto& data = cellData(cell);
+                const auto titleBounds = cell.titleBounds();
+                const auto offset = vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y) - titleBounds.height());
+
+                Renderer::TextureFont& font = fontManager().font(data.fontDescriptor);
+                const auto quads = font.quads(data.entityDefinition->name(), false, offset);
+                const auto titleVertices = TextVertex::toList(
+                    quads.size() / 2,
+                    kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
+                    kdl::skip_iterator(std::begin(quads), std::end(quads), 1, 2),
+                    kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
+                auto& allTitleVertices = stringVertices[data.fontDescriptor];
+                allTitleVertices.insert(std::end(allTitleVertices), std::begin(titleVertices), std::end(titleVertices));
+            });
+
             return stringVertices;
         }
 
@@ -26,12 +26,12 @@
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
-#include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 #include <kdl/vector_set.h>
 
@@ -119,23 +119,17 @@ namespace TrenchBroom {
             if (document->world() != nullptr) {
                 const auto& issueGenerators = document->world()->registeredIssueGenerators();
                 
+                const auto nodes = Model::collectNodes({document->world()});
+                Model::Node::validateIssues(nodes, issueGenerators);
+
                 auto issues = std::vector<Model::Issue*>{};
-                const auto collectIssues = [&](auto* node) {
+                for (auto* node : nodes) {
                     for (auto* issue : node->issues(issueGenerators)) {
                         if (m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenGenerators) == 0)) {
                             issues.push_back(issue);
                         }
                     }
-                };
-
-                document->world()->accept(kdl::overload(
-                    [&](auto&& thisLambda, Model::WorldNode* world)   { collectIssues(world); world->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::LayerNode* layer)   { collectIssues(layer); layer->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::GroupNode* group)   { collectIssues(group); group->visitChildren(thisLambda); },
-                    [&](auto&& thisLambda, Model::EntityNode* entity) { collectIssues(entity); entity->visitChildren(thisLambda); },
-                    [&](Model::BrushNode* brush)                      { collectIssues(brush); },
-                    [&](Model::PatchNode* patch)                      { collectIssues(patch); }
-                ));
+                }
 
                 issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) { return lhs->seqId() > rhs->seqId(); });
                 m_tableModel->setIssues(std::move(issues));
@@ -33,6 +33,7 @@
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
 #include "EL/ELExceptions.h"
+#include "IO/BinaryNodeFormat.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/GameConfigParser.h"
@@ -71,6 +72,7 @@
 #include "Model/Node.h"
 #include "Model/NodeContents.h"
 #include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/PatchGridCache.h"
 #include "Model/PatchNode.h"
 #include "Model/PropertyKeyWithDoubleQuotationMarksIssueGenerator.h"
 #include "Model/PropertyValueWithDoubleQuotationMarksIssueGenerator.h"
@@ -105,6 +107,7 @@
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/result.h>
 #include <kdl/result_for_each.h>
@@ -118,10 +121,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib> // for std::abs
+#include <future>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -312,6 +320,7 @@ namespace TrenchBroom {
             pref(Preferences::TextureMagFilter),
             pref(Preferences::TextureMinFilter), logger())),
         m_tagManager(std::make_unique<Model::TagManager>()),
+        m_patchGridCache(std::make_unique<Model::PatchGridCache>()),
         m_editorContext(std::make_unique<Model::EditorContext>()),
         m_grid(std::make_unique<Grid>(4)),
         m_path(DefaultDocumentName),
@@ -492,16 +501,35 @@ namespace TrenchBroom {
             documentWasNewedNotifier(this);
         }
 
-        void MapDocument::loadDocument(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path) {
+        static void reportLoadStage(const DocumentLoadProgress& progress, const DocumentLoadStage stage, const DocumentLoadDuration duration) {
+            if (progress) {
+                progress(stage, duration);
+            }
+        }
+
+        template <typename F>
+        static void runLoadStage(const DocumentLoadProgress& progress, const DocumentLoadStage stage, F&& fun) {
+            const auto startTime = std::chrono::steady_clock::now();
+            fun();
+            reportLoadStage(progress, stage, std::chrono::steady_clock::now() - startTime);
+        }
+
+        void MapDocument::loadDocument(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path, const DocumentLoadProgress& progress) {
             info("Loading document from " + path.asString());
 
             clearRepeatableCommands();
             clearDocument();
-            loadWorld(mapFormat, worldBounds, game, path);
+            runLoadStage(progress, DocumentLoadStage::World, [&]() {
+                loadWorld(mapFormat, worldBounds, game, path);
+            });
 
-            loadAssets();
-            registerIssueGenerators();
-            registerSmartTags();
+            loadAssets(progress);
+            runLoadStage(progress, DocumentLoadStage::IssueGenerators, [&]() {
+                registerIssueGenerators();
+            });
+            runLoadStage(progress, DocumentLoadStage::SmartTags, [&]() {
+                registerSmartTags();
+            });
             createTagActions();
 
             documentWasLoadedNotifier(this);
@@ -541,6 +569,7 @@ namespace TrenchBroom {
                 unloadAssets();
                 clearTagActions();
                 clearWorld();
+                m_patchGridCache->clear();
                 clearModificationCount();
 
                 documentWasClearedNotifier(this);
@@ -564,6 +593,10 @@ namespace TrenchBroom {
             return stream.str();
         }
 
+        std::string MapDocument::serializeSelectedNodesBinary() {
+            return IO::BinaryNodeFormat::writeNodes(m_selectedNodes.nodes(), m_world->mapFormat(), m_worldBounds);
+        }
+
         PasteType MapDocument::paste(const std::string& str) {
             // Try parsing as entities, then as brushes, in all compatible formats
             const std::vector<Model::Node*> nodes = m_game->parseNodes(str, m_world->mapFormat(), m_worldBounds, logger());
@@ -586,6 +619,14 @@ namespace TrenchBroom {
             return PasteType::Failed;
         }
 
+        std::optional<PasteType> MapDocument::pasteBinary(const std::string& data) {
+            const auto nodes = IO::BinaryNodeFormat::readNodes(data, m_world->mapFormat(), m_worldBounds);
+            if (!nodes) {
+                return std::nullopt;
+            }
+            return !nodes->empty() && pasteNodes(*nodes) ? PasteType::Node : PasteType::Failed;
+        }
+
         std::vector<Model::IdType> allPersistentGroupIds(const Model::Node& root) {
             auto result = std::vector<Model::IdType>{};
             root.accept(kdl::overload(
@@ -3038,12 +3079,179 @@ namespace TrenchBroom {
             info("Reloading entity definitions");
         }
 
-        void MapDocument::loadAssets() {
-            loadEntityDefinitions();
-            setEntityDefinitions();
-            loadEntityModels();
-            loadTextures();
-            setTextures();
+        /**
+         * Loads the entity definitions from the file given by the given spec. This function doesn't access the
+         * document and only reads from the disk, so it can run on a worker thread.
+         *
+         * @return the loaded definitions, or nothing if the definitions could not be loaded
+         */
+        static std::optional<std::vector<Assets::EntityDefinition*>> loadEntityDefinitionFile(const Model::Game& game, const Assets::EntityDefinitionFileSpec& spec, const std::vector<IO::Path>& searchPaths, Logger& logger) {
+            try {
+                const IO::Path path = game.findEntityDefinitionFile(spec, searchPaths);
+                IO::SimpleParserStatus status(logger);
+                auto definitions = game.loadEntityDefinitions(status, path);
+                logger.info("Loaded entity definition file " + path.lastComponent().asString());
+                return definitions;
+            } catch (const Exception& e) {
+                if (spec.builtin()) {
+                    logger.error() << "Could not load builtin entity definition file '" << spec.path() << "': " << e.what();
+                } else {
+                    logger.error() << "Could not load external entity definition file '" << spec.path() << "': " << e.what();
+                }
+                return std::nullopt;
+            }
+        }
+
+        /**
+         * Loads the texture collections named by the given world entity into the given texture manager. This function
+         * doesn't access the document, so it can run on a worker thread if the texture manager isn't shared.
+         */
+        static void loadTextureCollections(const Model::Game& game, const Model::Entity& worldEntity, const IO::Path& documentPath, Assets::TextureManager& textureManager, Logger& logger) {
+            try {
+                const IO::Path docDir = documentPath.isEmpty() ? IO::Path() : documentPath.deleteLastComponent();
+                game.loadTextureCollections(worldEntity, docDir, textureManager, logger);
+            } catch (const Exception& e) {
+                logger.error(e.what());
+            }
+        }
+
+        struct LoadedEntityDefinitions {
+            std::optional<std::vector<Assets::EntityDefinition*>> definitions;
+            CachingLogger logger;
+            DocumentLoadDuration duration;
+        };
+
+        struct LoadedTextureCollections {
+            std::vector<Assets::TextureCollection> collections;
+            CachingLogger logger;
+            DocumentLoadDuration duration;
+        };
+
+        /**
+         * Lets the document wait until one of the asset loaders that run concurrently has finished. A loader marks
+         * itself as finished just before its result becomes available in its future, so the document may still have to
+         * wait briefly for the result.
+         */
+        class AssetLoaderSignal {
+        public:
+            enum class Loader {
+                EntityDefinitions,
+                Textures
+            };
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::vector<Loader> m_finished;
+        public:
+            /**
+             * Marks the given loader as finished when it is destroyed, even if the loader throws.
+             */
+            class FinishedGuard {
+            private:
+                AssetLoaderSignal& m_signal;
+                Loader m_loader;
+            public:
+                FinishedGuard(AssetLoaderSignal& signal, const Loader loader) :
+                m_signal(signal),
+                m_loader(loader) {}
+
+                ~FinishedGuard() {
+                    {
+                        const auto lock = std::lock_guard<std::mutex>(m_signal.m_mutex);
+                        m_signal.m_finished.push_back(m_loader);
+                    }
+                    m_signal.m_condition.notify_one();
+                }
+            };
+
+            /**
+             * Blocks until a loader has finished that wasn't returned by a previous call, and returns it.
+             */
+            Loader waitForNextFinished() {
+                auto lock = std::unique_lock<std::mutex>(m_mutex);
+                m_condition.wait(lock, [&]() { return !m_finished.empty(); });
+
+                const auto loader = m_finished.front();
+                m_finished.erase(std::begin(m_finished));
+                return loader;
+            }
+        };
+
+        void MapDocument::loadAssets(const DocumentLoadProgress& progress) {
+            // Entity definitions and texture collections only depend on the world entity, so they are loaded
+            // concurrently. The workers must not access the document, so they log to their own loggers, which are
+            // replayed into the document's log when the results are bound on this thread.
+            // the signal must outlive the futures, whose destructors wait for the loaders
+            auto signal = AssetLoaderSignal();
+
+            const auto game = m_game;
+            const auto definitionFileSpec = entityDefinitionFile();
+            const auto searchPaths = externalSearchPaths();
+            auto definitionsFuture = std::async(std::launch::async, [&signal, game, definitionFileSpec, searchPaths]() {
+                const auto finished = AssetLoaderSignal::FinishedGuard(signal, AssetLoaderSignal::Loader::EntityDefinitions);
+                const auto startTime = std::chrono::steady_clock::now();
+                LoadedEntityDefinitions result;
+                result.definitions = loadEntityDefinitionFile(*game, definitionFileSpec, searchPaths, result.logger);
+                result.duration = std::chrono::steady_clock::now() - startTime;
+                return result;
+            });
+
+            const auto worldEntity = m_world->entity();
+            const auto documentPath = m_path;
+            const int magFilter = pref(Preferences::TextureMagFilter);
+            const int minFilter = pref(Preferences::TextureMinFilter);
+            auto texturesFuture = std::async(std::launch::async, [&signal, game, worldEntity, documentPath, magFilter, minFilter]() {
+                const auto finished = AssetLoaderSignal::FinishedGuard(signal, AssetLoaderSignal::Loader::Textures);
+                const auto startTime = std::chrono::steady_clock::now();
+                LoadedTextureCollections result;
+                Assets::TextureManager textureManager(magFilter, minFilter, result.logger);
+                loadTextureCollections(*game, worldEntity, documentPath, textureManager, result.logger);
+                result.collections = textureManager.releaseCollections();
+                result.duration = std::chrono::steady_clock::now() - startTime;
+                return result;
+            });
+
+            const auto bindEntityDefinitions = [&](LoadedEntityDefinitions loaded) {
+                loaded.logger.setParentLogger(this);
+                reportLoadStage(progress, DocumentLoadStage::EntityDefinitions, loaded.duration);
+
+                runLoadStage(progress, DocumentLoadStage::BindEntityDefinitions, [&]() {
+                    if (loaded.definitions) {
+                        m_entityDefinitionManager->setDefinitions(*loaded.definitions);
+                        createEntityDefinitionActions();
+                    }
+                    setEntityDefinitions();
+                });
+            };
+
+            const auto bindTextures = [&](LoadedTextureCollections loaded) {
+                loaded.logger.setParentLogger(this);
+                reportLoadStage(progress, DocumentLoadStage::Textures, loaded.duration);
+
+                runLoadStage(progress, DocumentLoadStage::BindTextures, [&]() {
+                    m_textureManager->setTextureCollections(std::move(loaded.collections));
+                    setTextures();
+                });
+            };
+
+            // bind whichever result becomes available first
+            for (size_t i = 0u; i < 2u; ++i) {
+                switch (signal.waitForNextFinished()) {
+                    case AssetLoaderSignal::Loader::EntityDefinitions:
+                        bindEntityDefinitions(definitionsFuture.get());
+                        break;
+                    case AssetLoaderSignal::Loader::Textures:
+                        bindTextures(texturesFuture.get());
+                        break;
+                    switchDefault()
+                }
+            }
+
+            // entity models are loaded from the game file system, which the texture loader may also be reading
+            // from, so we wait until the texture collections are loaded
+            runLoadStage(progress, DocumentLoadStage::EntityModels, [&]() {
+                loadEntityModels();
+            });
         }
 
         void MapDocument::unloadAssets() {
@@ -3053,20 +3261,9 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadEntityDefinitions() {
-            const Assets::EntityDefinitionFileSpec spec = entityDefinitionFile();
-            try {
-                const IO::Path path = m_game->findEntityDefinitionFile(spec, externalSearchPaths());
-                IO::SimpleParserStatus status(logger());
-                m_entityDefinitionManager->loadDefinitions(path, *m_game, status);
-                info("Loaded entity definition file " + path.lastComponent().asString());
-
+            if (const auto definitions = loadEntityDefinitionFile(*m_game, entityDefinitionFile(), externalSearchPaths(), logger())) {
+                m_entityDefinitionManager->setDefinitions(*definitions);
                 createEntityDefinitionActions();
-            } catch (const Exception& e) {
-                if (spec.builtin()) {
-                    error() << "Could not load builtin entity definition file '" << spec.path() << "': " << e.what();
-                } else {
-                    error() << "Could not load external entity definition file '" << spec.path() << "': " << e.what();
-                }
             }
         }
 
@@ -3093,12 +3290,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadTextures() {
-            try {
-                const IO::Path docDir = m_path.isEmpty() ? IO::Path() : m_path.deleteLastComponent();
-                m_game->loadTextureCollections(m_world->entity(), docDir, *m_textureManager, logger());
-            } catch (const Exception& e) {
-                error(e.what());
-            }
+            loadTextureCollections(*m_game, m_world->entity(), m_path, *m_textureManager, logger());
         }
 
         void MapDocument::unloadTextures() {
@@ -3106,25 +3298,64 @@ namespace TrenchBroom {
             m_textureManager->clear();
         }
 
-        static auto makeSetTexturesVisitor(Assets::TextureManager& manager) {
-            return kdl::overload(
+        /** Below this number of brushes, binding textures on several threads doesn't pay off. */
+        static constexpr size_t ParallelTextureBindingThreshold = 1024;
+
+        /**
+         * Binds the textures to the faces of the given brushes. If there are enough brushes, they are split into one
+         * chunk per hardware thread and the chunks are bound in parallel. Every chunk accumulates its own changes to the
+         * texture usage counts, which are merged and applied once all chunks are done.
+         */
+        static void bindBrushTextures(const std::vector<Model::BrushNode*>& brushNodes, Assets::TextureManager& manager) {
+            const size_t chunkCount = brushNodes.size() < ParallelTextureBindingThreshold
+                ? size_t(1)
+                : std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+            const size_t chunkSize = (brushNodes.size() + chunkCount - 1u) / chunkCount;
+
+            std::vector<Assets::TextureUsageCounts> usageCounts(chunkCount);
+            const auto bindChunk = [&](const size_t chunk) {
+                const size_t first = chunk * chunkSize;
+                const size_t last = std::min(first + chunkSize, brushNodes.size());
+                for (size_t i = first; i < last; ++i) {
+                    Model::BrushNode* brushNode = brushNodes[i];
+                    const Model::Brush& brush = brushNode->brush();
+                    for (size_t j = 0u; j < brush.faceCount(); ++j) {
+                        // looking up a texture only reads the texture manager's index
+                        Assets::Texture* texture = manager.texture(brush.face(j).attributes().textureName());
+                        brushNode->setFaceTexture(j, texture, usageCounts[chunk]);
+                    }
+                }
+            };
+
+            if (chunkCount == 1u) {
+                bindChunk(0u);
+            } else {
+                kdl::parallel_for(chunkCount, bindChunk);
+            }
+
+            for (size_t i = 1u; i < chunkCount; ++i) {
+                usageCounts.front().merge(usageCounts[i]);
+            }
+            usageCounts.front().apply();
+        }
+
+        static void bindTextures(const std::vector<Model::Node*>& nodes, Assets::TextureManager& manager) {
+            std::vector<Model::BrushNode*> brushNodes;
+            Model::Node::visitAll(nodes, kdl::overload(
                 [] (auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
                 [] (auto&& thisLambda, Model::EntityNode* entity) { entity->visitChildren(thisLambda); },
-                [&](Model::BrushNode* brushNode) { 
-                    const Model::Brush& brush = brushNode->brush();
-                    for (size_t i = 0u; i < brush.faceCount(); ++i) {
-                        const Model::BrushFace& face = brush.face(i);
-                        Assets::Texture* texture = manager.texture(face.attributes().textureName());
-                        brushNode->setFaceTexture(i, texture);
-                    }
+                [&](Model::BrushNode* brushNode) {
+                    brushNodes.push_back(brushNode);
                 },
                 [&](Model::PatchNode* patchNode) { 
                     auto* texture = manager.texture(patchNode->patch().textureName());
                     patchNode->setTexture(texture);
                 }
-            );
+            ));
+
+            bindBrushTextures(brushNodes, manager);
         }
 
         static auto makeUnsetTexturesVisitor() {
@@ -3146,12 +3377,12 @@ namespace TrenchBroom {
         }
 
         void MapDocument::setTextures() {
-            m_world->accept(makeSetTexturesVisitor(*m_textureManager));
+            bindTextures({m_world.get()}, *m_textureManager);
             textureUsageCountsDidChangeNotifier();
         }
 
         void MapDocument::setTextures(const std::vector<Model::Node*>& nodes) {
-            Model::Node::visitAll(nodes, makeSetTexturesVisitor(*m_textureManager));
+            bindTextures(nodes, *m_textureManager);
             textureUsageCountsDidChangeNotifier();
         }
 
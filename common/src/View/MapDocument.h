@@ -27,6 +27,7 @@
 #include "Model/NodeCollection.h"
 #include "Model/NodeContents.h"
 #include "View/CachingLogger.h"
+#include "View/DocumentLoadStage.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/bbox.h>
@@ -62,6 +63,7 @@ namespace TrenchBroom {
         class Game;
         class Issue;
         enum class MapFormat;
+        class PatchGridCache;
         class PickResult;
         class PointFile;
         class PortalFile;
@@ -102,6 +104,7 @@ namespace TrenchBroom {
             std::unique_ptr<Assets::EntityModelManager> m_entityModelManager;
             std::unique_ptr<Assets::TextureManager> m_textureManager;
             std::unique_ptr<Model::TagManager> m_tagManager;
+            std::unique_ptr<Model::PatchGridCache> m_patchGridCache;
 
             std::unique_ptr<Model::EditorContext> m_editorContext;
             std::unique_ptr<Grid> m_grid;
@@ -257,7 +260,7 @@ namespace TrenchBroom {
             void createEntityDefinitionActions();
         public: // new, load, save document
             void newDocument(Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game);
-            void loadDocument(Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path);
+            void loadDocument(Model::MapFormat mapFormat, const vm::bbox3& worldBounds, std::shared_ptr<Model::Game> game, const IO::Path& path, const DocumentLoadProgress& progress = DocumentLoadProgress());
             void saveDocument();
             void saveDocumentAs(const IO::Path& path);
             void saveDocumentTo(const IO::Path& path);
@@ -271,7 +274,21 @@ namespace TrenchBroom {
             std::string serializeSelectedNodes();
             std::string serializeSelectedBrushFaces();
 
+            /**
+             * Serializes the selected nodes in the binary node format, which can only be pasted into a document with
+             * the same map format and world bounds in this process, but avoids parsing and rebuilding the brush
+             * geometry when pasting.
+             */
+            std::string serializeSelectedNodesBinary();
+
             PasteType paste(const std::string& str);
+
+            /**
+             * Pastes nodes serialized by serializeSelectedNodesBinary. Returns an empty optional if the given data
+             * cannot be read, e.g. because it was written for another map format, so that the caller can fall back to
+             * the text representation.
+             */
+            std::optional<PasteType> pasteBinary(const std::string& data);
         private:
             bool pasteNodes(const std::vector<Model::Node*>& nodes);
             bool pasteBrushFaces(const std::vector<Model::BrushFace>& faces);
@@ -530,7 +547,7 @@ namespace TrenchBroom {
 
             void reloadEntityDefinitions();
         private:
-            void loadAssets();
+            void loadAssets(const DocumentLoadProgress& progress = DocumentLoadProgress());
             void unloadAssets();
 
             void loadEntityDefinitions();
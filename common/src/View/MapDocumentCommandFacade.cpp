@@ -37,6 +37,7 @@
 #include "Model/Issue.h"
 #include "Model/LayerNode.h"
 #include "Model/ModelUtils.h"
+#include "Model/PatchGridCache.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "View/CommandProcessor.h"
@@ -340,6 +341,15 @@ namespace TrenchBroom {
             Notifier<>::NotifyBeforeAndAfter notifyEntityDefinitions(notifyEntityDefinitionsChange, entityDefinitionsWillChangeNotifier, entityDefinitionsDidChangeNotifier);
             Notifier<>::NotifyBeforeAndAfter notifyMods(notifyModsChange, modsWillChangeNotifier, modsDidChangeNotifier);
 
+            // tessellate the new patches in parallel before they are set one by one
+            auto patches = std::vector<const Model::BezierPatch*>{};
+            for (const auto& pair : nodesToSwap) {
+                if (const auto* patch = std::get_if<Model::BezierPatch>(&pair.second.get())) {
+                    patches.push_back(patch);
+                }
+            }
+            Model::precomputePatchGrids(patches, *m_patchGridCache);
+
             for (auto& pair : nodesToSwap) {
                 auto* node = pair.first;
                 auto& contents = pair.second.get();
@@ -350,7 +360,7 @@ namespace TrenchBroom {
                     [&](Model::GroupNode* groupNode)   -> Model::NodeContents { return Model::NodeContents(groupNode->setGroup(std::get<Model::Group>(std::move(contents)))); },
                     [&](Model::EntityNode* entityNode) -> Model::NodeContents { return Model::NodeContents(entityNode->setEntity(std::get<Model::Entity>(std::move(contents)))); },
                     [&](Model::BrushNode* brushNode)   -> Model::NodeContents { return Model::NodeContents(brushNode->setBrush(std::get<Model::Brush>(std::move(contents)))); },
-                    [&](Model::PatchNode* patchNode)   -> Model::NodeContents { return Model::NodeContents(patchNode->setPatch(std::get<Model::BezierPatch>(std::move(contents)))); }
+                    [&](Model::PatchNode* patchNode)   -> Model::NodeContents { return Model::NodeContents(patchNode->setPatch(std::get<Model::BezierPatch>(std::move(contents)), *m_patchGridCache)); }
                 ));
             }
 
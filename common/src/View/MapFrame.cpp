@@ -24,7 +24,9 @@
 #include "FileLogger.h"
 #include "Preferences.h"
 #include "PreferenceManager.h"
+#include "Profiler.h"
 #include "TrenchBroomApp.h"
+#include "IO/IOUtils.h"
 #include "IO/PathQt.h"
 #include "Model/BrushNode.h"
 #include "Model/EditorContext.h"
@@ -80,6 +82,7 @@
 
 #include <cassert>
 #include <chrono>
+#include <fstream>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -187,6 +190,7 @@ namespace TrenchBroom {
             // let's trigger a final autosave before releasing the document
             NullLogger logger;
             m_autosaver->triggerAutosave(logger);
+            m_autosaver->waitForAutosave(logger);
 
             m_document->setViewEffectsService(nullptr);
             m_document.reset();
@@ -801,8 +805,12 @@ namespace TrenchBroom {
             if (!confirmOrDiscardChanges() || !closeCompileDialog()) {
                 return false;
             }
+            const auto progress = [&](const DocumentLoadStage stage, const DocumentLoadDuration duration) {
+                logger().debug() << "Loaded " << stage << " in " << static_cast<long>(duration.count()) << "ms";
+            };
+
             const auto startTime = std::chrono::high_resolution_clock::now();
-            m_document->loadDocument(mapFormat, MapDocument::DefaultWorldBounds, game, path);
+            m_document->loadDocument(mapFormat, MapDocument::DefaultWorldBounds, game, path, progress);
             const auto endTime = std::chrono::high_resolution_clock::now();
 
             logger().info() << "Loaded " << m_document->path() << " in "
@@ -1102,17 +1110,27 @@ namespace TrenchBroom {
             }
         }
 
+        static const auto BinaryNodesMimeType = QString("application/x-trenchbroom-nodes");
+
         void MapFrame::copyToClipboard() {
             QClipboard *clipboard = QApplication::clipboard();
 
             std::string str;
+            std::string binary;
             if (m_document->hasSelectedNodes()) {
                 str = m_document->serializeSelectedNodes();
+                binary = m_document->serializeSelectedNodesBinary();
             } else if (m_document->hasSelectedBrushFaces()) {
                 str = m_document->serializeSelectedBrushFaces();
             }
 
-            clipboard->setText(mapStringToUnicode(m_document->encoding(), str));
+            // the text is for other applications and instances, the binary data is a faster path for pasting nodes
+            auto* mimeData = new QMimeData();
+            mimeData->setText(mapStringToUnicode(m_document->encoding(), str));
+            if (!binary.empty()) {
+                mimeData->setData(BinaryNodesMimeType, QByteArray(binary.data(), static_cast<int>(binary.size())));
+            }
+            clipboard->setMimeData(mimeData);
         }
 
         bool MapFrame::canCutSelection() const {
@@ -1150,6 +1168,15 @@ namespace TrenchBroom {
 
         PasteType MapFrame::paste() {
             auto *clipboard = QApplication::clipboard();
+
+            const auto* mimeData = clipboard->mimeData();
+            if (mimeData != nullptr && mimeData->hasFormat(BinaryNodesMimeType)) {
+                const auto data = mimeData->data(BinaryNodesMimeType);
+                if (const auto result = m_document->pasteBinary(std::string(data.constData(), static_cast<size_t>(data.size())))) {
+                    return *result;
+                }
+            }
+
             const auto qtext = clipboard->text();
 
             if (qtext.isEmpty()) {
@@ -1821,6 +1848,23 @@ namespace TrenchBroom {
             showModelessDialog(window);
         }
 
+        void MapFrame::debugSaveProfilerTrace() {
+            const QString fileName = QFileDialog::getSaveFileName(this, tr("Save Profiler Trace"), "trace.json", "Chrome trace files (*.json)");
+            if (fileName.isEmpty()) {
+                return;
+            }
+
+            const IO::Path path = IO::pathFromQString(fileName);
+            std::ofstream stream = IO::openPathAsOutputStream(path);
+            if (!stream) {
+                logger().error() << "Could not open " << path << " for writing";
+                return;
+            }
+
+            Profiler::writeChromeTrace(stream);
+            logger().info() << "Saved profiler trace to " << path;
+        }
+
         void MapFrame::focusChange(QWidget* /* oldFocus */, QWidget* newFocus) {
             auto newMapView = dynamic_cast<MapViewBase*>(newFocus);
             if (newMapView != nullptr) {
@@ -363,6 +363,7 @@ namespace TrenchBroom {
             void debugThrowExceptionDuringCommand();
             void debugSetWindowSize();
             void debugShowPalette();
+            void debugSaveProfilerTrace();
 
             void focusChange(QWidget* oldFocus, QWidget* newFocus);
 
@@ -23,6 +23,7 @@
 #include "Logger.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityDefinitionGroup.h"
 #include "Assets/EntityDefinitionManager.h"
@@ -43,6 +44,7 @@
 #include "Model/PointFile.h"
 #include "Model/PortalFile.h"
 #include "Model/WorldNode.h"
+#include "Renderer/AttrString.h"
 #include "Renderer/Camera.h"
 #include "Renderer/Compass.h"
 #include "Renderer/FontDescriptor.h"
@@ -73,6 +75,9 @@
 #include <vecmath/polygon.h>
 #include <vecmath/util.h>
 
+#include <fmt/format.h>
+
+#include <cstdint>
 #include <sstream>
 #include <vector>
 
@@ -831,6 +836,7 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::doRender() {
+            TB_PROFILE_SCOPE("MapViewBase::render");
             doPreRender();
 
             const IO::Path& fontPath = pref(Preferences::RendererFontPath());
@@ -962,10 +968,40 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::renderFPS(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) {
-            if (pref(Preferences::ShowFPS)) {
+            const bool showFPS = pref(Preferences::ShowFPS);
+#ifdef TB_ENABLE_PROFILER
+            const bool showProfiler = pref(Preferences::ShowProfiler);
+#else
+            const bool showProfiler = false;
+#endif
+
+            if (showFPS || showProfiler) {
+                Renderer::AttrString string;
+                if (showFPS) {
+                    string.appendLeftJustified(m_currentFPS);
+                }
+                if (showProfiler) {
+                    appendProfilerSummary(string);
+                }
+
                 Renderer::RenderService renderService(renderContext, renderBatch);
+                renderService.renderHeadsUp(string);
+            }
+        }
+
+        void MapViewBase::appendProfilerSummary(Renderer::AttrString& string) const {
+            // summarize the events of the last second
+            const std::int64_t window = 1000 * 1000 * 1000;
+            for (const auto& summary : Profiler::summarize(Profiler::now() - window)) {
+                string.appendLeftJustified(fmt::format("{}: {} calls, {:.2f}ms total, {:.2f}ms max",
+                    summary.name,
+                    summary.count,
+                    static_cast<double>(summary.totalDuration) / 1.0e6,
+                    static_cast<double>(summary.maxDuration) / 1.0e6));
+            }
 
-                renderService.renderHeadsUp(m_currentFPS);
+            for (const auto counter : { ProfilerCounter::VboBytesUploaded, ProfilerCounter::BrushesValidated, ProfilerCounter::PicksPerformed }) {
+                string.appendLeftJustified(fmt::format("{}: {}", Profiler::counterName(counter), Profiler::counterValue(counter)));
             }
         }
 
@@ -56,6 +56,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class AttrString;
         class Camera;
         class Compass;
         class MapRenderer;
@@ -281,6 +282,7 @@ namespace TrenchBroom {
 
             void renderCompass(Renderer::RenderBatch& renderBatch);
             void renderFPS(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
+            void appendProfilerSummary(Renderer::AttrString& string) const;
         public: // implement InputEventProcessor interface
             void processEvent(const KeyEvent& event) override;
             void processEvent(const MouseEvent& event) override;
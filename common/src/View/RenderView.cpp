@@ -22,6 +22,7 @@
 #include "TrenchBroomApp.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/Transformation.h"
@@ -166,7 +167,10 @@ namespace TrenchBroom {
         void RenderView::paintGL() {
             if (TrenchBroom::View::isReportingCrash()) return;
 
-            render();
+            {
+                TB_PROFILE_SCOPE("RenderView::paintGL");
+                render();
+            }
 
             // Update stats
             m_framesRendered++;
@@ -32,11 +32,13 @@
 #include "Model/Hit.h"
 #include "Model/HitAdapter.h"
 #include "Model/HitFilter.h"
+#include "Model/ModelUtils.h"
 #include "Model/PickResult.h"
 #include "Model/Polyhedron.h"
 #include "Renderer/Camera.h"
 #include "View/Grid.h"
 #include "View/MapDocument.h"
+#include "View/Selection.h"
 
 #include <kdl/collection_utils.h>
 #include <kdl/map_utils.h>
@@ -91,6 +93,7 @@ namespace TrenchBroom {
         ResizeBrushesTool::ResizeBrushesTool(std::weak_ptr<MapDocument> document) :
         Tool(true),
         m_document(std::move(document)),
+        m_selectedFaceIndexValid(false),
         m_dragging(false),
         m_splitBrushes(false) {
             bindObservers();
@@ -265,38 +268,15 @@ namespace TrenchBroom {
         }
 
         std::vector<Model::BrushFaceHandle> ResizeBrushesTool::collectDragFaces(const Model::BrushFaceHandle& faceHandle) const {
-            auto result = std::vector<Model::BrushFaceHandle>{};
-
-            auto document = kdl::mem_lock(m_document);
-            const auto& nodes = document->selectedNodes().nodes();
-
-            const auto& referenceFace = faceHandle.face();
-            for (auto* node : nodes) {
-                node->accept(kdl::overload(
-                    [] (Model::WorldNode*) {},
-                    [] (Model::LayerNode*) {},
-                    [] (Model::GroupNode*) {},
-                    [] (Model::EntityNode*){},
-                    [&](Model::BrushNode* brushNode) {
-                        const auto& brush = brushNode->brush();
-                        for (size_t i = 0; i < brush.faceCount(); ++i) {
-                            const auto& face = brush.face(i);
-                            if (&face == &referenceFace) {
-                                continue;
-                            }
-
-                            if (!face.coplanarWith(referenceFace.boundary())) {
-                                continue;
-                            }
-
-                            result.emplace_back(brushNode, i);
-                        }
-                    },
-                    [] (Model::PatchNode*) {}
-                ));
+            if (!m_selectedFaceIndexValid) {
+                auto document = kdl::mem_lock(m_document);
+                for (auto* brushNode : document->selectedNodes().brushes()) {
+                    m_selectedFaceIndex.addBrush(brushNode);
+                }
+                m_selectedFaceIndexValid = true;
             }
 
-            return result;            
+            return kdl::vec_erase(m_selectedFaceIndex.findCoplanarFaces(faceHandle.face().boundary()), faceHandle);
         }
 
         /**
@@ -643,32 +623,81 @@ namespace TrenchBroom {
 
         void ResizeBrushesTool::bindObservers() {
             auto document = kdl::mem_lock(m_document);
-            document->nodesWereAddedNotifier.addObserver(this, &ResizeBrushesTool::nodesDidChange);
-            document->nodesWillChangeNotifier.addObserver(this, &ResizeBrushesTool::nodesDidChange);
-            document->nodesWillBeRemovedNotifier.addObserver(this, &ResizeBrushesTool::nodesDidChange);
+            document->documentWasClearedNotifier.addObserver(this, &ResizeBrushesTool::documentWasCleared);
+            document->nodesWereAddedNotifier.addObserver(this, &ResizeBrushesTool::nodesWereAdded);
+            document->nodesWillChangeNotifier.addObserver(this, &ResizeBrushesTool::nodesWillChange);
+            document->nodesDidChangeNotifier.addObserver(this, &ResizeBrushesTool::nodesDidChange);
+            document->nodesWillBeRemovedNotifier.addObserver(this, &ResizeBrushesTool::nodesWillBeRemoved);
             document->selectionDidChangeNotifier.addObserver(this, &ResizeBrushesTool::selectionDidChange);
         }
 
         void ResizeBrushesTool::unbindObservers() {
             if (!kdl::mem_expired(m_document)) {
                 auto document = kdl::mem_lock(m_document);
-                document->nodesWereAddedNotifier.removeObserver(this, &ResizeBrushesTool::nodesDidChange);
-                document->nodesWillChangeNotifier.removeObserver(this, &ResizeBrushesTool::nodesDidChange);
-                document->nodesWillBeRemovedNotifier.removeObserver(this, &ResizeBrushesTool::nodesDidChange);
+                document->documentWasClearedNotifier.removeObserver(this, &ResizeBrushesTool::documentWasCleared);
+                document->nodesWereAddedNotifier.removeObserver(this, &ResizeBrushesTool::nodesWereAdded);
+                document->nodesWillChangeNotifier.removeObserver(this, &ResizeBrushesTool::nodesWillChange);
+                document->nodesDidChangeNotifier.removeObserver(this, &ResizeBrushesTool::nodesDidChange);
+                document->nodesWillBeRemovedNotifier.removeObserver(this, &ResizeBrushesTool::nodesWillBeRemoved);
                 document->selectionDidChangeNotifier.removeObserver(this, &ResizeBrushesTool::selectionDidChange);
             }
         }
 
-        void ResizeBrushesTool::nodesDidChange(const std::vector<Model::Node*>&) {
+        void ResizeBrushesTool::documentWasCleared(MapDocument*) {
+            // the selection is cleared without a notification, so the index is rebuilt when it is needed again
+            m_selectedFaceIndex.clear();
+            m_selectedFaceIndexValid = false;
+        }
+
+        void ResizeBrushesTool::nodesWereAdded(const std::vector<Model::Node*>&) {
             if (!m_dragging) {
                 m_proposedDragHandles.clear();
             }
         }
 
-        void ResizeBrushesTool::selectionDidChange(const Selection&) {
+        void ResizeBrushesTool::nodesWillChange(const std::vector<Model::Node*>& nodes) {
             if (!m_dragging) {
                 m_proposedDragHandles.clear();
             }
+
+            for (const auto* brushNode : Model::filterBrushNodes(nodes)) {
+                m_selectedFaceIndex.removeBrush(brushNode);
+            }
+        }
+
+        void ResizeBrushesTool::nodesDidChange(const std::vector<Model::Node*>& nodes) {
+            if (m_selectedFaceIndexValid) {
+                for (auto* brushNode : Model::filterBrushNodes(nodes)) {
+                    if (brushNode->selected()) {
+                        m_selectedFaceIndex.addBrush(brushNode);
+                    }
+                }
+            }
+        }
+
+        void ResizeBrushesTool::nodesWillBeRemoved(const std::vector<Model::Node*>& nodes) {
+            if (!m_dragging) {
+                m_proposedDragHandles.clear();
+            }
+
+            for (const auto* brushNode : Model::filterBrushNodes(nodes)) {
+                m_selectedFaceIndex.removeBrush(brushNode);
+            }
+        }
+
+        void ResizeBrushesTool::selectionDidChange(const Selection& selection) {
+            if (!m_dragging) {
+                m_proposedDragHandles.clear();
+            }
+
+            if (m_selectedFaceIndexValid) {
+                for (const auto* brushNode : Model::filterBrushNodes(selection.deselectedNodes())) {
+                    m_selectedFaceIndex.removeBrush(brushNode);
+                }
+                for (auto* brushNode : Model::filterBrushNodes(selection.selectedNodes())) {
+                    m_selectedFaceIndex.addBrush(brushNode);
+                }
+            }
         }
     }
 }
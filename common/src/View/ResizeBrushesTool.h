@@ -21,6 +21,7 @@
 
 #include "FloatType.h"
 #include "Model/Brush.h"
+#include "Model/BrushFacePlaneIndex.h"
 #include "Model/HitType.h"
 #include "View/Tool.h"
 
@@ -99,6 +100,12 @@ namespace TrenchBroom {
              * Propsed drag handles for the next drag. Should only be accessed when m_dragging is false.
              */
             std::vector<DragHandle> m_proposedDragHandles;
+            /**
+             * Indexes the faces of the selected brushes by their planes to find the faces that are dragged together.
+             * Built when it is first needed and then kept up to date as the selection and the selected brushes change.
+             */
+            mutable Model::BrushFacePlaneIndex m_selectedFaceIndex;
+            mutable bool m_selectedFaceIndexValid;
             bool m_dragging;
         private: // drag state - should only be accessed when m_dragging is true
             std::vector<Model::BrushFaceHandle> m_currentDragVisualHandles;
@@ -149,7 +156,11 @@ namespace TrenchBroom {
         private:
             void bindObservers();
             void unbindObservers();
+            void documentWasCleared(MapDocument* document);
+            void nodesWereAdded(const std::vector<Model::Node*>& nodes);
+            void nodesWillChange(const std::vector<Model::Node*>& nodes);
             void nodesDidChange(const std::vector<Model::Node*>& nodes);
+            void nodesWillBeRemoved(const std::vector<Model::Node*>& nodes);
             void selectionDidChange(const Selection& selection);
         };
     }
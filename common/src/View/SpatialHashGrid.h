@@ -0,0 +1,255 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * Stores values at 3D positions in a sparse, hashed grid of uniform cubic cells. Only cells which contain at
+         * least one value are allocated, so the grid is unbounded and its memory usage is proportional to the number
+         * of values.
+         *
+         * Radius queries only visit the cells that overlap the query sphere. Ray queries visit every occupied cell, but
+         * only test the values in cells whose bounds are close enough to the ray.
+         *
+         * @tparam T the type of the stored values, must be equality comparable
+         */
+        template <typename T>
+        class SpatialHashGrid {
+        private:
+            struct CellKey {
+                int64_t x;
+                int64_t y;
+                int64_t z;
+
+                bool operator==(const CellKey& other) const {
+                    return x == other.x && y == other.y && z == other.z;
+                }
+            };
+
+            struct CellKeyHash {
+                size_t operator()(const CellKey& key) const {
+                    auto result = static_cast<size_t>(key.x);
+                    const auto combine = [&](const int64_t value) {
+                        result ^= static_cast<size_t>(value) + 0x9e3779b9 + (result << 6) + (result >> 2);
+                    };
+
+                    combine(key.y);
+                    combine(key.z);
+                    return result;
+                }
+            };
+
+            struct Entry {
+                vm::vec3 position;
+                T value;
+            };
+
+            using Cell = std::vector<Entry>;
+
+            FloatType m_cellSize;
+            std::unordered_map<CellKey, Cell, CellKeyHash> m_cells;
+            size_t m_size;
+        public:
+            /**
+             * Creates a new empty grid with the given cell size.
+             *
+             * @param cellSize the edge length of the grid cells, must be positive
+             */
+            explicit SpatialHashGrid(const FloatType cellSize) :
+            m_cellSize(cellSize),
+            m_size(0u) {
+                assert(m_cellSize > FloatType(0.0));
+            }
+
+            /**
+             * Returns the number of values stored in this grid.
+             */
+            size_t size() const {
+                return m_size;
+            }
+
+            /**
+             * Indicates whether this grid stores any values.
+             */
+            bool empty() const {
+                return m_size == 0u;
+            }
+
+            /**
+             * Returns the number of cells which contain at least one value.
+             */
+            size_t cellCount() const {
+                return m_cells.size();
+            }
+
+            /**
+             * Stores the given value at the given position. The grid may store the same value multiple times.
+             */
+            void insert(const vm::vec3& position, T value) {
+                m_cells[cellKey(position)].push_back(Entry{position, std::move(value)});
+                ++m_size;
+            }
+
+            /**
+             * Removes one occurrence of the given value stored at the given position.
+             *
+             * @return true if the value was found and removed and false otherwise
+             */
+            bool remove(const vm::vec3& position, const T& value) {
+                const auto cellIt = m_cells.find(cellKey(position));
+                if (cellIt == std::end(m_cells)) {
+                    return false;
+                }
+
+                auto& cell = cellIt->second;
+                const auto entryIt = std::find_if(std::begin(cell), std::end(cell), [&](const Entry& entry) {
+                    return entry.value == value;
+                });
+                if (entryIt == std::end(cell)) {
+                    return false;
+                }
+
+                // the order of the entries within a cell is irrelevant
+                *entryIt = std::move(cell.back());
+                cell.pop_back();
+                if (cell.empty()) {
+                    m_cells.erase(cellIt);
+                }
+
+                --m_size;
+                return true;
+            }
+
+            /**
+             * Removes all values from this grid.
+             */
+            void clear() {
+                m_cells.clear();
+                m_size = 0u;
+            }
+
+            /**
+             * Calls the given function for every value whose position has at most the given distance to the given
+             * center.
+             *
+             * @tparam F the type of the function, must accept the position and the value
+             * @param center the center of the query sphere
+             * @param radius the radius of the query sphere
+             * @param fun the function to call
+             */
+            template <typename F>
+            void forEachInRadius(const vm::vec3& center, const FloatType radius, const F& fun) const {
+                const auto squaredRadius = radius * radius;
+                const auto visitCell = [&](const Cell& cell) {
+                    for (const auto& entry : cell) {
+                        if (vm::squared_distance(entry.position, center) <= squaredRadius) {
+                            fun(entry.position, entry.value);
+                        }
+                    }
+                };
+
+                const auto min = cellKey(center - vm::vec3::fill(radius));
+                const auto max = cellKey(center + vm::vec3::fill(radius));
+                const auto rangeSize = static_cast<double>(max.x - min.x + 1)
+                                     * static_cast<double>(max.y - min.y + 1)
+                                     * static_cast<double>(max.z - min.z + 1);
+
+                if (rangeSize > static_cast<double>(m_cells.size())) {
+                    // the query covers more cells than are occupied, so it's cheaper to visit every occupied cell
+                    for (const auto& [key, cell] : m_cells) {
+                        visitCell(cell);
+                    }
+                } else {
+                    for (auto x = min.x; x <= max.x; ++x) {
+                        for (auto y = min.y; y <= max.y; ++y) {
+                            for (auto z = min.z; z <= max.z; ++z) {
+                                const auto it = m_cells.find(CellKey{x, y, z});
+                                if (it != std::end(m_cells)) {
+                                    visitCell(it->second);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Calls the given function for every value in each cell that might contain values close enough to the
+             * given ray. For every occupied cell, the given radius function is called with the cell bounds and must
+             * return an upper bound for the query radius of any position within these bounds. The function is then
+             * called for the values of the cell if the ray intersects the cell bounds expanded by that radius.
+             *
+             * The given function must perform the exact test on each value itself.
+             *
+             * @tparam R the type of the radius function, must accept a bounding box and return a radius
+             * @tparam F the type of the function, must accept the position and the value
+             * @param ray the query ray
+             * @param radius the radius function
+             * @param fun the function to call
+             */
+            template <typename R, typename F>
+            void forEachNearRay(const vm::ray3& ray, const R& radius, const F& fun) const {
+                for (const auto& [key, cell] : m_cells) {
+                    const auto bounds = cellBounds(key);
+                    const auto r = radius(bounds);
+                    const auto expandedBounds = vm::bbox3(bounds.min - vm::vec3::fill(r), bounds.max + vm::vec3::fill(r));
+                    if (!vm::is_nan(vm::intersect_ray_bbox(ray, expandedBounds))) {
+                        for (const auto& entry : cell) {
+                            fun(entry.position, entry.value);
+                        }
+                    }
+                }
+            }
+        private:
+            CellKey cellKey(const vm::vec3& position) const {
+                return CellKey{
+                    static_cast<int64_t>(std::floor(position.x() / m_cellSize)),
+                    static_cast<int64_t>(std::floor(position.y() / m_cellSize)),
+                    static_cast<int64_t>(std::floor(position.z() / m_cellSize))
+                };
+            }
+
+            vm::bbox3 cellBounds(const CellKey& key) const {
+                const auto min = vm::vec3(
+                    static_cast<FloatType>(key.x),
+                    static_cast<FloatType>(key.y),
+                    static_cast<FloatType>(key.z)) * m_cellSize;
+                return vm::bbox3(min, min + vm::vec3::fill(m_cellSize));
+            }
+        };
+    }
+}
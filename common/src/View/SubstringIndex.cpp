@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SubstringIndex.h"
+
+#include <kdl/string_format.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace View {
+        static uint32_t trigramAt(const std::string& str, const size_t i) {
+            return
+                static_cast<uint32_t>(static_cast<unsigned char>(str[i])) << 16 |
+                static_cast<uint32_t>(static_cast<unsigned char>(str[i + 1])) << 8 |
+                static_cast<uint32_t>(static_cast<unsigned char>(str[i + 2]));
+        }
+
+        size_t SubstringIndex::add(const std::string& str) {
+            const auto id = m_strings.size();
+            m_strings.push_back(kdl::str_to_lower(str));
+
+            const auto& lower = m_strings.back();
+            for (size_t i = 0u; i + 2u < lower.size(); ++i) {
+                auto& ids = m_postings[trigramAt(lower, i)];
+                // a trigram can occur several times in the same string, but the ids are added in ascending order
+                if (ids.empty() || ids.back() != id) {
+                    ids.push_back(id);
+                }
+            }
+
+            return id;
+        }
+
+        std::vector<size_t> SubstringIndex::find(const std::string& pattern) const {
+            std::vector<size_t> result;
+
+            const auto lower = kdl::str_to_lower(pattern);
+            if (lower.size() < 3u) {
+                for (size_t id = 0u; id < m_strings.size(); ++id) {
+                    if (m_strings[id].find(lower) != std::string::npos) {
+                        result.push_back(id);
+                    }
+                }
+                return result;
+            }
+
+            std::vector<const std::vector<size_t>*> postings;
+            for (size_t i = 0u; i + 2u < lower.size(); ++i) {
+                const auto it = m_postings.find(trigramAt(lower, i));
+                if (it == std::end(m_postings)) {
+                    return result;
+                }
+                postings.push_back(&it->second);
+            }
+
+            std::sort(std::begin(postings), std::end(postings), [](const auto* lhs, const auto* rhs) {
+                return lhs->size() < rhs->size();
+            });
+
+            result = *postings.front();
+            std::vector<size_t> intersection;
+            for (auto it = std::next(std::begin(postings)); it != std::end(postings) && !result.empty(); ++it) {
+                intersection.clear();
+                std::set_intersection(
+                    std::begin(result), std::end(result),
+                    std::begin(**it), std::end(**it),
+                    std::back_inserter(intersection));
+                result.swap(intersection);
+            }
+
+            // all trigrams occurring in a string does not mean that they occur in the right order
+            result.erase(std::remove_if(std::begin(result), std::end(result), [&](const size_t id) {
+                return m_strings[id].find(lower) == std::string::npos;
+            }), std::end(result));
+
+            return result;
+        }
+
+        size_t SubstringIndex::size() const {
+            return m_strings.size();
+        }
+
+        void SubstringIndex::clear() {
+            m_strings.clear();
+            m_postings.clear();
+        }
+    }
+}
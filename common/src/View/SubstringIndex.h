@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * An index for case insensitive substring queries over a set of strings.
+         *
+         * Every string is split into its overlapping trigrams, and for each trigram, the index records the ids of the
+         * strings that contain it. A query intersects the id lists of the trigrams of the pattern, starting with the
+         * shortest list, and then checks only the remaining candidates. Patterns that are shorter than a trigram are
+         * matched by scanning all strings.
+         *
+         * The ids are the indices at which the strings were added.
+         */
+        class SubstringIndex {
+        private:
+            std::vector<std::string> m_strings;
+            std::unordered_map<uint32_t, std::vector<size_t>> m_postings;
+        public:
+            /**
+             * Adds the given string to this index and returns its id.
+             */
+            size_t add(const std::string& str);
+
+            /**
+             * Returns the ids of all strings which contain the given pattern, ignoring case, in ascending order. If the
+             * pattern is empty, all ids are returned.
+             */
+            std::vector<size_t> find(const std::string& pattern) const;
+
+            size_t size() const;
+            void clear();
+        };
+    }
+}
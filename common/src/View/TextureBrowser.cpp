@@ -206,10 +206,12 @@ namespace TrenchBroom {
         }
 
         void TextureBrowser::documentWasNewed(MapDocument*) {
+            m_view->invalidateFilterIndex();
             reload();
         }
 
         void TextureBrowser::documentWasLoaded(MapDocument*) {
+            m_view->invalidateFilterIndex();
             reload();
         }
 
@@ -230,6 +232,7 @@ namespace TrenchBroom {
         }
 
         void TextureBrowser::textureCollectionsDidChange() {
+            m_view->invalidateFilterIndex();
             reload();
         }
 
@@ -241,6 +244,7 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             if (path == Preferences::TextureBrowserIconSize.path() ||
                 document->isGamePathPreference(path)) {
+                m_view->invalidateFilterIndex();
                 reload();
             } else {
                 m_view->update();
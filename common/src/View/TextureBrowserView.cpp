@@ -63,7 +63,9 @@ namespace TrenchBroom {
         m_group(false),
         m_hideUnused(false),
         m_sortOrder(TextureSortOrder::Name),
-        m_selectedTexture(nullptr) {
+        m_selectedTexture(nullptr),
+        m_fittedTitlesWidth(0.0f),
+        m_filterIndexValid(false) {
             auto doc = kdl::mem_lock(m_document);
             doc->textureUsageCountsDidChangeNotifier.addObserver(this, &TextureBrowserView::usageCountDidChange);
         }
@@ -131,6 +133,11 @@ namespace TrenchBroom {
             });
         }
 
+        void TextureBrowserView::invalidateFilterIndex() {
+            m_filterIndexValid = false;
+            invalidate();
+        }
+
         void TextureBrowserView::usageCountDidChange() {
             invalidate();
             update();
@@ -155,6 +162,15 @@ namespace TrenchBroom {
 
             const Renderer::FontDescriptor font(fontPath, static_cast<size_t>(fontSize));
 
+            const float maxCellWidth = layout.maxCellWidth();
+            if (!m_fittedTitlesFont || m_fittedTitlesFont->compare(font) != 0 || m_fittedTitlesWidth != maxCellWidth) {
+                m_fittedTitles.clear();
+                m_fittedTitlesFont = font;
+                m_fittedTitlesWidth = maxCellWidth;
+            }
+
+            updateFilterMatches();
+
             if (m_group) {
                 for (const Assets::TextureCollection& collection : getCollections()) {
                     layout.addGroup(collection.name(), static_cast<float>(fontSize) + 2.0f);
@@ -172,12 +188,10 @@ namespace TrenchBroom {
 
             const auto  textureName = IO::Path(texture->name()).lastComponent().asString();
 
-            const auto textureFont = fontManager().selectFontSize(font, textureName, maxCellWidth, 6);
-            const auto groupFont   = fontManager().selectFontSize(font, groupName, maxCellWidth, 6);
+            const auto [textureFont, textureNameSize] = fitTitle(textureName, font, maxCellWidth);
+            const auto [groupFont, groupNameSize]     = fitTitle(groupName, font, maxCellWidth);
 
             const auto defaultTextHeight = fontManager().font(font).measure(groupName + textureName).y();
-            const auto textureNameSize   = fontManager().font(textureFont).measure(textureName);
-            const auto groupNameSize     = fontManager().font(groupFont).measure(groupName);
 
             const auto totalSize = vm::vec2f(vm::max(groupNameSize.x(), textureNameSize.x()), 2.0f * defaultTextHeight + 4.0f);
 
@@ -202,6 +216,16 @@ namespace TrenchBroom {
             totalSize.y());
         }
 
+        const TextureBrowserView::FittedTitle& TextureBrowserView::fitTitle(const std::string& title, const Renderer::FontDescriptor& font, const float maxWidth) {
+            auto it = m_fittedTitles.find(title);
+            if (it == std::end(m_fittedTitles)) {
+                const auto fittedFont = fontManager().selectFontSize(font, title, maxWidth, 6);
+                const auto fittedSize = fontManager().font(fittedFont).measure(title);
+                it = m_fittedTitles.emplace(title, FittedTitle{fittedFont, fittedSize}).first;
+            }
+            return it->second;
+        }
+
         struct TextureBrowserView::CompareByUsageCount {
             kdl::ci::string_less m_less;
 
@@ -232,16 +256,6 @@ namespace TrenchBroom {
             }
         };
 
-        struct TextureBrowserView::MatchName {
-            std::string pattern;
-
-            explicit MatchName(const std::string& i_pattern) : pattern(i_pattern) {}
-
-            bool operator()(const Assets::Texture* texture) const {
-                return !kdl::ci::str_contains(texture->name(), pattern);
-            }
-        };
-
         const std::vector<Assets::TextureCollection>& TextureBrowserView::getCollections() const {
             auto doc = kdl::mem_lock(m_document);
             return doc->textureManager().collections();
@@ -262,11 +276,34 @@ namespace TrenchBroom {
             return textures;
         }
 
+        void TextureBrowserView::updateFilterMatches() {
+            m_filterMatches.clear();
+            if (m_filterText.empty()) {
+                return;
+            }
+
+            if (!m_filterIndexValid) {
+                m_filterIndex.clear();
+                m_filterIndexTextures.clear();
+                for (const Assets::TextureCollection& collection : getCollections()) {
+                    for (const Assets::Texture& texture : collection.textures()) {
+                        m_filterIndex.add(texture.name());
+                        m_filterIndexTextures.push_back(&texture);
+                    }
+                }
+                m_filterIndexValid = true;
+            }
+
+            for (const size_t id : m_filterIndex.find(m_filterText)) {
+                m_filterMatches.insert(m_filterIndexTextures[id]);
+            }
+        }
+
         void TextureBrowserView::filterTextures(std::vector<const Assets::Texture*>& textures) const {
             if (m_hideUnused)
                 textures = kdl::vec_erase_if(std::move(textures), MatchUsageCount());
             if (!m_filterText.empty())
-                textures = kdl::vec_erase_if(std::move(textures), MatchName(m_filterText));
+                textures = kdl::vec_erase_if(std::move(textures), [&](const Assets::Texture* texture) { return m_filterMatches.count(texture) == 0u; });
         }
 
         void TextureBrowserView::sortTextures(std::vector<const Assets::Texture*>& textures) const {
@@ -315,26 +352,15 @@ namespace TrenchBroom {
             using BoundsVertex = Renderer::GLVertexTypes::P2C4::Vertex;
             std::vector<BoundsVertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
-                const Group& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
-                        const Row& row = group[j];
-                        if (row.intersectsY(y, height)) {
-                            for (size_t k = 0; k < row.size(); ++k) {
-                                const Cell& cell = row[k];
-                                const LayoutBounds& bounds = cell.itemBounds();
-                                const Assets::Texture* texture = cellData(cell).texture;
-                                const Color& color = textureColor(*texture);
-                                vertices.emplace_back(vm::vec2f(bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)), color);
-                                vertices.emplace_back(vm::vec2f(bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)), color);
-                                vertices.emplace_back(vm::vec2f(bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)), color);
-                                vertices.emplace_back(vm::vec2f(bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)), color);
-                            }
-                        }
-                    }
-                }
-            }
+            layout.visitCellsIntersectingY(y, height, [&](const Cell& cell) {
+                const LayoutBounds& bounds = cell.itemBounds();
+                const Assets::Texture* texture = cellData(cell).texture;
+                const Color& color = textureColor(*texture);
+                vertices.emplace_back(vm::vec2f(bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)), color);
+                vertices.emplace_back(vm::vec2f(bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)), color);
+                vertices.emplace_back(vm::vec2f(bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)), color);
+                vertices.emplace_back(vm::vec2f(bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)), color);
+            });
 
             Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::move(vertices));
             Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::TextureBrowserBorderShader);
@@ -359,40 +385,25 @@ namespace TrenchBroom {
             shader.set("Texture", 0);
             shader.set("Brightness", pref(Preferences::Brightness));
 
-            size_t num = 0;
+            layout.visitCellsIntersectingY(y, height, [&](const Cell& cell) {
+                const LayoutBounds& bounds = cell.itemBounds();
+                const Assets::Texture* texture = cellData(cell).texture;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
-                const Group& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    for (size_t j = 0; j < group.size(); ++j) {
-                        const Row& row = group[j];
-                        if (row.intersectsY(y, height)) {
-                            for (size_t k = 0; k < row.size(); ++k) {
-                                const Cell& cell = row[k];
-                                const LayoutBounds& bounds = cell.itemBounds();
-                                const Assets::Texture* texture = cellData(cell).texture;
-
-                                Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::vector<TextureVertex>({
-                                    TextureVertex(vm::vec2f(bounds.left(),  height - (bounds.top() - y)),    vm::vec2f(0.0f, 0.0f)),
-                                    TextureVertex(vm::vec2f(bounds.left(),  height - (bounds.bottom() - y)), vm::vec2f(0.0f, 1.0f)),
-                                    TextureVertex(vm::vec2f(bounds.right(), height - (bounds.bottom() - y)), vm::vec2f(1.0f, 1.0f)),
-                                    TextureVertex(vm::vec2f(bounds.right(), height - (bounds.top() - y)),    vm::vec2f(1.0f, 0.0f))
-                                }));
-
-                                shader.set("GrayScale", texture->overridden());
-                                texture->activate();
-
-                                vertexArray.prepare(vboManager());
-                                vertexArray.render(Renderer::PrimType::Quads);
-
-                                texture->deactivate();
-
-                                ++num;
-                            }
-                        }
-                    }
-                }
-            }
+                Renderer::VertexArray vertexArray = Renderer::VertexArray::move(std::vector<TextureVertex>({
+                    TextureVertex(vm::vec2f(bounds.left(),  height - (bounds.top() - y)),    vm::vec2f(0.0f, 0.0f)),
+                    TextureVertex(vm::vec2f(bounds.left(),  height - (bounds.bottom() - y)), vm::vec2f(0.0f, 1.0f)),
+                    TextureVertex(vm::vec2f(bounds.right(), height - (bounds.bottom() - y)), vm::vec2f(1.0f, 1.0f)),
+                    TextureVertex(vm::vec2f(bounds.right(), height - (bounds.top() - y)),    vm::vec2f(1.0f, 0.0f))
+                }));
+
+                shader.set("GrayScale", texture->overridden());
+                texture->activate();
+
+                vertexArray.prepare(vboManager());
+                vertexArray.render(Renderer::PrimType::Quads);
+
+                texture->deactivate();
+            });
         }
 
         void TextureBrowserView::renderNames(Layout& layout, const float y, const float height) {
@@ -404,15 +415,14 @@ namespace TrenchBroom {
             using Vertex = Renderer::GLVertexTypes::P2::Vertex;
             std::vector<Vertex> vertices;
 
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.groupsIntersectingY(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const Group& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    const LayoutBounds titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y))));
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.bottom() - y))));
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.bottom() - y))));
-                    vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.top() - y))));
-                }
+                const LayoutBounds titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.top() - y))));
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.left(), height - (titleBounds.bottom() - y))));
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.bottom() - y))));
+                vertices.push_back(Vertex(vm::vec2f(titleBounds.right(), height - (titleBounds.top() - y))));
             }
 
             Renderer::ActiveShader shader(shaderManager(), Renderer::Shaders::VaryingPUniformCShader);
@@ -452,69 +462,63 @@ namespace TrenchBroom {
             const std::vector<Color> subTextColor{ pref(Preferences::BrowserSubTextColor) };
 
             StringMap stringVertices;
-            for (size_t i = 0; i < layout.size(); ++i) {
+            const auto [firstGroup, lastGroup] = layout.groupsIntersectingY(y, height);
+            for (size_t i = firstGroup; i < lastGroup; ++i) {
                 const auto& group = layout[i];
-                if (group.intersectsY(y, height)) {
-                    const auto& title = group.item();
-                    if (!title.empty()) {
-                        const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
-                        const auto offset = vm::vec2f(titleBounds.left() + 2.0f, height - (titleBounds.top() - y) - titleBounds.height());
-
-                        auto& font = fontManager().font(defaultDescriptor);
-                        const auto quads = font.quads(title, false, offset);
-                        const auto titleVertices = TextVertex::toList(
-                            quads.size() / 2,
-                            kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
-                            kdl::skip_iterator(std::begin(quads), std::end(quads), 1, 2),
-                            kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
-                        auto& vertices = stringVertices[defaultDescriptor];
-                        vertices.insert(std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
-                    }
-
-                    for (size_t j = 0; j < group.size(); ++j) {
-                        const auto& row = group[j];
-                        if (row.intersectsY(y, height)) {
-                            for (unsigned int k = 0; k < row.size(); k++) {
-                                const auto& cell = row[k];
-                                const auto titleBounds = cell.titleBounds();
-                                const auto& textureFont = fontManager().font(cellData(cell).mainTitleFont);
-                                const auto& groupFont   = fontManager().font(cellData(cell).subTitleFont);
-
-                                // y is relative to top, but OpenGL coords are relative to bottom, so invert
-                                const auto titleOffset = vm::vec2f(titleBounds.left(), y + height - titleBounds.bottom());
-
-                                const auto textureNameOffset = titleOffset + cellData(cell).mainTitleOffset;
-                                const auto groupNameOffset   = titleOffset + cellData(cell).subTitleOffset;
-
-                                const auto& textureName = cellData(cell).mainTitle;
-                                const auto& groupName   = cellData(cell).subTitle;
-
-                                const auto textureNameQuads = textureFont.quads(textureName, false, textureNameOffset);
-                                const auto groupNameQuads   = groupFont.quads(groupName, false, groupNameOffset);
-
-                                const auto textureNameVertices = TextVertex::toList(
-                                    textureNameQuads.size() / 2,
-                                    kdl::skip_iterator(std::begin(textureNameQuads), std::end(textureNameQuads), 0, 2),
-                                    kdl::skip_iterator(std::begin(textureNameQuads), std::end(textureNameQuads), 1, 2),
-                                    kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
-
-                                const auto groupNameVertices = TextVertex::toList(
-                                    groupNameQuads.size() / 2,
-                                    kdl::skip_iterator(std::begin(groupNameQuads), std::end(groupNameQuads), 0, 2),
-                                    kdl::skip_iterator(std::begin(groupNameQuads), std::end(groupNameQuads), 1, 2),
-                                    kdl::skip_iterator(std::begin(subTextColor), std::end(subTextColor), 0, 0));
-
-                                auto& mainTitleVertices = stringVertices[cellData(cell).mainTitleFont];
-                                mainTitleVertices = kdl::vec_concat(std::move(mainTitleVertices), textureNameVertices);
-
-                                auto& subTitleVertices = stringVertices[cellData(cell).subTitleFont];
-                                subTitleVertices = kdl::vec_concat(std::move(subTitleVertices), groupNameVertices);
-                            }
-                        }
-                    }
+                const auto& title = group.item();
+                if (!title.empty()) {
+                    const auto titleBounds = layout.titleBoundsForVisibleRect(group, y, height);
+                    const auto offset = vm::vec2f(titleBounds.left() + 2.0f, height - (titleBounds.top() - y) - titleBounds.height());
+
+                    auto& font = fontManager().font(defaultDescriptor);
+                    const auto quads = font.quads(title, false, offset);
+                    const auto titleVertices = TextVertex::toList(
+                        quads.size() / 2,
+                        kdl::skip_iterator(std::begin(quads), std::end(quads), 0, 2),
+                        kdl::skip_iterator(std::begin(quads), std::end(quads), 1, 2),
+                        kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
+                    auto& vertices = stringVertices[defaultDescriptor];
+                    vertices.insert(std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
                 }
             }
 
+            layout.visitCellsIntersectingY(y, height, [&](const Cell& cell) {
+                const auto& data = cellData(cell);
+                const auto titleBounds = cell.titleBounds();
+                const auto& textureFont = fontManager().font(data.mainTitleFont);
+                const auto& groupFont   = fontManager().font(data.subTitleFont);
+
+                // y is relative to top, but OpenGL coords are relative to bottom, so invert
+                const auto titleOffset = vm::vec2f(titleBounds.left(), y + height - titleBounds.bottom());
+
+                const auto textureNameOffset = titleOffset + data.mainTitleOffset;
+                const auto groupNameOffset   = titleOffset + data.subTitleOffset;
+
+                const auto& textureName = data.mainTitle;
+                const auto& groupName   = data.subTitle;
+
+                const auto textureNameQuads = textureFont.quads(textureName, false, textureNameOffset);
+                const auto groupNameQuads   = groupFont.quads(groupName, false, groupNameOffset);
+
+                const auto textureNameVertices = TextVertex::toList(
+                    textureNameQuads.size() / 2,
+                    kdl::skip_iterator(std::begin(textureNameQuads), std::end(textureNameQuads), 0, 2),
+                    kdl::skip_iterator(std::begin(textureNameQuads), std::end(textureNameQuads), 1, 2),
+                    kdl::skip_iterator(std::begin(textColor), std::end(textColor), 0, 0));
+
+                const auto groupNameVertices = TextVertex::toList(
+                    groupNameQuads.size() / 2,
+                    kdl::skip_iterator(std::begin(groupNameQuads), std::end(groupNameQuads), 0, 2),
+                    kdl::skip_iterator(std::begin(groupNameQuads), std::end(groupNameQuads), 1, 2),
+                    kdl::skip_iterator(std::begin(subTextColor), std::end(subTextColor), 0, 0));
+
+                auto& mainTitleVertices = stringVertices[data.mainTitleFont];
+                mainTitleVertices.insert(std::end(mainTitleVertices), std::begin(textureNameVertices), std::end(textureNameVertices));
+
+                auto& subTitleVertices = stringVertices[data.subTitleFont];
+                subTitleVertices.insert(std::end(subTitleVertices), std::begin(groupNameVertices), std::end(groupNameVertices));
+            });
+
             return stringVertices;
         }
 
@@ -22,10 +22,14 @@
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/GLVertexType.h"
 #include "View/CellView.h"
+#include "View/SubstringIndex.h"
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class QScrollBar;
@@ -69,6 +73,28 @@ namespace TrenchBroom {
             std::string m_filterText;
 
             const Assets::Texture* m_selectedTexture;
+
+            struct FittedTitle {
+                Renderer::FontDescriptor font;
+                vm::vec2f size;
+            };
+
+            /**
+             * Caches the font size selected for each title and the size of the title in that font. The cache is only
+             * valid for the font and maximum cell width stored alongside it.
+             */
+            std::unordered_map<std::string, FittedTitle> m_fittedTitles;
+            std::optional<Renderer::FontDescriptor> m_fittedTitlesFont;
+            float m_fittedTitlesWidth;
+
+            /**
+             * Indexes the names of the textures of all collections for filtering. The index is built lazily and must
+             * be invalidated whenever the texture collections change.
+             */
+            SubstringIndex m_filterIndex;
+            std::vector<const Assets::Texture*> m_filterIndexTextures;
+            bool m_filterIndexValid;
+            std::unordered_set<const Assets::Texture*> m_filterMatches;
         public:
             TextureBrowserView(QScrollBar* scrollBar,
                                GLContextManager& contextManager,
@@ -84,22 +110,28 @@ namespace TrenchBroom {
             void setSelectedTexture(const Assets::Texture* selectedTexture);
 
             void revealTexture(const Assets::Texture* texture);
+
+            /**
+             * Must be called when the texture collections of the document change.
+             */
+            void invalidateFilterIndex();
         private:
             void usageCountDidChange();
 
             void doInitLayout(Layout& layout) override;
             void doReloadLayout(Layout& layout) override;
             void addTextureToLayout(Layout& layout, const Assets::Texture* texture, const std::string& groupName, const Renderer::FontDescriptor& font);
+            const FittedTitle& fitTitle(const std::string& title, const Renderer::FontDescriptor& font, float maxWidth);
 
             struct CompareByUsageCount;
             struct CompareByName;
             struct MatchUsageCount;
-            struct MatchName;
 
             const std::vector<Assets::TextureCollection>& getCollections() const;
             std::vector<const Assets::Texture*> getTextures(const Assets::TextureCollection& collection) const;
             std::vector<const Assets::Texture*> getTextures() const;
 
+            void updateFilterMatches();
             void filterTextures(std::vector<const Assets::Texture*>& textures) const;
             void sortTextures(std::vector<const Assets::Texture*>& textures) const;
 
@@ -25,40 +25,65 @@
 #include "Model/Polyhedron.h"
 #include "View/Grid.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/distance.h>
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
 #include <vecmath/plane.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace View {
         VertexHandleManagerBase::~VertexHandleManagerBase() {}
 
+        /**
+         * Returns an upper bound of the radius of the pick sphere of any point handle within the given bounds. The
+         * perspective scaling factor is an affine function of the position, so its maximum is attained at a corner.
+         */
+        static FloatType maxPointHandlePickRadius(const Renderer::Camera& camera, const vm::bbox3& bounds, const FloatType handleRadius) {
+            auto maxScaling = FloatType(0.0);
+            for (size_t i = 0; i < 8; ++i) {
+                const auto corner = vm::vec3(
+                    (i & 1u) ? bounds.max.x() : bounds.min.x(),
+                    (i & 2u) ? bounds.max.y() : bounds.min.y(),
+                    (i & 4u) ? bounds.max.z() : bounds.min.z());
+                maxScaling = std::max(maxScaling, static_cast<FloatType>(camera.perspectiveScalingFactor(vm::vec3f(corner))));
+            }
+            return FloatType(2.0) * handleRadius * maxScaling;
+        }
+
         const Model::HitType::Type VertexHandleManager::HandleHitType = Model::HitType::freeType();
 
         void VertexHandleManager::pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const auto& [position, info] : m_handles) {
-                const auto distance = camera.pickPointHandle(pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            const auto pickRadius = [&](const vm::bbox3& bounds) {
+                return maxPointHandlePickRadius(camera, bounds, handleRadius);
+            };
+
+            pickNearRay(pickRay, pickRadius, [&](const vm::vec3& position) {
+                const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
                 if (!vm::is_nan(distance)) {
                     const auto hitPoint = vm::point_at_distance(pickRay, distance);
                     const auto error = vm::squared_distance(pickRay, position).distance;
-                    pickResult.addHit(Model::Hit::hit(HandleHitType, distance, hitPoint, position, error));
+                    return Model::Hit::hit(HandleHitType, distance, hitPoint, position, error);
                 }
-            }
+                return Model::Hit::NoHit;
+            }, pickResult);
         }
 
-        void VertexHandleManager::addHandles(const Model::BrushNode* brushNode) {
+        void VertexHandleManager::addHandles(Model::BrushNode* brushNode) {
             const Model::Brush& brush = brushNode->brush();
             for (const Model::BrushVertex* vertex : brush.vertices()) {
-                add(vertex->position());
+                add(vertex->position(), brushNode);
             }
         }
 
-        void VertexHandleManager::removeHandles(const Model::BrushNode* brushNode) {
+        void VertexHandleManager::removeHandles(Model::BrushNode* brushNode) {
             const Model::Brush& brush = brushNode->brush();
             for (const Model::BrushVertex* vertex : brush.vertices()) {
-                assertResult(remove(vertex->position()))
+                assertResult(remove(vertex->position(), brushNode))
             }
         }
 
@@ -88,28 +113,35 @@ namespace TrenchBroom {
         }
 
         void EdgeHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const auto& [position, info] : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            const auto pickRadius = [&](const vm::bbox3& bounds) {
+                return maxPointHandlePickRadius(camera, bounds, handleRadius);
+            };
+
+            // the index position of an edge handle is its center
+            pickNearRay(pickRay, pickRadius, [&](const vm::segment3& position) {
                 const vm::vec3 pointHandle = position.center();
 
-                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::is_nan(pointDist)) {
                     const vm::vec3 hitPoint = vm::point_at_distance(pickRay, pointDist);
-                    pickResult.addHit(Model::Hit::hit(HandleHitType, pointDist, hitPoint, position));
+                    return Model::Hit::hit(HandleHitType, pointDist, hitPoint, position);
                 }
-            }
+                return Model::Hit::NoHit;
+            }, pickResult);
         }
 
-        void EdgeHandleManager::addHandles(const Model::BrushNode* brushNode) {
+        void EdgeHandleManager::addHandles(Model::BrushNode* brushNode) {
             const Model::Brush& brush = brushNode->brush();
             for (const Model::BrushEdge* edge : brush.edges()) {
-                add(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()));
+                add(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()), brushNode);
             }
         }
 
-        void EdgeHandleManager::removeHandles(const Model::BrushNode* brushNode) {
+        void EdgeHandleManager::removeHandles(Model::BrushNode* brushNode) {
             const Model::Brush& brush = brushNode->brush();
             for (const Model::BrushEdge* edge : brush.edges()) {
-                assertResult(remove(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position())))
+                assertResult(remove(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()), brushNode))
             }
         }
 
@@ -145,28 +177,35 @@ namespace TrenchBroom {
         }
 
         void FaceHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const auto& [position, info] : m_handles) {
+            const auto handleRadius = static_cast<FloatType>(pref(Preferences::HandleRadius));
+            const auto pickRadius = [&](const vm::bbox3& bounds) {
+                return maxPointHandlePickRadius(camera, bounds, handleRadius);
+            };
+
+            // the index position of a face handle is its center
+            pickNearRay(pickRay, pickRadius, [&](const vm::polygon3& position) {
                 const auto pointHandle = position.center();
 
-                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius)));
+                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::is_nan(pointDist)) {
                     const auto hitPoint = vm::point_at_distance(pickRay, pointDist);
-                    pickResult.addHit(Model::Hit::hit(HandleHitType, pointDist, hitPoint, position));
+                    return Model::Hit::hit(HandleHitType, pointDist, hitPoint, position);
                 }
-            }
+                return Model::Hit::NoHit;
+            }, pickResult);
         }
 
-        void FaceHandleManager::addHandles(const Model::BrushNode* brushNode) {
+        void FaceHandleManager::addHandles(Model::BrushNode* brushNode) {
             const Model::Brush& brush = brushNode->brush();
             for (const Model::BrushFace& face : brush.faces()) {
-                add(face.polygon());
+                add(face.polygon(), brushNode);
             }
         }
 
-        void FaceHandleManager::removeHandles(const Model::BrushNode* brushNode) {
+        void FaceHandleManager::removeHandles(Model::BrushNode* brushNode) {
             const Model::Brush& brush = brushNode->brush();
             for (const Model::BrushFace& face : brush.faces()) {
-                assertResult(remove(face.polygon()))
+                assertResult(remove(face.polygon(), brushNode))
             }
         }
 
@@ -20,16 +20,20 @@
 #pragma once
 
 #include "FloatType.h"
+#include "Macros.h"
 #include "Model/BrushNode.h"
 #include "Model/BrushFace.h"
 #include "Model/HitType.h"
 #include "Model/PickResult.h"
 #include "Renderer/Camera.h"
+#include "View/SpatialHashGrid.h"
 
 #include <kdl/vector_set.h>
 
+#include <vecmath/polygon.h>
 #include <vecmath/segment.h>
 
+#include <algorithm>
 #include <iterator>
 #include <map>
 #include <vector>
@@ -42,6 +46,21 @@ namespace TrenchBroom {
     namespace View {
         class Grid;
 
+        /**
+         * Returns the position at which the given handle is stored in the spatial index of a handle manager.
+         */
+        inline vm::vec3 handleIndexPosition(const vm::vec3& handle) {
+            return handle;
+        }
+
+        inline vm::vec3 handleIndexPosition(const vm::segment3& handle) {
+            return handle.center();
+        }
+
+        inline vm::vec3 handleIndexPosition(const vm::polygon3& handle) {
+            return handle.center();
+        }
+
         class VertexHandleManagerBase {
         public:
             virtual ~VertexHandleManagerBase();
@@ -66,7 +85,7 @@ namespace TrenchBroom {
              *
              * @param brushNode the brush whose handles to add
              */
-            virtual void addHandles(const Model::BrushNode* brushNode) = 0;
+            virtual void addHandles(Model::BrushNode* brushNode) = 0;
 
             /**
              * Removes all handles of the given range of brushes from this handle manager.
@@ -88,7 +107,7 @@ namespace TrenchBroom {
              *
              * @param brushNode the brush whose handles to remove
              */
-            virtual void removeHandles(const Model::BrushNode* brushNode) = 0;
+            virtual void removeHandles(Model::BrushNode* brushNode) = 0;
         };
 
         template <typename H>
@@ -105,6 +124,7 @@ namespace TrenchBroom {
             struct HandleInfo {
                 size_t count;
                 bool selected;
+                std::vector<Model::BrushNode*> brushes;
 
                 HandleInfo() :
                 count(0),
@@ -165,15 +185,29 @@ namespace TrenchBroom {
              */
             HandleMap m_handles;
 
+            /**
+             * The edge length of the cells of the spatial handle index.
+             */
+            static constexpr FloatType IndexCellSize = 64.0;
+
+            /**
+             * Indexes the entries of m_handles by their handle index position. Since the nodes of a std::map are
+             * stable, the index can refer to the entries directly.
+             */
+            SpatialHashGrid<HandleEntry*> m_handleIndex;
+
             /**
              * The total number of selected handles, not counting duplicates.
              */
             size_t m_selectedHandleCount;
         public:
             VertexHandleManagerBaseT() :
+            m_handleIndex(IndexCellSize),
             m_selectedHandleCount(0) {}
 
             virtual ~VertexHandleManagerBaseT() {}
+
+            deleteCopyAndMove(VertexHandleManagerBaseT)
         public:
             /**
              * Returns the hit type value of the picking hits reported by this manager.
@@ -300,7 +334,17 @@ namespace TrenchBroom {
              * @param handle the handle to add
              */
             void add(const Handle& handle) {
-                m_handles[handle].inc(); // unknown value gets value constructed, which for HandleInfo means its default constructor is called
+                addHandle(handle);
+            }
+
+            /**
+             * Adds the given handle to this manager and records the given brush as incident to it.
+             *
+             * @param handle the handle to add
+             * @param brushNode the brush that is incident to the given handle
+             */
+            void add(const Handle& handle, Model::BrushNode* brushNode) {
+                addHandle(handle).brushes.push_back(brushNode);
             }
 
             /**
@@ -312,13 +356,30 @@ namespace TrenchBroom {
             bool remove(const Handle& handle) {
                 const auto it = m_handles.find(handle);
                 if (it != std::end(m_handles)) {
-                    HandleInfo& info = it->second;
-                    info.dec();
+                    removeHandle(it);
+                    return true;
+                }
+
+                return false;
+            }
 
-                    if (info.count == 0) {
-                        deselect(info);
-                        m_handles.erase(it);
+            /**
+             * Removes the given handle from this manager and removes the given brush from the brushes which are
+             * recorded as incident to it.
+             *
+             * @param handle the handle to remove
+             * @param brushNode the brush that is incident to the given handle
+             * @return true if the given handle was contained in this manager (and therefore removed) and false otherwise
+             */
+            bool remove(const Handle& handle, Model::BrushNode* brushNode) {
+                const auto it = m_handles.find(handle);
+                if (it != std::end(m_handles)) {
+                    auto& brushes = it->second.brushes;
+                    const auto brushIt = std::find(std::begin(brushes), std::end(brushes), brushNode);
+                    if (brushIt != std::end(brushes)) {
+                        brushes.erase(brushIt);
                     }
+                    removeHandle(it);
                     return true;
                 }
 
@@ -329,9 +390,33 @@ namespace TrenchBroom {
              * Removes all handles from this manager.
              */
             void clear() {
+                m_handleIndex.clear();
                 m_handles.clear();
                 m_selectedHandleCount = 0;
             }
+        private:
+            HandleInfo& addHandle(const Handle& handle) {
+                const auto [it, inserted] = m_handles.try_emplace(handle);
+                if (inserted) {
+                    m_handleIndex.insert(handleIndexPosition(handle), &*it);
+                }
+
+                HandleInfo& info = it->second;
+                info.inc();
+                return info;
+            }
+
+            void removeHandle(typename HandleMap::iterator it) {
+                HandleInfo& info = it->second;
+                info.dec();
+
+                if (info.count == 0) {
+                    deselect(info);
+                    m_handleIndex.remove(handleIndexPosition(it->first), &*it);
+                    m_handles.erase(it);
+                }
+            }
+        public:
 
             /**
              * Selects the given range of handles.
@@ -417,14 +502,16 @@ namespace TrenchBroom {
                 }
             }
         private:
+            static constexpr FloatType CloseHandleEpsilon = 0.001 * 0.001;
+
             template <typename F>
             void forEachCloseHandle(const H& otherHandle, F fun) {
-                static const auto epsilon = 0.001 * 0.001;
-                for (auto& [handle, info] : m_handles) {
-                    if (compare(otherHandle, handle, epsilon) == 0) {
-                        fun(info);
+                // handles that are close to each other have close index positions, too
+                m_handleIndex.forEachInRadius(handleIndexPosition(otherHandle), FloatType(2.0) * CloseHandleEpsilon, [&](const vm::vec3& /* position */, HandleEntry* entry) {
+                    if (compare(otherHandle, entry->first, CloseHandleEpsilon) == 0) {
+                        fun(entry->second);
                     }
-                }
+                });
             }
 
             void select(HandleInfo& info) {
@@ -468,7 +555,52 @@ namespace TrenchBroom {
                     }
                 }
             }
+        protected:
+            /**
+             * Applies the given picking test to all handles whose index position might be within the given pick
+             * radius of the given pick ray, and adds all hits to the given picking result.
+             *
+             * @tparam R the type of the pick radius function, must map a bounding box to an upper bound of the pick
+             * radius of any position within that box
+             * @tparam P the type of the picking test, which must be a unary function that maps a handle to a picking hit
+             * @param pickRay the pick ray
+             * @param pickRadius the pick radius function
+             * @param test the picking test to apply
+             * @param pickResult the pick result to add hits to
+             */
+            template <typename R, typename P>
+            void pickNearRay(const vm::ray3& pickRay, const R& pickRadius, const P& test, Model::PickResult& pickResult) const {
+                m_handleIndex.forEachNearRay(pickRay, pickRadius, [&](const vm::vec3& /* position */, const HandleEntry* entry) {
+                    const auto hit = test(entry->first);
+                    if (hit.isMatch()) {
+                        pickResult.addHit(hit);
+                    }
+                });
+            }
         public:
+            /**
+             * Finds and returns all brushes which are incident to the given handle. Only brushes whose handles were
+             * added to this manager are considered.
+             *
+             * @param handle the handle
+             * @return a set of all brushes that are incident to the given handle
+             */
+            std::vector<Model::BrushNode*> findIncidentBrushes(const Handle& handle) const {
+                kdl::vector_set<Model::BrushNode*> result;
+
+                // the brushes of equal handles are not necessarily recorded under the same key, e.g. the polygons of
+                // adjacent faces have opposite windings, so we check the brushes of every handle at the same position
+                m_handleIndex.forEachInRadius(handleIndexPosition(handle), FloatType(2.0) * CloseHandleEpsilon, [&](const vm::vec3& /* position */, const HandleEntry* entry) {
+                    for (auto* brushNode : entry->second.brushes) {
+                        if (isIncident(handle, brushNode)) {
+                            result.insert(brushNode);
+                        }
+                    }
+                });
+
+                return result.release_data();
+            }
+
             /**
              * Finds and returns all brushes in the given range which are incident to the given handle.
              *
@@ -555,8 +687,8 @@ namespace TrenchBroom {
              */
             void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::BrushNode* brushNode) override;
-            void removeHandles(const Model::BrushNode* brushNode) override;
+            void addHandles(Model::BrushNode* brushNode) override;
+            void removeHandles(Model::BrushNode* brushNode) override;
 
             Model::HitType::Type hitType() const override;
         private:
@@ -600,8 +732,8 @@ namespace TrenchBroom {
              */
             void pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::BrushNode* brushNode) override;
-            void removeHandles(const Model::BrushNode* brushNode) override;
+            void addHandles(Model::BrushNode* brushNode) override;
+            void removeHandles(Model::BrushNode* brushNode) override;
 
             Model::HitType::Type hitType() const override;
         private:
@@ -646,8 +778,8 @@ namespace TrenchBroom {
              */
             void pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
-            void addHandles(const Model::BrushNode* brushNode) override;
-            void removeHandles(const Model::BrushNode* brushNode) override;
+            void addHandles(Model::BrushNode* brushNode) override;
+            void removeHandles(Model::BrushNode* brushNode) override;
 
             Model::HitType::Type hitType() const override;
         private:
@@ -153,6 +153,9 @@ namespace TrenchBroom {
             m_rendererFontSizeCombo->addItems({ "8", "9", "10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "20", "22", "24", "26", "28", "32", "36", "40", "48", "56", "64", "72" });
             m_rendererFontSizeCombo->setValidator(new QIntValidator(1, 96));
 
+            m_cacheLoadedMaps = new QCheckBox();
+            m_cacheLoadedMaps->setToolTip("Cache loaded maps in the user data directory so that unchanged maps open faster.");
+
             auto* layout = new FormWithSectionsLayout();
             layout->setContentsMargins(0, LayoutConstants::MediumVMargin, 0, 0);
             layout->setVerticalSpacing(2);
@@ -177,6 +180,9 @@ namespace TrenchBroom {
             layout->addSection("Fonts");
             layout->addRow("Renderer Font Size", m_rendererFontSizeCombo);
 
+            layout->addSection("Files");
+            layout->addRow("Cache loaded maps", m_cacheLoadedMaps);
+
             viewBox->setMinimumWidth(400);
             viewBox->setLayout(layout);
 
@@ -194,6 +200,7 @@ namespace TrenchBroom {
             connect(m_textureModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ViewPreferencePane::textureModeChanged);
             connect(m_textureBrowserIconSizeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ViewPreferencePane::textureBrowserIconSizeChanged);
             connect(m_rendererFontSizeCombo, &QComboBox::currentTextChanged, this, &ViewPreferencePane::rendererFontSizeChanged);
+            connect(m_cacheLoadedMaps, &QCheckBox::stateChanged, this, &ViewPreferencePane::cacheLoadedMapsChanged);
         }
 
         bool ViewPreferencePane::doCanResetToDefaults() {
@@ -213,6 +220,7 @@ namespace TrenchBroom {
             prefs.resetToDefault(Preferences::Theme);
             prefs.resetToDefault(Preferences::TextureBrowserIconSize);
             prefs.resetToDefault(Preferences::RendererFontSize);
+            prefs.resetToDefault(Preferences::CacheLoadedMaps);
         }
 
         void ViewPreferencePane::doUpdateControls() {
@@ -226,6 +234,7 @@ namespace TrenchBroom {
 
             m_showAxes->setChecked(pref(Preferences::ShowAxes));
             m_enableMsaa->setChecked(pref(Preferences::EnableMSAA));
+            m_cacheLoadedMaps->setChecked(pref(Preferences::CacheLoadedMaps));
             m_themeCombo->setCurrentIndex(findThemeIndex(pref(Preferences::Theme)));
 
             const auto textureBrowserIconSize = pref(Preferences::TextureBrowserIconSize);
@@ -358,5 +367,11 @@ namespace TrenchBroom {
                 prefs.set(Preferences::RendererFontSize, value);
             }
         }
+
+        void ViewPreferencePane::cacheLoadedMapsChanged(const int state) {
+            const auto value = state == Qt::Checked;
+            auto& prefs = PreferenceManager::instance();
+            prefs.set(Preferences::CacheLoadedMaps, value);
+        }
     }
 }
@@ -41,6 +41,7 @@ namespace TrenchBroom {
             QComboBox* m_themeCombo;
             QComboBox* m_textureBrowserIconSizeCombo;
             QComboBox* m_rendererFontSizeCombo;
+            QCheckBox* m_cacheLoadedMaps;
         public:
             explicit ViewPreferencePane(QWidget* parent = nullptr);
        private:
@@ -67,6 +68,7 @@ namespace TrenchBroom {
             void themeChanged(int index);
             void textureBrowserIconSizeChanged(int index);
             void rendererFontSizeChanged(const QString& text);
+            void cacheLoadedMapsChanged(int state);
         };
     }
 }
@@ -0,0 +1,4 @@
+textures/test/test // overrides two existing textures with the same name
+{
+    qer_editorimage textures/test/editor_image.jpg
+}
@@ -0,0 +1,140 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/WadFileSystem.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<unsigned char> makePaletteTable(const std::vector<unsigned char>& rgb, const PaletteTransparency transparency) {
+            std::vector<unsigned char> result;
+            for (size_t i = 0; i < 256; ++i) {
+                result.push_back(rgb[3 * i + 0]);
+                result.push_back(rgb[3 * i + 1]);
+                result.push_back(rgb[3 * i + 2]);
+                result.push_back(i == 255 && transparency == PaletteTransparency::Index255Transparent ? 0x00 : 0xFF);
+            }
+            return result;
+        }
+
+        static std::vector<unsigned char> readPaletteFixture() {
+            IO::DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            auto reader = fs.openFile(IO::Path("fixture/test/palette.lmp"))->reader();
+
+            auto result = std::vector<unsigned char>(reader.size());
+            reader.read(result.data(), result.size());
+            return result;
+        }
+
+        static void checkEqualStats(const IndexedToRgbaStats& actual, const IndexedToRgbaStats& expected) {
+            CHECK(actual.colorSum[0] == expected.colorSum[0]);
+            CHECK(actual.colorSum[1] == expected.colorSum[1]);
+            CHECK(actual.colorSum[2] == expected.colorSum[2]);
+            CHECK(actual.alphaAnd == expected.alphaAnd);
+        }
+
+        TEST_CASE("PaletteTest.convertIndexedToRgbaMatchesScalar", "[PaletteTest]") {
+            const auto transparency = GENERATE(PaletteTransparency::Opaque, PaletteTransparency::Index255Transparent);
+            // cover pixel counts that are not a multiple of the vector width and one that spans several blocks
+            const auto pixelCount = GENERATE(size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(64 * 64), size_t(1000003));
+
+            const auto paletteTable = makePaletteTable(readPaletteFixture(), transparency);
+
+            auto rng = std::mt19937(static_cast<std::mt19937::result_type>(pixelCount));
+            auto distribution = std::uniform_int_distribution<int>(0, 255);
+            auto indexedImage = std::vector<unsigned char>(pixelCount);
+            for (auto& index : indexedImage) {
+                index = static_cast<unsigned char>(distribution(rng));
+            }
+
+            auto expectedImage = std::vector<unsigned char>(4 * pixelCount);
+            const auto expectedStats = convertIndexedToRgbaScalar(paletteTable.data(), indexedImage.data(), pixelCount, expectedImage.data());
+
+            auto actualImage = std::vector<unsigned char>(4 * pixelCount);
+            const auto actualStats = convertIndexedToRgba(paletteTable.data(), indexedImage.data(), pixelCount, actualImage.data());
+
+            CHECK(actualImage == expectedImage);
+            checkEqualStats(actualStats, expectedStats);
+        }
+
+        TEST_CASE("PaletteTest.indexedToRgbaWadTextures", "[PaletteTest]") {
+            const auto wadName = GENERATE(std::string("cr8_czg.wad"), std::string("q1_masked.wad"));
+
+            const auto paletteData = readPaletteFixture();
+            const auto palette = Palette(paletteData);
+
+            NullLogger logger;
+            const auto wadPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/IO/Wad") + IO::Path(wadName);
+            IO::WadFileSystem wadFS(wadPath, logger);
+
+            const auto texturePaths = wadFS.findItems(IO::Path(""), IO::FileExtensionMatcher("D"));
+            REQUIRE(!texturePaths.empty());
+
+            for (const auto& texturePath : texturePaths) {
+                auto file = wadFS.openFile(texturePath);
+                auto reader = file->reader().buffer();
+
+                const auto name = reader.readString(16);
+                const auto width = reader.readSize<int32_t>();
+                const auto height = reader.readSize<int32_t>();
+                const auto offset = reader.readSize<int32_t>();
+                const auto pixelCount = width * height;
+
+                const auto transparency = (!name.empty() && name.front() == '{')
+                                          ? PaletteTransparency::Index255Transparent
+                                          : PaletteTransparency::Opaque;
+                const auto paletteTable = makePaletteTable(paletteData, transparency);
+
+                const auto* indexedImage = reinterpret_cast<const unsigned char*>(reader.begin() + offset);
+                auto expectedImage = std::vector<unsigned char>(4 * pixelCount);
+                const auto expectedStats = convertIndexedToRgbaScalar(paletteTable.data(), indexedImage, pixelCount, expectedImage.data());
+
+                reader.seekFromBegin(offset);
+                auto actualImage = TextureBuffer(4 * pixelCount);
+                Color averageColor;
+                const auto hasTransparency = palette.indexedToRgba(reader, pixelCount, actualImage, transparency, averageColor);
+
+                CAPTURE(texturePath.asString());
+                CHECK(std::vector<unsigned char>(actualImage.data(), actualImage.data() + actualImage.size()) == expectedImage);
+                CHECK(hasTransparency == (expectedStats.alphaAnd != 0xFF));
+                CHECK(averageColor.r() == static_cast<float>(expectedStats.colorSum[0]) / (255.0f * static_cast<float>(pixelCount)));
+                CHECK(averageColor.g() == static_cast<float>(expectedStats.colorSum[1]) / (255.0f * static_cast<float>(pixelCount)));
+                CHECK(averageColor.b() == static_cast<float>(expectedStats.colorSum[2]) / (255.0f * static_cast<float>(pixelCount)));
+                CHECK(averageColor.a() == 1.0f);
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/TextureBuffer.h"
+
+#include <vecmath/vec.h>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        TEST_CASE("TextureBufferTest.fullMipLevelCount", "[TextureBufferTest]") {
+            CHECK(fullMipLevelCount(1, 1) == 1u);
+            CHECK(fullMipLevelCount(2, 1) == 2u);
+            CHECK(fullMipLevelCount(64, 64) == 7u);
+            CHECK(fullMipLevelCount(64, 16) == 7u);
+            CHECK(fullMipLevelCount(707, 710) == 10u);
+        }
+
+        static TextureBufferList makeLevel0(const size_t width, const size_t height, const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a) {
+            TextureBufferList buffers;
+            setMipBufferSize(buffers, 1, width, height, GL_RGBA);
+            for (size_t i = 0; i < width * height; ++i) {
+                buffers[0].data()[4 * i + 0] = r;
+                buffers[0].data()[4 * i + 1] = g;
+                buffers[0].data()[4 * i + 2] = b;
+                buffers[0].data()[4 * i + 3] = a;
+            }
+            return buffers;
+        }
+
+        TEST_CASE("TextureBufferTest.generateMipmapsUniformColor", "[TextureBufferTest]") {
+            auto buffers = makeLevel0(16, 4, 12, 161, 255, 128);
+            generateMipmaps(buffers, fullMipLevelCount(16, 4), 16, 4, GL_RGBA);
+
+            REQUIRE(buffers.size() == 5u);
+            for (size_t level = 0; level < buffers.size(); ++level) {
+                const auto size = sizeAtMipLevel(16, 4, level);
+                REQUIRE(buffers[level].size() == 4u * size.x() * size.y());
+
+                for (size_t i = 0; i < size.x() * size.y(); ++i) {
+                    CHECK(buffers[level].data()[4 * i + 0] == 12);
+                    CHECK(buffers[level].data()[4 * i + 1] == 161);
+                    CHECK(buffers[level].data()[4 * i + 2] == 255);
+                    CHECK(buffers[level].data()[4 * i + 3] == 128);
+                }
+            }
+        }
+
+        TEST_CASE("TextureBufferTest.generateMipmapsGammaCorrect", "[TextureBufferTest]") {
+            // alternating black and white columns, alternating transparent and opaque rows
+            auto buffers = makeLevel0(2, 2, 0, 0, 0, 0);
+            auto* pixels = buffers[0].data();
+            for (size_t y = 0; y < 2; ++y) {
+                for (size_t x = 0; x < 2; ++x) {
+                    auto* pixel = pixels + 4 * (2 * y + x);
+                    pixel[0] = pixel[1] = pixel[2] = x == 0 ? 0 : 255;
+                    pixel[3] = y == 0 ? 0 : 255;
+                }
+            }
+
+            generateMipmaps(buffers, 2, 2, 2, GL_RGBA);
+
+            REQUIRE(buffers.size() == 2u);
+            REQUIRE(buffers[1].size() == 4u);
+
+            // half of the light intensity is sRGB 188 rather than 128
+            CHECK(buffers[1].data()[0] == 188);
+            CHECK(buffers[1].data()[1] == 188);
+            CHECK(buffers[1].data()[2] == 188);
+            // alpha is averaged linearly
+            CHECK(buffers[1].data()[3] == 128);
+        }
+    }
+}
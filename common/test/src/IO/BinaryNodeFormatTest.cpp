@@ -0,0 +1,282 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "IO/BinaryNodeFormat.h"
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PatchNode.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static std::vector<Model::Node*> roundTrip(const std::vector<Model::Node*>& nodes, const Model::MapFormat mapFormat, const vm::bbox3& worldBounds) {
+            const auto data = BinaryNodeFormat::writeNodes(nodes, mapFormat, worldBounds);
+            auto result = BinaryNodeFormat::readNodes(data, mapFormat, worldBounds);
+            REQUIRE(result.has_value());
+            return std::move(*result);
+        }
+
+        static void checkBrushGeometry(const Model::Brush& actual, const Model::Brush& expected) {
+            CHECK(actual == expected);
+            CHECK(actual.vertexCount() == expected.vertexCount());
+            CHECK(actual.edgeCount() == expected.edgeCount());
+            CHECK(actual.bounds() == expected.bounds());
+            for (size_t i = 0; i < expected.faceCount(); ++i) {
+                CHECK(actual.face(i).vertexPositions() == expected.face(i).vertexPositions());
+            }
+        }
+
+        TEST_CASE("BinaryNodeFormatTest.roundTripBrushes", "[BinaryNodeFormatTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto mapFormat = GENERATE(Model::MapFormat::Standard, Model::MapFormat::Valve);
+
+            const auto builder = Model::BrushBuilder(mapFormat, worldBounds);
+            auto cube = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom").value();
+
+            auto attributes = cube.face(0).attributes();
+            attributes.setOffset(vm::vec2f(3.0f, -7.0f));
+            attributes.setScale(vm::vec2f(0.5f, 2.0f));
+            attributes.setRotation(33.0f);
+            attributes.setSurfaceContents(1);
+            attributes.setSurfaceFlags(2);
+            attributes.setSurfaceValue(3.0f);
+            attributes.setColor(Color(0.25f, 0.5f, 0.75f, 1.0f));
+            cube.face(0).setAttributes(attributes);
+
+            const auto pyramid = builder.createBrush({
+                vm::vec3(-32.0, -32.0, 0.0),
+                vm::vec3(+32.0, -32.0, 0.0),
+                vm::vec3(+32.0, +32.0, 0.0),
+                vm::vec3(-32.0, +32.0, 0.0),
+                vm::vec3(  0.0,   0.0, 48.0)
+            }, "pyramid").value();
+
+            auto brushNodes = std::vector<Model::Node*>{
+                new Model::BrushNode(cube),
+                new Model::BrushNode(pyramid)
+            };
+
+            auto nodes = roundTrip(brushNodes, mapFormat, worldBounds);
+            REQUIRE(nodes.size() == 2u);
+
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                const auto* expected = static_cast<Model::BrushNode*>(brushNodes[i]);
+                const auto* actual = dynamic_cast<Model::BrushNode*>(nodes[i]);
+                REQUIRE(actual != nullptr);
+                checkBrushGeometry(actual->brush(), expected->brush());
+            }
+
+            // the restored geometry must support further editing
+            auto translatedBrush = static_cast<Model::BrushNode*>(nodes[1])->brush();
+            const auto transformation = vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0));
+            REQUIRE(translatedBrush.transform(worldBounds, transformation, false).is_success());
+
+            auto expectedBrush = pyramid;
+            REQUIRE(expectedBrush.transform(worldBounds, transformation, false).is_success());
+            checkBrushGeometry(translatedBrush, expectedBrush);
+
+            kdl::vec_clear_and_delete(nodes);
+            kdl::vec_clear_and_delete(brushNodes);
+        }
+
+        TEST_CASE("BinaryNodeFormatTest.roundTripNodeHierarchy", "[BinaryNodeFormatTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto mapFormat = Model::MapFormat::Quake3;
+            const auto builder = Model::BrushBuilder(mapFormat, worldBounds);
+
+            auto entity = Model::Entity({
+                {Model::PropertyKeys::Classname, "func_door"},
+                {"speed", "100"}
+            });
+            entity.setProtectedProperties({"speed"});
+
+            auto* entityNode = new Model::EntityNode(std::move(entity));
+            entityNode->addChild(new Model::BrushNode(builder.createCube(64.0, "door").value()));
+
+            auto group = Model::Group("group");
+            group.setLinkedGroupId("linked_group_id");
+            group.setTransformation(vm::translation_matrix(vm::vec3(32.0, 0.0, 0.0)));
+
+            auto* groupNode = new Model::GroupNode(std::move(group));
+            groupNode->setPersistentId(7u);
+            groupNode->addChild(entityNode);
+            groupNode->addChild(new Model::PatchNode(Model::BezierPatch(3, 3, {
+                {0, 0, 0, 0, 0}, {1, 0, 1, 1, 0}, {2, 0, 0, 2, 0},
+                {0, 1, 1, 0, 1}, {1, 1, 2, 1, 1}, {2, 1, 1, 2, 1},
+                {0, 2, 0, 0, 2}, {1, 2, 1, 1, 2}, {2, 2, 0, 2, 2}
+            }, "patch")));
+
+            auto* pointEntityNode = new Model::EntityNode({
+                {Model::PropertyKeys::Classname, "light"},
+                {Model::PropertyKeys::Origin, "0 0 0"}
+            });
+
+            auto originalNodes = std::vector<Model::Node*>{groupNode, pointEntityNode};
+            auto nodes = roundTrip(originalNodes, mapFormat, worldBounds);
+            REQUIRE(nodes.size() == 2u);
+
+            const auto* actualGroupNode = dynamic_cast<Model::GroupNode*>(nodes[0]);
+            REQUIRE(actualGroupNode != nullptr);
+            CHECK(actualGroupNode->group() == groupNode->group());
+            CHECK(actualGroupNode->persistentId() == groupNode->persistentId());
+            REQUIRE(actualGroupNode->childCount() == 2u);
+
+            const auto* actualEntityNode = dynamic_cast<Model::EntityNode*>(actualGroupNode->children()[0]);
+            REQUIRE(actualEntityNode != nullptr);
+            CHECK(actualEntityNode->entity() == entityNode->entity());
+            CHECK(actualEntityNode->entity().protectedProperties() == std::vector<std::string>{"speed"});
+            REQUIRE(actualEntityNode->childCount() == 1u);
+
+            const auto* actualBrushNode = dynamic_cast<Model::BrushNode*>(actualEntityNode->children()[0]);
+            REQUIRE(actualBrushNode != nullptr);
+            checkBrushGeometry(actualBrushNode->brush(), static_cast<Model::BrushNode*>(entityNode->children()[0])->brush());
+
+            const auto* actualPatchNode = dynamic_cast<Model::PatchNode*>(actualGroupNode->children()[1]);
+            REQUIRE(actualPatchNode != nullptr);
+            CHECK(actualPatchNode->patch() == static_cast<Model::PatchNode*>(groupNode->children()[1])->patch());
+
+            const auto* actualPointEntityNode = dynamic_cast<Model::EntityNode*>(nodes[1]);
+            REQUIRE(actualPointEntityNode != nullptr);
+            CHECK(actualPointEntityNode->entity() == pointEntityNode->entity());
+            CHECK_FALSE(actualPointEntityNode->hasChildren());
+
+            kdl::vec_clear_and_delete(nodes);
+            kdl::vec_clear_and_delete(originalNodes);
+        }
+
+        TEST_CASE("BinaryNodeFormatTest.readIncompatibleData", "[BinaryNodeFormatTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto builder = Model::BrushBuilder(Model::MapFormat::Standard, worldBounds);
+
+            auto nodes = std::vector<Model::Node*>{new Model::BrushNode(builder.createCube(64.0, "texture").value())};
+            const auto data = BinaryNodeFormat::writeNodes(nodes, Model::MapFormat::Standard, worldBounds);
+            kdl::vec_clear_and_delete(nodes);
+
+            SECTION("Other map format") {
+                CHECK(BinaryNodeFormat::readNodes(data, Model::MapFormat::Valve, worldBounds) == std::nullopt);
+            }
+
+            SECTION("Other world bounds") {
+                CHECK(BinaryNodeFormat::readNodes(data, Model::MapFormat::Standard, vm::bbox3(4096.0)) == std::nullopt);
+            }
+
+            SECTION("Text data") {
+                CHECK(BinaryNodeFormat::readNodes("{ \"classname\" \"worldspawn\" }", Model::MapFormat::Standard, worldBounds) == std::nullopt);
+            }
+
+            SECTION("Truncated data") {
+                for (size_t size = 0; size < data.size(); size += 7u) {
+                    CHECK(BinaryNodeFormat::readNodes(std::string_view(data).substr(0, size), Model::MapFormat::Standard, worldBounds) == std::nullopt);
+                }
+            }
+
+            SECTION("Trailing data") {
+                CHECK(BinaryNodeFormat::readNodes(data + std::string(1u, '\0'), Model::MapFormat::Standard, worldBounds) == std::nullopt);
+            }
+
+            SECTION("Corrupted vertex index") {
+                // the last four bytes are the index of the last vertex of the last face
+                auto corruptedData = data;
+                corruptedData[corruptedData.size() - 4u] = static_cast<char>(100);
+                CHECK(BinaryNodeFormat::readNodes(corruptedData, Model::MapFormat::Standard, worldBounds) == std::nullopt);
+            }
+
+            SECTION("Corrupted face boundary") {
+                // swapping the last two vertex indices of the last face leaves the surface open
+                auto corruptedData = data;
+                const auto size = corruptedData.size();
+                for (size_t i = 0; i < 4u; ++i) {
+                    std::swap(corruptedData[size - 8u + i], corruptedData[size - 4u + i]);
+                }
+                CHECK(BinaryNodeFormat::readNodes(corruptedData, Model::MapFormat::Standard, worldBounds) == std::nullopt);
+            }
+        }
+
+        TEST_CASE("BinaryNodeFormatTest.readInvalidGeometry", "[BinaryNodeFormatTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto builder = Model::BrushBuilder(Model::MapFormat::Standard, worldBounds);
+
+            SECTION("Brush vertex off its face planes") {
+                auto nodes = std::vector<Model::Node*>{new Model::BrushNode(builder.createCube(64.0, "texture").value())};
+                auto data = BinaryNodeFormat::writeNodes(nodes, Model::MapFormat::Standard, worldBounds);
+                kdl::vec_clear_and_delete(nodes);
+
+                // the brush node kind is followed by its file position and its vertex count
+                const auto brushPrefix = std::string("\x03\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\x08\0\0\0", 21u);
+                const auto offset = data.find(brushPrefix);
+                REQUIRE(offset != std::string::npos);
+
+                // move the first vertex to the center of the cube
+                const auto x = FloatType(0.0);
+                std::memcpy(data.data() + offset + brushPrefix.size(), &x, sizeof(x));
+                CHECK(BinaryNodeFormat::readNodes(data, Model::MapFormat::Standard, worldBounds) == std::nullopt);
+            }
+
+            SECTION("Invalid patch control point counts") {
+                // patches are only written as children of other nodes
+                auto* groupNode = new Model::GroupNode(Model::Group("group"));
+                groupNode->addChild(new Model::PatchNode(Model::BezierPatch(3, 3, {
+                    {0, 0, 0, 0, 0}, {1, 0, 1, 1, 0}, {2, 0, 0, 2, 0},
+                    {0, 1, 1, 0, 1}, {1, 1, 2, 1, 1}, {2, 1, 1, 2, 1},
+                    {0, 2, 0, 0, 2}, {1, 2, 1, 1, 2}, {2, 2, 0, 2, 2}
+                }, "patch")));
+
+                auto nodes = std::vector<Model::Node*>{groupNode};
+                auto data = BinaryNodeFormat::writeNodes(nodes, Model::MapFormat::Standard, worldBounds);
+                kdl::vec_clear_and_delete(nodes);
+
+                // the patch node kind is followed by its file position and its row and column counts
+                const auto patchPrefix = std::string("\x04\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 17u);
+                const auto offset = data.find(patchPrefix + std::string("\x03\0\0\0\x03\0\0\0", 8u));
+                REQUIRE(offset != std::string::npos);
+
+                const auto rowCount = GENERATE(uint32_t(1), uint32_t(2), uint32_t(4), std::numeric_limits<uint32_t>::max());
+                std::memcpy(data.data() + offset + patchPrefix.size(), &rowCount, sizeof(rowCount));
+                CHECK(BinaryNodeFormat::readNodes(data, Model::MapFormat::Standard, worldBounds) == std::nullopt);
+            }
+        }
+    }
+}
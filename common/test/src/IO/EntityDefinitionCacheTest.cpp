@@ -0,0 +1,186 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "Assets/PropertyDefinition.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static const auto BaseFgd = R"(
+@BaseClass = Appearflags [
+    spawnflags(Flags) =
+    [
+        256 : "Not on Easy" : 0
+        512 : "Not on Normal" : 1
+    ]
+]
+)";
+
+        static const auto MainFgd = R"(
+@include "base.fgd"
+
+@PointClass base(Appearflags) size(-16 -16 -24, 16 16 32) color(0 255 0) model({ "path": "progs/player.mdl", "skin": 1 }) = info_player_start : "Player start"
+[
+    angle(integer) : "Angle" : 90
+    target(target_destination) : "Target"
+    message(string) : "Message" : "hello"
+    speed(float) : "Speed" : "1.5"
+    style(choices) : "Style" : 1 =
+    [
+        0 : "Normal"
+        1 : "Flicker"
+    ]
+]
+
+@SolidClass = func_door : "Door"
+[
+    targetname(target_source) : "Name"
+    wait(integer) : "Wait" : 4
+]
+)";
+
+        static std::vector<Assets::EntityDefinition*> parseFgd(const TestEnvironment& env, std::vector<Path>& includedPaths) {
+            const auto path = env.dir() + Path("main.fgd");
+            TestParserStatus status;
+            FgdParser parser(MainFgd, Color(1.0f, 1.0f, 1.0f, 1.0f), path);
+            auto result = parser.parseDefinitions(status);
+            includedPaths = parser.includedPaths();
+            return result;
+        }
+
+        static const Assets::EntityDefinition* findDefinition(const std::vector<Assets::EntityDefinition*>& definitions, const std::string& name) {
+            for (const auto* definition : definitions) {
+                if (definition->name() == name) {
+                    return definition;
+                }
+            }
+            return nullptr;
+        }
+
+        static void checkPropertyDefinitionsEqual(const Assets::PropertyDefinition& expected, const Assets::PropertyDefinition& actual) {
+            CHECK(actual.key() == expected.key());
+            CHECK(actual.type() == expected.type());
+            CHECK(actual.shortDescription() == expected.shortDescription());
+            CHECK(actual.longDescription() == expected.longDescription());
+            CHECK(actual.readOnly() == expected.readOnly());
+            CHECK(Assets::PropertyDefinition::defaultValue(actual) == Assets::PropertyDefinition::defaultValue(expected));
+        }
+
+        static void checkEntityDefinitionsEqual(const Assets::EntityDefinition& expected, const Assets::EntityDefinition& actual) {
+            CHECK(actual.type() == expected.type());
+            CHECK(actual.name() == expected.name());
+            CHECK(actual.color() == expected.color());
+            CHECK(actual.description() == expected.description());
+
+            if (expected.type() == Assets::EntityDefinitionType::PointEntity) {
+                const auto& expectedPoint = static_cast<const Assets::PointEntityDefinition&>(expected);
+                const auto& actualPoint = static_cast<const Assets::PointEntityDefinition&>(actual);
+                CHECK(actualPoint.bounds() == expectedPoint.bounds());
+                CHECK(actualPoint.modelDefinition() == expectedPoint.modelDefinition());
+            }
+
+            const auto& expectedProperties = expected.propertyDefinitions();
+            const auto& actualProperties = actual.propertyDefinitions();
+            REQUIRE(actualProperties.size() == expectedProperties.size());
+            for (size_t i = 0; i < expectedProperties.size(); ++i) {
+                checkPropertyDefinitionsEqual(*expectedProperties[i], *actualProperties[i]);
+            }
+        }
+
+        TEST_CASE("EntityDefinitionCacheTest.roundTrip", "[EntityDefinitionCacheTest]") {
+            TestEnvironment env("EntityDefinitionCacheTest");
+            env.createFile(Path("main.fgd"), MainFgd);
+            env.createFile(Path("base.fgd"), BaseFgd);
+
+            const auto defaultColor = Color(1.0f, 1.0f, 1.0f, 1.0f);
+            const auto mainPath = env.dir() + Path("main.fgd");
+            const auto cache = EntityDefinitionCache(env.dir() + Path("cache"), "1.0");
+
+            CHECK_FALSE(cache.load(mainPath, defaultColor).has_value());
+
+            std::vector<Path> includedPaths;
+            auto definitions = parseFgd(env, includedPaths);
+            CHECK(includedPaths == std::vector<Path>{env.dir() + Path("base.fgd")});
+            REQUIRE(definitions.size() == 2u);
+
+            cache.store(mainPath, includedPaths, defaultColor, definitions);
+
+            auto cached = cache.load(mainPath, defaultColor);
+            REQUIRE(cached.has_value());
+            REQUIRE(cached->size() == definitions.size());
+            for (size_t i = 0; i < definitions.size(); ++i) {
+                checkEntityDefinitionsEqual(*definitions[i], *(*cached)[i]);
+            }
+
+            const auto* playerStart = findDefinition(*cached, "info_player_start");
+            REQUIRE(playerStart != nullptr);
+
+            const auto* flags = playerStart->propertyDefinition("spawnflags");
+            REQUIRE(flags != nullptr);
+            REQUIRE(flags->type() == Assets::PropertyDefinitionType::FlagsProperty);
+            CHECK(static_cast<const Assets::FlagsPropertyDefinition*>(flags)->options().size() == 2u);
+            CHECK(static_cast<const Assets::FlagsPropertyDefinition*>(flags)->defaultValue() == 512);
+
+            const auto* style = playerStart->propertyDefinition("style");
+            REQUIRE(style != nullptr);
+            REQUIRE(style->type() == Assets::PropertyDefinitionType::ChoiceProperty);
+            CHECK(static_cast<const Assets::ChoicePropertyDefinition*>(style)->options() == Assets::ChoicePropertyOption::List{
+                Assets::ChoicePropertyOption("0", "Normal"),
+                Assets::ChoicePropertyOption("1", "Flicker")
+            });
+
+            SECTION("A different default color invalidates the cache") {
+                CHECK_FALSE(cache.load(mainPath, Color(1.0f, 0.0f, 0.0f, 1.0f)).has_value());
+            }
+
+            SECTION("A different application version invalidates the cache") {
+                const auto otherCache = EntityDefinitionCache(env.dir() + Path("cache"), "2.0");
+                CHECK_FALSE(otherCache.load(mainPath, defaultColor).has_value());
+            }
+
+            SECTION("Changing the definition file invalidates the cache") {
+                env.createFile(Path("main.fgd"), std::string(MainFgd) + "\n// changed\n");
+                CHECK_FALSE(cache.load(mainPath, defaultColor).has_value());
+            }
+
+            SECTION("Changing an included file invalidates the cache") {
+                env.createFile(Path("base.fgd"), std::string(BaseFgd) + "\n// changed\n");
+                CHECK_FALSE(cache.load(mainPath, defaultColor).has_value());
+            }
+
+            kdl::vec_clear_and_delete(*cached);
+            kdl::vec_clear_and_delete(definitions);
+        }
+    }
+}
@@ -865,6 +865,7 @@ decor_goddess_statue : "Goddess Statue" [])";
             CHECK(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "worldspawn"; }));
             CHECK(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "info_player_start"; }));
             CHECK(std::any_of(std::begin(defs), std::end(defs), [](const auto* def) { return def->name() == "info_player_coop"; }));
+            CHECK(parser.includedPaths().size() == 2u);
 
             kdl::vec_clear_and_delete(defs);
         }
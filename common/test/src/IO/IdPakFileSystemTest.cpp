@@ -49,6 +49,7 @@ namespace TrenchBroom {
 
             CHECK(fs.fileExists(Path("gfx/palette.lmp")));
             CHECK(fs.fileExists(Path("GFX/Palette.LMP")));
+            CHECK(fs.fileExists(Path("gfx/../GFX/./palette.lmp")));
         }
 
         TEST_CASE("IdPakFileSystemTest.findItems", "[IdPakFileSystemTest]") {
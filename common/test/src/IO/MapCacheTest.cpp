@@ -0,0 +1,226 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Logger.h"
+#include "TestLogger.h"
+#include "IO/DiskIO.h"
+#include "IO/FileMatcher.h"
+#include "IO/MapCache.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/Layer.h"
+#include "Model/LayerNode.h"
+#include "Model/LockState.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/VisibilityState.h"
+#include "Model/WorldNode.h"
+
+#include <vecmath/bbox.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static const auto CachedMap = R"(// Game: Quake
+// Format: Standard
+// entity 0
+{
+"classname" "worldspawn"
+"message" "cached map"
+"_tb_layer_color" "0.5 0.25 1"
+// brush 0
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+"_tb_layer_sort_index" "0"
+"_tb_layer_locked" "1"
+"_tb_layer_hidden" "1"
+}
+// entity 2
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "2"
+"_tb_layer" "1"
+// brush 0
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+// entity 3
+{
+"classname" "func_door"
+"_tb_group" "2"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) door 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) door 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) door 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) door 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) door 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) door 0 0 0 1 1
+}
+}
+// entity 4
+{
+"classname" "light"
+"origin" "0 0 0"
+}
+)";
+
+        static std::string writeWorld(const Model::WorldNode& worldNode) {
+            auto str = std::stringstream{};
+            auto writer = NodeWriter{worldNode, str};
+            writer.writeMap();
+            return str.str();
+        }
+
+        static std::vector<std::tuple<size_t, size_t>> filePositions(Model::WorldNode& worldNode) {
+            auto result = std::vector<std::tuple<size_t, size_t>>{};
+            for (const auto* node : Model::collectDescendants({&worldNode})) {
+                result.emplace_back(node->lineNumber(), node->lineCount());
+            }
+            return result;
+        }
+
+        TEST_CASE("MapCacheTest.roundTrip", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto mapPath = env.dir() + Path("test.map");
+            const auto contents = std::string(CachedMap);
+            const auto cache = MapCache(env.dir() + Path("cache"), "1.0");
+            auto logger = NullLogger{};
+
+            CHECK(cache.load(mapPath, contents, {Model::MapFormat::Standard}, worldBounds, logger) == nullptr);
+
+            auto status = TestParserStatus{};
+            auto worldNode = WorldReader(contents, Model::MapFormat::Standard).read(worldBounds, status);
+            cache.store(mapPath, contents, *worldNode, worldBounds, {{LogLevel::Warn, "some warning"}, {LogLevel::Info, "some info"}});
+
+            auto testLogger = TestLogger{};
+            auto cachedWorldNode = cache.load(mapPath, contents, {Model::MapFormat::Standard}, worldBounds, testLogger);
+            REQUIRE(cachedWorldNode != nullptr);
+
+            // the messages of the parser are reported again
+            CHECK(testLogger.countMessages() == 2u);
+            CHECK(testLogger.countMessages(LogLevel::Warn) == 1u);
+            CHECK(testLogger.countMessages(LogLevel::Info) == 1u);
+
+            CHECK(cachedWorldNode->mapFormat() == Model::MapFormat::Standard);
+            CHECK(cachedWorldNode->entity() == worldNode->entity());
+            CHECK(cachedWorldNode->defaultLayer()->layer().color() == Color(0.5f, 0.25f, 1.0f));
+            CHECK(filePositions(*cachedWorldNode) == filePositions(*worldNode));
+
+            const auto customLayers = cachedWorldNode->customLayers();
+            REQUIRE(customLayers.size() == 1u);
+            const auto& layer = customLayers.front()->layer();
+            CHECK(layer.name() == "My Layer");
+            CHECK(layer.sortIndex() == 0);
+            CHECK(customLayers.front()->persistentId() == worldNode->customLayers().front()->persistentId());
+            CHECK(customLayers.front()->lockState() == Model::LockState::Locked);
+            CHECK(customLayers.front()->visibilityState() == Model::VisibilityState::Hidden);
+
+            const auto brushNodes = Model::filterBrushNodes(Model::collectDescendants({cachedWorldNode.get()}));
+            CHECK(brushNodes.size() == 3u);
+            for (auto* brushNode : brushNodes) {
+                CHECK(cachedWorldNode->nodeTree().contains(brushNode));
+            }
+
+            CHECK(writeWorld(*cachedWorldNode) == writeWorld(*worldNode));
+
+            SECTION("Changing the map file invalidates the cache") {
+                CHECK(cache.load(mapPath, contents + "\n", {Model::MapFormat::Standard}, worldBounds, logger) == nullptr);
+
+                auto changedContents = contents;
+                changedContents[changedContents.find("cached map")] = 'C';
+                CHECK(cache.load(mapPath, changedContents, {Model::MapFormat::Standard}, worldBounds, logger) == nullptr);
+            }
+
+            SECTION("Other map formats and world bounds invalidate the cache") {
+                CHECK(cache.load(mapPath, contents, {Model::MapFormat::Valve}, worldBounds, logger) == nullptr);
+                CHECK(cache.load(mapPath, contents, {Model::MapFormat::Standard}, vm::bbox3(4096.0), logger) == nullptr);
+            }
+
+            SECTION("Other application versions invalidate the cache") {
+                const auto otherCache = MapCache(env.dir() + Path("cache"), "1.1");
+                CHECK(otherCache.load(mapPath, contents, {Model::MapFormat::Standard}, worldBounds, logger) == nullptr);
+            }
+
+            SECTION("Any acceptable map format matches") {
+                CHECK(cache.load(mapPath, contents, {Model::MapFormat::Valve, Model::MapFormat::Standard}, worldBounds, logger) != nullptr);
+            }
+
+            SECTION("Other map files are not cached") {
+                CHECK(cache.load(env.dir() + Path("other.map"), contents, {Model::MapFormat::Standard}, worldBounds, logger) == nullptr);
+            }
+        }
+
+        TEST_CASE("MapCacheTest.limitCacheFiles", "[MapCacheTest]") {
+            TestEnvironment env("MapCacheTest");
+
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto contents = std::string(CachedMap);
+            const auto cacheDir = env.dir() + Path("cache");
+            const auto cache = MapCache(cacheDir, "1.0");
+
+            auto status = TestParserStatus{};
+            auto worldNode = WorldReader(contents, Model::MapFormat::Standard).read(worldBounds, status);
+            for (size_t i = 0; i < MapCache::MaxCacheFiles + 4u; ++i) {
+                cache.store(env.dir() + Path("test" + std::to_string(i) + ".map"), contents, *worldNode, worldBounds, {});
+            }
+
+            CHECK(Disk::findItems(cacheDir, FileExtensionMatcher("mapcache")).size() == MapCache::MaxCacheFiles);
+
+            // no temporary files are left behind
+            CHECK(Disk::findItems(cacheDir, FileExtensionMatcher("tmp")).empty());
+        }
+    }
+}
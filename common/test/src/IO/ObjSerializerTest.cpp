@@ -34,6 +34,7 @@
 
 #include <memory>
 #include <sstream>
+#include <string>
 
 #include "Catch2.h"
 
@@ -361,5 +362,55 @@ f  71/1/71  80/1/80  81/1/81  72/1/72
             CHECK(mtlStream.str() == R"(newmtl some_texture
 )");
         }
+
+        static size_t countLines(const std::string& str, const std::string& prefix) {
+            auto stream = std::istringstream{str};
+            auto line = std::string{};
+            size_t count = 0u;
+            while (std::getline(stream, line)) {
+                if (line.compare(0u, prefix.size(), prefix) == 0) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        TEST_CASE("ObjSerializer.writeBrushesInChunks") {
+            const auto worldBounds = vm::bbox3{8192.0};
+
+            auto map = Model::WorldNode{Model::Entity{}, Model::MapFormat::Quake3};
+
+            auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+            const auto brushCount = ObjSerializer::ChunkSize + 1u;
+            for (size_t i = 0u; i < brushCount; ++i) {
+                map.defaultLayer()->addChild(new Model::BrushNode{builder.createCube(64.0, "some_texture").value()});
+            }
+
+            auto objStream = std::ostringstream{};
+            auto mtlStream = std::ostringstream{};
+            const auto mtlFilename = "some_file_name.mtl";
+
+            auto writer = NodeWriter{map, std::make_unique<ObjSerializer>(objStream, mtlStream, mtlFilename)};
+            writer.writeMap();
+
+            const auto obj = objStream.str();
+            CHECK(countLines(obj, "mtllib ") == 1u);
+            CHECK(countLines(obj, "# vertices") == 2u);
+            CHECK(countLines(obj, "o ") == brushCount);
+
+            // vertex positions are not shared between brushes, texture coordinates and normals are shared within a chunk
+            CHECK(countLines(obj, "v ") == 8u * brushCount);
+            CHECK(countLines(obj, "vt ") == 2u * 4u);
+            CHECK(countLines(obj, "vn ") == 2u * 6u);
+
+            // the second chunk refers to its own texture coordinates and normals
+            CHECK(obj.find(R"(o entity0_brush4096
+usemtl some_texture
+f  32769/5/7  32770/6/7  32771/7/7  32772/8/7
+)") != std::string::npos);
+
+            CHECK(mtlStream.str() == R"(newmtl some_texture
+)");
+        }
     }
 }
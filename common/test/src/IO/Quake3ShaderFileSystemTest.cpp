@@ -21,6 +21,7 @@
 #include "Assets/Quake3Shader.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/Path.h"
 #include "IO/Quake3ShaderFileSystem.h"
@@ -56,6 +57,34 @@ namespace TrenchBroom {
             }));
         }
 
+        TEST_CASE("Quake3ShaderFileSystemTest.testLinkDuplicateTextures", "[Quake3ShaderFileSystemTest]") {
+            NullLogger logger;
+
+            // There are two textures named "test" with different extensions. The shader must be linked to the first
+            // one, and the second one must not replace it with a generated shader.
+
+            const auto workDir = IO::Disk::getCurrentWorkingDir();
+            const auto testDir = workDir + Path("fixture/test/IO/Shader/fs/duplicates");
+            const auto fallbackDir = testDir + Path("fallback");
+            const auto texturePrefix = Path("textures");
+            const auto shaderSearchPath = Path("scripts");
+            const auto textureSearchPaths = std::vector<Path> { texturePrefix };
+
+            std::shared_ptr<FileSystem> fs = std::make_shared<DiskFileSystem>(fallbackDir);
+            fs = std::make_shared<DiskFileSystem>(fs, testDir);
+            fs = std::make_shared<Quake3ShaderFileSystem>(fs, shaderSearchPath, textureSearchPaths, logger);
+
+            CHECK_THAT(fs->findItems(texturePrefix + Path("test"), FileExtensionMatcher("")), Catch::UnorderedEquals(std::vector<Path>{
+                texturePrefix + Path("test/editor_image"),
+                texturePrefix + Path("test/test"),
+            }));
+
+            const auto file = fs->openFile(texturePrefix + Path("test/test"));
+            const auto* shaderFile = dynamic_cast<const ObjectFile<Assets::Quake3Shader>*>(file.get());
+            REQUIRE(shaderFile != nullptr);
+            CHECK(shaderFile->object().editorImage == texturePrefix + Path("test/editor_image.jpg"));
+        }
+
         TEST_CASE("Quake3ShaderFileSystemTest.testSkipMalformedFiles", "[Quake3ShaderFileSystemTest]") {
             NullLogger logger;
 
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TextureCollectionLoader.h"
+#include "IO/TextureReader.h"
+#include "IO/WadFileSystem.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST_CASE("TextureCollectionLoaderTest.loadWadRepeatedly", "[TextureCollectionLoaderTest]") {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            NullLogger logger;
+            IdMipTextureReader textureReader(nameStrategy, fs, logger, palette);
+
+            const auto wadPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+
+            // read every texture sequentially to obtain the expected pixels
+            auto expectedPixels = std::map<std::string, std::vector<std::vector<unsigned char>>>();
+            {
+                WadFileSystem wadFS(Disk::getCurrentWorkingDir() + wadPath, logger);
+                for (const auto& texturePath : wadFS.findItems(Path(""), FileExtensionMatcher("D"))) {
+                    const auto texture = textureReader.readTexture(wadFS.openFile(texturePath));
+                    auto& mips = expectedPixels[texture.name()];
+                    for (const auto& buffer : texture.buffersIfUnprepared()) {
+                        mips.emplace_back(buffer.data(), buffer.data() + buffer.size());
+                    }
+                }
+            }
+            REQUIRE(expectedPixels.size() == 21u);
+
+            auto loader = FileTextureCollectionLoader(logger, { Disk::getCurrentWorkingDir() }, {});
+            for (size_t i = 0; i < 20u; ++i) {
+                const auto collection = loader.loadTextureCollection(wadPath, { "D" }, textureReader);
+                REQUIRE(collection.textures().size() == expectedPixels.size());
+
+                for (const auto& texture : collection.textures()) {
+                    const auto& expectedMips = expectedPixels.at(texture.name());
+                    const auto& buffers = texture.buffersIfUnprepared();
+                    REQUIRE(buffers.size() == expectedMips.size());
+
+                    for (size_t mip = 0; mip < buffers.size(); ++mip) {
+                        const auto& buffer = buffers[mip];
+                        CHECK(std::vector<unsigned char>(buffer.data(), buffer.data() + buffer.size()) == expectedMips[mip]);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -20,16 +20,29 @@
 #include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
+#include "IO/Reader.h"
 #include "IO/ZipFileSystem.h"
 
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
 #include <algorithm>
 #include <cassert>
+#include <string>
 
 #include "Catch2.h"
 
 namespace TrenchBroom {
     namespace IO {
+        TEST_CASE("ZipFileSystemTest.invalidArchive", "[ZipFileSystemTest]") {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/invalid.zip");
+
+            // errors are reported when the archive is mounted rather than when it is first accessed
+            CHECK_THROWS_AS(ZipFileSystem(zipPath), FileSystemException);
+        }
+
         TEST_CASE("ZipFileSystemTest.directoryExists", "[ZipFileSystemTest]") {
             const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
 
@@ -139,5 +152,27 @@ namespace TrenchBroom {
 
             CHECK(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        TEST_CASE("ZipFileSystemTest.openFileConcurrently", "[ZipFileSystemTest]") {
+            const Path zipPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Zip/zip_test.zip");
+
+            const ZipFileSystem fs(zipPath);
+            const auto paths = fs.findItemsRecursively(Path("textures"), FileExtensionMatcher("wal"));
+            REQUIRE(paths.size() == 7u);
+
+            const auto expected = kdl::vec_transform(paths, [&](const auto& path) {
+                auto reader = fs.openFile(path)->reader().buffer();
+                return std::string(reader.stringView());
+            });
+
+            // files are decompressed on several threads, and reopened files are served from the cache
+            for (size_t i = 0; i < 2; ++i) {
+                const auto actual = kdl::vec_parallel_transform(paths, [&](const auto& path) {
+                    auto reader = fs.openFile(path)->reader().buffer();
+                    return std::string(reader.stringView());
+                });
+                CHECK(actual == expected);
+            }
+        }
     }
 }
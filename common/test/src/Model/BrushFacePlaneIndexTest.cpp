@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushFacePlaneIndex.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static std::vector<BrushFaceHandle> findCoplanarFacesBruteForce(const std::vector<std::unique_ptr<BrushNode>>& brushNodes, const vm::plane3& plane) {
+            std::vector<BrushFaceHandle> result;
+            for (const auto& brushNode : brushNodes) {
+                const auto& brush = brushNode->brush();
+                for (size_t i = 0; i < brush.faceCount(); ++i) {
+                    if (brush.face(i).coplanarWith(plane)) {
+                        result.emplace_back(brushNode.get(), i);
+                    }
+                }
+            }
+            return result;
+        }
+
+        static std::unique_ptr<BrushNode> createCuboidNode(const BrushBuilder& builder, const vm::bbox3& bounds) {
+            return std::make_unique<BrushNode>(builder.createCuboid(bounds, "texture").value());
+        }
+
+        TEST_CASE("BrushFacePlaneIndexTest.findCoplanarFaces", "[BrushFacePlaneIndexTest]") {
+            const auto worldBounds = vm::bbox3(8192.0);
+            const auto builder = BrushBuilder(MapFormat::Standard, worldBounds);
+
+            std::vector<std::unique_ptr<BrushNode>> brushNodes;
+            brushNodes.push_back(createCuboidNode(builder, vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(32, 32, 32))));
+            brushNodes.push_back(createCuboidNode(builder, vm::bbox3(vm::vec3(32, 0, 0), vm::vec3(64, 32, 32))));
+            brushNodes.push_back(createCuboidNode(builder, vm::bbox3(vm::vec3(0, 32, 0), vm::vec3(32, 64, 32))));
+            brushNodes.push_back(createCuboidNode(builder, vm::bbox3(vm::vec3(0, 4000, 0), vm::vec3(32, 4032, 32))));
+            brushNodes.push_back(createCuboidNode(builder, vm::bbox3(vm::vec3(0, -64, 0), vm::vec3(32.5, -32, 32))));
+
+            // faces with arbitrary normals
+            auto rotatedBrush = builder.createCuboid(vm::bbox3(vm::vec3(-64, -64, -64), vm::vec3(-32, -32, -32)), "texture").value();
+            REQUIRE(rotatedBrush.transform(worldBounds, vm::rotation_matrix(vm::to_radians(15.0), vm::to_radians(30.0), vm::to_radians(45.0)), false).is_success());
+            brushNodes.push_back(std::make_unique<BrushNode>(std::move(rotatedBrush)));
+
+            BrushFacePlaneIndex index;
+            CHECK(index.empty());
+
+            for (const auto& brushNode : brushNodes) {
+                index.addBrush(brushNode.get());
+            }
+            CHECK_FALSE(index.empty());
+            CHECK(index.contains(brushNodes[0].get()));
+
+            SECTION("Finds the same faces as testing every face") {
+                for (const auto& brushNode : brushNodes) {
+                    for (const auto& face : brushNode->brush().faces()) {
+                        CHECK_THAT(index.findCoplanarFaces(face.boundary()), Catch::UnorderedEquals(findCoplanarFacesBruteForce(brushNodes, face.boundary())));
+                    }
+                }
+            }
+
+            SECTION("Finds faces on the same plane regardless of their distance") {
+                const auto plane = vm::plane3(32.0, vm::vec3::pos_x());
+                const auto faces = index.findCoplanarFaces(plane);
+                CHECK(faces.size() == 3u);
+                CHECK(kdl::vec_contains(kdl::vec_transform(faces, [](const auto& faceHandle) { return faceHandle.node(); }), brushNodes[3].get()));
+            }
+
+            SECTION("Removed brushes are not found") {
+                index.removeBrush(brushNodes[2].get());
+                CHECK_FALSE(index.contains(brushNodes[2].get()));
+                CHECK(index.findCoplanarFaces(vm::plane3(32.0, vm::vec3::pos_x())).size() == 2u);
+
+                // removing a brush twice does nothing
+                index.removeBrush(brushNodes[2].get());
+                CHECK(index.findCoplanarFaces(vm::plane3(32.0, vm::vec3::pos_x())).size() == 2u);
+            }
+
+            SECTION("Adding a brush again replaces its faces") {
+                index.removeBrush(brushNodes[1].get());
+                brushNodes[1]->setBrush(builder.createCuboid(vm::bbox3(vm::vec3(0, 64, 0), vm::vec3(32, 96, 32)), "texture").value());
+                index.addBrush(brushNodes[1].get());
+                index.addBrush(brushNodes[1].get());
+
+                CHECK(index.findCoplanarFaces(vm::plane3(32.0, vm::vec3::pos_x())).size() == 4u);
+                CHECK(index.findCoplanarFaces(vm::plane3(64.0, vm::vec3::pos_x())).empty());
+            }
+
+            SECTION("Clearing removes all brushes") {
+                index.clear();
+                CHECK(index.empty());
+                CHECK(index.findCoplanarFaces(vm::plane3(32.0, vm::vec3::pos_x())).empty());
+            }
+        }
+    }
+}
@@ -59,7 +59,7 @@ namespace TrenchBroom {
             const vm::vec3 p2(0.0, -1.0, 4.0);
 
             const BrushFaceAttributes attribs("");
-            BrushFace face = BrushFace::create(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)).value();
+            BrushFace face = BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).value();
             CHECK(face.points()[0] == vm::approx(p0));
             CHECK(face.points()[1] == vm::approx(p1));
             CHECK(face.points()[2] == vm::approx(p2));
@@ -73,7 +73,7 @@ namespace TrenchBroom {
             const vm::vec3 p2(2.0, 0.0, 4.0);
 
             const BrushFaceAttributes attribs("");
-            CHECK_FALSE(BrushFace::create(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)).is_success());
+            CHECK_FALSE(BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).is_success());
         }
 
         TEST_CASE("BrushFaceTest.textureUsageCount", "[BrushFaceTest]") {
@@ -89,7 +89,7 @@ namespace TrenchBroom {
             BrushFaceAttributes attribs("");
             {
                 // test constructor
-                BrushFace face = BrushFace::create(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)).value();
+                BrushFace face = BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).value();
                 CHECK(texture.usageCount() == 0u);
 
                 // test setTexture
@@ -120,6 +120,40 @@ namespace TrenchBroom {
             CHECK(texture2.usageCount() == 0u);
         }
 
+        TEST_CASE("BrushFaceTest.textureUsageCountsDeferred", "[BrushFaceTest]") {
+            const vm::vec3 p0(0.0,  0.0, 4.0);
+            const vm::vec3 p1(1.0,  0.0, 4.0);
+            const vm::vec3 p2(0.0, -1.0, 4.0);
+            Assets::Texture texture("testTexture", 64, 64);
+            Assets::Texture texture2("testTexture2", 64, 64);
+
+            BrushFaceAttributes attribs("");
+            {
+                BrushFace face1 = BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).value();
+                BrushFace face2 = BrushFace::create(p0, p1, p2, attribs, ParaxialTexCoordSystem(p0, p1, p2, attribs)).value();
+                face1.setTexture(&texture);
+                CHECK(texture.usageCount() == 1u);
+
+                // the changes are recorded, but not applied
+                Assets::TextureUsageCounts usageCounts1, usageCounts2;
+                CHECK(face1.setTexture(&texture2, usageCounts1));
+                CHECK(face2.setTexture(&texture2, usageCounts2));
+                CHECK_FALSE(face2.setTexture(&texture2, usageCounts2));
+                CHECK(face1.texture() == &texture2);
+                CHECK(face2.texture() == &texture2);
+                CHECK(texture.usageCount() == 1u);
+                CHECK(texture2.usageCount() == 0u);
+
+                usageCounts1.merge(usageCounts2);
+                usageCounts1.apply();
+                CHECK(texture.usageCount() == 0u);
+                CHECK(texture2.usageCount() == 2u);
+            }
+
+            CHECK(texture.usageCount() == 0u);
+            CHECK(texture2.usageCount() == 0u);
+        }
+
         TEST_CASE("BrushFaceTest.projectedArea") {
             const auto worldBounds = vm::bbox3{8192.0};
             const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
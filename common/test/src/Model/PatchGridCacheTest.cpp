@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/BezierPatch.h"
+#include "Model/PatchGridCache.h"
+#include "Model/PatchNode.h"
+
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static BezierPatch makePatch(const FloatType z) {
+            using P = BezierPatch::Point;
+            return BezierPatch{3, 3, {
+                P{0, 0, z}, P{1, 0, z}, P{2, 0, z},
+                P{0, 1, z}, P{1, 1, z}, P{2, 1, z},
+                P{0, 2, z}, P{1, 2, z}, P{2, 2, z},
+            }, "texture"};
+        }
+
+        TEST_CASE("PatchGridCacheTest.returnsCachedGrid") {
+            auto cache = PatchGridCache{};
+
+            const auto grid1 = cache.get(makePatch(0.0), 2u);
+            const auto grid2 = cache.get(makePatch(0.0), 2u);
+            CHECK(grid1 == grid2);
+            CHECK(cache.size() == 1u);
+            CHECK(cache.hits() == 1u);
+            CHECK(cache.misses() == 1u);
+
+            CHECK(grid1->points == makePatchGrid(makePatch(0.0), 2u).points);
+        }
+
+        TEST_CASE("PatchGridCacheTest.keyIncludesControlPointsAndSubdivisions") {
+            auto cache = PatchGridCache{};
+
+            const auto grid = cache.get(makePatch(0.0), 2u);
+            CHECK(cache.get(makePatch(0.0), 1u) != grid);
+            CHECK(cache.get(makePatch(1.0), 2u) != grid);
+
+            auto transformedPatch = makePatch(0.0);
+            transformedPatch.transform(vm::translation_matrix(vm::vec3(0, 0, 1)));
+            CHECK(cache.get(transformedPatch, 2u) == cache.get(makePatch(1.0), 2u));
+            CHECK(cache.size() == 3u);
+        }
+
+        TEST_CASE("PatchGridCacheTest.evictsLeastRecentlyUsed") {
+            auto cache = PatchGridCache{2u};
+
+            const auto grid0 = cache.get(makePatch(0.0), 1u);
+            const auto grid1 = cache.get(makePatch(1.0), 1u);
+
+            // touch the first grid so that the second one is evicted
+            CHECK(cache.get(makePatch(0.0), 1u) == grid0);
+            cache.get(makePatch(2.0), 1u);
+
+            CHECK(cache.size() == 2u);
+            CHECK(cache.get(makePatch(0.0), 1u) == grid0);
+            CHECK(cache.get(makePatch(1.0), 1u) != grid1);
+        }
+
+        TEST_CASE("PatchGridCacheTest.nodesShareGrids") {
+            auto cache = PatchGridCache{};
+
+            auto patchNode = PatchNode{makePatch(1.0)};
+            auto otherPatchNode = PatchNode{makePatch(2.0)};
+            CHECK(&patchNode.grid() != &otherPatchNode.grid());
+
+            patchNode.setPatch(makePatch(3.0), cache);
+            otherPatchNode.setPatch(makePatch(3.0), cache);
+            CHECK(&patchNode.grid() == &otherPatchNode.grid());
+        }
+    }
+}
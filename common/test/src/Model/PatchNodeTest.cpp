@@ -26,6 +26,7 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/approx.h>
+#include <vecmath/intersection.h>
 #include <vecmath/ray.h>
 #include <vecmath/ray_io.h>
 #include <vecmath/vec.h>
@@ -179,5 +180,95 @@ namespace TrenchBroom {
                 CHECK(pickResult.size() == 0u);
             }
         }
+
+        TEST_CASE("PatchNode.computeSubdivisionsPerSurface") {
+            using P = BezierPatch::Point;
+
+            SECTION("Flat patch with linear texture coordinates needs no subdivisions") {
+                const auto patch = BezierPatch{3, 3, {
+                    P{0, 0, 0, 0.0, 0.0}, P{1, 0, 0, 0.5, 0.0}, P{2, 0, 0, 1.0, 0.0},
+                    P{0, 1, 0, 0.0, 0.5}, P{1, 1, 0, 0.5, 0.5}, P{2, 1, 0, 1.0, 0.5},
+                    P{0, 2, 0, 0.0, 1.0}, P{1, 2, 0, 0.5, 1.0}, P{2, 2, 0, 1.0, 1.0},
+                }, "texture"};
+                CHECK(computeSubdivisionsPerSurface(patch, 0.5, 1.0 / 64.0, 3u) == 0u);
+            }
+
+            SECTION("Curved patch needs more subdivisions for a smaller error") {
+                const auto patch = BezierPatch{3, 3, {
+                    P{0, 0, 0}, P{32, 0, 32}, P{64, 0, 0},
+                    P{0, 32, 0}, P{32, 32, 32}, P{64, 32, 0},
+                    P{0, 64, 0}, P{32, 64, 32}, P{64, 64, 0},
+                }, "texture"};
+
+                // |p0 - 2*p1 + p2| = 64, so 4 segments are needed for an error of 1 and 8 segments for an error of 0.25
+                CHECK(computeSubdivisionsPerSurface(patch, 1.0, 1.0, 8u) == 2u);
+                CHECK(computeSubdivisionsPerSurface(patch, 0.25, 1.0, 8u) == 3u);
+                CHECK(computeSubdivisionsPerSurface(patch, 0.25, 1.0, 2u) == 2u);
+            }
+
+            SECTION("Twisted patch needs subdivisions") {
+                // z = x*y/64 over a 64x64 square, the diagonals of the untessellated quad deviate from the surface by 16
+                const auto patch = BezierPatch{3, 3, {
+                    P{0,  0, 0}, P{32,  0,  0}, P{64,  0,  0},
+                    P{0, 32, 0}, P{32, 32, 16}, P{64, 32, 32},
+                    P{0, 64, 0}, P{32, 64, 32}, P{64, 64, 64},
+                }, "texture"};
+
+                // the mixed difference p00 - p01 - p10 + p11 = 16, so 16/k^2 <= 0.5 requires 8 segments
+                CHECK(computeSubdivisionsPerSurface(patch, 0.5, 1.0, 8u) == 3u);
+                CHECK(computeSubdivisionsPerSurface(patch, 4.0, 1.0, 8u) == 1u);
+            }
+        }
+
+        TEST_CASE("PatchNode.intersectWithRayFindsClosestHit") {
+            using P = BezierPatch::Point;
+
+            // a patch that is curved so that it folds back over itself along the x axis
+            const auto patch = BezierPatch{3, 5, {
+                P{0, 0, 0}, P{64, 0, 0}, P{64, 0, 32}, P{64, 0, 64}, P{0, 0, 64},
+                P{0, 32, 0}, P{64, 32, 0}, P{64, 32, 32}, P{64, 32, 64}, P{0, 32, 64},
+                P{0, 64, 0}, P{64, 64, 0}, P{64, 64, 32}, P{64, 64, 64}, P{0, 64, 64},
+            }, "texture"};
+
+            const auto grid = makePatchGrid(patch, 3u);
+            REQUIRE(!grid.boundsHierarchy.empty());
+
+            // compare against testing every triangle of the grid
+            const auto bruteForce = [&](const vm::ray3& ray) {
+                auto closest = vm::nan<FloatType>();
+                for (size_t row = 0u; row < grid.quadRowCount(); ++row) {
+                    for (size_t col = 0u; col < grid.quadColumnCount(); ++col) {
+                        const auto& v0 = grid.point(row, col).position;
+                        const auto& v1 = grid.point(row, col + 1u).position;
+                        const auto& v2 = grid.point(row + 1u, col + 1u).position;
+                        const auto& v3 = grid.point(row + 1u, col).position;
+                        for (const auto distance : {vm::intersect_ray_triangle(ray, v0, v1, v2), vm::intersect_ray_triangle(ray, v2, v3, v0)}) {
+                            if (!vm::is_nan(distance) && (vm::is_nan(closest) || distance < closest)) {
+                                closest = distance;
+                            }
+                        }
+                    }
+                }
+                return closest;
+            };
+
+            const auto ray = GENERATE(
+                vm::ray3{vm::vec3{16, 16, 100}, vm::vec3::neg_z()},
+                vm::ray3{vm::vec3{16, 16, -100}, vm::vec3::pos_z()},
+                vm::ray3{vm::vec3{40, 48, 32}, vm::vec3::pos_x()},
+                vm::ray3{vm::vec3{100, 32, 32}, vm::vec3::neg_x()},
+                vm::ray3{vm::vec3{200, 200, 200}, vm::vec3::pos_x()}
+            );
+
+            CAPTURE(ray);
+
+            const auto expected = bruteForce(ray);
+            const auto actual = grid.intersectWithRay(ray);
+            if (vm::is_nan(expected)) {
+                CHECK(vm::is_nan(actual));
+            } else {
+                CHECK(actual == vm::approx(expected));
+            }
+        }
     }
 }
@@ -18,16 +18,25 @@
  */
 
 #include "FloatType.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/MapFormat.h"
 #include "Model/Polyhedron.h"
 #include "Model/Polyhedron_BrushGeometryPayload.h"
 #include "Model/Polyhedron_DefaultPayload.h"
 #include "Model/Polyhedron_Instantiation.h"
 
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/plane.h>
 #include <vecmath/scalar.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <cmath>
 #include <iterator>
 #include <tuple>
 #include <set>
@@ -435,6 +444,143 @@ namespace TrenchBroom {
             CHECK(p.hasFace({ p2, p6, p8, p4 }));
         }
 
+        TEST_CASE("PolyhedronTest.constructFromGridOfCubeVertices", "[PolyhedronTest]") {
+            // the vertices of a grid of cubes, most of which are inside of the convex hull or on its faces; the larger
+            // grid has enough vertices to be culled in parallel chunks
+            const auto cubeCount = GENERATE(size_t(8), size_t(16));
+            const auto halfSize = static_cast<double>(cubeCount) * 16.0;
+
+            std::vector<vm::vec3d> points;
+            for (size_t x = 0u; x <= cubeCount; ++x) {
+                for (size_t y = 0u; y <= cubeCount; ++y) {
+                    for (size_t z = 0u; z <= cubeCount; ++z) {
+                        points.push_back(vm::vec3d(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)) * 32.0 - vm::vec3d::fill(halfSize));
+                    }
+                }
+            }
+
+            const Polyhedron3d p(points);
+            CHECK(p.closed());
+            CHECK(p == Polyhedron3d(vm::bbox3d(halfSize)));
+        }
+
+        TEST_CASE("PolyhedronTest.constructFromSphereWithInnerPoints", "[PolyhedronTest]") {
+            // points on a sphere, all of which are vertices of the convex hull; there are too few of them to be culled
+            std::vector<vm::vec3d> spherePoints;
+            for (size_t i = 0u; i < 60u; ++i) {
+                const auto z = 1.0 - (2.0 * static_cast<double>(i) + 1.0) / 60.0;
+                const auto r = std::sqrt(1.0 - z * z);
+                const auto phi = static_cast<double>(i) * 2.399963229728653; // golden angle
+                spherePoints.push_back(vm::vec3d(r * std::cos(phi), r * std::sin(phi), z) * 128.0);
+            }
+
+            // enough points inside of the sphere to be culled in parallel chunks
+            std::vector<vm::vec3d> innerPoints;
+            for (size_t x = 0u; x < 18u; ++x) {
+                for (size_t y = 0u; y < 18u; ++y) {
+                    for (size_t z = 0u; z < 18u; ++z) {
+                        innerPoints.push_back(vm::vec3d(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)) * 6.0 - vm::vec3d::fill(51.0));
+                    }
+                }
+            }
+
+            const Polyhedron3d expected(spherePoints);
+            REQUIRE(expected.closed());
+            REQUIRE(expected.vertexCount() == spherePoints.size());
+
+            const Polyhedron3d p(kdl::vec_concat(innerPoints, spherePoints));
+            CHECK(p == expected);
+        }
+
+        /**
+         * Checks that culling the given points before adding them yields the same polyhedron as adding every point.
+         */
+        static void checkAddPointsMatchesAddPoint(const std::vector<vm::vec3d>& points) {
+            const Polyhedron3d culled(points);
+
+            Polyhedron3d incremental;
+            incremental.addPointsWithoutCulling(points);
+
+            CHECK(culled.closed());
+            CHECK(culled == incremental);
+        }
+
+        TEST_CASE("PolyhedronTest.addPointsNearHullMatchesAddPoint", "[PolyhedronTest]") {
+            // the culling margin is the plane epsilon plus the minimum edge length, which is 0.01, so these offsets
+            // place points on both sides of the margin
+            const auto offsets = std::vector<double>{ 0.0, 0.00001, 0.0001, 0.001, 0.005, 0.0099, 0.01, 0.0101, 0.011, 0.02 };
+
+            SECTION("Points near the faces and corners of a cube") {
+                std::vector<vm::vec3d> points;
+                for (const auto offset : offsets) {
+                    for (size_t axis = 0u; axis < 3u; ++axis) {
+                        for (const auto side : { -1.0, 1.0 }) {
+                            for (double u = -64.0; u <= 64.0; u += 16.0) {
+                                for (double v = -64.0; v <= 64.0; v += 16.0) {
+                                    auto point = vm::vec3d::zero();
+                                    point[axis] = side * (64.0 - offset);
+                                    point[(axis + 1u) % 3u] = u;
+                                    point[(axis + 2u) % 3u] = v;
+                                    points.push_back(point);
+                                }
+                            }
+                        }
+                    }
+
+                    // points that are closer to a corner than the minimum edge length
+                    for (const auto x : { -1.0, 1.0 }) {
+                        for (const auto y : { -1.0, 1.0 }) {
+                            for (const auto z : { -1.0, 1.0 }) {
+                                points.push_back(vm::vec3d(x * (64.0 - offset), y * 64.0, z * (64.0 - offset / 2.0)));
+                            }
+                        }
+                    }
+                }
+
+                checkAddPointsMatchesAddPoint(points);
+            }
+
+            SECTION("Points near a sphere") {
+                std::vector<vm::vec3d> points;
+                for (size_t i = 0u; i < 100u; ++i) {
+                    const auto z = 1.0 - (2.0 * static_cast<double>(i) + 1.0) / 100.0;
+                    const auto r = std::sqrt(1.0 - z * z);
+                    const auto phi = static_cast<double>(i) * 2.399963229728653; // golden angle
+                    const auto direction = vm::vec3d(r * std::cos(phi), r * std::sin(phi), z);
+                    for (const auto offset : offsets) {
+                        points.push_back(direction * (128.0 - offset));
+                    }
+                }
+
+                checkAddPointsMatchesAddPoint(points);
+            }
+
+            SECTION("Convex merge of brushes") {
+                // the vertices of a grid of rotated cubes, as collected by a convex merge of these brushes
+                const auto worldBounds = vm::bbox3(8192.0);
+                const auto builder = BrushBuilder(MapFormat::Standard, worldBounds);
+
+                std::vector<vm::vec3d> points;
+                for (size_t x = 0u; x < 4u; ++x) {
+                    for (size_t y = 0u; y < 4u; ++y) {
+                        for (size_t z = 0u; z < 4u; ++z) {
+                            auto brush = builder.createCube(32.0, "texture").value();
+                            const auto angle = vm::to_radians(static_cast<double>(x + y + z) * 15.0);
+                            const auto transformation = vm::translation_matrix(vm::vec3d(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)) * 40.0)
+                                                      * vm::rotation_matrix(vm::vec3d::pos_z(), angle);
+                            REQUIRE(brush.transform(worldBounds, transformation, false).is_success());
+
+                            for (const auto* vertex : brush.vertices()) {
+                                points.push_back(vertex->position());
+                            }
+                        }
+                    }
+                }
+
+                checkAddPointsMatchesAddPoint(points);
+            }
+        }
+
         TEST_CASE("PolyhedronTest.copy", "[PolyhedronTest]") {
             const vm::vec3d p1( 0.0, 0.0, 8.0);
             const vm::vec3d p2( 8.0, 0.0, 0.0);
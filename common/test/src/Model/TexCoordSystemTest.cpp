@@ -22,9 +22,16 @@
 #include "Model/BrushFaceAttributes.h"
 #include "Model/ParaxialTexCoordSystem.h"
 #include "Model/ParallelTexCoordSystem.h"
+#include "Model/TexCoordSystem.h"
 
+#include <vecmath/approx.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <variant>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -54,5 +61,43 @@ namespace TrenchBroom {
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
+
+        TEST_CASE("TexCoordSystemTest.copyVariant", "[TexCoordSystemTest]") {
+            TexCoordSystemVariant original = ParallelTexCoordSystem(vm::vec3::pos_y(), vm::vec3::pos_x());
+            TexCoordSystemVariant copy = original;
+
+            CHECK(std::holds_alternative<ParallelTexCoordSystem>(copy));
+            CHECK(asTexCoordSystem(copy) == asTexCoordSystem(original));
+
+            asTexCoordSystem(copy).resetTextureAxes(vm::vec3::pos_z());
+            CHECK(asTexCoordSystem(original).xAxis() == vm::vec3::pos_y());
+        }
+
+        TEST_CASE("TexCoordSystemTest.transformWithSharedTransform", "[TexCoordSystemTest]") {
+            // rotate by 90 degrees about the face normal and move the face within its plane
+            const auto transformation = vm::translation_matrix(vm::vec3(0.0, -16.0, -8.0)) * vm::rotation_matrix(vm::vec3::pos_x(), vm::to_radians(90.0));
+            const auto sharedTransform = TexCoordSystemTransform(transformation);
+            CHECK(sharedTransform.invertible);
+            CHECK(sharedTransform.translation == vm::approx(vm::vec3(0.0, -16.0, -8.0)));
+
+            const auto oldBoundary = vm::plane3(0.0, vm::vec3::pos_x());
+            const auto newBoundary = oldBoundary.transform(transformation);
+            const auto textureSize = vm::vec2f(64.0f, 64.0f);
+            const auto invariant = vm::vec3(0.0, 16.0, 16.0);
+
+            BrushFaceAttributes attribs("");
+            ParallelTexCoordSystem parallel(vm::vec3::pos_y(), vm::vec3::neg_z());
+            parallel.transform(oldBoundary, newBoundary, sharedTransform, attribs, textureSize, true, invariant);
+
+            // the texture axes are rotated along with the face
+            CHECK(parallel.xAxis() == vm::approx(vm::vec3::pos_z()));
+            CHECK(parallel.yAxis() == vm::approx(vm::vec3::pos_y()));
+            CHECK(attribs.rotation() == vm::approx(90.0f));
+
+            // a point (0, y, z) with texture coordinates (y, -z) is moved to (0, -z - 16, y - 8), which has the texture
+            // coordinates (y - 8, -z - 16) on the new axes, so the offset (8, 16) keeps the texture in place
+            CHECK(attribs.offset() == vm::approx(vm::vec2f(8.0f, 16.0f)));
+            CHECK(attribs.scale() == vm::vec2f(1.0f, 1.0f));
+        }
     }
 }
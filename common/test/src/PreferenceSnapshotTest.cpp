@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "PreferenceManager.h"
+#include "PreferenceSnapshot.h"
+#include "Preferences.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    TEST_CASE("PreferenceSnapshotTest.publishOnChange", "[PreferenceSnapshotTest]") {
+        auto& prefs = PreferenceManager::instance();
+
+        const auto before = prefs.snapshot();
+        REQUIRE(before != nullptr);
+        CHECK(before->version() == prefs.snapshotVersion());
+
+        const bool textureLock = pref(Preferences::TextureLock);
+        CHECK(before->get(Preferences::TextureLock) == textureLock);
+        CHECK(before->get(Preferences::GridAlpha) == pref(Preferences::GridAlpha));
+        CHECK(before->get(Preferences::RendererFontSize) == pref(Preferences::RendererFontSize));
+        CHECK(before->get(Preferences::BackgroundColor) == pref(Preferences::BackgroundColor));
+
+        {
+            const TemporarilySetPref setTextureLock(Preferences::TextureLock, !textureLock);
+
+            const auto after = prefs.snapshot();
+            CHECK(after->version() > before->version());
+            CHECK(after->get(Preferences::TextureLock) == !textureLock);
+
+            // earlier snapshots are not affected
+            CHECK(before->get(Preferences::TextureLock) == textureLock);
+        }
+
+        CHECK(prefs.snapshot()->get(Preferences::TextureLock) == textureLock);
+    }
+
+    TEST_CASE("PreferenceSnapshotTest.unchangedValueDoesNotPublish", "[PreferenceSnapshotTest]") {
+        auto& prefs = PreferenceManager::instance();
+
+        const auto version = prefs.snapshotVersion();
+        CHECK_FALSE(prefs.set(Preferences::TextureLock, pref(Preferences::TextureLock)));
+        CHECK(prefs.snapshotVersion() == version);
+    }
+
+    TEST_CASE("PreferenceSnapshotTest.readOnOtherThread", "[PreferenceSnapshotTest]") {
+        const TemporarilySetPref setGridAlpha(Preferences::GridAlpha, 0.25f);
+
+        float gridAlpha = 0.0f;
+        std::thread thread([&]() {
+            gridAlpha = preferenceSnapshot().get(Preferences::GridAlpha);
+        });
+        thread.join();
+
+        CHECK(gridAlpha == 0.25f);
+    }
+
+    TEST_CASE("PreferenceSnapshotTest.readWhilePublishing", "[PreferenceSnapshotTest]") {
+        constexpr size_t ChangeCount = 200u;
+
+        auto& prefs = PreferenceManager::instance();
+        const TemporarilySetPref setFontSize(Preferences::RendererFontSize, 0);
+
+        // the reader thread must not use Catch's assertions, so it only records what it observes
+        std::atomic<bool> done(false);
+        std::vector<uint64_t> versions;
+        std::vector<int> fontSizes;
+        std::thread reader([&]() {
+            while (!done) {
+                const auto& snapshot = preferenceSnapshot();
+                versions.push_back(snapshot.version());
+                fontSizes.push_back(snapshot.get(Preferences::RendererFontSize));
+            }
+
+            const auto& snapshot = preferenceSnapshot();
+            versions.push_back(snapshot.version());
+            fontSizes.push_back(snapshot.get(Preferences::RendererFontSize));
+        });
+
+        for (size_t i = 1u; i <= ChangeCount; ++i) {
+            prefs.set(Preferences::RendererFontSize, static_cast<int>(i));
+        }
+        done = true;
+        reader.join();
+
+        REQUIRE(!versions.empty());
+        CHECK(std::is_sorted(std::begin(versions), std::end(versions)));
+        CHECK(std::is_sorted(std::begin(fontSizes), std::end(fontSizes)));
+        CHECK(fontSizes.back() == static_cast<int>(ChangeCount));
+        CHECK(versions.back() == prefs.snapshotVersion());
+    }
+}
@@ -0,0 +1,146 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    static size_t countEvents(const std::vector<Profiler::Event>& events, const std::string& name) {
+        return static_cast<size_t>(std::count_if(std::begin(events), std::end(events), [&](const Profiler::Event& event) {
+            return event.name == name;
+        }));
+    }
+
+    TEST_CASE("ProfilerTest.scopedTimerRecordsEvent", "[ProfilerTest]") {
+        Profiler::clear();
+
+        {
+            const Profiler::ScopedTimer timer("scopedTimerRecordsEvent");
+        }
+
+        const auto events = Profiler::events();
+        REQUIRE(countEvents(events, "scopedTimerRecordsEvent") == 1u);
+
+        const auto& event = events.back();
+        CHECK(event.duration >= 0);
+        CHECK(event.start <= Profiler::now());
+    }
+
+    TEST_CASE("ProfilerTest.clearDiscardsEventsAndCounters", "[ProfilerTest]") {
+        Profiler::recordEvent("clearDiscardsEvents", Profiler::now(), Profiler::now());
+        Profiler::addToCounter(ProfilerCounter::PicksPerformed, 3u);
+
+        Profiler::clear();
+
+        CHECK(countEvents(Profiler::events(), "clearDiscardsEvents") == 0u);
+        CHECK(Profiler::counterValue(ProfilerCounter::PicksPerformed) == 0u);
+    }
+
+    TEST_CASE("ProfilerTest.recordFromMultipleThreads", "[ProfilerTest]") {
+        Profiler::clear();
+
+        constexpr size_t ThreadCount = 4u;
+        constexpr size_t EventsPerThread = 100u;
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0u; i < ThreadCount; ++i) {
+            threads.emplace_back([]() {
+                for (size_t j = 0u; j < EventsPerThread; ++j) {
+                    const Profiler::ScopedTimer timer("recordFromMultipleThreads");
+                    Profiler::addToCounter(ProfilerCounter::BrushesValidated, 1u);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const auto events = Profiler::events();
+        CHECK(countEvents(events, "recordFromMultipleThreads") == ThreadCount * EventsPerThread);
+        CHECK(Profiler::counterValue(ProfilerCounter::BrushesValidated) == ThreadCount * EventsPerThread);
+        CHECK(std::is_sorted(std::begin(events), std::end(events), [](const auto& lhs, const auto& rhs) {
+            return lhs.start < rhs.start;
+        }));
+    }
+
+    TEST_CASE("ProfilerTest.ringBufferKeepsMostRecentEvents", "[ProfilerTest]") {
+        Profiler::clear();
+
+        std::thread thread([]() {
+            const auto start = Profiler::now();
+            for (size_t i = 0u; i < Profiler::EventsPerThread + 10u; ++i) {
+                const auto time = start + static_cast<std::int64_t>(i);
+                Profiler::recordEvent(i < 10u ? "ringBufferOld" : "ringBufferNew", time, time + 1);
+            }
+        });
+        thread.join();
+
+        const auto events = Profiler::events();
+        CHECK(countEvents(events, "ringBufferOld") == 0u);
+        CHECK(countEvents(events, "ringBufferNew") == Profiler::EventsPerThread);
+    }
+
+    TEST_CASE("ProfilerTest.summarize", "[ProfilerTest]") {
+        Profiler::clear();
+
+        const auto start = Profiler::now();
+        Profiler::recordEvent("summarizeShort", start, start + 10);
+        Profiler::recordEvent("summarizeLong", start, start + 100);
+        Profiler::recordEvent("summarizeLong", start + 1, start + 51);
+
+        const auto summary = Profiler::summarize(start);
+        REQUIRE(summary.size() == 2u);
+
+        CHECK(std::string(summary[0].name) == "summarizeLong");
+        CHECK(summary[0].count == 2u);
+        CHECK(summary[0].totalDuration == 150);
+        CHECK(summary[0].maxDuration == 100);
+
+        CHECK(std::string(summary[1].name) == "summarizeShort");
+        CHECK(summary[1].count == 1u);
+        CHECK(summary[1].totalDuration == 10);
+    }
+
+    TEST_CASE("ProfilerTest.writeChromeTrace", "[ProfilerTest]") {
+        Profiler::clear();
+
+        const auto start = Profiler::now();
+        Profiler::recordEvent("write \"trace\"", start, start + 2500);
+        Profiler::addToCounter(ProfilerCounter::VboBytesUploaded, 1024u);
+
+        std::stringstream str;
+        Profiler::writeChromeTrace(str);
+        const auto trace = str.str();
+
+        CHECK(trace.rfind("{\"traceEvents\":[", 0) == 0u);
+        CHECK(trace.find("\"name\":\"write \\\"trace\\\"\"") != std::string::npos);
+        CHECK(trace.find("\"ph\":\"X\"") != std::string::npos);
+        CHECK(trace.find("\"dur\":2.500") != std::string::npos);
+        CHECK(trace.find("\"ph\":\"C\"") != std::string::npos);
+        CHECK(trace.find("\"VBO bytes uploaded\":1024") != std::string::npos);
+        CHECK(trace.find("\"displayTimeUnit\":\"ms\"}") != std::string::npos);
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/GLVertex.h"
+
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static const auto DefaultColor = Color(0.0f, 1.0f, 0.0f);
+        static const auto SelectedColor = Color(1.0f, 0.0f, 0.0f);
+
+        static std::vector<LinkRenderer::LineVertex> getLines(EntityLinkCache& cache, Model::WorldNode& world, const Model::EditorContext& editorContext) {
+            auto lines = std::vector<LinkRenderer::LineVertex>{};
+            auto arrows = std::vector<LinkRenderer::ArrowVertex>{};
+            cache.getVertices(world, editorContext, DefaultColor, SelectedColor, lines, arrows);
+            CHECK(lines.size() % 2u == 0u);
+            CHECK(arrows.size() >= lines.size() * 2u);
+            return lines;
+        }
+
+        static bool hasLink(const std::vector<LinkRenderer::LineVertex>& lines, const Model::EntityNodeBase* source, const Model::EntityNodeBase* target, const Color& color) {
+            const auto start = vm::vec3f(source->linkSourceAnchor());
+            const auto end = vm::vec3f(target->linkTargetAnchor());
+            for (size_t i = 0u; i < lines.size(); i += 2u) {
+                if (getVertexComponent<0>(lines[i]) == start && getVertexComponent<0>(lines[i + 1u]) == end) {
+                    return getVertexComponent<1>(lines[i]) == color && getVertexComponent<1>(lines[i + 1u]) == color;
+                }
+            }
+            return false;
+        }
+
+        TEST_CASE("EntityLinkRendererTest.updateChangedLinks", "[EntityLinkRendererTest]") {
+            Model::WorldNode world(Model::Entity(), Model::MapFormat::Standard);
+            Model::EditorContext editorContext;
+
+            auto* sourceNode = new Model::EntityNode({
+                {Model::PropertyKeys::Target, "a"},
+                {Model::PropertyKeys::Origin, "0 0 0"}
+            });
+            auto* targetNode1 = new Model::EntityNode({
+                {Model::PropertyKeys::Targetname, "a"},
+                {Model::PropertyKeys::Origin, "64 0 0"}
+            });
+            auto* targetNode2 = new Model::EntityNode({
+                {Model::PropertyKeys::Targetname, "b"},
+                {Model::PropertyKeys::Origin, "0 64 0"}
+            });
+            world.defaultLayer()->addChild(sourceNode);
+            world.defaultLayer()->addChild(targetNode1);
+            world.defaultLayer()->addChild(targetNode2);
+
+            EntityLinkCache cache;
+
+            auto lines = getLines(cache, world, editorContext);
+            CHECK(lines.size() == 2u);
+            CHECK(hasLink(lines, sourceNode, targetNode1, DefaultColor));
+
+            SECTION("Changing the target of the source entity") {
+                sourceNode->setEntity(Model::Entity({
+                    {Model::PropertyKeys::Target, "b"},
+                    {Model::PropertyKeys::Origin, "0 0 0"}
+                }));
+                cache.invalidateNodes({sourceNode});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 2u);
+                CHECK(hasLink(lines, sourceNode, targetNode2, DefaultColor));
+            }
+
+            SECTION("Changing the name of a target entity") {
+                targetNode2->setEntity(Model::Entity({
+                    {Model::PropertyKeys::Targetname, "a"},
+                    {Model::PropertyKeys::Origin, "0 64 0"}
+                }));
+                cache.invalidateNodes({targetNode2});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 4u);
+                CHECK(hasLink(lines, sourceNode, targetNode1, DefaultColor));
+                CHECK(hasLink(lines, sourceNode, targetNode2, DefaultColor));
+
+                targetNode1->setEntity(Model::Entity({
+                    {Model::PropertyKeys::Origin, "64 0 0"}
+                }));
+                cache.invalidateNodes({targetNode1});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 2u);
+                CHECK(hasLink(lines, sourceNode, targetNode2, DefaultColor));
+            }
+
+            SECTION("Moving a target entity") {
+                targetNode1->setEntity(Model::Entity({
+                    {Model::PropertyKeys::Targetname, "a"},
+                    {Model::PropertyKeys::Origin, "128 0 0"}
+                }));
+                cache.invalidateNodes({targetNode1});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 2u);
+                CHECK(hasLink(lines, sourceNode, targetNode1, DefaultColor));
+            }
+
+            SECTION("Selecting a target entity") {
+                targetNode1->select();
+                cache.invalidateNodes({targetNode1});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 2u);
+                CHECK(hasLink(lines, sourceNode, targetNode1, SelectedColor));
+
+                targetNode1->deselect();
+                cache.invalidateNodes({targetNode1});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(hasLink(lines, sourceNode, targetNode1, DefaultColor));
+            }
+
+            SECTION("Removing a target entity") {
+                world.defaultLayer()->removeChild(targetNode1);
+                const auto removedNode = std::unique_ptr<Model::EntityNode>(targetNode1);
+                cache.removeNodes({targetNode1});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.empty());
+
+                world.defaultLayer()->addChild(removedNode.get());
+                cache.invalidateNodes({removedNode.get()});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 2u);
+                CHECK(hasLink(lines, sourceNode, targetNode1, DefaultColor));
+
+                world.defaultLayer()->removeChild(targetNode1);
+            }
+
+            SECTION("Removing the source entity") {
+                world.defaultLayer()->removeChild(sourceNode);
+                const auto removedNode = std::unique_ptr<Model::EntityNode>(sourceNode);
+                cache.removeNodes({sourceNode});
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.empty());
+            }
+
+            SECTION("Invalidating the cache") {
+                sourceNode->setEntity(Model::Entity({
+                    {Model::PropertyKeys::Target, "b"},
+                    {Model::PropertyKeys::Origin, "0 0 0"}
+                }));
+                cache.invalidate();
+
+                lines = getLines(cache, world, editorContext);
+                CHECK(lines.size() == 2u);
+                CHECK(hasLink(lines, sourceNode, targetNode2, DefaultColor));
+            }
+        }
+    }
+}
@@ -134,7 +134,7 @@ namespace TrenchBroom {
     namespace Model {
         BrushFace createParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName) {
             const BrushFaceAttributes attributes(textureName);
-            return BrushFace::create(point0, point1, point2, attributes, std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, attributes)).value();
+            return BrushFace::create(point0, point1, point2, attributes, ParaxialTexCoordSystem(point0, point1, point2, attributes)).value();
         }
 
         std::vector<vm::vec3> asVertexList(const std::vector<vm::segment3>& edges) {
@@ -236,6 +236,9 @@ namespace TrenchBroom {
             auto configParser = IO::GameConfigParser(configStr, configPath);
             auto config = std::make_unique<Model::GameConfig>(configParser.parse());
             auto game = std::make_shared<Model::GameImpl>(*config, gamePath, logger);
+            // don't write the maps and entity definitions loaded by tests to the user's caches
+            game->setMapCacheDirectory(std::nullopt);
+            game->setEntityDefinitionCacheDirectory(std::nullopt);
 
             // We would ideally just return game, but GameImpl captures a raw reference
             // to the GameConfig.
@@ -18,10 +18,15 @@
  */
 
 #include "Logger.h"
+#include "IO/DiskIO.h"
 #include "IO/Path.h"
 #include "IO/TestEnvironment.h"
 #include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/Layer.h"
 #include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
 #include "View/Autosaver.h"
 #include "View/MapDocumentTest.h"
 
@@ -61,6 +66,7 @@ namespace TrenchBroom {
             addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -77,6 +83,7 @@ namespace TrenchBroom {
 
             Autosaver autosaver(document, 0s);
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -101,6 +108,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(100ms);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK(env.directoryExists(IO::Path("autosave")));
@@ -125,6 +133,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(100ms);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
             CHECK(env.directoryExists(IO::Path("autosave")));
@@ -134,12 +143,14 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(100ms);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
             CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
 
             // modify the map
             addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
             CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
         }
 
@@ -165,8 +176,107 @@ namespace TrenchBroom {
             addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
         }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverDeletesTemporaryBackups") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            env.createDirectory(IO::Path("autosave"));
+            env.createFile(IO::Path("autosave/test.1.map"), "some content");
+            env.createFile(IO::Path("autosave/test.2.map.tmp"), "incomplete content");
+            env.createFile(IO::Path("autosave/other.1.map.tmp"), "other content");
+
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s);
+
+            // modify the map
+            addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
+
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
+
+            CHECK(env.fileExists(IO::Path("autosave/test.2.map")));
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map.tmp")));
+
+            // temporary backups of other maps are kept
+            CHECK(env.fileExists(IO::Path("autosave/other.1.map.tmp")));
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesSameContentAsSynchronousSave") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s);
+
+            // modify the map so that it contains every kind of node
+            auto* layerNode = new Model::LayerNode(Model::Layer("layer"));
+            addNode(*document, document->world(), layerNode);
+
+            auto* entityNode = new Model::EntityNode({{"classname", "func_detail"}});
+            addNode(*document, layerNode, entityNode);
+            addNode(*document, entityNode, createBrushNode("entity_texture"));
+
+            auto* brushNode = createBrushNode("group_texture");
+            addNode(*document, document->currentLayer(), brushNode);
+            document->select(brushNode);
+            document->groupSelection("group");
+            document->deselectAll();
+
+            addNode(*document, document->currentLayer(), createPatchNode("patch_texture"));
+            document->hideLayers({layerNode});
+
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
+            REQUIRE(env.fileExists(IO::Path("autosave/test.1.map")));
+
+            document->saveDocumentTo(env.dir() + IO::Path("sync.map"));
+
+            const auto autosaved = IO::Disk::readTextFile(env.dir() + IO::Path("autosave/test.1.map"));
+            const auto saved = IO::Disk::readTextFile(env.dir() + IO::Path("sync.map"));
+            CHECK(autosaved == saved);
+        }
+
+        TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCancelsSupersededAutosave") {
+            using namespace std::literals::chrono_literals;
+
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0s);
+
+            addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
+            autosaver.triggerAutosave(logger);
+
+            // start another autosave before the first one is reported
+            addNode(*document, document->currentLayer(), createBrushNode("some_texture"));
+            autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
+
+            // the first autosave may have finished before it was superseded, but there is never an incomplete backup
+            CHECK(env.fileExists(IO::Path("autosave/test.1.map")));
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.1.map.tmp")));
+            CHECK_FALSE(env.fileExists(IO::Path("autosave/test.2.map.tmp")));
+
+            document->saveDocumentTo(env.dir() + IO::Path("sync.map"));
+            const auto saved = IO::Disk::readTextFile(env.dir() + IO::Path("sync.map"));
+            const auto latestBackup = env.fileExists(IO::Path("autosave/test.2.map")) ? IO::Path("autosave/test.2.map") : IO::Path("autosave/test.1.map");
+            CHECK(IO::Disk::readTextFile(env.dir() + latestBackup) == saved);
+        }
     }
 }
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/WorldNode.h"
+#include "View/ClipTool.h"
+#include "View/MapDocument.h"
+#include "View/Selection.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/bbox_io.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+#include "MapDocumentTest.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST_CASE_METHOD(MapDocumentTest, "ClipToolTest.clipWhileDraggingPoint") {
+            const Model::BrushBuilder builder(document->world()->mapFormat(), document->worldBounds());
+
+            const auto leftBounds = vm::bbox3(vm::vec3(-64, -16, -16), vm::vec3(-32, 16, 16));
+            const auto centerBounds = vm::bbox3(vm::vec3(-16, -16, -16), vm::vec3(16, 16, 16));
+            const auto rightBounds = vm::bbox3(vm::vec3(32, -16, -16), vm::vec3(64, 16, 16));
+
+            auto* leftBrushNode = new Model::BrushNode(builder.createCuboid(leftBounds, "texture").value());
+            auto* centerBrushNode = new Model::BrushNode(builder.createCuboid(centerBounds, "texture").value());
+            auto* rightBrushNode = new Model::BrushNode(builder.createCuboid(rightBounds, "texture").value());
+
+            document->addNodes({{document->parentForNodes(), {leftBrushNode, centerBrushNode, rightBrushNode}}});
+            document->select(std::vector<Model::Node*>{leftBrushNode, centerBrushNode, rightBrushNode});
+
+            ClipTool tool(document);
+            REQUIRE(tool.activate());
+
+            // keep both sides
+            tool.toggleSide();
+
+            // the clip plane is x = 0
+            tool.addPoint(vm::vec3(0, -128, -128), {});
+            tool.addPoint(vm::vec3(0, 128, -128), {});
+            tool.addPoint(vm::vec3(0, 0, 128), {});
+            REQUIRE(tool.canClip());
+
+            // tilt the plane so that the center brush lies entirely on one side, then move it back
+            tool.beginDragLastPoint();
+            REQUIRE(tool.dragPoint(vm::vec3(48, 0, 128), {}));
+            REQUIRE(tool.dragPoint(vm::vec3(0, 0, 128), {}));
+            tool.endDragPoint();
+
+            tool.performClip();
+
+            const auto clippedBounds = kdl::vec_transform(document->selectedNodes().brushes(), [](const auto* brushNode) {
+                return brushNode->logicalBounds();
+            });
+            CHECK_THAT(clippedBounds, Catch::UnorderedEquals(std::vector<vm::bbox3>{
+                leftBounds,
+                vm::bbox3(vm::vec3(-16, -16, -16), vm::vec3(0, 16, 16)),
+                vm::bbox3(vm::vec3(0, -16, -16), vm::vec3(16, 16, 16)),
+                rightBounds
+            }));
+
+            CHECK(tool.deactivate());
+        }
+    }
+}
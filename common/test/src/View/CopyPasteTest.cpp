@@ -313,5 +313,47 @@ common/caulk
                 CHECK(pastedGroupNode->persistentId() == persistentGroupId);
             }
         }
+
+        TEST_CASE_METHOD(MapDocumentTest, "CopyPasteTest.pasteBinary", "[CopyPasteTest]") {
+            const Model::BrushBuilder builder(document->world()->mapFormat(), document->worldBounds());
+            const auto box = vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64));
+
+            auto* brushNode = new Model::BrushNode(builder.createCuboid(box, "texture").value());
+            addNode(*document, document->parentForNodes(), brushNode);
+
+            document->select(brushNode);
+            auto* groupNode = document->groupSelection("test");
+
+            document->deselectAll();
+            document->select(groupNode);
+
+            const auto data = document->serializeSelectedNodesBinary();
+
+            SECTION("Paste group with brush") {
+                document->deselectAll();
+                REQUIRE(document->pasteBinary(data) == PasteType::Node);
+                REQUIRE(document->selectedNodes().groupCount() == 1u);
+
+                const auto* binaryGroupNode = document->selectedNodes().groups().front();
+                REQUIRE(binaryGroupNode->childCount() == 1u);
+                const auto* binaryBrushNode = dynamic_cast<const Model::BrushNode*>(binaryGroupNode->children().front());
+                REQUIRE(binaryBrushNode != nullptr);
+
+                CHECK(binaryGroupNode->group().name() == "test");
+                CHECK(binaryBrushNode->brush() == brushNode->brush());
+                CHECK(binaryBrushNode->logicalBounds() == box);
+                CHECK(binaryGroupNode->persistentId() != groupNode->persistentId());
+            }
+
+            SECTION("Pasting fails for another map format") {
+                auto binaryData = data;
+                binaryData[8] = static_cast<char>(binaryData[8] + 1);
+                CHECK(document->pasteBinary(binaryData) == std::nullopt);
+            }
+
+            SECTION("Pasting text data fails") {
+                CHECK(document->pasteBinary(document->serializeSelectedNodes()) == std::nullopt);
+            }
+        }
     }
 }
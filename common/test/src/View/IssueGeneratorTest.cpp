@@ -19,6 +19,7 @@
  */
 
 #include "MapDocumentTest.h"
+#include "TestUtils.h"
 
 #include "Model/BrushNode.h"
 #include "Model/EntityNode.h"
@@ -28,12 +29,16 @@
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 
 #include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 
+#include <utility>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom {
@@ -88,5 +93,51 @@ namespace TrenchBroom {
 
             kdl::vec_clear_and_delete(issueGenerators);
         }
+
+        TEST_CASE_METHOD(MapDocumentTest, "IssueGeneratorTest.validateIssuesInParallel") {
+            auto* emptyValueEntityNode = new Model::EntityNode({{"classname", "info_player_start"}, {"key", ""}});
+            auto* missingTargetEntityNode = new Model::EntityNode({{"classname", "trigger_relay"}, {"target", "missing"}});
+            auto* brushEntityNode = new Model::EntityNode({{"classname", "func_door"}});
+            auto* entityBrushNode = createBrushNode();
+            auto* worldBrushNode = createBrushNode();
+
+            addNode(*document, document->parentForNodes(), emptyValueEntityNode);
+            addNode(*document, document->parentForNodes(), missingTargetEntityNode);
+            addNode(*document, document->parentForNodes(), brushEntityNode);
+            addNode(*document, brushEntityNode, entityBrushNode);
+            addNode(*document, document->parentForNodes(), worldBrushNode);
+
+            const auto& issueGenerators = document->world()->registeredIssueGenerators();
+            const auto nodes = Model::collectNodes({document->world()});
+
+            const auto collectIssueTypes = [&]() {
+                auto result = std::vector<std::pair<Model::Node*, Model::IssueType>>{};
+                for (auto* node : nodes) {
+                    for (const auto* issue : node->issues(issueGenerators)) {
+                        result.emplace_back(issue->node(), issue->type());
+                    }
+                }
+                return result;
+            };
+
+            const auto expectedIssueTypes = collectIssueTypes();
+            REQUIRE_FALSE(expectedIssueTypes.empty());
+
+            for (auto* node : nodes) {
+                node->invalidateIssues();
+            }
+
+            Model::Node::validateIssues(nodes, issueGenerators);
+            CHECK(collectIssueTypes() == expectedIssueTypes);
+
+            // the sequence numbers must follow the order of the nodes and generators
+            auto issues = std::vector<Model::Issue*>{};
+            for (auto* node : nodes) {
+                issues = kdl::vec_concat(std::move(issues), node->issues(issueGenerators));
+            }
+            for (size_t i = 1u; i < issues.size(); ++i) {
+                CHECK(issues[i - 1u]->seqId() < issues[i]->seqId());
+            }
+        }
     }
 }
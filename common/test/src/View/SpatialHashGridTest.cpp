@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "View/SpatialHashGrid.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static std::vector<int> findInRadius(const SpatialHashGrid<int>& grid, const vm::vec3& center, const FloatType radius) {
+            std::vector<int> result;
+            grid.forEachInRadius(center, radius, [&](const vm::vec3& /* position */, const int value) {
+                result.push_back(value);
+            });
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
+        TEST_CASE("SpatialHashGridTest.insertAndRemove", "[SpatialHashGridTest]") {
+            SpatialHashGrid<int> grid(16.0);
+            CHECK(grid.empty());
+
+            grid.insert(vm::vec3(1, 1, 1), 1);
+            grid.insert(vm::vec3(2, 2, 2), 2);
+            grid.insert(vm::vec3(100, 100, 100), 3);
+            CHECK(grid.size() == 3u);
+            CHECK(grid.cellCount() == 2u);
+
+            CHECK_FALSE(grid.remove(vm::vec3(1, 1, 1), 3));
+            CHECK_FALSE(grid.remove(vm::vec3(50, 50, 50), 1));
+            CHECK(grid.remove(vm::vec3(1, 1, 1), 1));
+            CHECK(grid.size() == 2u);
+
+            CHECK(grid.remove(vm::vec3(100, 100, 100), 3));
+            CHECK(grid.cellCount() == 1u);
+
+            grid.clear();
+            CHECK(grid.empty());
+            CHECK(grid.cellCount() == 0u);
+        }
+
+        TEST_CASE("SpatialHashGridTest.forEachInRadius", "[SpatialHashGridTest]") {
+            SpatialHashGrid<int> grid(16.0);
+            grid.insert(vm::vec3(0, 0, 0), 1);
+            grid.insert(vm::vec3(-1, -1, -1), 2);
+            grid.insert(vm::vec3(15, 0, 0), 3);
+            grid.insert(vm::vec3(17, 0, 0), 4);
+            grid.insert(vm::vec3(-64, 0, 0), 5);
+
+            CHECK(findInRadius(grid, vm::vec3(0, 0, 0), 0.0) == std::vector<int>{1});
+            CHECK(findInRadius(grid, vm::vec3(0, 0, 0), 2.0) == std::vector<int>{1, 2});
+            CHECK(findInRadius(grid, vm::vec3(16, 0, 0), 1.0) == std::vector<int>{3, 4});
+            CHECK(findInRadius(grid, vm::vec3(16, 0, 0), 0.5) == std::vector<int>{});
+
+            // a query sphere that covers more cells than are occupied
+            CHECK(findInRadius(grid, vm::vec3(0, 0, 0), 1000.0) == std::vector<int>{1, 2, 3, 4, 5});
+        }
+
+        TEST_CASE("SpatialHashGridTest.forEachNearRay", "[SpatialHashGridTest]") {
+            SpatialHashGrid<int> grid(16.0);
+            grid.insert(vm::vec3(8, 8, 8), 1);
+            grid.insert(vm::vec3(8, 40, 8), 2);
+            grid.insert(vm::vec3(200, 8, 8), 3);
+
+            const auto ray = vm::ray3(vm::vec3(-100, 8, 8), vm::vec3::pos_x());
+            const auto findNearRay = [&](const FloatType radius) {
+                std::vector<int> result;
+                grid.forEachNearRay(ray, [&](const vm::bbox3& /* bounds */) { return radius; }, [&](const vm::vec3& /* position */, const int value) {
+                    result.push_back(value);
+                });
+                std::sort(std::begin(result), std::end(result));
+                return result;
+            };
+
+            CHECK(findNearRay(0.0) == std::vector<int>{1, 3});
+            CHECK(findNearRay(32.0) == std::vector<int>{1, 2, 3});
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "View/SubstringIndex.h"
+
+#include <kdl/string_compare.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST_CASE("SubstringIndexTest.find", "[SubstringIndexTest]") {
+            SubstringIndex index;
+            CHECK(index.add("base_floor1") == 0u);
+            CHECK(index.add("BASE_WALL") == 1u);
+            CHECK(index.add("sky1") == 2u);
+            CHECK(index.add("wallwall") == 3u);
+            CHECK(index.size() == 4u);
+
+            CHECK(index.find("") == std::vector<size_t>{0u, 1u, 2u, 3u});
+            CHECK(index.find("1") == std::vector<size_t>{0u, 2u});
+            CHECK(index.find("base") == std::vector<size_t>{0u, 1u});
+            CHECK(index.find("Wall") == std::vector<size_t>{1u, 3u});
+            CHECK(index.find("lwa") == std::vector<size_t>{3u});
+            CHECK(index.find("wallwall") == std::vector<size_t>{3u});
+            CHECK(index.find("base_floor1x").empty());
+            CHECK(index.find("xyz").empty());
+
+            index.clear();
+            CHECK(index.size() == 0u);
+            CHECK(index.find("base").empty());
+        }
+
+        TEST_CASE("SubstringIndexTest.findRequiresTrigramOrder", "[SubstringIndexTest]") {
+            // "abcxbcd" contains all trigrams of "abcd", but not "abcd" itself
+            SubstringIndex index;
+            index.add("abcxbcd");
+            index.add("xabcdx");
+
+            CHECK(index.find("abcd") == std::vector<size_t>{1u});
+        }
+
+        TEST_CASE("SubstringIndexTest.matchesLinearScan", "[SubstringIndexTest]") {
+            const auto strings = std::vector<std::string>{
+                "metal1_1", "metal1_2", "metal2_1", "wood_1", "WOOD_plank", "+0button", "+1button", "*water0", "*lava1", "sky4"
+            };
+
+            SubstringIndex index;
+            for (const auto& str : strings) {
+                index.add(str);
+            }
+
+            for (const auto& pattern : {"metal", "1_", "wood", "butt", "+0b", "*", "a", "0", "tal2_1", "n"}) {
+                std::vector<size_t> expected;
+                for (size_t i = 0u; i < strings.size(); ++i) {
+                    if (kdl::ci::str_contains(strings[i], pattern)) {
+                        expected.push_back(i);
+                    }
+                }
+                CHECK(index.find(pattern) == expected);
+            }
+        }
+    }
+}
@@ -611,5 +611,65 @@ namespace TrenchBroom {
                 CHECK(!faces[i].hasTag(tag));
             }
         }
+
+        TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagUpdateBrushFaceTagsAfterChangingTexture") {
+            auto* brushNode = createBrushNode("some_texture");
+            addNode(*document, document->parentForNodes(), brushNode);
+
+            const auto& textureTag = document->smartTag("texture");
+            const auto& texturePatternTag = document->smartTag("texturePattern");
+            const auto& singleParamTag = document->smartTag("surfaceparm_single");
+            const auto& multiParamTag = document->smartTag("surfaceparm_multi");
+
+            const auto faceHandle = Model::BrushFaceHandle(brushNode, 0u);
+            CHECK(faceHandle.face().hasTag(textureTag));
+            CHECK_FALSE(faceHandle.face().hasTag(texturePatternTag));
+            CHECK_FALSE(faceHandle.face().hasTag(singleParamTag));
+            CHECK(faceHandle.face().hasTag(multiParamTag));
+
+            document->select(faceHandle);
+
+            Model::ChangeBrushFaceAttributesRequest request;
+            request.setTextureName("other_texture");
+            document->setFaceAttributes(request);
+
+            CHECK_FALSE(faceHandle.face().hasTag(textureTag));
+            CHECK(faceHandle.face().hasTag(texturePatternTag));
+            CHECK(faceHandle.face().hasTag(singleParamTag));
+            CHECK(faceHandle.face().hasTag(multiParamTag));
+
+            // the texture is not loaded, so only the texture name tags can match
+            request.setTextureName("missing_other_texture");
+            document->setFaceAttributes(request);
+
+            CHECK(faceHandle.face().texture() == nullptr);
+            CHECK_FALSE(faceHandle.face().hasTag(textureTag));
+            CHECK(faceHandle.face().hasTag(texturePatternTag));
+            CHECK_FALSE(faceHandle.face().hasTag(singleParamTag));
+            CHECK_FALSE(faceHandle.face().hasTag(multiParamTag));
+
+            const auto& faces = brushNode->brush().faces();
+            for (size_t i = 1u; i < faces.size(); ++i) {
+                CHECK(faces[i].hasTag(textureTag));
+            }
+        }
+
+        TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagInitializeBrushFaceTagsAfterRegisteringTags") {
+            auto* brushNode = createBrushNode("some_texture");
+            addNode(*document, document->parentForNodes(), brushNode);
+            CHECK(brushNode->brush().face(0u).hasTag(document->smartTag("texture")));
+
+            // the tags that match a texture are cached, but the cache must not outlive the tags
+            game->setSmartTags({
+                Model::SmartTag("texture", {}, std::make_unique<Model::TextureNameTagMatcher>("other_texture"))
+            });
+            document->registerSmartTags();
+
+            auto* otherBrushNode = createBrushNode("some_texture");
+            addNode(*document, document->parentForNodes(), otherBrushNode);
+            for (const auto& face : otherBrushNode->brush().faces()) {
+                CHECK_FALSE(face.hasTag(document->smartTag("texture")));
+            }
+        }
     }
 }
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2021 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "View/VertexHandleManager.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/polygon.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+    namespace View {
+        static std::unique_ptr<Model::BrushNode> createCube(const vm::bbox3& bounds) {
+            const Model::BrushBuilder builder(Model::MapFormat::Standard, vm::bbox3(4096.0));
+            return std::make_unique<Model::BrushNode>(builder.createCuboid(bounds, "texture").value());
+        }
+
+        TEST_CASE("VertexHandleManagerTest.findIncidentBrushes", "[VertexHandleManagerTest]") {
+            auto left = createCube(vm::bbox3(vm::vec3(-32, 0, 0), vm::vec3(0, 32, 32)));
+            auto right = createCube(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(32, 32, 32)));
+
+            VertexHandleManager vertexHandles;
+            vertexHandles.addHandles(left.get());
+            vertexHandles.addHandles(right.get());
+            CHECK(vertexHandles.totalHandleCount() == 12u);
+
+            CHECK(vertexHandles.findIncidentBrushes(vm::vec3(-32, 0, 0)) == std::vector<Model::BrushNode*>{left.get()});
+            CHECK(kdl::vec_sort(vertexHandles.findIncidentBrushes(vm::vec3(0, 0, 0))) == kdl::vec_sort(std::vector<Model::BrushNode*>{left.get(), right.get()}));
+            CHECK(vertexHandles.findIncidentBrushes(vm::vec3(64, 0, 0)).empty());
+
+            vertexHandles.removeHandles(left.get());
+            CHECK(vertexHandles.totalHandleCount() == 8u);
+            CHECK(vertexHandles.findIncidentBrushes(vm::vec3(0, 0, 0)) == std::vector<Model::BrushNode*>{right.get()});
+            CHECK(vertexHandles.findIncidentBrushes(vm::vec3(-32, 0, 0)).empty());
+
+            EdgeHandleManager edgeHandles;
+            edgeHandles.addHandles(left.get());
+            edgeHandles.addHandles(right.get());
+            CHECK(kdl::vec_sort(edgeHandles.findIncidentBrushes(vm::segment3(vm::vec3(0, 0, 0), vm::vec3(0, 0, 32)))) == kdl::vec_sort(std::vector<Model::BrushNode*>{left.get(), right.get()}));
+
+            FaceHandleManager faceHandles;
+            faceHandles.addHandles(left.get());
+            faceHandles.addHandles(right.get());
+            for (const auto& face : right->brush().faces()) {
+                const auto incidentBrushes = faceHandles.findIncidentBrushes(face.polygon());
+                CHECK(kdl::vec_contains(incidentBrushes, right.get()));
+            }
+        }
+
+        TEST_CASE("VertexHandleManagerTest.selectCloseHandles", "[VertexHandleManagerTest]") {
+            VertexHandleManager vertexHandles;
+            vertexHandles.add(vm::vec3(0, 0, 0));
+            vertexHandles.add(vm::vec3(64, 0, 0));
+
+            vertexHandles.select(vm::vec3(0.0000001, 0, 0));
+            CHECK(vertexHandles.selected(vm::vec3(0, 0, 0)));
+            CHECK_FALSE(vertexHandles.selected(vm::vec3(64, 0, 0)));
+            CHECK(vertexHandles.selectedHandleCount() == 1u);
+
+            vertexHandles.select(vm::vec3(63.9, 0, 0));
+            CHECK(vertexHandles.selectedHandleCount() == 1u);
+
+            vertexHandles.deselect(vm::vec3(0, 0, 0));
+            CHECK_FALSE(vertexHandles.anySelected());
+        }
+    }
+}